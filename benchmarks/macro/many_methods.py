@@ -0,0 +1,43 @@
+#! /usr/bin/python3
+#! -*- coding:utf-8; mode:python; -*-
+
+import argparse
+
+ap = argparse.ArgumentParser(
+    description=("Generate a MiniJava program with many methods of moderate size.")
+)
+ap.add_argument(
+    'number', metavar='N', type=int,
+    help="number of methods"
+)
+ns = ap.parse_args()
+
+print("class Many {")
+print("")
+print("\tpublic int[] data;")
+for i in range(ns.number):
+    callee = "this.m{:d}(x - 1, y)".format(i - 1) if i > 0 else "x"
+    print("")
+    print("\tpublic int m{:d}(int x, int y) {{".format(i))
+    print("\t\tint i = 0;")
+    print("\t\tint s = {:d};".format(i % 101))
+    print("\t\twhile (i < y) {")
+    print("\t\t\tif ((i % {:d}) == 0 && s > x) {{".format(i % 7 + 2))
+    print("\t\t\t\ts = s - x * {:d} + data[i % 16];".format(i % 13 + 1))
+    print("\t\t\t} else {")
+    print("\t\t\t\ts = s + (i * y) / {:d};".format(i % 11 + 1))
+    print("\t\t\t}")
+    print("\t\t\ti = i + 1;")
+    print("\t\t}")
+    print("\t\tif (x > 0) {")
+    print("\t\t\ts = s + {:s};".format(callee))
+    print("\t\t}")
+    print("\t\treturn s;")
+    print("\t}")
+print("")
+print("\tpublic static void main(String[] args) {")
+print("\t\tMany many = new Many();")
+print("\t\tmany.data = new int[16];")
+print("\t\tSystem.out.println(many.m{:d}(3, 10));".format(ns.number - 1))
+print("\t}")
+print("}")
@@ -0,0 +1,221 @@
+#include <cstddef>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "asm/allocator.hpp"
+#include "asm/assembly.hpp"
+#include "asm/elf.hpp"
+#include "asm/encoder.hpp"
+#include "asm/generator.hpp"
+#include "asm/macros.hpp"
+#include "asm/output.hpp"
+#include "firm.hpp"
+#include "io/file_output.hpp"
+#include "irg/irg.hpp"
+#include "opt/opt.hpp"
+#include "parser/ast.hpp"
+#include "parser/ast_factory.hpp"
+#include "parser/ast_misc.hpp"
+#include "semantic/semantic.hpp"
+#include "symbol/symbol_pool.hpp"
+
+#include "testaux/astgen.hpp"
+#include "testaux/benchmark.hpp"
+#include "testaux/temporary_file.hpp"
+
+
+namespace /* anonymous */
+{
+
+	using pool_type = minijava::symbol_pool<>;
+
+	using minijava::backend::virtual_assembly;
+	using minijava::backend::real_assembly;
+
+	const std::string stages[] = {"generate", "allocate", "expand", "write", "encode"};
+
+
+	// Finds the single stage that was selected on the command-line.
+	std::string get_selected_stage(const testaux::benchmark_setup& setup)
+	{
+		auto selected = std::string{};
+		for (const auto& name : stages) {
+			if (setup.get_cmd_flag(name)) {
+				if (!selected.empty()) {
+					throw std::invalid_argument{"Only one stage can be benchmarked at a time"};
+				}
+				selected = name;
+			}
+		}
+		if (selected.empty()) {
+			throw std::invalid_argument{"Please select a stage to benchmark"};
+		}
+		return selected;
+	}
+
+
+	// Counts the instructions in all basic blocks of all assemblies.
+	template <typename RegT>
+	std::size_t count_instructions(const std::vector<minijava::backend::assembly<RegT>>& assemblies)
+	{
+		auto count = std::size_t{};
+		for (const auto& assembly : assemblies) {
+			for (const auto& block : assembly.blocks) {
+				count += block.code.size();
+			}
+		}
+		return count;
+	}
+
+
+	// Runs the benchmark for `stage` on the functions in `irgs`.  All stages
+	// before the benchmarked one are run once up-front so only the selected
+	// stage is timed.
+	testaux::result run_stage(const testaux::constraints& constr, const std::string& stage,
+	                          const std::vector<firm::ir_graph*>& irgs)
+	{
+		if (stage == "generate") {
+			const auto benchmark = [&irgs](){
+				for (const auto irg : irgs) {
+					const auto virtasm = minijava::backend::assemble_function(irg);
+					testaux::clobber_memory(&virtasm);
+				}
+			};
+			return testaux::run_benchmark(constr, benchmark);
+		}
+		auto virtasms = std::vector<virtual_assembly>{};
+		for (const auto irg : irgs) {
+			virtasms.push_back(minijava::backend::assemble_function(irg));
+		}
+		if (stage == "allocate") {
+			const auto benchmark = [&virtasms](){
+				for (const auto& virtasm : virtasms) {
+					const auto realasm = minijava::backend::allocate_registers(virtasm);
+					testaux::clobber_memory(&realasm);
+				}
+			};
+			return testaux::run_benchmark(constr, benchmark);
+		}
+		auto realasms = std::vector<real_assembly>{};
+		for (const auto& virtasm : virtasms) {
+			realasms.push_back(minijava::backend::allocate_registers(virtasm));
+		}
+		if (stage == "expand") {
+			// Macro expansion works in-place so every run needs a fresh copy.
+			const auto prepare = [&realasms](){ return realasms; };
+			const auto benchmark = [](std::vector<real_assembly>& input){
+				for (auto& realasm : input) {
+					minijava::backend::expand_macros(realasm);
+					testaux::clobber_memory(&realasm);
+				}
+			};
+			return testaux::run_benchmark_with_setup(constr, prepare, benchmark);
+		}
+		for (auto& realasm : realasms) {
+			minijava::backend::expand_macros(realasm);
+		}
+		if (stage == "write") {
+			const testaux::temporary_file tempfile{};
+			const auto prepare = [&tempfile](){
+				return minijava::file_output{tempfile.filename()};
+			};
+			const auto benchmark = [&realasms](minijava::file_output& out){
+				for (const auto& realasm : realasms) {
+					minijava::backend::write_text(realasm, out);
+				}
+				out.flush();
+			};
+			return testaux::run_benchmark_with_setup(constr, prepare, benchmark);
+		}
+		if (stage == "encode") {
+			const auto benchmark = [&realasms](){
+				auto obj = minijava::backend::object_file{};
+				for (const auto& realasm : realasms) {
+					minijava::backend::encode_text(realasm, true, obj);
+				}
+				testaux::clobber_memory(&obj);
+			};
+			return testaux::run_benchmark(constr, benchmark);
+		}
+		throw std::logic_error{"Unknown stage: " + stage};
+	}
+
+
+	void real_main(int argc, char** argv)
+	{
+		const auto t0 = testaux::clock_type::now();
+		auto setup = testaux::benchmark_setup{
+			"backend",
+			"Benchmark for performance of a single stage of the assembly back-end."
+		};
+		setup.add_cmd_arg("recursion-depth", "recursion depth for deriving the input");
+		setup.add_cmd_flag("print", "print the sample data to standard error output");
+		setup.add_cmd_flag("optimize", "run all optimizations before lowering the IRG");
+		setup.add_cmd_flag("generate", "benchmark generating assembly with virtual registers");
+		setup.add_cmd_flag("allocate", "benchmark register allocation");
+		setup.add_cmd_flag("expand", "benchmark macro expansion");
+		setup.add_cmd_flag("write", "benchmark writing textual assembly");
+		setup.add_cmd_flag("encode", "benchmark encoding machine code");
+		if (!setup.process(argc, argv)) {
+			return;
+		}
+		const auto depth = setup.get_cmd_arg("recursion-depth");
+		const auto stage = get_selected_stage(setup);
+		auto engine = testaux::get_random_engine();
+		auto pool = pool_type{};
+		auto factory = minijava::ast_factory{};
+		const auto ast = testaux::generate_semantic_ast(engine, pool, factory, depth);
+		if (setup.get_cmd_flag("print")) {
+			std::clog << "/* Randomly generated MiniJava program.  */\n"
+					  << "/* Number of AST nodes:     " << std::setw(12) << factory.id() << " */\n"
+					  << "/* Maximum recursion depth: " << std::setw(12) << depth << " */\n"
+					  << "\n"
+					  << *ast << std::flush;
+		}
+		const auto seminfo = minijava::check_program(*ast, pool, factory);
+		auto firm = minijava::initialize_firm();
+		auto ir = minijava::create_firm_ir(*firm, *ast, seminfo, "benchmark");
+		if (setup.get_cmd_flag("optimize")) {
+			minijava::register_all_optimizations();
+		}
+		minijava::optimize(ir);
+		const auto guard = minijava::make_irp_guard(*ir->second, ir->first);
+		auto irgs = std::vector<firm::ir_graph*>{};
+		const auto n = firm::get_irp_n_irgs();
+		for (std::size_t i = 0; i < n; ++i) {
+			irgs.push_back(firm::get_irp_irg(i));
+		}
+		auto virtasms = std::vector<virtual_assembly>{};
+		for (const auto irg : irgs) {
+			virtasms.push_back(minijava::backend::assemble_function(irg));
+		}
+		const auto size = count_instructions(virtasms);
+		if (size == 0) {
+			throw std::invalid_argument{"Generated program has no instructions; try a greater recursion depth"};
+		}
+		auto constr = setup.get_constraints();
+		if (constr.timeout.count() > 0) {
+			constr.timeout -= testaux::duration_type{testaux::clock_type::now() - t0};
+		}
+		const auto absres = run_stage(constr, stage, irgs);
+		const auto relres = testaux::normalize(absres, size);
+		testaux::print_result(relres);
+	}
+
+}  // namespace /* anonymous */
+
+
+int main(int argc, char * * argv)
+{
+	try {
+		real_main(argc, argv);
+		return EXIT_SUCCESS;
+	} catch (const std::exception& e) {
+		std::cerr << "backend: error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
@@ -105,7 +105,7 @@ namespace /* anonymous */
 			constr.timeout -= testaux::duration_type{testaux::clock_type::now() - t0};
 		}
 		const auto absres = testaux::run_benchmark(constr, benchmark, input, what);
-		const auto relres = testaux::result{absres.mean / size, absres.stdev / size, absres.n};
+		const auto relres = testaux::normalize(absres, size);
 		testaux::print_result(relres);
 	}
 
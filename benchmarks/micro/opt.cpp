@@ -0,0 +1,108 @@
+#include <cstddef>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "irg/irg.hpp"
+#include "opt/opt.hpp"
+#include "parser/ast.hpp"
+#include "parser/ast_factory.hpp"
+#include "parser/ast_misc.hpp"
+#include "semantic/semantic.hpp"
+#include "symbol/symbol_pool.hpp"
+
+#include "testaux/astgen.hpp"
+#include "testaux/benchmark.hpp"
+
+
+namespace /* anonymous */
+{
+
+	using pool_type = minijava::symbol_pool<>;
+
+
+	// Finds the single optimization that was selected on the command-line.
+	std::string get_selected_optimization(const testaux::benchmark_setup& setup)
+	{
+		auto selected = std::string{};
+		for (const auto& name : minijava::get_optimization_names()) {
+			if (setup.get_cmd_flag(name)) {
+				if (!selected.empty()) {
+					throw std::invalid_argument{"Only one optimization can be benchmarked at a time"};
+				}
+				selected = name;
+			}
+		}
+		if (selected.empty()) {
+			throw std::invalid_argument{"Please select an optimization to benchmark"};
+		}
+		return selected;
+	}
+
+
+	void real_main(int argc, char** argv)
+	{
+		const auto t0 = testaux::clock_type::now();
+		auto setup = testaux::benchmark_setup{
+			"opt",
+			"Benchmark for performance of a single optimization applied once to a freshly created Firm IRG."
+		};
+		setup.add_cmd_arg("recursion-depth", "recursion depth for deriving the input");
+		setup.add_cmd_flag("print", "print the sample data to standard error output");
+		for (const auto& name : minijava::get_optimization_names()) {
+			setup.add_cmd_flag(name, "benchmark the '" + name + "' optimization");
+		}
+		if (!setup.process(argc, argv)) {
+			return;
+		}
+		const auto depth = setup.get_cmd_arg("recursion-depth");
+		const auto optname = get_selected_optimization(setup);
+		auto engine = testaux::get_random_engine();
+		auto pool = pool_type{};
+		auto factory = minijava::ast_factory{};
+		const auto ast = testaux::generate_semantic_ast(engine, pool, factory, depth);
+		const auto size = factory.id();
+		if (setup.get_cmd_flag("print")) {
+			std::clog << "/* Randomly generated MiniJava program.  */\n"
+					  << "/* Number of AST nodes:     " << std::setw(12) << size  << " */\n"
+					  << "/* Maximum recursion depth: " << std::setw(12) << depth << " */\n"
+					  << "\n"
+					  << *ast << std::flush;
+		}
+		const auto seminfo = minijava::check_program(*ast, pool, factory);
+		auto firm = minijava::initialize_firm();
+		auto constr = setup.get_constraints();
+		if (constr.timeout.count() > 0) {
+			constr.timeout -= testaux::duration_type{testaux::clock_type::now() - t0};
+		}
+		// The optimization modifies the IRG so every run needs a fresh one.
+		const auto prepare = [&](){
+			return minijava::create_firm_ir(*firm, *ast, seminfo, "benchmark");
+		};
+		const auto benchmark = [&optname](minijava::firm_ir& ir){
+			const auto opt = minijava::create_optimization(optname);
+			const auto guard = minijava::make_irp_guard(*ir->second, ir->first);
+			testaux::clobber_memory(ir.get());
+			opt->optimize(ir);
+			testaux::clobber_memory(ir.get());
+		};
+		const auto absres = testaux::run_benchmark_with_setup(constr, prepare, benchmark);
+		const auto relres = testaux::normalize(absres, size);
+		testaux::print_result(relres);
+	}
+
+}  // namespace /* anonymous */
+
+
+int main(int argc, char * * argv)
+{
+	try {
+		real_main(argc, argv);
+		return EXIT_SUCCESS;
+	} catch (const std::exception& e) {
+		std::cerr << "opt: error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "symbol/concurrent_symbol_pool.hpp"
+#include "symbol/symbol_pool.hpp"
+#include "system/workers.hpp"
+
+#include "testaux/benchmark.hpp"
+#include "testaux/random_tokens.hpp"
+
+
+namespace /* anonymous */
+{
+
+	// Baseline that shares a sequential pool by locking it as a whole.
+	class locked_symbol_pool final
+	{
+	public:
+
+		minijava::symbol normalize(const std::string& text)
+		{
+			const std::lock_guard<std::mutex> lock{_mutex};
+			return _pool.normalize(text);
+		}
+
+	private:
+
+		minijava::symbol_pool<> _pool{};
+
+		std::mutex _mutex{};
+
+	};
+
+	template <typename PoolT>
+	void benchmark(const std::vector<std::vector<std::string>>& input)
+	{
+		PoolT pool{};
+		testaux::clobber_memory(&pool);
+		minijava::run_worker_threads(input.size(), input.size(), [&](const std::size_t i){
+			for (const auto& word : input[i]) {
+				const auto canonical = pool.normalize(word);
+				testaux::clobber_memory(canonical.c_str());
+			}
+		});
+		testaux::clobber_memory(&pool);
+	}
+
+	// Every thread gets its own sequence of words drawn from the same
+	// vocabulary so the threads keep interning overlapping identifiers.
+	std::vector<std::vector<std::string>>
+	get_input(const std::size_t threads, const std::size_t size, const std::size_t vocabulary)
+	{
+		auto engine = testaux::get_random_engine();
+		auto words = std::vector<std::string>{};
+		words.reserve(vocabulary);
+		while (words.size() < vocabulary) {
+			words.push_back(testaux::get_random_identifier(engine));
+		}
+		auto wordchoice = std::uniform_int_distribution<std::size_t>{0, vocabulary - 1};
+		auto input = std::vector<std::vector<std::string>>(threads);
+		for (auto& sequence : input) {
+			sequence.reserve(size);
+			while (sequence.size() < size) {
+				sequence.push_back(words[wordchoice(engine)]);
+			}
+		}
+		return input;
+	}
+
+	void real_main(int argc, char * * argv)
+	{
+		const auto t0 = testaux::clock_type::now();
+		auto setup = testaux::benchmark_setup{
+			"symbol-pool",
+			"Benchmark for interning identifiers in a symbol pool from multiple threads."
+		};
+		setup.add_cmd_arg("threads", "number of threads interning identifiers at the same time");
+		setup.add_cmd_arg("size", "number of identifiers each thread interns");
+		setup.add_cmd_arg("vocabulary", "number of distinct identifiers shared by all threads");
+		setup.add_cmd_flag("locked", "use a sequential pool behind a single lock instead of the concurrent pool");
+		if (!setup.process(argc, argv)) {
+			return;
+		}
+		const auto threads = setup.get_cmd_arg("threads");
+		const auto size = setup.get_cmd_arg("size");
+		const auto vocabulary = setup.get_cmd_arg("vocabulary");
+		if ((threads == 0) || (vocabulary == 0)) {
+			throw std::invalid_argument{"Number of threads and vocabulary size must not be zero"};
+		}
+		const auto input = get_input(threads, size, vocabulary);
+		auto constr = setup.get_constraints();
+		if (constr.timeout.count() > 0) {
+			constr.timeout -= testaux::duration_type{testaux::clock_type::now() - t0};
+		}
+		const auto absres = setup.get_cmd_flag("locked")
+			? testaux::run_benchmark(constr, benchmark<locked_symbol_pool>, input)
+			: testaux::run_benchmark(constr, benchmark<minijava::concurrent_symbol_pool<>>, input);
+		const auto relres = testaux::normalize(absres, threads * size);
+		testaux::print_result(relres);
+	}
+
+}
+
+int main(int argc, char * * argv)
+{
+	try {
+		real_main(argc, argv);
+		return EXIT_SUCCESS;
+	} catch (const std::exception& e) {
+		std::cerr << "symbol-pool: error: " << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+}
@@ -73,7 +73,7 @@ namespace /* anonymous */
 		}
 		const auto nops = 4 * count;
 		const auto absres = testaux::run_benchmark(constr, benchmark, input);
-		const auto relres = testaux::result{absres.mean / nops, absres.stdev / nops, absres.n};
+		const auto relres = testaux::normalize(absres, nops);
 		testaux::print_result(relres);
 	}
 
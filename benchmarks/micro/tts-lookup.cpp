@@ -121,7 +121,7 @@ namespace /* anonymous */
 			constr.timeout -= testaux::duration_type{testaux::clock_type::now() - t0};
 		}
 		const auto absres = testaux::run_benchmark(constr, benchmark, haystacks, needles);
-		const auto relres = testaux::result{absres.mean / count, absres.stdev / count, absres.n};
+		const auto relres = testaux::normalize(absres, count);
 		testaux::print_result(relres);
 	}
 
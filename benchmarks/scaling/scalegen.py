@@ -0,0 +1,110 @@
+#! /usr/bin/python3
+#! -*- coding:utf-8; mode:python; -*-
+
+import argparse
+import sys
+
+
+def gen_classes(units):
+    # about 30 tokens per class
+    for i in range(units):
+        other = 'C{:d}'.format(i - 1) if i > 0 else 'C{:d}'.format(i)
+        print("class C{:d} {{".format(i))
+        print("\tpublic int f;")
+        print("\tpublic {:s} next;".format(other))
+        print("\tpublic int get({:s} o) {{ return o.f + this.f; }}".format(other))
+        print("}")
+    print("class Main {")
+    print("\tpublic static void main(String[] args) {")
+    print("\t\tC{:d} c = new C{:d}();".format(units - 1, units - 1))
+    print("\t\tSystem.out.println(c.f);")
+    print("\t}")
+    print("}")
+
+
+def gen_methods(units):
+    # about 19 tokens per method
+    print("class Main {")
+    print("\tpublic int m0(int a) { return a; }")
+    for i in range(1, units):
+        print("\tpublic int m{:d}(int a) {{ return this.m{:d}(a + {:d}); }}".format(i, i - 1, i))
+    print("\tpublic static void main(String[] args) {")
+    print("\t\tSystem.out.println(new Main().m{:d}(0));".format(units - 1))
+    print("\t}")
+    print("}")
+
+
+def gen_statements(units):
+    # about 8 tokens per statement
+    print("class Main {")
+    print("\tpublic int run(int a) {")
+    print("\t\tint b = a;")
+    print("\t\tint c = 1;")
+    for i in range(units):
+        if i % 2 == 0:
+            print("\t\tb = b + c * {:d};".format(i % 97))
+        else:
+            print("\t\tc = c - b / {:d};".format(i % 89 + 1))
+    print("\t\treturn b + c;")
+    print("\t}")
+    print("\tpublic static void main(String[] args) {")
+    print("\t\tSystem.out.println(new Main().run(1));")
+    print("\t}")
+    print("}")
+
+
+def gen_expressions(units):
+    # about 2 tokens per operand
+    operators = ['+', '*', '-', '/']
+    print("class Main {")
+    print("\tpublic int run(int a, int b) {")
+    sys.stdout.write("\t\treturn a")
+    for i in range(units):
+        operand = 'b' if i % 2 == 0 else str(i % 1000 + 1)
+        sys.stdout.write(" {:s} {:s}".format(operators[i % len(operators)], operand))
+        if i % 16 == 15:
+            sys.stdout.write("\n\t\t\t")
+    print(";")
+    print("\t}")
+    print("\tpublic static void main(String[] args) {")
+    print("\t\tSystem.out.println(new Main().run(1, 2));")
+    print("\t}")
+    print("}")
+
+
+def gen_nesting(units):
+    # about 14 tokens per level
+    print("class Main {")
+    print("\tpublic int run(int x) {")
+    for i in range(units):
+        print("\t\tx = x + 1; if (x < {:d}) {{".format(i + 2))
+    print("\t\tx = 0;")
+    print("}" * units)
+    print("\t\treturn x;")
+    print("\t}")
+    print("\tpublic static void main(String[] args) {")
+    print("\t\tSystem.out.println(new Main().run(0));")
+    print("\t}")
+    print("}")
+
+
+SHAPES = {
+    'classes'     : (gen_classes,     30),
+    'methods'     : (gen_methods,     19),
+    'statements'  : (gen_statements,   8),
+    'expressions' : (gen_expressions,  2),
+    'nesting'     : (gen_nesting,     14),
+}
+
+ap = argparse.ArgumentParser(
+    description=(
+          "Generate a semantically correct MiniJava program of a given shape"
+        + " with approximately N tokens."
+    )
+)
+ap.add_argument('shape', metavar='SHAPE', choices=sorted(SHAPES.keys()), help="shape of the program")
+ap.add_argument('number', metavar='N', type=int, help="approximate number of tokens")
+ns = ap.parse_args()
+
+(generator, tokens_per_unit) = SHAPES[ns.shape]
+generator(max(1, ns.number // tokens_per_unit))
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+
+#include <boost/program_options.hpp>
+
+#include "asm/asm.hpp"
+#include "io/file_data.hpp"
+#include "irg/irg.hpp"
+#include "lexer/lexer.hpp"
+#include "lexer/token.hpp"
+#include "lexer/token_iterator.hpp"
+#include "opt/opt.hpp"
+#include "parser/ast_factory.hpp"
+#include "parser/parser.hpp"
+#include "semantic/semantic.hpp"
+#include "symbol/symbol_pool.hpp"
+
+namespace po = boost::program_options;
+
+
+namespace /* anonymous */
+{
+
+	using clock_type = std::chrono::steady_clock;
+
+	const std::string stages[] = {"lex", "parse", "check", "irg", "opt", "asm"};
+
+	// Peak resident set size of this process so far in bytes.
+	long get_peak_memory()
+	{
+		auto usage = rusage{};
+		if (getrusage(RUSAGE_SELF, &usage) < 0) {
+			return 0;
+		}
+		return usage.ru_maxrss * 1024L;
+	}
+
+	// Reports a completed stage that was started at time `t0` and tells
+	// whether it was the last one to run.
+	bool report(const std::string& stage, const clock_type::time_point t0, const std::string& last)
+	{
+		const auto t1 = clock_type::now();
+		const auto secs = std::chrono::duration<double>{t1 - t0}.count();
+		std::printf("%-8s  %18.8E  %18ld\n", stage.c_str(), secs, get_peak_memory());
+		std::fflush(stdout);
+		return (stage == last);
+	}
+
+	void run_stages(const std::string& filename, const std::string& last, const bool optimize)
+	{
+		auto in = minijava::file_data{filename};
+		auto pool = minijava::symbol_pool<>{};
+		auto t0 = clock_type::now();
+		auto tokens = std::vector<minijava::token>{};
+		{
+			auto lex = minijava::make_lexer(std::begin(in), std::end(in), pool, pool);
+			std::copy(minijava::token_begin(lex), minijava::token_end(lex), std::back_inserter(tokens));
+		}
+		std::printf("%-8s  %18zu\n", "tokens", tokens.size());
+		if (report("lex", t0, last)) {
+			return;
+		}
+		t0 = clock_type::now();
+		auto factory = minijava::ast_factory{};
+		const auto ast = minijava::parse_program(std::begin(tokens), std::end(tokens), factory);
+		if (report("parse", t0, last)) {
+			return;
+		}
+		t0 = clock_type::now();
+		const auto seminfo = minijava::check_program(*ast, pool, factory);
+		if (report("check", t0, last)) {
+			return;
+		}
+		auto firm = minijava::initialize_firm();
+		t0 = clock_type::now();
+		auto ir = minijava::create_firm_ir(*firm, *ast, seminfo, filename);
+		if (report("irg", t0, last)) {
+			return;
+		}
+		t0 = clock_type::now();
+		if (optimize) {
+			minijava::register_all_optimizations();
+		}
+		minijava::optimize(ir);
+		if (report("opt", t0, last)) {
+			return;
+		}
+		t0 = clock_type::now();
+		const auto obj = minijava::encode_object(ir);
+		report("asm", t0, last);
+	}
+
+	void real_main(int argc, char** argv)
+	{
+		auto input = std::string{};
+		auto last = std::string{"asm"};
+		auto options = po::options_description{"Options"};
+		options.add_options()
+			(
+				"stop-after",
+				po::value<std::string>(&last),
+				"stop after the stage 'lex', 'parse', 'check', 'irg', 'opt' or 'asm'"
+			)(
+				"optimize",
+				"run all optimizations in the 'opt' stage (otherwise, only lower the IRG)"
+			)(
+				"help",
+				"show help text and exit"
+			);
+		auto hidden = po::options_description{};
+		hidden.add_options()("input", po::value<std::string>(&input)->required(), "");
+		auto positional = po::positional_options_description{};
+		positional.add("input", 1);
+		auto all = po::options_description{};
+		all.add(options).add(hidden);
+		auto varmap = po::variables_map{};
+		po::store(po::command_line_parser(argc, argv).options(all).positional(positional).run(), varmap);
+		if (varmap.count("help")) {
+			std::cout << "usage: stages [--stop-after=STAGE] [--optimize] FILE\n"
+					  << "\n"
+					  << "Runs the stages of the compiler on FILE one after another and reports\n"
+					  << "for each one the wall-time it took and the peak memory usage so far.\n"
+					  << "The first line of output is the number of tokens in FILE.\n"
+					  << "\n"
+					  << options << "\n"
+					  << std::flush;
+			return;
+		}
+		po::notify(varmap);
+		if (std::find(std::begin(stages), std::end(stages), last) == std::end(stages)) {
+			throw po::error{"Unknown stage: " + last};
+		}
+		run_stages(input, last, varmap.count("optimize") > 0);
+	}
+
+}  // namespace /* anonymous */
+
+
+int main(int argc, char** argv)
+{
+	try {
+		real_main(argc, argv);
+		return EXIT_SUCCESS;
+	} catch (const std::exception& e) {
+		std::fprintf(stderr, "stages: error: %s\n", e.what());
+		return EXIT_FAILURE;
+	}
+}
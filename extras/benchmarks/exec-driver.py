@@ -0,0 +1,370 @@
+#! /usr/bin/python3
+#! -*- coding:utf-8; mode:python; -*-
+
+import argparse
+import collections
+import os.path
+import shutil
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+from lib.cli import (
+    TerminalSizeHack,
+    add_argument_groups,
+    add_compiler,
+    regretful_epilog,
+    use_color,
+)
+
+from lib.fancy import (
+    Reporter,
+)
+
+from lib.history import (
+    History,
+)
+
+from lib.manifest import (
+    InvalidManifestError,
+    ManifestLoader,
+)
+
+from lib.runner import (
+    COUNTERS,
+    BenchmarkRunner,
+    CollectionRunner,
+    Constraints,
+    Failure,
+    Result,
+    TimeoutFailure,
+)
+
+
+# Ways to compile the benchmark programs and the compiler options to use for
+# them.  Results are recorded under the name 'PROGRAM.CONFIGURATION'.
+CONFIGURATIONS = collections.OrderedDict([
+    ('native-O0', ['-O0']),
+    ('native-O1', ['-O1']),
+    ('native-O2', ['-O2']),
+    ('firm-O0',   ['--compile-firm', '-O0']),
+    ('firm-O1',   ['--compile-firm', '-O1']),
+    ('firm-O2',   ['--compile-firm', '-O2']),
+])
+
+
+def main(args):
+    ap = argparse.ArgumentParser(
+        prog='exec-driver',
+        usage="%(prog)s -X COMPILER -M MANIFEST -D DIR ... [OPTION ...] [--] [NAME ...]",
+        description=(
+              "Run benchmarks for the code generated by the compiler.  Each"
+            + " benchmark program is compiled once for every configuration"
+            + " (backend and optimization level) and the resulting executable"
+            + " is run repetitively to measure its total wall-time.  A NAME"
+            + " can either select a single 'PROGRAM.CONFIGURATION' or all"
+            + " configurations of a PROGRAM."
+        ),
+        epilog=regretful_epilog,
+        add_help=False,
+    )
+    (pos, ess, sta, sup) = add_argument_groups(ap)
+    add_compiler(ess)
+    ess.add_argument(
+        '-c', '--configurations', metavar='CONFIG', nargs='+',
+        choices=list(CONFIGURATIONS.keys()), default=list(CONFIGURATIONS.keys()),
+        help=(
+              "Only compile the benchmark programs in the configurations"
+            + " CONFIG.  The default is to use all of them: "
+            + ", ".join(CONFIGURATIONS.keys()) + "."
+        )
+    )
+    sup.add_argument(
+        '-P', '--perf', metavar='FILE', default=shutil.which('perf'),
+        help=(
+              "Use the 'perf' executable FILE to read the performance counters "
+            + ", ".join(COUNTERS) + " in an additional run of each benchmark. "
+            + " By default, 'perf' is searched in the '$PATH'.  If it cannot be"
+            + " found, no counters will be recorded.  Counters that are not"
+            + " supported are left out."
+        )
+    )
+    sup.add_argument(
+        '--no-perf', dest='perf', action='store_const', const=None,
+        help="Don't read any performance counters."
+    )
+    with TerminalSizeHack():
+        ns = ap.parse_args(args)
+    if ns.alert is not None and ns.history is None:
+        print("exec-driver: warning: --alert has no effect without --history", file=sys.stderr)
+    reporter = Reporter(
+        use_color(ns.color), counters=(COUNTERS if ns.perf is not None else ()), name_width=24
+    )
+    constraints = Constraints(
+        timeout=ns.timeout,
+        repetitions=ns.repetitions,
+        quantile=ns.quantile,
+        significance=ns.significance,
+        warmup=ns.warmup
+    )
+    if ns.info:
+        reporter.print_info()
+    try:
+        loader = ExecManifestLoader()
+        config = expand_configurations(loader.load(ns.manifest), ns.configurations)
+        selection = select_benchmarks(ns.benchmarks, config)
+        with History(ns.history, create=ns.update) as histo:
+            ecr = ExecCollectionRunner(
+                ns.directories, compiler=ns.compiler, perf=ns.perf,
+                constraints=constraints,
+                logger=lambda m : reporter.print_notice(m) if ns.verbose else None
+            )
+            return ecr.run_collection(
+                selection=selection, config=config, histo=histo,
+                update=ns.update, report=reporter, alert=ns.alert
+            )
+    except (AssertionError, TypeError):
+        raise
+    except KeyboardInterrupt:
+        reporter.print_error("Canceled by keyboard interrupt")
+        return 128 + 2
+    except Exception as e:
+        reporter.print_error(str(e))
+        return 1
+
+
+def expand_configurations(config, configurations):
+    """
+    @brief
+        `return`s a manifest with one benchmark per program and configuration.
+
+    @param config : dict
+        manifest with one definition per benchmark program
+
+    @param configurations : [str]
+        configurations to use unless a program restricts them
+
+    @returns dict
+        manifest with one definition per benchmark
+
+    """
+    expanded = dict()
+    for (name, stanza) in config.items():
+        for cfg in configurations:
+            if cfg in stanza.get('configurations', configurations):
+                expanded[name + '.' + cfg] = dict(stanza, configuration=cfg)
+    return expanded
+
+
+def select_benchmarks(names, config):
+    selection = list()
+    for name in names:
+        matches = sorted(key for key in config.keys() if key.split('.')[0] == name)
+        selection.extend(matches if matches else [name])
+    return selection
+
+
+class ExecManifestLoader(ManifestLoader):
+
+    def _validate_stanza(self, name, definition):
+        if 'source' not in definition:
+            raise InvalidManifestError(name + ": The 'source' attribute is required")
+        for (key, value) in definition.items():
+            if key in {'description', 'source', 'stdin', 'output'}:
+                if type(value) is not str:
+                    raise InvalidManifestError(name + "." + key + ": Expected a string")
+            elif key == 'expect':
+                if type(value) is not int:
+                    raise InvalidManifestError(name + "." + key + ": Expected an integer")
+            elif key == 'configurations':
+                if type(value) is not list or not all(type(s) is str for s in value):
+                    raise InvalidManifestError(name + "." + key + ": Expected an array of strings")
+                for cfg in value:
+                    if cfg not in CONFIGURATIONS:
+                        raise InvalidManifestError(name + "." + key + ": Unknown configuration: " + cfg)
+            elif type(key) is str:
+                raise InvalidManifestError(name + "." + key + ": Unknown attribute")
+            else:
+                raise InvalidManifestError()
+
+
+class ExecCollectionRunner(CollectionRunner):
+
+    def __init__(self, directories, compiler=None, perf=None, constraints=None, logger=None):
+        super().__init__(directories, constraints=constraints, logger=logger)
+        assert compiler is not None
+        self.__compiler = compiler
+        self.__perf = perf
+
+    def _run_single(self, name, stanza):
+        with tempfile.TemporaryDirectory() as tempdir:
+            runner = ExecBenchmarkRunner(
+                stanza, compiler=self.__compiler, perf=self.__perf,
+                directories=self.directories, tempdir=tempdir,
+                constraints=self.constraints, logger=self.logger
+            )
+            return runner.run()
+
+
+class ExecBenchmarkRunner(BenchmarkRunner):
+
+    def __init__(self, stanza, compiler=None, perf=None, directories=None,
+                 tempdir=None, constraints=None, logger=None):
+        super().__init__(directories, constraints=constraints, logger=logger)
+        assert None not in [compiler, tempdir]
+        self.__executable = os.path.join(tempdir, 'a.out')
+        self.__compile_cmd = [compiler]
+        self.__compile_cmd.extend(CONFIGURATIONS[stanza['configuration']])
+        self.__compile_cmd.extend(['--output', self.__executable, self.find_file(stanza['source'])])
+        self.__stdin = self.find_file(stanza['stdin']) if 'stdin' in stanza else os.devnull
+        self.__stdout = os.path.join(tempdir, 'stdout')
+        self.__output = stanza.get('output')
+        self.__expect = stanza.get('expect', 0)
+        self.__perf = perf
+        self.__perf_output = os.path.join(tempdir, 'perf')
+        self.__t0 = None
+        self.__min_samples = 3.0 / constraints.quantile + constraints.warmup
+
+    def run(self):
+        self.__t0 = time.time()
+        self.__compile()
+        self.__check_output()
+        timings = list()
+        while True:
+            (expired, remaining) = self.__get_expired_and_remaining_timeout()
+            t = None if expired else self.__run_once(timeout=remaining)
+            if t is not None:
+                timings.append(t)
+            if len(timings) >= self.__min_samples:
+                thetimings = self.__get_data(timings)
+                n = len(thetimings)
+                (mean, stdev) = _mean_stdev(thetimings)
+                if stdev < self.constraints.significance * mean:
+                    return Result(mean, stdev, n, counters=self.__count())
+                elif t is None:
+                    why = "Timing results did not converge within {:.2f} seconds".format(self.constraints.timeout)
+                    return Result(mean, stdev, n, reason=why, counters=self.__count())
+                elif self.constraints.repetitions is not None and len(timings) >= self.constraints.repetitions:
+                    why = "Timing results did not converge within {:d} runs".format(self.constraints.repetitions)
+                    return Result(mean, stdev, n, reason=why, counters=self.__count())
+            elif t is None:
+                raise TimeoutFailure(self.constraints.timeout)
+
+    def __compile(self):
+        (expired, remaining) = self.__get_expired_and_remaining_timeout()
+        if expired:
+            raise TimeoutFailure(self.constraints.timeout)
+        self.logger("Running " + repr(self.__compile_cmd))
+        try:
+            proc = subprocess.Popen(
+                self.__compile_cmd,
+                stdin=subprocess.DEVNULL,
+                stdout=subprocess.DEVNULL,
+                stderr=subprocess.PIPE
+            )
+            try:
+                (stdout, stderr) = proc.communicate(timeout=remaining)
+            except subprocess.TimeoutExpired:
+                proc.kill()
+                proc.communicate()
+                raise TimeoutFailure(self.constraints.timeout)
+        except OSError as e:
+            raise Failure(e)
+        if proc.returncode != 0:
+            message = stderr.decode(errors='replace').strip().split('\n')[-1]
+            raise Failure("Compiler exited with error code {:d}: {:s}".format(proc.returncode, message))
+
+    def __check_output(self):
+        # The first run is not timed but its output is compared to the
+        # expected output (if any) so a miscompiled program cannot produce
+        # good-looking results.
+        (expired, remaining) = self.__get_expired_and_remaining_timeout()
+        if expired or self.__run_once(timeout=remaining, stdout=self.__stdout) is None:
+            raise TimeoutFailure(self.constraints.timeout)
+        if self.__output is not None:
+            with open(self.__stdout, 'r') as istr:
+                if istr.read() != self.__output:
+                    raise Failure("Program did not produce the expected output")
+
+    def __run_once(self, timeout=None, stdout=os.devnull, prefix=[]):
+        (status, t) = (None, None)
+        cmd = prefix + [self.__executable]
+        try:
+            with open(self.__stdin, 'rb') as istr, open(stdout, 'wb') as ostr:
+                self.logger("Running " + repr(cmd) + " with " + repr({'stdin' : self.__stdin, 'stdout' : stdout}))
+                t0 = time.perf_counter()
+                proc = subprocess.Popen(cmd, stdin=istr, stdout=ostr, stderr=subprocess.DEVNULL)
+                try:
+                    proc.communicate(timeout=timeout)
+                except subprocess.TimeoutExpired:
+                    proc.kill()
+                    proc.communicate()
+                    return None
+                t1 = time.perf_counter()
+                status = proc.returncode
+                t = t1 - t0
+                self.logger("Process exited with return code {:d} after {:.4f} seconds".format(status, t))
+        except OSError as e:
+            raise Failure(e)
+        if status != self.__expect:
+            raise Failure("Program exited with error code {:d} instead of {:d}".format(status, self.__expect))
+        return t
+
+    def __count(self):
+        # Counting is done in a separate run because 'perf' adds some
+        # overhead.  The counters for user-space are deterministic enough that
+        # a single run is sufficient.
+        if self.__perf is None:
+            return dict()
+        (expired, remaining) = self.__get_expired_and_remaining_timeout()
+        if expired:
+            return dict()
+        events = ','.join(c + ':u' for c in COUNTERS)
+        prefix = [self.__perf, 'stat', '-x', ',', '-e', events, '-o', self.__perf_output, '--']
+        if self.__run_once(timeout=remaining, prefix=prefix) is None:
+            return dict()
+        counters = dict()
+        try:
+            with open(self.__perf_output, 'r') as istr:
+                for line in istr:
+                    fields = line.strip().split(',')
+                    if len(fields) < 3:
+                        continue
+                    name = fields[2].split(':')[0]
+                    if name not in COUNTERS:
+                        continue
+                    try:
+                        counters[name] = float(fields[0])
+                    except ValueError:
+                        # 'perf' reports '<not supported>' or '<not counted>'
+                        # if the counter is not available.
+                        self.logger("Cannot read counter {}: {}".format(name, fields[0]))
+        except OSError as e:
+            self.logger("Cannot read output of 'perf': " + str(e))
+        return counters
+
+    def __get_data(self, values):
+        data = values[self.constraints.warmup : ]
+        data.sort()
+        n = round(self.constraints.quantile * len(data))
+        return data[ : n]
+
+    def __get_expired_and_remaining_timeout(self):
+        assert self.__t0 is not None
+        if self.constraints.timeout is None:
+            return (False, None)
+        remaining = self.constraints.timeout - (time.time() - self.__t0)
+        expired = (remaining <= 0.0)
+        return (expired, remaining)
+
+
+def _mean_stdev(values):
+    mean = statistics.mean(values)
+    stdev = statistics.stdev(values, xbar=mean)
+    return (mean, stdev)
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
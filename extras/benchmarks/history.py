@@ -45,7 +45,9 @@ def main(args):
         help=(
               "Export history data for a benchmark in a text format that can,"
             + " for example, be given to Gnuplot or some other data-processing"
-            + " software."
+            + " software.  Additional counters that were recorded along with"
+            + " the timings, such as instruction counts, are exported as"
+            + " additional columns."
         ),
     )
     sub_export.add_argument(
@@ -136,14 +138,16 @@ def _action_export(histo, name, tol=None):
         printhdr("Last Data Point", time.strftime(timefmt, last))
     else:
         raise RuntimeError("No data points")
+    counters = sorted(set(c for hr in bench.results for c in hr.counters.keys()))
     print()
-    print('#   {:>14s}{:>16s}{:>16s}{:>16s}'.format("timestamp", "mean / s", "stdev / s", "N"))
+    print('#   {:>14s}{:>16s}{:>16s}{:>16s}'.format("timestamp", "mean / s", "stdev / s", "N")
+          + ''.join('{:>16s}'.format(c) for c in counters))
     print()
     for hr in sorted(bench.results, key=lambda r : r.timestamp):
         print('{:<2s}{:16d}{:16.3e}{:16.3e}{:16d}'.format(
             '#' if notok(hr) else '',
             hr.timestamp, hr.mean, hr.stdev, hr.n
-        ))
+        ) + ''.join('{:16.6g}'.format(hr.counters.get(c, float('nan'))) for c in counters))
 
 
 def median_rel_stdev(results):
@@ -40,8 +40,10 @@ class NoAnsi(object):
 
 class Reporter(object):
 
-    def __init__(self, color, unit='s'):
+    def __init__(self, color, unit='s', counters=(), name_width=16):
         self.__ansi = Ansi if color else NoAnsi
+        self.__counters = tuple(counters)
+        self.__name_width = name_width
         self.__width = max(75, _shutil.get_terminal_size().columns)
         self.__separator = '-' * self.__width
         self.__unit = unit
@@ -54,11 +56,11 @@ class Reporter(object):
 
     def print_header(self):
         print(self.__separator)
-        print('{} {:<16s}{:>12s}{:>12s}{:>8s}{:>12s}   {:s}{}'.format(
+        print('{} {:<{w}s}{:>12s}{:>12s}{:>8s}{:>12s}{:s}   {:s}{}'.format(
             self.__ansi.BOLD,
             "id", "mean / " + self.__unit, "stdev / " + self.__unit, "N",
-            "trend", "description",
-            self.__ansi.NOBOLD
+            "trend", self.__format_counter_header(), "description",
+            self.__ansi.NOBOLD, w=self.__name_width
         ))
         print(self.__separator)
 
@@ -76,10 +78,11 @@ class Reporter(object):
         short_description = self.__shorten_description(description)
         umean = result.mean / self.__unit_factor
         ustdev = result.stdev / self.__unit_factor
+        counter = self.__format_counter(result)
         if trend is None:
-            print(' {:16s}{:>12s}{:>12s}{:8d}{:>12s}   {:s}'.format(
+            print(' {:{w}s}{:>12s}{:>12s}{:8d}{:>12s}{:s}   {:s}'.format(
                 short_name, _fmttime(umean), _fmttime(ustdev), result.n, 'n/a',
-                short_description
+                counter, short_description, w=self.__name_width
             ))
         else:
             if alerted:
@@ -89,9 +92,10 @@ class Reporter(object):
             else:
                 trendon = self.__ansi.NOCOLOR
             trendoff = self.__ansi.NOCOLOR
-            print(' {:16s}{:>12s}{:>12s}{:8d}{}{:+12.2f}{}   {:s}'.format(
+            print(' {:{w}s}{:>12s}{:>12s}{:8d}{}{:+12.2f}{}{:s}   {:s}'.format(
                 short_name, _fmttime(umean), _fmttime(ustdev), result.n,
-                trendon, trend, trendoff, short_description
+                trendon, trend, trendoff, counter, short_description,
+                w=self.__name_width
             ))
 
     def print_error(self, message, name=None):
@@ -161,6 +165,15 @@ class Reporter(object):
             + " will show the quantity (m - M) / sqrt(s^2 + S^2)."
         )
         print("")
+        for counter in self.__counters:
+            self.__print_column_info(
+                counter,
+                "Value of this performance counter for a single run of the"
+                + " benchmark (or unit of work for micro-benchmarks).  Large"
+                + " numbers are abbreviated with the usual SI prefixes.  If the"
+                + " counter could not be measured, 'n/a' is shown."
+            )
+            print("")
         self.__print_column_info(
             'description',
             "Description of the benchmark as provided in the manifest file. "
@@ -179,11 +192,19 @@ class Reporter(object):
         for line in tw.wrap(explanation):
             print(line)
 
+    def __format_counter_header(self):
+        return ''.join('{:>14s}'.format(c) for c in self.__counters)
+
+    def __format_counter(self, result):
+        values = (result.counters.get(c) for c in self.__counters)
+        return ''.join('{:>14s}'.format('n/a' if v is None else _fmtcount(v)) for v in values)
+
     def __shorten_name(self, text=None):
-        return _shorten(text, 16)
+        return _shorten(text, self.__name_width)
 
     def __shorten_description(self, text=None):
-        return _shorten(text, self.__width - 64)
+        extra = self.__name_width - 16 + 14 * len(self.__counters)
+        return _shorten(text, max(self.__width - 64 - extra, 6))
 
 
 def _shorten(text, limit):
@@ -201,3 +222,10 @@ def _fmttime(secs, limit=0.001, fmt='.3f'):
     if secs < limit:
         return '< ' + fmt.format(limit)
     return fmt.format(secs)
+
+
+def _fmtcount(value):
+    for (factor, prefix) in [(1.0e12, 'T'), (1.0e9, 'G'), (1.0e6, 'M'), (1.0e3, 'k')]:
+        if value >= factor:
+            return '{:.3f} {:s}'.format(value / factor, prefix)
+    return '{:.4g}'.format(value)
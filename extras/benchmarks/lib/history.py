@@ -19,6 +19,12 @@ CREATE TABLE IF NOT EXISTS `Results` (
     `n`            INTEGER  NOT NULL CHECK (`n` > 0),
     `timestamp`    INTEGER  NOT NULL
 );
+
+CREATE TABLE IF NOT EXISTS `Counters` (
+    `result`       INTEGER  REFERENCES `Results.rowid` ON DELETE CASCADE,
+    `counter`      TEXT     NOT NULL,
+    `value`        REAL     NOT NULL
+);
 """
 
 
@@ -63,13 +69,18 @@ class HistoricResult(object):
     @member timestamp : int
         POSIX time-stamp when the benchmark was executed
 
+    @member counters : {str : float}
+        additional measurements (such as the number of executed instructions)
+        by name
+
     """
 
-    def __init__(self, mean, stdev, n, timestamp):
+    def __init__(self, mean, stdev, n, timestamp, counters=None):
         self.mean = mean
         self.stdev = stdev
         self.n = n
         self.timestamp = timestamp
+        self.counters = counters if counters is not None else dict()
 
     @property
     def relative_stdev(self):
@@ -185,7 +196,7 @@ class History(object):
             )
         return True
 
-    def append(self, name, mean, stdev, n, timestamp=None):
+    def append(self, name, mean, stdev, n, timestamp=None, counters=None):
         """
         @brief
             Adds a benchmark result to the database.
@@ -210,6 +221,9 @@ class History(object):
         @param timestamp : int | NoneType
             POSIX time-stamp
 
+        @param counters : {str : float} | NoneType
+            additional measurements by name
+
         @returns bool
             `True` in connected and `False` in detached state
 
@@ -220,8 +234,12 @@ class History(object):
         if timestamp is None:
             timestamp = int(_time.time())
         with self.__conn as conn:
-            conn.execute("INSERT INTO `Results` VALUES(?, ?, ?, ?, ?)",
-                         (name, mean, stdev, n, timestamp))
+            curs = conn.execute("INSERT INTO `Results` VALUES(?, ?, ?, ?, ?)",
+                                (name, mean, stdev, n, timestamp))
+            rowid = curs.lastrowid
+            for (counter, value) in (counters or dict()).items():
+                conn.execute("INSERT INTO `Counters` VALUES(?, ?, ?)",
+                             (rowid, counter, value))
         return True
 
     def get_descriptions(self):
@@ -272,11 +290,19 @@ class History(object):
             except StopIteration:
                 raise RuntimeError("No such benchmark")
             curs = conn.execute(
-                "SELECT `mean`, `stdev`, `n`, `timestamp` FROM `Results` WHERE `name` = ?",
+                "SELECT `rowid`, `mean`, `stdev`, `n`, `timestamp` FROM `Results` WHERE `name` = ?",
+                _as_singleton(name)
+            )
+            results = {r[0] : HistoricResult(r[1], r[2], r[3], r[4]) for r in curs}
+            curs = conn.execute(
+                "SELECT `Counters`.`result`, `Counters`.`counter`, `Counters`.`value`"
+                + " FROM `Counters` INNER JOIN `Results` ON `Counters`.`result` = `Results`.`rowid`"
+                + " WHERE `Results`.`name` = ?",
                 _as_singleton(name)
             )
-            results = [HistoricResult(r[0], r[1], r[2], r[3]) for r in curs]
-            return ResultAggregation(description=description, results=results)
+            for (rowid, counter, value) in curs:
+                results[rowid].counters[counter] = value
+            return ResultAggregation(description=description, results=list(results.values()))
 
     def drop_benchmark(self, name):
         """
@@ -295,6 +321,11 @@ class History(object):
         if self.__conn is None:
             return False
         with self.__conn as conn:
+            conn.execute(
+                "DELETE FROM `Counters` WHERE `result` IN"
+                + " (SELECT `rowid` FROM `Results` WHERE `name` = ?)",
+                _as_singleton(name)
+            )
             conn.execute(
                 "DELETE FROM `Results` WHERE `name` = ?",
                 _as_singleton(name)
@@ -323,6 +354,11 @@ class History(object):
         if self.__conn is None:
             return False
         with self.__conn as conn:
+            conn.execute(
+                "DELETE FROM `Counters` WHERE `result` IN"
+                + " (SELECT `rowid` FROM `Results` WHERE `timestamp` >= ?)",
+                _as_singleton(ts)
+            )
             conn.execute(
                 "DELETE FROM `Results` WHERE `timestamp` >= ?",
                 _as_singleton(ts)
@@ -7,6 +7,11 @@ import os.path as _ospath
 import time as _time
 
 
+# Names of the performance counters the drivers know about.  They are the same
+# as used by the 'perf' tool and the 'testaux' benchmark harness.
+COUNTERS = ('cycles', 'instructions', 'branch-misses', 'cache-misses', 'page-faults')
+
+
 class CollectionRunner(object):
 
     def __init__(self, directories, constraints=None, logger=None):
@@ -47,7 +52,7 @@ class CollectionRunner(object):
             baseline = histo.get_best(key)
             if update:
                 histo.register(key, description)
-                histo.append(key, res.mean, res.stdev, res.n)
+                histo.append(key, res.mean, res.stdev, res.n, counters=res.counters)
             trend = _get_trend((res.mean, res.stdev), baseline)
             alerted = False if None in [alert, trend] else (trend >= alert)
             if alerted:
@@ -171,7 +176,8 @@ class TimeoutFailure(Failure):
 
 class Constraints(object):
 
-    def __init__(self, timeout=None, repetitions=None, quantile=None, significance=None, warmup=None):
+    def __init__(self, timeout=None, repetitions=None, quantile=None, significance=None, warmup=None,
+                 counters=False):
         assert timeout is None or type(timeout) is float and timeout > 0.0
         self.__timeout = timeout
         assert repetitions is None or type(repetitions) is int and repetitions > 3
@@ -182,6 +188,8 @@ class Constraints(object):
         self.__significance = significance
         assert type(warmup) is int and warmup >= 0
         self.__warmup = warmup
+        assert type(counters) is bool
+        self.__counters = counters
 
     @property
     def timeout(self):
@@ -203,6 +211,10 @@ class Constraints(object):
     def warmup(self):
         return self.__warmup
 
+    @property
+    def counters(self):
+        return self.__counters
+
     def as_environment(self, env=None):
         if env is None:
             env = dict()
@@ -213,27 +225,37 @@ class Constraints(object):
         env['BENCHMARK_QUANTILE'] = '{:.6g}'.format(self.__quantile)
         env['BENCHMARK_SIGNIFICANCE'] = '{:.6g}'.format(self.__significance)
         env['BENCHMARK_WARMUP'] = '{:d}'.format(self.__warmup)
+        env['BENCHMARK_COUNTERS'] = '1' if self.__counters else '0'
         return env
 
 
 class Result(object):
 
-    def __init__(self, mean, stdev, n, reason=None):
+    def __init__(self, mean, stdev, n, reason=None, counters=None):
         self.mean = mean
         self.stdev = stdev
         self.n = n
         self.reason = reason
+        self.counters = counters if counters is not None else dict()
 
     @classmethod
     def from_string(cls, text):
+        lines = text.splitlines()
         try:
-            (w0, w1, w2) = text.split()
+            (w0, w1, w2) = lines[0].split()
             mean = float(w0)
             stdev = float(w1)
             n = int(w2)
-        except ValueError:
+        except (IndexError, ValueError):
             raise ValueError("Benchmark result string not in format '%g %g %d'")
-        return Result(mean, stdev, n)
+        counters = dict()
+        for line in lines[1 : ]:
+            try:
+                (name, value) = line.split()
+                counters[name] = float(value)
+            except ValueError:
+                raise ValueError("Benchmark counter string not in format '%s %g'")
+        return Result(mean, stdev, n, counters=counters)
 
 
 def _do_find_file(filename, directories, logger):
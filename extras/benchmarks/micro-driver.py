@@ -29,6 +29,7 @@ from lib.manifest import (
 )
 
 from lib.runner import (
+    COUNTERS,
     BenchmarkRunner,
     CollectionRunner,
     Constraints,
@@ -52,10 +53,19 @@ def main(args):
         epilog=regretful_epilog,
         add_help=False,
     )
-    add_argument_groups(ap)
+    (pos, ess, sta, sup) = add_argument_groups(ap)
+    sup.add_argument(
+        '-P', '--counters', action='store_true',
+        help=(
+              "Also read the performance counters " + ", ".join(COUNTERS)
+            + " while running the benchmarks and report the median value per"
+            + " unit of work.  Counters that are not available on this system"
+            + " are left out."
+        )
+    )
     with TerminalSizeHack():
         ns = ap.parse_args(args)
-    reporter = Reporter(use_color(ns.color), unit='ns')
+    reporter = Reporter(use_color(ns.color), unit='ns', counters=(COUNTERS if ns.counters else ()))
     if ns.alert is not None and ns.history is None:
         print("micro-driver: warning: --alert has no effect without --history", file=sys.stderr)
     constraints = Constraints(
@@ -63,7 +73,8 @@ def main(args):
         repetitions=ns.repetitions,
         quantile=ns.quantile,
         significance=ns.significance,
-        warmup=ns.warmup
+        warmup=ns.warmup,
+        counters=ns.counters
     )
     if ns.info:
         reporter.print_info()
@@ -0,0 +1,436 @@
+#! /usr/bin/python3
+#! -*- coding:utf-8; mode:python; -*-
+
+import argparse
+import math
+import os.path
+import subprocess
+import sys
+import tempfile
+import time
+
+from lib.cli import (
+    TerminalSizeHack,
+    add_benchmarks,
+    add_color,
+    add_directories,
+    add_help,
+    add_manifest,
+    add_verbose,
+    regretful_epilog,
+    use_color,
+)
+
+from lib.fancy import (
+    Ansi,
+    NoAnsi,
+    Reporter,
+)
+
+from lib.manifest import (
+    InvalidManifestError,
+    ManifestLoader,
+)
+
+from lib.runner import (
+    Failure,
+)
+
+
+STAGES = ('lex', 'parse', 'check', 'irg', 'opt', 'asm')
+
+
+def main(args):
+    ap = argparse.ArgumentParser(
+        prog='scaling-driver',
+        usage="%(prog)s -M MANIFEST -D DIR ... [OPTION ...] [--] [NAME ...]",
+        description=(
+              "Run the compiler stages on generated inputs of geometrically"
+            + " growing size and fit a power law to the time and peak memory"
+            + " each stage takes.  A series whose fitted exponent exceeds the"
+            + " limit is reported as an alert.  A series where the compiler"
+            + " crashes or exceeds the timeout is reported as a failure."
+        ),
+        epilog=regretful_epilog,
+        add_help=False,
+    )
+    pos = ap.add_argument_group(title="Positional Aruments", description="")
+    ess = ap.add_argument_group(title="Essential Options", description="")
+    sta = ap.add_argument_group(title="Statistical Options", description="")
+    sup = ap.add_argument_group(title="Supplementary Options", description="")
+    add_benchmarks(pos)
+    add_manifest(ess)
+    add_directories(ess)
+    sta.add_argument(
+        '-T', '--timeout', metavar='SECS', type=float, default=60.0,
+        help=(
+              "Timeout for a single run of the stages in seconds.  A size that"
+            + " doesn't complete within SECS seconds is reported as a failure"
+            + " and no larger sizes are tried.  The default is %(default).0f"
+            + " seconds."
+        )
+    )
+    sta.add_argument(
+        '-R', '--repetitions', metavar='TIMES', type=int, default=3,
+        help=(
+              "Run the stages TIMES times on each input and use the fastest"
+            + " time.  The default is %(default)d."
+        )
+    )
+    sta.add_argument(
+        '-L', '--limit', metavar='EXPONENT', type=float, default=1.5,
+        help=(
+              "Alert if the fitted exponent for time or memory of any stage"
+            + " exceeds EXPONENT.  An exponent of 1 means linear scaling."
+            + "  The default is %(default).2f."
+        )
+    )
+    sta.add_argument(
+        '--min-time', metavar='SECS', type=float, default=0.01,
+        help=(
+              "Ignore measurements shorter than SECS seconds when fitting"
+            + " because they are dominated by noise.  The default is"
+            + " %(default).3f seconds."
+        )
+    )
+    sta.add_argument(
+        '-m', '--max-size', metavar='N', type=int, default=None,
+        help="Skip all sizes in the manifest that are greater than N for a quick run."
+    )
+    sup.add_argument(
+        '-o', '--output', metavar='DIR', default=None,
+        help=(
+              "Write the measured data for each series to the file"
+            + " DIR/NAME.dat in a format that can be fed to Gnuplot.  The"
+            + " columns are the number of tokens followed by the time and"
+            + " peak memory after each stage."
+        )
+    )
+    add_verbose(sup)
+    add_color(sup)
+    add_help(sup)
+    with TerminalSizeHack():
+        ns = ap.parse_args(args)
+    if ns.timeout <= 0.0 or ns.repetitions < 1 or ns.limit <= 0.0 or ns.min_time < 0.0:
+        ap.error("Invalid statistical options")
+    reporter = Reporter(use_color(ns.color))
+    logger = lambda m : reporter.print_notice(m) if ns.verbose else None
+    try:
+        loader = ScalingManifestLoader()
+        config = loader.load(ns.manifest)
+        selection = ns.benchmarks if ns.benchmarks else sorted(config.keys())
+        table = ScalingTable(use_color(ns.color), ns.limit)
+        reporter.print_prolog("Running {:d} scaling series ...".format(len(selection)))
+        t0 = time.time()
+        (alerts, failures) = (0, 0)
+        table.print_header()
+        for name in selection:
+            stanza = config.get(name)
+            if stanza is None:
+                reporter.print_error("No definition for this series in the manifest file", name=name)
+                failures += 1
+                continue
+            runner = SeriesRunner(
+                stanza, directories=ns.directories, timeout=ns.timeout,
+                repetitions=ns.repetitions, max_size=ns.max_size, logger=logger
+            )
+            series = runner.run()
+            fits = series.fit(ns.min_time)
+            alerts += table.print_series(name, series, fits)
+            if series.failure is not None:
+                failures += 1
+                reporter.print_error(series.failure, name=name)
+            if ns.output is not None:
+                series.write_data(os.path.join(ns.output, name + '.dat'))
+        table.print_footer()
+        elapsed = math.ceil(time.time() - t0)
+        reporter.print_epilog("Completed scaling series in {:d} seconds".format(elapsed))
+        reporter.print_epilog("")
+        reporter.print_epilog("{:6d} superlinear alerts (limit was {:.2f})".format(alerts, ns.limit))
+        reporter.print_epilog("{:6d} hard failures".format(failures))
+        reporter.print_epilog("")
+        return alerts + failures
+    except (AssertionError, TypeError):
+        raise
+    except KeyboardInterrupt:
+        reporter.print_error("Canceled by keyboard interrupt")
+        return 128 + 2
+    except Exception as e:
+        reporter.print_error(str(e))
+        return 1
+
+
+class ScalingManifestLoader(ManifestLoader):
+
+    def _validate_stanza(self, name, definition):
+        for key in ['generator', 'sizes']:
+            if key not in definition:
+                raise InvalidManifestError(name + ": The '" + key + "' attribute is required")
+        for (key, value) in definition.items():
+            if key == 'description':
+                if type(value) is not str:
+                    raise InvalidManifestError(name + "." + key + ": Expected a string")
+            elif key == 'generator':
+                if type(value) is not list or not value or not all(type(s) is str for s in value):
+                    raise InvalidManifestError(name + "." + key + ": Expected a non-empty array of strings")
+                if not any('{SIZE}' in s for s in value):
+                    raise InvalidManifestError(name + "." + key + ": The command must use '{SIZE}'")
+            elif key == 'sizes':
+                if type(value) is not list or not value or not all(type(n) is int and n > 0 for n in value):
+                    raise InvalidManifestError(name + "." + key + ": Expected a non-empty array of positive integers")
+            elif key == 'stop-after':
+                if value not in STAGES:
+                    raise InvalidManifestError(name + "." + key + ": Expected one of " + ", ".join(STAGES))
+            elif key == 'optimize':
+                if type(value) is not bool:
+                    raise InvalidManifestError(name + "." + key + ": Expected a boolean")
+            elif type(key) is str:
+                raise InvalidManifestError(name + "." + key + ": Unknown attribute")
+            else:
+                raise InvalidManifestError()
+
+
+class Series(object):
+
+    """
+    @brief
+        Measurements for a single scaling series.
+
+    @member points : [(int, {str : (float, int)})]
+        number of tokens and for each stage the time in seconds and the peak
+        memory usage in bytes, sorted by the number of tokens
+
+    @member stages : [str]
+        names of the stages that were run
+
+    @member failure : str | NoneType
+        reason why the series could not be completed or `None`
+
+    """
+
+    def __init__(self, stages):
+        self.points = list()
+        self.stages = stages
+        self.failure = None
+
+    def fit(self, min_time):
+        """
+        @brief
+            Fits a power law to the time and memory of each stage.
+
+        For the time, only measurements that took at least `min_time` are
+        used.  For the memory, the peak memory of the smallest input is
+        subtracted as a baseline and only measurements that are at least
+        twice the baseline are used.  Smaller values are dominated by the
+        memory the process needs anyway.
+
+        @param min_time : float
+            minimum time for a measurement to be used
+
+        @returns {str : (float | NoneType, float | NoneType)}
+            exponents for time and memory of each stage or `None` if there
+            were not enough data points
+
+        """
+        fits = dict()
+        for stage in self.stages:
+            data = [(n, m[stage]) for (n, m) in self.points if stage in m]
+            if not data:
+                fits[stage] = (None, None)
+                continue
+            baseline = data[0][1][1]
+            times = [(n, t) for (n, (t, mem)) in data if t >= min_time]
+            memory = [(n, mem - baseline) for (n, (t, mem)) in data if mem >= 2 * baseline]
+            fits[stage] = (_fit_exponent(times), _fit_exponent(memory))
+        return fits
+
+    def write_data(self, filename):
+        with open(filename, 'w') as ostr:
+            print('#{:>15s}'.format('tokens') + ''.join(
+                '{:>16s}{:>16s}'.format(s + ' / s', s + ' / B') for s in self.stages
+            ), file=ostr)
+            print("", file=ostr)
+            for (n, m) in self.points:
+                print('{:16d}'.format(n) + ''.join(
+                    '{:16.6g}{:16d}'.format(*m[s]) if s in m else '{:>16s}{:>16s}'.format('nan', 'nan')
+                    for s in self.stages
+                ), file=ostr)
+
+
+class SeriesRunner(object):
+
+    def __init__(self, stanza, directories=None, timeout=None, repetitions=None,
+                 max_size=None, logger=None):
+        self.__directories = directories
+        self.__timeout = timeout
+        self.__repetitions = repetitions
+        self.__logger = logger if logger is not None else lambda x : None
+        self.__generator = stanza['generator']
+        self.__sizes = sorted(n for n in stanza['sizes'] if max_size is None or n <= max_size)
+        last = stanza.get('stop-after', STAGES[-1])
+        self.__stages = list(STAGES[ : STAGES.index(last) + 1])
+        self.__stages_args = ['--stop-after=' + last]
+        if stanza.get('optimize', False):
+            self.__stages_args.append('--optimize')
+
+    def run(self):
+        series = Series(self.__stages)
+        try:
+            stages_cmd = [self.__find_file('stages')] + self.__stages_args
+            generator = [self.__find_file(self.__generator[0])]
+        except Failure as e:
+            series.failure = str(e)
+            return series
+        with tempfile.TemporaryDirectory() as tempdir:
+            infile = os.path.join(tempdir, 'input.mj')
+            for size in self.__sizes:
+                try:
+                    cmd = generator + [s.format(SIZE=size) for s in self.__generator[1 : ]]
+                    self.__generate(cmd, infile)
+                    point = None
+                    for i in range(self.__repetitions):
+                        point = _merge_points(point, self.__run_stages(stages_cmd + [infile]))
+                    series.points.append(point)
+                except Failure as e:
+                    series.failure = "Size {:d}: {:s}".format(size, str(e))
+                    break
+        series.points.sort(key=lambda p : p[0])
+        return series
+
+    def __generate(self, cmd, outfile):
+        self.__logger("Running " + repr(cmd) + " with " + repr({'stdout' : outfile}))
+        try:
+            with open(outfile, 'wb') as ostr:
+                proc = subprocess.run(
+                    cmd, stdin=subprocess.DEVNULL, stdout=ostr, stderr=subprocess.DEVNULL,
+                    timeout=self.__timeout
+                )
+        except subprocess.TimeoutExpired:
+            raise Failure("Generator did not finish within {:.0f} seconds".format(self.__timeout))
+        except OSError as e:
+            raise Failure(e)
+        if proc.returncode != 0:
+            raise Failure("Generator failed with error code {:d}: ".format(proc.returncode) + ' '.join(cmd))
+
+    def __run_stages(self, cmd):
+        self.__logger("Running " + repr(cmd))
+        try:
+            proc = subprocess.run(
+                cmd, stdin=subprocess.DEVNULL, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                timeout=self.__timeout
+            )
+        except subprocess.TimeoutExpired:
+            raise Failure("Stages did not finish within {:.0f} seconds".format(self.__timeout))
+        except OSError as e:
+            raise Failure(e)
+        if proc.returncode < 0:
+            raise Failure("Stages were killed by signal {:d}".format(-proc.returncode))
+        if proc.returncode != 0:
+            message = proc.stderr.decode(errors='replace').strip()
+            raise Failure("Stages exited with error code {:d}: {:s}".format(proc.returncode, message))
+        tokens = None
+        stages = dict()
+        try:
+            for line in proc.stdout.decode().splitlines():
+                words = line.split()
+                if words[0] == 'tokens':
+                    tokens = int(words[1])
+                else:
+                    stages[words[0]] = (float(words[1]), int(words[2]))
+        except (IndexError, ValueError):
+            raise Failure("Cannot parse output of the stages")
+        if tokens is None or not all(s in stages for s in self.__stages):
+            raise Failure("Incomplete output of the stages")
+        self.__logger("{:d} tokens: ".format(tokens) + repr(stages))
+        return (tokens, stages)
+
+    def __find_file(self, filename):
+        for directory in self.__directories:
+            path = os.path.join(directory, filename)
+            if os.path.exists(path):
+                return path
+        raise Failure("Cannot find file: " + filename)
+
+
+class ScalingTable(object):
+
+    def __init__(self, color, limit):
+        self.__ansi = Ansi if color else NoAnsi
+        self.__limit = limit
+        self.__separator = '-' * 80
+
+    def print_header(self):
+        print(self.__separator)
+        print('{} {:<24s}{:<8s}{:>12s}{:>12s}{:>12s}{:>10s}{}'.format(
+            self.__ansi.BOLD, "series", "stage", "tokens", "time / s", "exp(time)",
+            "exp(mem)", self.__ansi.NOBOLD
+        ))
+        print(self.__separator)
+
+    def print_footer(self):
+        print(self.__separator)
+
+    def print_series(self, name, series, fits):
+        """
+        @brief
+            Prints one row per stage and `return`s the number of alerts.
+
+        """
+        alerts = 0
+        if not series.points:
+            print(' {:<24s}{:<8s}{:>12s}'.format(name[ : 23], '', 'n/a'))
+            return alerts
+        (tokens, largest) = series.points[-1]
+        for stage in series.stages:
+            (texp, mexp) = fits[stage]
+            alerted = any(e is not None and e > self.__limit for e in (texp, mexp))
+            alerts += 1 if alerted else 0
+            print(' {:<24s}{:<8s}{:>12d}{:>12.3f}{}{:>12s}{:>10s}{}'.format(
+                name[ : 23], stage, tokens, largest[stage][0],
+                self.__ansi.RED if alerted else '',
+                _fmtexp(texp), _fmtexp(mexp),
+                self.__ansi.NOCOLOR if alerted else ''
+            ))
+            name = ''
+        return alerts
+
+
+def _merge_points(old, new):
+    if old is None:
+        return new
+    (n, stages) = new
+    if n != old[0]:
+        raise Failure("Number of tokens changed between runs")
+    merged = {s : (min(old[1][s][0], t), max(old[1][s][1], m)) for (s, (t, m)) in stages.items()}
+    return (n, merged)
+
+
+def _fit_exponent(data):
+    """
+    @brief
+        Fits `y = c * x^k` to the data by linear least squares in log-log
+        space and `return`s `k`.
+
+    @param data : [(float, float)]
+        data points with positive coordinates
+
+    @returns float | NoneType
+        exponent `k` or `None` if fewer than three distinct points are given
+
+    """
+    points = [(math.log(x), math.log(y)) for (x, y) in data if x > 0 and y > 0]
+    if len(set(x for (x, y) in points)) < 3:
+        return None
+    xmean = sum(x for (x, y) in points) / len(points)
+    ymean = sum(y for (x, y) in points) / len(points)
+    sxy = sum((x - xmean) * (y - ymean) for (x, y) in points)
+    sxx = sum((x - xmean)**2 for (x, y) in points)
+    return sxy / sxx
+
+
+def _fmtexp(value):
+    return 'n/a' if value is None else '{:.2f}'.format(value)
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
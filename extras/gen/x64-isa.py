@@ -18,6 +18,9 @@ MACROS = [
     ("CALL_ALIGNED", "Call a function with correct stack pointer alignment (macro)"),
     ("DIV", "Compute quotient of two registers (macro)"),
     ("MOD", "Compute remainder of division of two registers (macro)"),
+    ("NEW", "Allocate zero-initialized memory of constant size from the runtime heap (macro)"),
+    ("WRITE", "Write a byte to the output buffer of the runtime (macro)"),
+    ("READ", "Read a byte from the input buffer of the runtime (macro)"),
 ]
 
 INSTRUCTIONS = [
@@ -2,9 +2,11 @@
 
 #include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <map>
-#include <numeric>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "asm/instruction.hpp"
 #include "exceptions.hpp"
@@ -42,6 +44,11 @@ namespace /* anonymous*/
 	 */
 	static const auto tmp_address_register = be::real_register::r11;
 
+	/**
+	 * @brief size of the header word in front of every block on the heap of the runtime (see `mj_runtime.c`)
+	 */
+	constexpr std::int64_t heap_header_size = 8;
+
 	/**
 	 * @brief
 	 *     Returns the argument register for the argument at the given position.
@@ -71,6 +78,171 @@ namespace /* anonymous*/
 	}
 
 
+	/**
+	 * @brief
+	 *     Callee-saved registers (according to the ABI) that may hold virtual
+	 *     registers, in the order in which they are handed out.
+	 */
+	static const be::real_register callee_saved_registers[] = {
+		be::real_register::b,
+		be::real_register::r12,
+		be::real_register::r13,
+		be::real_register::r14,
+		be::real_register::r15,
+	};
+
+
+	/**
+	 * @brief
+	 *     Describes where the virtual registers of a function live and how its
+	 *     stack frame looks like.
+	 */
+	struct frame_layout
+	{
+		/** @brief General-purpose registers that live in a real register. */
+		std::map<be::virtual_register, be::real_register> registers{};
+
+		/** @brief General-purpose registers that live in a stack slot (1-based). */
+		std::map<be::virtual_register, int> slots{};
+
+		/** @brief Callee-saved registers that are used and must be preserved. */
+		std::vector<be::real_register> saved{};
+
+		/** @brief Highest number of an argument register that is read. */
+		int argument_count{};
+
+		/** @brief Whether the function needs a frame pointer. */
+		bool has_frame{};
+
+		/**
+		 * @brief
+		 *     `return`s the address of the given (1-based) stack slot.
+		 *
+		 * @param slot
+		 *     number of the slot
+		 *
+		 * @returns
+		 *     address relative to the frame pointer
+		 */
+		be::real_address slot_address(const int slot) const
+		{
+			assert(has_frame && (slot > 0));
+			auto addr = be::real_address{};
+			addr.base = be::real_register::bp;
+			addr.constant = static_cast<std::int32_t>(-8 * slot);
+			return addr;
+		}
+	};
+
+
+	/**
+	 * @brief
+	 *     Calls `func` with every register that is read or written via the
+	 *     given operand, including the registers used in an address.
+	 *
+	 * @param op    virtual operand
+	 * @param func  callback taking a `be::virtual_register`
+	 */
+	template <typename FuncT>
+	void for_each_register(const be::virtual_operand& op, FuncT&& func)
+	{
+		if (const auto reg = be::get_register(op)) {
+			func(*reg);
+		} else if (const auto addr = be::get_address(op)) {
+			if (addr->base) {
+				func(*addr->base);
+			}
+			if (addr->index) {
+				func(*addr->index);
+			}
+		}
+	}
+
+
+	/**
+	 * @brief
+	 *     Decides where each virtual register of the given function lives.
+	 *
+	 * Registers are counted by their number of occurrences and the most
+	 * frequently used general-purpose registers are put into real registers
+	 * for the whole function.  Since they are never shared, no liveness
+	 * information is needed.  Leaf functions first use the argument registers
+	 * that are not occupied by their own arguments (they are caller-saved and
+	 * hence free), then callee-saved registers.  All other functions only use
+	 * callee-saved registers so their values survive calls.  Only the
+	 * callee-saved registers that are actually used are preserved.  A frame
+	 * pointer is only set up if there are stack slots or stack arguments.
+	 *
+	 * @param virtasm  virtual assembly of the function
+	 * @return         frame layout
+	 */
+	frame_layout make_frame_layout(const be::virtual_assembly& virtasm)
+	{
+		auto layout = frame_layout{};
+		auto uses = std::map<be::virtual_register, int>{};
+		auto is_leaf = true;
+		for (const auto& block : virtasm.blocks) {
+			for (const auto& instr : block.code) {
+				if ((instr.code == be::opcode::mac_call_aligned) || (instr.code == be::opcode::op_call)
+						|| (instr.code == be::opcode::mac_new) || (instr.code == be::opcode::mac_write)
+						|| (instr.code == be::opcode::mac_read)) {
+					is_leaf = false;
+				}
+				const auto count = [&layout, &uses](const be::virtual_register reg){
+					if (be::is_argument_register(reg)) {
+						layout.argument_count = std::max(layout.argument_count, number(reg));
+					} else if (be::is_general_register(reg)) {
+						uses[reg] += 1;
+					}
+				};
+				for_each_register(instr.op1, count);
+				if (is_argument(instr.op2)) {
+					// destination argument registers are arguments of a call
+					continue;
+				}
+				for_each_register(instr.op2, count);
+			}
+		}
+		auto available = std::vector<be::real_register>{};
+		if (is_leaf) {
+			for (auto i = layout.argument_count + 1; i <= 6; ++i) {
+				const auto reg = get_argument_register(i);
+				// D is clobbered by the DIV and MOD macros.
+				if (reg != be::real_register::d) {
+					available.push_back(reg);
+				}
+			}
+		}
+		for (const auto reg : callee_saved_registers) {
+			available.push_back(reg);
+		}
+		auto candidates = std::vector<std::pair<be::virtual_register, int>>(uses.begin(), uses.end());
+		std::stable_sort(
+			candidates.begin(), candidates.end(),
+			[](const auto& lhs, const auto& rhs){ return lhs.second > rhs.second; }
+		);
+		auto next = available.begin();
+		for (const auto& candidate : candidates) {
+			if (next != available.end()) {
+				layout.registers.emplace(candidate.first, *next);
+				if (std::find(std::begin(callee_saved_registers), std::end(callee_saved_registers), *next)
+						!= std::end(callee_saved_registers)) {
+					layout.saved.push_back(*next);
+				}
+				++next;
+			}
+		}
+		for (const auto& use : uses) {
+			if (layout.registers.find(use.first) == layout.registers.end()) {
+				const auto slot = static_cast<int>(layout.slots.size()) + 1;
+				layout.slots.emplace(use.first, slot);
+			}
+		}
+		layout.has_frame = !layout.slots.empty() || (layout.argument_count > 6);
+		return layout;
+	}
+
+
 	/**
 	 * @brief
 	 *     Converts virtual operands to real operands.
@@ -78,22 +250,25 @@ namespace /* anonymous*/
 	 * Uses the temporary address register for address calculations, if
 	 * necessary.
 	 */
-	struct op_visitor : public boost::static_visitor<operand>
+	struct op_visitor
 	{
 
-		op_visitor(std::vector<be::real_instruction>& code) : _code{code} {}
+		op_visitor(std::vector<be::real_instruction>& code, const frame_layout& layout)
+			: _code{code}, _layout{layout}
+		{
+		}
 
 		operand operator()(std::int64_t imm)
 		{
 			return imm;
 		}
 
-		operand operator()(const std::string& name)
+		operand operator()(const be::label_id label)
 		{
-			return name;
+			return label;
 		}
 
-		operand operator()(be::virtual_address vaddr)
+		operand operator()(const be::virtual_address& vaddr)
 		{
 			assert(!vaddr.index);
 			if (auto base = vaddr.base) {
@@ -133,14 +308,15 @@ namespace /* anonymous*/
 				} else {
 					auto addr = be::real_address{};
 					addr.base = be::real_register::bp;
-					addr.constant = (num - 5) * std::int64_t{8};
+					addr.constant = static_cast<std::int32_t>(8 * (num - 5));
 					return std::move(addr);
 				}
 			} else if (be::is_general_register(reg)) {
-				auto addr = be::real_address{};
-				addr.base = be::real_register::bp;
-				addr.constant = -(number(reg) * std::int64_t{8});
-				return std::move(addr);
+				const auto pos = _layout.registers.find(reg);
+				if (pos != _layout.registers.end()) {
+					return pos->second;
+				}
+				return _layout.slot_address(_layout.slots.at(reg));
 			} else if (reg == be::virtual_register::result) {
 				return be::real_register::a;
 			} else {
@@ -160,6 +336,8 @@ namespace /* anonymous*/
 
 		std::vector<be::real_instruction>& _code;
 
+		const frame_layout& _layout;
+
 	};
 
 
@@ -193,6 +371,67 @@ namespace /* anonymous*/
 		}
 	}
 
+
+	/**
+	 * @brief
+	 *     Arguments of a function call, indexed by their (1-based) position.
+	 */
+	using call_arguments = std::map<int, std::pair<operand, be::bit_width>>;
+
+
+	/**
+	 * @brief
+	 *     Emits a call with correct stack pointer alignment that preserves
+	 *     the own argument registers of the calling function.
+	 *
+	 * @param code           instruction vector
+	 * @param target         function to call
+	 * @param args           arguments of the call
+	 * @param own_arguments  number of arguments of the calling function
+	 */
+	void add_call(std::vector<be::real_instruction>& code, const be::label_id target,
+	              const call_arguments& args, const int own_arguments)
+	{
+		using be::opcode;
+		using be::bit_width;
+		using be::real_register;
+		const auto call_argc = static_cast<int>(args.size());
+		const auto saved_registers = std::min(6, own_arguments);
+		// save own argument registers (RTL)
+		for (int i = saved_registers; i > 0; --i) {
+			code.emplace_back(opcode::op_push, bit_width::lxiv, get_argument_register(i));
+		}
+		// ensure alignment
+		auto atsp = be::real_address{};
+		atsp.base = real_register::sp;
+		code.emplace_back(opcode::op_push, bit_width::lxiv, real_register::sp);
+		code.emplace_back(opcode::op_push, bit_width::lxiv, atsp);
+		code.emplace_back(opcode::op_and, bit_width::lxiv, -16, real_register::sp);
+		// push stack arguments (RTL)
+		for (int i = call_argc; i > 6; --i) {
+			const auto& arg = args.at(i);
+			code.emplace_back(opcode::op_push, bit_width::lxiv, arg.first);
+		}
+		// set register arguments
+		for (int i = std::min(call_argc, 6); i > 0; --i) {
+			const auto& arg = args.at(i);
+			code.emplace_back(opcode::op_mov, arg.second, arg.first, get_argument_register(i));
+		}
+		// perform actual call
+		code.emplace_back(opcode::op_call, bit_width{}, target);
+		// reset stack pointer (remove stack arguments)
+		if (call_argc > 6) {
+			code.emplace_back(opcode::op_add, bit_width::lxiv, std::int64_t{8} * (call_argc - 6), real_register::sp);
+		}
+		// alignment magic
+		atsp.constant = 8;
+		code.emplace_back(opcode::op_mov, bit_width::lxiv, atsp, real_register::sp);
+		// restore own argument registers (LTR)
+		for (int i = 1; i <= saved_registers; ++i) {
+			code.emplace_back(opcode::op_pop, bit_width::lxiv, get_argument_register(i));
+		}
+	}
+
 }  // namespace /* anonymous */
 
 
@@ -204,46 +443,34 @@ namespace minijava
 
 		real_assembly allocate_registers(const virtual_assembly& virtasm)
 		{
-			int argument_count, general_count;
-			std::tie(argument_count, general_count) = std::accumulate(
-					virtasm.blocks.begin(), virtasm.blocks.end(),
-					std::make_tuple(0, 0),
-					[](auto const& cur_count, auto const& cur_block) {
-						return std::accumulate(
-								cur_block.code.begin(), cur_block.code.end(),
-								cur_count,
-								[](auto const& cur_cnt, auto const& cur_instr) {
-									int argc, regc;
-									std::tie(argc, regc) = cur_cnt;
-									if (auto reg = get_register(cur_instr.op1)) {
-										if (is_argument_register(*reg)) {
-											argc = std::max(argc, number(*reg));
-										} else if (is_general_register(*reg)) {
-											regc = std::max(regc, number(*reg));
-										}
-									}
-									if (auto reg = get_register(cur_instr.op2)) {
-										// destination argument registers don't count
-										if (is_general_register(*reg)) {
-											regc = std::max(regc, number(*reg));
-										}
-									}
-									return std::make_tuple(argc, regc);
-								}
-						);
-					}
-			);
+			const auto layout = make_frame_layout(virtasm);
+			const auto argument_count = layout.argument_count;
+			const auto saved_count = static_cast<int>(layout.saved.size());
+			const auto slot_count = static_cast<int>(layout.slots.size());
 			auto realasm = real_assembly{virtasm.ldname};
+			realasm.labels = virtasm.labels;
 			{
 				// function prologue
 				auto prologue = basic_block<real_register>{""};
-				prologue.code.emplace_back(opcode::op_push, bit_width::lxiv, real_register::bp);
-				prologue.code.emplace_back(opcode::op_mov, bit_width::lxiv, real_register::sp, real_register::bp);
-				prologue.code.emplace_back(opcode::op_sub, bit_width::lxiv, std::int64_t{8} * general_count, real_register::sp);
+				if (layout.has_frame) {
+					prologue.code.emplace_back(opcode::op_push, bit_width::lxiv, real_register::bp);
+					prologue.code.emplace_back(opcode::op_mov, bit_width::lxiv, real_register::sp, real_register::bp);
+					if (slot_count + saved_count > 0) {
+						prologue.code.emplace_back(opcode::op_sub, bit_width::lxiv, std::int64_t{8} * (slot_count + saved_count), real_register::sp);
+					}
+					for (int i = 0; i < saved_count; ++i) {
+						const auto reg = layout.saved[static_cast<std::size_t>(i)];
+						prologue.code.emplace_back(opcode::op_mov, bit_width::lxiv, reg, layout.slot_address(slot_count + i + 1));
+					}
+				} else {
+					for (const auto reg : layout.saved) {
+						prologue.code.emplace_back(opcode::op_push, bit_width::lxiv, reg);
+					}
+				}
 				realasm.blocks.push_back(std::move(prologue));
 			}
 			// for keeping track of function arguments
-			auto next_call_args = std::map<int, std::pair<operand<real_register>, bit_width>>{};
+			auto next_call_args = call_arguments{};
 			auto assert_args_empty = [&next_call_args]() {
 				if (!next_call_args.empty()) {
 					MINIJAVA_THROW_ICE_MSG(
@@ -266,10 +493,47 @@ namespace minijava
 					}
 				}
 			};
+			// Inline fast paths for runtime functions branch to out-of-line
+			// blocks that call the runtime and are placed after the last
+			// block of the function.
+			auto slow_blocks = std::vector<basic_block<real_register>>{};
+			auto slow_path_count = 0;
+			const auto make_slow_path_labels = [&](const std::string& what){
+				const auto name = ".L" + virtasm.ldname + "_" + what + std::to_string(slow_path_count++);
+				return std::make_pair(realasm.labels.intern(name + "_slow"), realasm.labels.intern(name));
+			};
+			// Ends `block` after a fast path and continues with a new block
+			// that is the target of the jump back from the slow path.  The
+			// slow path calls `target` with `args` and moves the result of
+			// the call (unless `result_width` is empty) to the temporary
+			// register.
+			const auto add_slow_path = [&](basic_block<real_register>& block,
+			                               const std::pair<label_id, label_id>& labels,
+			                               const label_id target, const call_arguments& args,
+			                               const bit_width result_width){
+				realasm.blocks.push_back(std::move(block));
+				block = basic_block<real_register>{realasm.labels.name(labels.second)};
+				auto slow_block = basic_block<real_register>{realasm.labels.name(labels.first)};
+				add_call(slow_block.code, target, args, argument_count);
+				if (result_width != bit_width{}) {
+					slow_block.code.emplace_back(opcode::op_mov, result_width, real_register::a, tmp_register);
+				}
+				slow_block.code.emplace_back(opcode::op_jmp, bit_width{}, labels.second);
+				slow_blocks.push_back(std::move(slow_block));
+			};
+			const auto runtime_new = realasm.labels.intern("mj_runtime_new");
+			const auto heap_next = realasm.labels.intern("mj_runtime_heap_next");
+			const auto heap_limit = realasm.labels.intern("mj_runtime_heap_limit");
+			const auto runtime_write = realasm.labels.intern("mj_runtime_write");
+			const auto output_next = realasm.labels.intern("mj_runtime_output_next");
+			const auto output_limit = realasm.labels.intern("mj_runtime_output_limit");
+			const auto runtime_read = realasm.labels.intern("mj_runtime_read");
+			const auto input_next = realasm.labels.intern("mj_runtime_input_next");
+			const auto input_limit = realasm.labels.intern("mj_runtime_input_limit");
 			// transform basic blocks
 			for (auto const& block : virtasm.blocks) {
 				auto real_block = basic_block<real_register>{block.label};
-				auto visitor = op_visitor{real_block.code};
+				auto visitor = op_visitor{real_block.code, layout};
 				for (auto const& instr : block.code) {
 					// working with two addresses would break the address calculation in the visitor
 					assert(get_address(instr.op1) == nullptr || get_address(instr.op2) == nullptr);
@@ -278,52 +542,98 @@ namespace minijava
 					case opcode::op_call:
 					{
 						assert_args_complete();
-						auto call_argc = static_cast<int>(next_call_args.size());
-						auto saved_registers = std::min(6, argument_count);
-						// save own argument registers (RTL)
-						for (int i = saved_registers; i > 0; --i) {
-							real_block.code.emplace_back(opcode::op_push, bit_width::lxiv, get_argument_register(i));
-						}
-						// ensure alignment
-						auto atsp = real_address{};
-						atsp.base = real_register::sp;
-						real_block.code.emplace_back(opcode::op_push, bit_width::lxiv, real_register::sp);
-						real_block.code.emplace_back(opcode::op_push, bit_width::lxiv, atsp);
-						real_block.code.emplace_back(opcode::op_and, bit_width::lxiv, -16, real_register::sp);
-						// push stack arguments (RTL)
-						for (int i = call_argc; i > 6; --i) {
-							const auto& arg = next_call_args.at(i);
-							real_block.code.emplace_back(opcode::op_push, bit_width::lxiv, arg.first);
-						}
-						// set register arguments
-						for (int i = std::min(call_argc, 6); i > 0; --i) {
-							const auto& arg = next_call_args.at(i);
-							real_block.code.emplace_back(opcode::op_mov, arg.second, arg.first, get_argument_register(i));
-						}
-						// perform actual call
-						auto target = get_name(instr.op1);
+						auto target = get_label(instr.op1);
 						if (target == nullptr) {
 							MINIJAVA_THROW_ICE_MSG(
 								minijava::internal_compiler_error,
 								"call without target encountered"
 							);
 						}
-						real_block.code.emplace_back(opcode::op_call, bit_width{}, *target);
-						// reset stack pointer (remove stack arguments)
-						if (call_argc > 6) {
-							real_block.code.emplace_back(opcode::op_add, bit_width::lxiv, std::int64_t{8} * (call_argc - 6), real_register::sp);
-						}
-						// alignment magic
-						atsp.constant = 8;
-						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, atsp, real_register::sp);
-						// restore own argument registers (LTR)
-						for (int i = 1; i <= saved_registers; ++i) {
-							real_block.code.emplace_back(opcode::op_pop, bit_width::lxiv, get_argument_register(i));
-						}
+						add_call(real_block.code, *target, next_call_args, argument_count);
 						// reset state
 						next_call_args.clear();
 						break;
 					}
+					case opcode::mac_new:
+					{
+						// Bump the heap pointer of the runtime inline, write the
+						// block header (its size) and only call the runtime
+						// (out of line) if the current span is exhausted.
+						// `visitor` keeps referring to `real_block.code` after
+						// the block is split.
+						assert_args_empty();
+						assert(!is_argument(instr.op2));
+						const auto size = get_immediate(instr.op1);
+						assert((size != nullptr) && (*size > 0) && (*size % 8 == 0));
+						auto dst = instr.op2.apply_visitor(visitor);
+						const auto labels = make_slow_path_labels("new");
+						const auto total = *size + heap_header_size;
+						auto addr = real_address{};
+						addr.constant = static_cast<std::int32_t>(total);
+						addr.base = tmp_register;
+						auto header = real_address{};
+						header.base = tmp_register;
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, heap_next, tmp_register);
+						real_block.code.emplace_back(opcode::op_lea, bit_width{}, addr, tmp_address_register);
+						real_block.code.emplace_back(opcode::op_cmp, bit_width::lxiv, heap_limit, tmp_address_register);
+						real_block.code.emplace_back(opcode::op_ja, bit_width{}, labels.first);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, tmp_address_register, heap_next);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, total, header);
+						real_block.code.emplace_back(opcode::op_add, bit_width::lxiv, heap_header_size, tmp_register);
+						auto args = call_arguments{};
+						args.emplace(1, std::make_pair(operand<real_register>{std::int64_t{1}}, bit_width::xxxii));
+						args.emplace(2, std::make_pair(operand<real_register>{*size}, bit_width::xxxii));
+						add_slow_path(real_block, labels, runtime_new, args, bit_width::lxiv);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, tmp_register, std::move(dst));
+						break;
+					}
+					case opcode::mac_write:
+					{
+						// Store the byte in the output buffer of the runtime
+						// inline and only call the runtime (out of line) if
+						// the buffer is full.  The runtime sets the limit to
+						// the start of the buffer if every byte must go
+						// through the slow path.
+						assert_args_empty();
+						assert(empty(instr.op2));
+						auto value = instr.op1.apply_visitor(visitor);
+						const auto labels = make_slow_path_labels("write");
+						auto buffer = real_address{};
+						buffer.base = tmp_register;
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, output_next, tmp_register);
+						real_block.code.emplace_back(opcode::op_cmp, bit_width::lxiv, output_limit, tmp_register);
+						real_block.code.emplace_back(opcode::op_jae, bit_width{}, labels.first);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::xxxii, value, tmp_address_register);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::viii, tmp_address_register, buffer);
+						real_block.code.emplace_back(opcode::op_add, bit_width::lxiv, std::int64_t{1}, tmp_register);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, tmp_register, output_next);
+						auto args = call_arguments{};
+						args.emplace(1, std::make_pair(std::move(value), bit_width::xxxii));
+						add_slow_path(real_block, labels, runtime_write, args, bit_width{});
+						break;
+					}
+					case opcode::mac_read:
+					{
+						// Take the byte from the input buffer of the runtime
+						// inline and only call the runtime (out of line) if
+						// the buffer is empty.
+						assert_args_empty();
+						assert(!is_argument(instr.op1) && empty(instr.op2));
+						auto dst = instr.op1.apply_visitor(visitor);
+						const auto labels = make_slow_path_labels("read");
+						auto buffer = real_address{};
+						buffer.base = tmp_address_register;
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, input_next, tmp_address_register);
+						real_block.code.emplace_back(opcode::op_cmp, bit_width::lxiv, input_limit, tmp_address_register);
+						real_block.code.emplace_back(opcode::op_jae, bit_width{}, labels.first);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::xxxii, std::int64_t{0}, tmp_register);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::viii, buffer, tmp_register);
+						real_block.code.emplace_back(opcode::op_add, bit_width::lxiv, std::int64_t{1}, tmp_address_register);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, tmp_address_register, input_next);
+						add_slow_path(real_block, labels, runtime_read, call_arguments{}, bit_width::xxxii);
+						real_block.code.emplace_back(opcode::op_mov, bit_width::xxxii, tmp_register, std::move(dst));
+						break;
+					}
 					case opcode::op_mov:
 					{
 						auto op1 = instr.op1.apply_visitor(visitor);
@@ -377,14 +687,21 @@ namespace minijava
 						assert(!is_argument(instr.op2));
 						auto op1 = instr.op1.apply_visitor(visitor);
 						auto op2 = instr.op2.apply_visitor(visitor);
-						real_block.code.emplace_back(
-								instr.code, instr.width,
-								std::move(op1), tmp_register
-						);
-						real_block.code.emplace_back(
-								opcode::op_mov, bit_width::lxiv,
-								tmp_register, std::move(op2)
-						);
+						if (is_address(op2)) {
+							real_block.code.emplace_back(
+									instr.code, instr.width,
+									std::move(op1), tmp_register
+							);
+							real_block.code.emplace_back(
+									opcode::op_mov, bit_width::lxiv,
+									tmp_register, std::move(op2)
+							);
+						} else {
+							real_block.code.emplace_back(
+									instr.code, instr.width,
+									std::move(op1), std::move(op2)
+							);
+						}
 						break;
 					}
 					case opcode::op_add:
@@ -401,6 +718,12 @@ namespace minijava
 						break;
 					}
 					case opcode::op_imul:
+					case opcode::op_cmove:
+					case opcode::op_cmovl:
+					case opcode::op_cmovg:
+					case opcode::op_cmovle:
+					case opcode::op_cmovge:
+					case opcode::op_cmovne:
 					case opcode::mac_div:
 					case opcode::mac_mod:
 					{
@@ -476,13 +799,23 @@ namespace minijava
 					case opcode::op_jnz:
 						assert_args_empty();
 						assert(!empty(instr.op1) && empty(instr.op2));
-						real_block.code.emplace_back(instr.code, instr.width, *get_name(instr.op1));
+						real_block.code.emplace_back(instr.code, instr.width, *get_label(instr.op1));
 						break;
 					case opcode::op_ret:
 						assert_args_empty();
 						// epilogue
-						real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, real_register::bp, real_register::sp);
-						real_block.code.emplace_back(opcode::op_pop, bit_width::lxiv, real_register::bp);
+						if (layout.has_frame) {
+							for (int i = 0; i < saved_count; ++i) {
+								const auto reg = layout.saved[static_cast<std::size_t>(i)];
+								real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, layout.slot_address(slot_count + i + 1), reg);
+							}
+							real_block.code.emplace_back(opcode::op_mov, bit_width::lxiv, real_register::bp, real_register::sp);
+							real_block.code.emplace_back(opcode::op_pop, bit_width::lxiv, real_register::bp);
+						} else {
+							for (auto it = layout.saved.rbegin(); it != layout.saved.rend(); ++it) {
+								real_block.code.emplace_back(opcode::op_pop, bit_width::lxiv, *it);
+							}
+						}
 						real_block.code.emplace_back(opcode::op_ret);
 						break;
 					case opcode::op_nop:
@@ -497,6 +830,7 @@ namespace minijava
 				}
 				realasm.blocks.push_back(std::move(real_block));
 			}
+			std::move(slow_blocks.begin(), slow_blocks.end(), std::back_inserter(realasm.blocks));
 			return realasm;
 		}
 
@@ -2,41 +2,135 @@
 
 #include <cassert>
 #include <cstddef>
+#include <string>
+#include <vector>
+
+#include <boost/optional.hpp>
 
 #include "asm/allocator.hpp"
 #include "asm/assembly.hpp"
 #include "asm/data.hpp"
+#include "asm/elf.hpp"
+#include "asm/encoder.hpp"
 #include "asm/generator.hpp"
 #include "asm/macros.hpp"
 #include "asm/output.hpp"
 #include "exceptions.hpp"
 #include "firm.hpp"
 #include "irg/irg.hpp"
+#include "system/workers.hpp"
 
 
 namespace minijava
 {
 
-	void assemble(firm_ir& ir, file_output& out)
+	namespace /* anonymous */
+	{
+
+		// Number of functions per thread that go through the parallel part
+		// of the backend together.  More functions balance the load better
+		// but keep more backend data alive at the same time.
+		constexpr std::size_t functions_per_thread = 32;
+
+		// Code of a single function on its way through the backend.
+		struct function_code
+		{
+			// Does the function have external visibility?
+			bool global{};
+
+			// Code with virtual registers (until registers are allocated).
+			boost::optional<backend::virtual_assembly> virtasm{};
+
+			// Code with real registers and macros expanded.
+			boost::optional<backend::real_assembly> realasm{};
+
+			// Assembly text (only if the caller asks for it).
+			std::string text{};
+		};
+
+		// Generates the code for the functions of the current IRP and passes
+		// each one to `consume` on the calling thread.
+		//
+		// Instruction selection reads the IRG and therefore has to run on
+		// the calling thread, too.  Each IRG is freed as soon as its virtual
+		// assembly exists.  The IRGs are taken from the back of the IRP
+		// because freeing any other one moves all IRGs after it, which
+		// would be quadratic for programs with many methods.  Hence the
+		// functions are emitted in reverse order.  Register allocation, macro expansion and `finish`
+		// only work on the backend structures of a single function, so they
+		// run on up to `threads` threads for a window of functions at a time.
+		// With a single thread, only one function is in flight at any time.
+		template <typename FinishT, typename ConsumeT>
+		void generate_code(const std::size_t threads, FinishT&& finish, ConsumeT&& consume)
+		{
+			const auto window = (threads < 2) ? 1 : threads * functions_per_thread;
+			auto functions = std::vector<function_code>{};
+			while (firm::get_irp_n_irgs() > 0) {
+				functions.clear();
+				while ((functions.size() < window) && (firm::get_irp_n_irgs() > 0)) {
+					const auto irg = firm::get_irp_irg(firm::get_irp_n_irgs() - 1);
+					const auto entity = firm::get_irg_entity(irg);
+					functions.emplace_back();
+					auto& code = functions.back();
+					code.global = (firm::get_entity_visibility(entity) == firm::ir_visibility_external);
+					code.virtasm = backend::assemble_function(irg);
+					firm::free_ir_graph(irg);
+				}
+				run_worker_threads(functions.size(), threads, [&functions, &finish](const std::size_t i){
+					auto& code = functions[i];
+					code.realasm = backend::allocate_registers(*code.virtasm);
+					code.virtasm = boost::none;
+					backend::expand_macros(*code.realasm);
+					finish(code);
+				});
+				for (auto& code : functions) {
+					consume(code);
+				}
+			}
+		}
+
+	}  // namespace /* anonymous */
+
+	void assemble(firm_ir& ir, file_output& out, const std::size_t threads)
 	{
 		assert(ir);
 		const auto guard = make_irp_guard(*ir->second, ir->first);
 		backend::write_data_segment(firm::get_glob_type(), out);
 		out.write("\n\t.text\n");
-		const auto n = firm::get_irp_n_irgs();
-		for (std::size_t i = 0; i < n; ++i) {
-			const auto irg = firm::get_irp_irg(i);
-			const auto virtasm = backend::assemble_function(irg);
-			auto realasm = backend::allocate_registers(virtasm);
-			backend::expand_macros(realasm);
-			const auto entity = firm::get_irg_entity(irg);
-			if (firm::get_entity_visibility(entity) == firm::ir_visibility_external) {
-				const auto ldname = firm::get_entity_ld_name(entity);
-				out.print("\t.globl %s\n", ldname);
+		const auto finish = [](function_code& code){
+			if (code.global) {
+				code.text = "\t.globl " + code.realasm->ldname + "\n";
 			}
-			backend::write_text(realasm, out);
-			out.write("\n");
-		}
+			code.text += backend::format_text(*code.realasm);
+			code.text += "\n";
+			code.realasm = boost::none;
+		};
+		const auto consume = [&out](function_code& code){
+			out.write(code.text);
+		};
+		generate_code(threads, finish, consume);
+	}
+
+	void assemble_object(firm_ir& ir, file_output& out, const std::size_t threads)
+	{
+		const auto obj = encode_object(ir, threads);
+		backend::write_elf_object(obj, out);
+	}
+
+	backend::object_file encode_object(firm_ir& ir, const std::size_t threads)
+	{
+		assert(ir);
+		const auto guard = make_irp_guard(*ir->second, ir->first);
+		auto obj = backend::object_file{};
+		backend::encode_data_segment(firm::get_glob_type(), obj);
+		// Encoding appends to the shared object file and has to be done in
+		// order on the calling thread.
+		const auto finish = [](function_code&){};
+		const auto consume = [&obj](function_code& code){
+			backend::encode_text(*code.realasm, code.global, obj);
+		};
+		generate_code(threads, finish, consume);
+		return obj;
 	}
 
 }  // namespace minijava
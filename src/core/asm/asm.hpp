@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <cstddef>
+
+#include "asm/elf.hpp"
 #include "io/file_output.hpp"
 #include "irg/irg.hpp"
 
@@ -22,14 +25,69 @@ namespace minijava
 	 * This function performs no optimization.  This has to be done beforehand,
 	 * if desired.
 	 *
+	 * The IRG is consumed in the process:  The graph of each function is
+	 * freed as soon as its code was generated so that only the backend data
+	 * of a single function is alive at any time.  Afterwards, `ir` contains
+	 * no more functions and may only be destroyed.
+	 *
+	 * Instruction selection reads the IRG and always runs on the calling
+	 * thread.  If `threads` is greater than one, register allocation, macro
+	 * expansion and formatting of the assembly text run in parallel for a
+	 * window of functions at a time, which then holds the backend data of
+	 * that many functions.  The output does not depend on the number of
+	 * threads.
+	 *
 	 * @param ir
 	 *     lowered Firm IRG
 	 *
 	 * @param out
 	 *     file to which the assembly shall be written
 	 *
+	 * @param threads
+	 *     maximum number of threads to use
+	 *
+	 */
+	void assemble(firm_ir& ir, file_output& out, std::size_t threads = 1);
+
+	/**
+	 * @brief
+	 *     Emits an x64 ELF relocatable object file for the lowered IRG.
+	 *
+	 * This produces the same code as `assemble` but encodes it directly so
+	 * no external assembler is needed.  It is only available for ELF
+	 * targets.  Like `assemble`, it consumes the IRG and can use several
+	 * threads, except for the final encoding which is always sequential.
+	 *
+	 * @param ir
+	 *     lowered Firm IRG
+	 *
+	 * @param out
+	 *     file to which the object file shall be written
+	 *
+	 * @param threads
+	 *     maximum number of threads to use
+	 *
+	 */
+	void assemble_object(firm_ir& ir, file_output& out, std::size_t threads = 1);
+
+	/**
+	 * @brief
+	 *     Encodes the lowered IRG as x64 machine code in memory.
+	 *
+	 * This produces the same object file that `assemble_object` writes and
+	 * consumes the IRG in the same way.
+	 *
+	 * @param ir
+	 *     lowered Firm IRG
+	 *
+	 * @param threads
+	 *     maximum number of threads to use
+	 *
+	 * @returns
+	 *     in-memory object file
+	 *
 	 */
-	void assemble(firm_ir& ir, file_output& out);
+	backend::object_file encode_object(firm_ir& ir, std::size_t threads = 1);
 
 	/**
 	 * @brief
@@ -1,3 +1,31 @@
 #include "asm/assembly.hpp"
 
-// This file is empty.
+#include <cassert>
+
+
+namespace minijava
+{
+
+	namespace backend
+	{
+
+		label_id label_table::intern(const std::string& name)
+		{
+			const auto id = static_cast<label_id>(_names.size());
+			const auto inserted = _ids.insert({name, id});
+			if (inserted.second) {
+				_names.push_back(name);
+			}
+			return inserted.first->second;
+		}
+
+		const std::string& label_table::name(const label_id id) const
+		{
+			const auto idx = static_cast<std::size_t>(id);
+			assert(idx < _names.size());
+			return _names[idx];
+		}
+
+	}  // namespace backend
+
+}  // namespace minijava
@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "asm/basic_block.hpp"
+#include "asm/instruction.hpp"
 
 
 namespace minijava
@@ -20,6 +23,70 @@ namespace minijava
 	namespace backend
 	{
 
+		/**
+		 * @brief
+		 *     Per-function table of interned label names.
+		 *
+		 * Instructions refer to labels by `label_id` so they do not have to
+		 * carry strings.  Interning the same name twice yields the same
+		 * identifier.
+		 *
+		 */
+		class label_table final
+		{
+		public:
+
+			/**
+			 * @brief
+			 *     `return`s the identifier for a name, interning it if it is
+			 *     not in the table yet.
+			 *
+			 * @param name
+			 *     label name
+			 *
+			 * @returns
+			 *     identifier of the label
+			 *
+			 */
+			label_id intern(const std::string& name);
+
+			/**
+			 * @brief
+			 *     `return`s the name of a label in the table.
+			 *
+			 * @param id
+			 *     identifier obtained from `intern`
+			 *
+			 * @returns
+			 *     name of the label
+			 *
+			 */
+			const std::string& name(label_id id) const;
+
+			/**
+			 * @brief
+			 *     `return`s the number of distinct labels in the table.
+			 *
+			 * @returns
+			 *     number of labels
+			 *
+			 */
+			std::size_t size() const noexcept
+			{
+				return _names.size();
+			}
+
+		private:
+
+			/** @brief Names indexed by their identifier. */
+			std::vector<std::string> _names{};
+
+			/** @brief Identifiers of the interned names. */
+			std::unordered_map<std::string, label_id> _ids{};
+
+		};
+
+
 		/**
 		 * @brief
 		 *     Assembly for a function block.
@@ -48,6 +115,9 @@ namespace minijava
 
 			/** @brief List of basic blocks. */
 			std::vector<basic_block<RegT>> blocks{};
+
+			/** @brief Names of the labels referred to by instructions. */
+			label_table labels{};
 		};
 
 		/** @brief Type used for x64 assemblies using virtual registers. */
@@ -1,6 +1,9 @@
 #include "asm/data.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <utility>
+
 #include "firm.hpp"
 
 #include "exceptions.hpp"
@@ -119,24 +122,107 @@ namespace minijava
 				}
 			}
 
-			void write_global_entity(const firm::ir_entity* entity, file_output& out)
+			void encode_initializer(const firm::ir_entity* entity, const firm::ir_initializer_t* initializer, object_file& obj)
+			{
+				const auto type = firm::get_entity_type(entity);
+
+				switch (firm::get_initializer_kind(initializer)) {
+				case firm::IR_INITIALIZER_CONST:
+					{
+						const auto val = get_initializer_const_value(initializer);
+						if (firm::get_irn_opcode(val) != firm::iro_Address) {
+							MINIJAVA_NOT_IMPLEMENTED_MSG("Cannot handle global variables of non-address type");
+						}
+						auto rel = relocation{};
+						rel.section = object_section::data;
+						rel.offset = obj.data.size();
+						rel.symbol = firm::get_entity_ld_name(firm::get_Address_entity(val));
+						rel.kind = relocation_kind::abs64;
+						obj.relocations.push_back(std::move(rel));
+						obj.data.resize(obj.data.size() + 8);
+						return;
+					}
+				case firm::IR_INITIALIZER_COMPOUND:
+					{
+						assert(!firm::is_Array_type(type));
+						assert(firm::is_compound_type(type));
+						std::size_t offset = 0;
+						std::size_t n_members = firm::get_compound_n_members(type);
+						for (std::size_t i = 0; i < n_members; ++i) {
+							const auto member = firm::get_compound_member(type, i);
+							if (offset != static_cast<std::size_t>(firm::get_entity_offset(member))) {
+								MINIJAVA_NOT_IMPLEMENTED_MSG("Cannot handle padding");
+							}
+							assert(0 == firm::get_entity_bitfield_size(member));
+							assert(i < firm::get_initializer_compound_n_entries(initializer));
+							const auto sub_initializer = firm::get_initializer_compound_value(initializer, i);
+							encode_initializer(member, sub_initializer, obj);
+							offset += firm::get_type_size(firm::get_entity_type(member));
+						}
+						return;
+					}
+				default:
+					MINIJAVA_NOT_REACHED();
+				}
+			}
+
+			// Returns whether `entity` belongs into the data segment.
+			bool is_data_entity(const firm::ir_entity* entity)
 			{
 				// do not write stuff, that shall not be linked
 				const auto linkage = firm::get_entity_linkage(entity);
 				if (linkage & firm::IR_LINKAGE_NO_CODEGEN) {
-					return;
+					return false;
 				}
 				// writen data shall have a definition
 				if (!entity_has_definition(entity)) {
-					return;
+					return false;
 				}
 				// do not write methods in the data segment
 				if (firm::is_method_entity(entity)) {
-					return;
+					return false;
 				}
 				if (firm::get_entity_visibility(entity) != firm::ir_visibility_local) {
 					MINIJAVA_NOT_IMPLEMENTED_MSG("Cannot handle non-local visibility");
 				}
+				return true;
+			}
+
+			void encode_global_entity(const firm::ir_entity* entity, object_file& obj)
+			{
+				if (!is_data_entity(entity)) {
+					return;
+				}
+				const auto size = determine_size(entity);
+				const auto alignment = std::max<std::size_t>(determine_alignment(entity), 1);
+				assert((std::size_t{1} << log2_floor(alignment)) == alignment);
+				auto sym = object_symbol{};
+				sym.name = firm::get_entity_ld_name(entity);
+				sym.kind = symbol_kind::object;
+				sym.size = size;
+				const auto initializer = firm::get_entity_initializer(entity);
+				if (initializer_is_null(initializer)) {
+					obj.bss_size = (obj.bss_size + alignment - 1) / alignment * alignment;
+					obj.bss_alignment = std::max<std::uint64_t>(obj.bss_alignment, alignment);
+					sym.section = object_section::bss;
+					sym.offset = obj.bss_size;
+					obj.bss_size += size;
+				} else {
+					align_section(obj.data, alignment);
+					obj.data_alignment = std::max<std::uint64_t>(obj.data_alignment, alignment);
+					sym.section = object_section::data;
+					sym.offset = obj.data.size();
+					encode_initializer(entity, initializer, obj);
+					assert(obj.data.size() - sym.offset == size);
+				}
+				obj.symbols.push_back(std::move(sym));
+			}
+
+			void write_global_entity(const firm::ir_entity* entity, file_output& out)
+			{
+				if (!is_data_entity(entity)) {
+					return;
+				}
 				const auto name = firm::get_entity_ld_name(entity);
 				const auto size = determine_size(entity);
 				const auto alignment = determine_alignment(entity);
@@ -186,6 +272,16 @@ namespace minijava
 			}
 		}
 
+		void encode_data_segment(firm::ir_type*const glob, object_file& obj)
+		{
+			assert(glob != nullptr);
+			std::size_t type_count = get_compound_n_members(glob);
+			for (std::size_t i = 0; i < type_count; ++i) {
+				const auto* entity = firm::get_compound_member(glob, i);
+				encode_global_entity(entity, obj);
+			}
+		}
+
 	}  // namespace backend
 
 }  // namespace minijava
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "asm/elf.hpp"
 #include "firm.hpp"
 #include "io/file_output.hpp"
 
@@ -26,6 +27,23 @@ namespace minijava
 		 */
 		void write_data_segment(firm::ir_type* glob, file_output& out);
 
+		/**
+		 * @brief
+		 *     Adds the data segment to an object file.
+		 *
+		 * This is the binary equivalent of `write_data_segment`.  Initialized
+		 * globals go to the data section, all others to the BSS section.
+		 * Pointers to other entities become relocations.
+		 *
+		 * @param glob
+		 *     Firm global type
+		 *
+		 * @param obj
+		 *     object file to add the data to
+		 *
+		 */
+		void encode_data_segment(firm::ir_type* glob, object_file& obj);
+
 	}  // namespace backend
 
 }  // namespace minijava
@@ -0,0 +1,315 @@
+#include "asm/elf.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <map>
+#include <utility>
+
+#include "exceptions.hpp"
+
+
+namespace minijava
+{
+
+	namespace backend
+	{
+
+		namespace /* anonymous */
+		{
+
+			// Constants from the ELF specification and the x86-64 psABI.
+			constexpr std::uint16_t et_rel = 1;
+			constexpr std::uint16_t em_x86_64 = 62;
+			constexpr std::uint32_t sht_progbits = 1;
+			constexpr std::uint32_t sht_symtab = 2;
+			constexpr std::uint32_t sht_strtab = 3;
+			constexpr std::uint32_t sht_rela = 4;
+			constexpr std::uint32_t sht_nobits = 8;
+			constexpr std::uint64_t shf_write = 0x1;
+			constexpr std::uint64_t shf_alloc = 0x2;
+			constexpr std::uint64_t shf_execinstr = 0x4;
+			constexpr std::uint64_t shf_info_link = 0x40;
+			constexpr std::uint8_t stb_local = 0;
+			constexpr std::uint8_t stb_global = 1;
+			constexpr std::uint8_t stt_notype = 0;
+			constexpr std::uint8_t stt_object = 1;
+			constexpr std::uint8_t stt_func = 2;
+			constexpr std::size_t ehdr_size = 64;
+			constexpr std::size_t shdr_size = 64;
+			constexpr std::size_t sym_size = 24;
+			constexpr std::size_t rela_size = 24;
+
+			// Indices of the sections in the section header table.
+			enum section_number : std::uint16_t
+			{
+				sec_null,
+				sec_text,
+				sec_data,
+				sec_bss,
+				sec_rela_text,
+				sec_rela_data,
+				sec_symtab,
+				sec_strtab,
+				sec_shstrtab,
+				sec_note_gnu_stack,
+				sec_count
+			};
+
+			// Appends the `size` least significant bytes of `value` to `buf`
+			// in little-endian byte order.
+			void put(std::vector<std::uint8_t>& buf, const std::uint64_t value, const std::size_t size)
+			{
+				for (std::size_t i = 0; i < size; ++i) {
+					buf.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+				}
+			}
+
+			// String table that stores every distinct string once.
+			class string_table final
+			{
+			public:
+
+				string_table()
+				{
+					_bytes.push_back(0);
+				}
+
+				std::uint32_t add(const std::string& str)
+				{
+					if (str.empty()) {
+						return 0;
+					}
+					const auto pos = _offsets.find(str);
+					if (pos != _offsets.end()) {
+						return pos->second;
+					}
+					const auto offset = static_cast<std::uint32_t>(_bytes.size());
+					_bytes.insert(_bytes.end(), str.begin(), str.end());
+					_bytes.push_back(0);
+					_offsets.emplace(str, offset);
+					return offset;
+				}
+
+				const std::vector<std::uint8_t>& bytes() const noexcept
+				{
+					return _bytes;
+				}
+
+			private:
+
+				std::vector<std::uint8_t> _bytes{};
+
+				std::map<std::string, std::uint32_t> _offsets{};
+
+			};
+
+			std::uint16_t section_number_of(const object_section section)
+			{
+				switch (section) {
+				case object_section::undefined:
+					return sec_null;
+				case object_section::text:
+					return sec_text;
+				case object_section::data:
+					return sec_data;
+				case object_section::bss:
+					return sec_bss;
+				}
+				MINIJAVA_NOT_REACHED();
+			}
+
+			std::uint8_t symbol_type_of(const symbol_kind kind)
+			{
+				switch (kind) {
+				case symbol_kind::none:
+					return stt_notype;
+				case symbol_kind::function:
+					return stt_func;
+				case symbol_kind::object:
+					return stt_object;
+				}
+				MINIJAVA_NOT_REACHED();
+			}
+
+			struct section_header
+			{
+				std::uint32_t name{};
+				std::uint32_t type{};
+				std::uint64_t flags{};
+				std::uint64_t offset{};
+				std::uint64_t size{};
+				std::uint32_t link{};
+				std::uint32_t info{};
+				std::uint64_t alignment{};
+				std::uint64_t entsize{};
+			};
+
+			void put_section_header(std::vector<std::uint8_t>& buf, const section_header& shdr)
+			{
+				put(buf, shdr.name, 4);
+				put(buf, shdr.type, 4);
+				put(buf, shdr.flags, 8);
+				put(buf, 0, 8);  // address
+				put(buf, shdr.offset, 8);
+				put(buf, shdr.size, 8);
+				put(buf, shdr.link, 4);
+				put(buf, shdr.info, 4);
+				put(buf, shdr.alignment, 8);
+				put(buf, shdr.entsize, 8);
+			}
+
+		}  // namespace /* anonymous */
+
+
+		void align_section(std::vector<std::uint8_t>& bytes, const std::size_t alignment)
+		{
+			assert((alignment > 0) && ((alignment & (alignment - 1)) == 0));
+			while (bytes.size() % alignment != 0) {
+				bytes.push_back(0);
+			}
+		}
+
+		void write_elf_object(const object_file& obj, file_output& out)
+		{
+			// Build the symbol table.  Local symbols must precede global ones
+			// and undefined symbols are implied by the relocations.
+			auto symbols = std::vector<object_symbol>{};
+			symbols.reserve(obj.symbols.size());
+			std::copy_if(
+				obj.symbols.begin(), obj.symbols.end(), std::back_inserter(symbols),
+				[](const auto& sym){ return !sym.global; }
+			);
+			const auto first_global = symbols.size() + 1;
+			std::copy_if(
+				obj.symbols.begin(), obj.symbols.end(), std::back_inserter(symbols),
+				[](const auto& sym){ return sym.global; }
+			);
+			auto indices = std::map<std::string, std::size_t>{};
+			for (std::size_t i = 0; i < symbols.size(); ++i) {
+				if (!indices.emplace(symbols[i].name, i + 1).second) {
+					MINIJAVA_THROW_ICE_MSG(internal_compiler_error, "Duplicate symbol " + symbols[i].name);
+				}
+			}
+			for (const auto& rel : obj.relocations) {
+				if (indices.find(rel.symbol) == indices.end()) {
+					auto sym = object_symbol{};
+					sym.name = rel.symbol;
+					sym.global = true;
+					symbols.push_back(sym);
+					indices.emplace(rel.symbol, symbols.size());
+				}
+			}
+			auto strtab = string_table{};
+			auto symtab = std::vector<std::uint8_t>(sym_size, 0);
+			for (const auto& sym : symbols) {
+				const auto binding = sym.global ? stb_global : stb_local;
+				put(symtab, strtab.add(sym.name), 4);
+				put(symtab, static_cast<std::uint8_t>((binding << 4) | symbol_type_of(sym.kind)), 1);
+				put(symtab, 0, 1);  // default visibility
+				put(symtab, section_number_of(sym.section), 2);
+				put(symtab, sym.offset, 8);
+				put(symtab, sym.size, 8);
+			}
+			// Build the relocation sections.
+			auto rela_text = std::vector<std::uint8_t>{};
+			auto rela_data = std::vector<std::uint8_t>{};
+			for (const auto& rel : obj.relocations) {
+				auto& rela = (rel.section == object_section::text) ? rela_text : rela_data;
+				assert((rel.section == object_section::text) || (rel.section == object_section::data));
+				const auto symidx = static_cast<std::uint64_t>(indices.at(rel.symbol));
+				put(rela, rel.offset, 8);
+				put(rela, (symidx << 32) | static_cast<std::uint32_t>(rel.kind), 8);
+				put(rela, static_cast<std::uint64_t>(rel.addend), 8);
+			}
+			// Lay out the file: header, section contents, section headers.
+			auto shstrtab = string_table{};
+			auto headers = std::vector<section_header>(sec_count);
+			auto image = std::vector<std::uint8_t>(ehdr_size, 0);
+			const auto add_contents = [&image](section_header& shdr, const std::vector<std::uint8_t>& bytes){
+				align_section(image, std::max<std::size_t>(shdr.alignment, 1));
+				shdr.offset = image.size();
+				shdr.size = bytes.size();
+				image.insert(image.end(), bytes.begin(), bytes.end());
+			};
+			headers[sec_text].name = shstrtab.add(".text");
+			headers[sec_text].type = sht_progbits;
+			headers[sec_text].flags = shf_alloc | shf_execinstr;
+			headers[sec_text].alignment = 16;
+			add_contents(headers[sec_text], obj.text);
+			headers[sec_data].name = shstrtab.add(".data");
+			headers[sec_data].type = sht_progbits;
+			headers[sec_data].flags = shf_alloc | shf_write;
+			headers[sec_data].alignment = obj.data_alignment;
+			add_contents(headers[sec_data], obj.data);
+			headers[sec_bss].name = shstrtab.add(".bss");
+			headers[sec_bss].type = sht_nobits;
+			headers[sec_bss].flags = shf_alloc | shf_write;
+			headers[sec_bss].alignment = obj.bss_alignment;
+			headers[sec_bss].offset = image.size();
+			headers[sec_bss].size = obj.bss_size;
+			headers[sec_rela_text].name = shstrtab.add(".rela.text");
+			headers[sec_rela_text].type = sht_rela;
+			headers[sec_rela_text].flags = shf_info_link;
+			headers[sec_rela_text].link = sec_symtab;
+			headers[sec_rela_text].info = sec_text;
+			headers[sec_rela_text].alignment = 8;
+			headers[sec_rela_text].entsize = rela_size;
+			add_contents(headers[sec_rela_text], rela_text);
+			headers[sec_rela_data].name = shstrtab.add(".rela.data");
+			headers[sec_rela_data].type = sht_rela;
+			headers[sec_rela_data].flags = shf_info_link;
+			headers[sec_rela_data].link = sec_symtab;
+			headers[sec_rela_data].info = sec_data;
+			headers[sec_rela_data].alignment = 8;
+			headers[sec_rela_data].entsize = rela_size;
+			add_contents(headers[sec_rela_data], rela_data);
+			headers[sec_symtab].name = shstrtab.add(".symtab");
+			headers[sec_symtab].type = sht_symtab;
+			headers[sec_symtab].link = sec_strtab;
+			headers[sec_symtab].info = static_cast<std::uint32_t>(first_global);
+			headers[sec_symtab].alignment = 8;
+			headers[sec_symtab].entsize = sym_size;
+			add_contents(headers[sec_symtab], symtab);
+			headers[sec_strtab].name = shstrtab.add(".strtab");
+			headers[sec_strtab].type = sht_strtab;
+			headers[sec_strtab].alignment = 1;
+			add_contents(headers[sec_strtab], strtab.bytes());
+			// The empty note marks the stack as non-executable.
+			headers[sec_note_gnu_stack].name = shstrtab.add(".note.GNU-stack");
+			headers[sec_note_gnu_stack].type = sht_progbits;
+			headers[sec_note_gnu_stack].alignment = 1;
+			headers[sec_note_gnu_stack].offset = image.size();
+			headers[sec_shstrtab].name = shstrtab.add(".shstrtab");
+			headers[sec_shstrtab].type = sht_strtab;
+			headers[sec_shstrtab].alignment = 1;
+			add_contents(headers[sec_shstrtab], shstrtab.bytes());
+			align_section(image, 8);
+			const auto shoff = image.size();
+			for (const auto& shdr : headers) {
+				put_section_header(image, shdr);
+			}
+			// Fill in the ELF header.
+			auto ehdr = std::vector<std::uint8_t>{0x7f, 'E', 'L', 'F', 2, 1, 1, 0};
+			put(ehdr, 0, 8);  // padding of e_ident
+			put(ehdr, et_rel, 2);
+			put(ehdr, em_x86_64, 2);
+			put(ehdr, 1, 4);  // version
+			put(ehdr, 0, 8);  // entry
+			put(ehdr, 0, 8);  // program header offset
+			put(ehdr, shoff, 8);
+			put(ehdr, 0, 4);  // flags
+			put(ehdr, ehdr_size, 2);
+			put(ehdr, 0, 2);  // program header entry size
+			put(ehdr, 0, 2);  // number of program headers
+			put(ehdr, shdr_size, 2);
+			put(ehdr, sec_count, 2);
+			put(ehdr, sec_shstrtab, 2);
+			assert(ehdr.size() == ehdr_size);
+			std::copy(ehdr.begin(), ehdr.end(), image.begin());
+			out.write(image.data(), image.size());
+		}
+
+	}  // namespace backend
+
+}  // namespace minijava
@@ -0,0 +1,177 @@
+/**
+ * @file elf.hpp
+ *
+ * @brief
+ *     In-memory relocatable object files and an ELF64 writer for them.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "io/file_output.hpp"
+
+
+namespace minijava
+{
+
+	namespace backend
+	{
+
+		/**
+		 * @brief
+		 *     Sections of an object file.
+		 *
+		 */
+		enum class object_section : std::uint8_t
+		{
+			undefined,  ///< not defined in this object (external symbol)
+			text,       ///< machine code
+			data,       ///< initialized data
+			bss,        ///< zero-initialized data
+		};
+
+		/**
+		 * @brief
+		 *     Kinds of symbols in an object file.
+		 *
+		 */
+		enum class symbol_kind : std::uint8_t
+		{
+			none,      ///< unknown (used for external symbols)
+			function,  ///< function in the text section
+			object,    ///< data object
+		};
+
+		/**
+		 * @brief
+		 *     A symbol defined or referenced in an object file.
+		 *
+		 */
+		struct object_symbol final
+		{
+			/** @brief Linker name of the symbol. */
+			std::string name{};
+
+			/** @brief Section the symbol is defined in. */
+			object_section section{};
+
+			/** @brief Kind of the symbol. */
+			symbol_kind kind{};
+
+			/** @brief Whether the symbol is visible to other objects. */
+			bool global{};
+
+			/** @brief Offset of the symbol in its section. */
+			std::uint64_t offset{};
+
+			/** @brief Size of the symbol in bytes. */
+			std::uint64_t size{};
+		};
+
+		/**
+		 * @brief
+		 *     Kinds of relocations needed by the backend.
+		 *
+		 * The numeric values are the ones defined by the x86-64 System V ABI.
+		 *
+		 */
+		enum class relocation_kind : std::uint32_t
+		{
+			abs64  =  1,  ///< `R_X86_64_64` (64 bit absolute)
+			pc32   =  2,  ///< `R_X86_64_PC32` (32 bit PC-relative)
+			plt32  =  4,  ///< `R_X86_64_PLT32` (32 bit PC-relative call)
+			abs32s = 11,  ///< `R_X86_64_32S` (32 bit sign-extended absolute)
+		};
+
+		/**
+		 * @brief
+		 *     A location in a section that must be patched by the linker.
+		 *
+		 */
+		struct relocation final
+		{
+			/** @brief Section that contains the location. */
+			object_section section{};
+
+			/** @brief Offset of the location in its section. */
+			std::uint64_t offset{};
+
+			/** @brief Name of the referenced symbol. */
+			std::string symbol{};
+
+			/** @brief Kind of the relocation. */
+			relocation_kind kind{};
+
+			/** @brief Constant added to the value of the symbol. */
+			std::int64_t addend{};
+		};
+
+		/**
+		 * @brief
+		 *     Contents of a relocatable object file.
+		 *
+		 * Symbols that are referenced by relocations but not listed in
+		 * `symbols` are added as undefined global symbols when the object is
+		 * written.
+		 *
+		 */
+		struct object_file final
+		{
+			/** @brief Contents of the text section. */
+			std::vector<std::uint8_t> text{};
+
+			/** @brief Contents of the data section. */
+			std::vector<std::uint8_t> data{};
+
+			/** @brief Alignment of the data section. */
+			std::uint64_t data_alignment{1};
+
+			/** @brief Size of the BSS section. */
+			std::uint64_t bss_size{};
+
+			/** @brief Alignment of the BSS section. */
+			std::uint64_t bss_alignment{1};
+
+			/** @brief Defined symbols. */
+			std::vector<object_symbol> symbols{};
+
+			/** @brief Relocations for the text and data sections. */
+			std::vector<relocation> relocations{};
+		};
+
+		/**
+		 * @brief
+		 *     Appends zero bytes to `bytes` until its size is a multiple of
+		 *     `alignment`.
+		 *
+		 * @param bytes
+		 *     section contents
+		 *
+		 * @param alignment
+		 *     alignment (must be a power of two)
+		 *
+		 */
+		void align_section(std::vector<std::uint8_t>& bytes, std::size_t alignment);
+
+		/**
+		 * @brief
+		 *     Writes an object file in the ELF64 relocatable format for
+		 *     x86-64.
+		 *
+		 * @param obj
+		 *     object file to write
+		 *
+		 * @param out
+		 *     file to write to
+		 *
+		 */
+		void write_elf_object(const object_file& obj, file_output& out);
+
+	}  // namespace backend
+
+}  // namespace minijava
@@ -0,0 +1,540 @@
+#include "asm/encoder.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exceptions.hpp"
+
+
+namespace minijava
+{
+
+	namespace backend
+	{
+
+		namespace /* anonymous */
+		{
+
+			// Returns the hardware encoding of a register, which is not the
+			// same as `number(reg)`.
+			int encoding(const real_register reg) noexcept
+			{
+				switch (reg) {
+				case real_register::a:   return 0;
+				case real_register::c:   return 1;
+				case real_register::d:   return 2;
+				case real_register::b:   return 3;
+				case real_register::sp:  return 4;
+				case real_register::bp:  return 5;
+				case real_register::si:  return 6;
+				case real_register::di:  return 7;
+				case real_register::r8:  return 8;
+				case real_register::r9:  return 9;
+				case real_register::r10: return 10;
+				case real_register::r11: return 11;
+				case real_register::r12: return 12;
+				case real_register::r13: return 13;
+				case real_register::r14: return 14;
+				case real_register::r15: return 15;
+				}
+				MINIJAVA_NOT_REACHED();
+			}
+
+			// Returns the condition code (`tttn` field) of a conditional
+			// instruction given the part of its mnemotic after `prefix` or -1
+			// if the mnemotic does not start with `prefix`.
+			int condition_code(const opcode code, const char*const prefix)
+			{
+				static const std::map<std::string, int> codes = {
+					{"o",  0x0}, {"no",  0x1}, {"b",   0x2}, {"c",   0x2},
+					{"nae", 0x2}, {"ae", 0x3}, {"nb",  0x3}, {"nc",  0x3},
+					{"e",  0x4}, {"z",   0x4}, {"ne",  0x5}, {"nz",  0x5},
+					{"be", 0x6}, {"na",  0x6}, {"a",   0x7}, {"nbe", 0x7},
+					{"s",  0x8}, {"ns",  0x9}, {"p",   0xa}, {"pe",  0xa},
+					{"np", 0xb}, {"po",  0xb}, {"l",   0xc}, {"nge", 0xc},
+					{"ge", 0xd}, {"nl",  0xd}, {"le",  0xe}, {"ng",  0xe},
+					{"g",  0xf}, {"nle", 0xf},
+				};
+				const auto name = mnemotic(code);
+				const auto length = std::strlen(prefix);
+				if ((name == nullptr) || (std::strncmp(name, prefix, length) != 0)) {
+					return -1;
+				}
+				const auto pos = codes.find(name + length);
+				return (pos != codes.end()) ? pos->second : -1;
+			}
+
+			bool fits_int8(const std::int64_t value) noexcept
+			{
+				return (value >= std::numeric_limits<std::int8_t>::min())
+					&& (value <= std::numeric_limits<std::int8_t>::max());
+			}
+
+			bool fits_int32(const std::int64_t value) noexcept
+			{
+				return (value >= std::numeric_limits<std::int32_t>::min())
+					&& (value <= std::numeric_limits<std::int32_t>::max());
+			}
+
+			[[noreturn]] void cannot_encode(const real_instruction& instr)
+			{
+				const auto name = mnemotic(instr.code);
+				MINIJAVA_THROW_ICE_MSG(
+					internal_compiler_error,
+					std::string{"Cannot encode instruction "} + ((name != nullptr) ? name : "(none)")
+				);
+			}
+
+			// Encodes the instructions of a single function.
+			class function_encoder final
+			{
+			public:
+
+				function_encoder(const real_assembly& realasm, object_file& obj)
+					: _realasm{realasm}, _obj{obj}, _code{obj.text}
+				{
+				}
+
+				void encode()
+				{
+					for (const auto& block : _realasm.blocks) {
+						_block_labels.insert(block.label);
+					}
+					for (const auto& block : _realasm.blocks) {
+						if (!block.label.empty()) {
+							_local_labels[block.label] = _code.size();
+						}
+						for (const auto& instr : block.code) {
+							_encode(instr);
+						}
+					}
+					for (const auto& fixup : _fixups) {
+						const auto target = static_cast<std::int64_t>(_local_labels.at(fixup.first));
+						const auto next = static_cast<std::int64_t>(fixup.second + 4);
+						_patch_int32(fixup.second, target - next);
+					}
+				}
+
+			private:
+
+				const real_assembly& _realasm;
+				object_file& _obj;
+				std::vector<std::uint8_t>& _code;
+				std::set<std::string> _block_labels{};
+				std::map<std::string, std::size_t> _local_labels{};
+				std::vector<std::pair<std::string, std::size_t>> _fixups{};
+
+				void _byte(const int value)
+				{
+					_code.push_back(static_cast<std::uint8_t>(value));
+				}
+
+				void _int(const std::int64_t value, const int size)
+				{
+					for (int i = 0; i < size; ++i) {
+						_byte(static_cast<int>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xffU));
+					}
+				}
+
+				void _patch_int32(const std::size_t offset, const std::int64_t value)
+				{
+					assert(fits_int32(value));
+					for (std::size_t i = 0; i < 4; ++i) {
+						_code[offset + i] = static_cast<std::uint8_t>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xffU);
+					}
+				}
+
+				const std::string& _name(const label_id label) const
+				{
+					return _realasm.labels.name(label);
+				}
+
+				void _relocate(const label_id label, const relocation_kind kind, const std::int64_t addend)
+				{
+					auto rel = relocation{};
+					rel.section = object_section::text;
+					rel.offset = _code.size();
+					rel.symbol = _name(label);
+					rel.kind = kind;
+					rel.addend = addend;
+					_obj.relocations.push_back(std::move(rel));
+				}
+
+				// Emits the operand-size prefix, the REX prefix (if needed)
+				// and the opcode bytes followed by the ModR/M byte (and SIB
+				// byte and displacement) for the register or memory operand
+				// `rm` and the register number (or opcode extension) `reg`.
+				//
+				// If `regbyte` is set, `reg` names an 8 bit register and if
+				// `width` is 8 bit, `rm` may name an 8 bit register, both of
+				// which may require an empty REX prefix.
+				void _modrm(const std::vector<int>& opcodes, const bit_width width,
+				            const int reg, const bool regbyte, const real_operand& rm)
+				{
+					auto rex = (width == bit_width::lxiv) ? 0x48 : 0x00;
+					if (reg >= 8) {
+						rex |= 0x44;
+					}
+					const auto bytereg = [](const int enc){ return (enc >= 4) && (enc <= 7); };
+					if (regbyte && (width == bit_width::viii) && bytereg(reg)) {
+						rex |= 0x40;
+					}
+					const auto rmreg = get_register(rm);
+					const auto addr = get_address(rm);
+					const auto label = get_label(rm);
+					auto base = -1;
+					auto index = -1;
+					if (rmreg != nullptr) {
+						base = encoding(*rmreg);
+						if ((width == bit_width::viii) && bytereg(base)) {
+							rex |= 0x40;
+						}
+					} else if (addr != nullptr) {
+						if (addr->base) {
+							base = encoding(*addr->base);
+						}
+						if (addr->index) {
+							index = encoding(*addr->index);
+							assert(index != 4);
+						}
+					} else if (label == nullptr) {
+						MINIJAVA_THROW_ICE_MSG(internal_compiler_error, "Invalid register or memory operand");
+					}
+					if (base >= 8) {
+						rex |= 0x41;
+					}
+					if (index >= 8) {
+						rex |= 0x42;
+					}
+					if (width == bit_width::xvi) {
+						_byte(0x66);
+					}
+					if (rex != 0) {
+						_byte(rex);
+					}
+					for (const auto opc : opcodes) {
+						_byte(opc);
+					}
+					const auto regbits = (reg & 7) << 3;
+					if (rmreg != nullptr) {
+						_byte(0xc0 | regbits | (base & 7));
+						return;
+					}
+					if (label != nullptr) {
+						// absolute 32 bit address
+						_byte(0x04 | regbits);
+						_byte(0x25);
+						_relocate(*label, relocation_kind::abs32s, 0);
+						_int(0, 4);
+						return;
+					}
+					const auto disp = addr->constant ? static_cast<std::int64_t>(*addr->constant) : 0;
+					const auto scale = addr->scale ? static_cast<int>(*addr->scale) : 1;
+					const auto ss = (scale == 8) ? 3 : (scale == 4) ? 2 : (scale == 2) ? 1 : 0;
+					assert((scale == 1) || (scale == 2) || (scale == 4) || (scale == 8));
+					if (base < 0) {
+						// no base: always a 32 bit displacement
+						_byte(0x04 | regbits);
+						_byte((ss << 6) | (((index < 0) ? 4 : index) & 7) << 3 | 5);
+						_int(disp, 4);
+						return;
+					}
+					const auto mod = ((disp == 0) && ((base & 7) != 5)) ? 0x00 : fits_int8(disp) ? 0x40 : 0x80;
+					if ((index >= 0) || ((base & 7) == 4)) {
+						_byte(mod | regbits | 4);
+						_byte((ss << 6) | (((index < 0) ? 4 : index) & 7) << 3 | (base & 7));
+					} else {
+						_byte(mod | regbits | (base & 7));
+					}
+					if (mod == 0x40) {
+						_int(disp, 1);
+					} else if (mod == 0x80) {
+						_int(disp, 4);
+					}
+				}
+
+				// Emits a jump or call to the label `op` using a 32 bit
+				// displacement after the given opcode bytes.
+				void _branch(const std::vector<int>& opcodes, const real_instruction& instr, const bool call)
+				{
+					const auto label = get_label(instr.op1);
+					if (label == nullptr) {
+						cannot_encode(instr);
+					}
+					for (const auto opc : opcodes) {
+						_byte(opc);
+					}
+					const auto& name = _name(*label);
+					if (!call && _block_labels.count(name)) {
+						_fixups.emplace_back(name, _code.size());
+					} else {
+						_relocate(*label, call ? relocation_kind::plt32 : relocation_kind::pc32, -4);
+					}
+					_int(0, 4);
+				}
+
+				// Encodes the binary arithmetic instructions with the given
+				// opcode extension (ADD = 0, OR = 1, AND = 4, SUB = 5, XOR =
+				// 6, CMP = 7).
+				void _arithmetic(const real_instruction& instr, const int ext)
+				{
+					const auto width = instr.width;
+					const auto byte = (width == bit_width::viii) ? 0 : 1;
+					if (const auto imm = get_immediate(instr.op1)) {
+						const auto dstreg = get_register(instr.op2);
+						if ((width != bit_width::viii) && fits_int8(*imm)) {
+							_modrm({0x83}, width, ext, false, instr.op2);
+							_int(*imm, 1);
+						} else if (!fits_int32(*imm)) {
+							cannot_encode(instr);
+						} else if ((dstreg != nullptr) && (*dstreg == real_register::a)) {
+							_modrm_less_prefix(width);
+							_byte((ext << 3) | 4 | byte);
+							_int(*imm, (width == bit_width::viii) ? 1 : (width == bit_width::xvi) ? 2 : 4);
+						} else {
+							_modrm({0x80 | byte}, width, ext, false, instr.op2);
+							_int(*imm, (width == bit_width::viii) ? 1 : (width == bit_width::xvi) ? 2 : 4);
+						}
+					} else if (const auto srcreg = get_register(instr.op1)) {
+						_modrm({(ext << 3) | byte}, width, encoding(*srcreg), true, instr.op2);
+					} else if (const auto dstreg = get_register(instr.op2)) {
+						_modrm({(ext << 3) | 2 | byte}, width, encoding(*dstreg), true, instr.op1);
+					} else {
+						cannot_encode(instr);
+					}
+				}
+
+				// Emits the prefixes for an instruction without ModR/M byte
+				// that implicitly operates on the A register.
+				void _modrm_less_prefix(const bit_width width)
+				{
+					if (width == bit_width::xvi) {
+						_byte(0x66);
+					} else if (width == bit_width::lxiv) {
+						_byte(0x48);
+					}
+				}
+
+				void _mov(const real_instruction& instr)
+				{
+					const auto width = instr.width;
+					const auto byte = (width == bit_width::viii) ? 0 : 1;
+					if (const auto imm = get_immediate(instr.op1)) {
+						if (const auto dstreg = get_register(instr.op2)) {
+							const auto enc = encoding(*dstreg);
+							if ((width == bit_width::lxiv) && fits_int32(*imm)) {
+								_modrm({0xc7}, width, 0, false, instr.op2);
+								_int(*imm, 4);
+								return;
+							}
+							auto rex = (width == bit_width::lxiv) ? 0x48 : 0x00;
+							if (enc >= 8) {
+								rex |= 0x41;
+							}
+							if ((width == bit_width::viii) && (enc >= 4) && (enc <= 7)) {
+								rex |= 0x40;
+							}
+							if (width == bit_width::xvi) {
+								_byte(0x66);
+							}
+							if (rex != 0) {
+								_byte(rex);
+							}
+							_byte(((width == bit_width::viii) ? 0xb0 : 0xb8) | (enc & 7));
+							_int(*imm, static_cast<int>(width) / 8);
+							return;
+						}
+						if (!fits_int32(*imm)) {
+							cannot_encode(instr);
+						}
+						_modrm({0xc6 | byte}, width, 0, false, instr.op2);
+						_int(*imm, (width == bit_width::viii) ? 1 : (width == bit_width::xvi) ? 2 : 4);
+					} else if (const auto srcreg = get_register(instr.op1)) {
+						_modrm({0x88 | byte}, width, encoding(*srcreg), true, instr.op2);
+					} else if (const auto dstreg = get_register(instr.op2)) {
+						_modrm({0x8a | byte}, width, encoding(*dstreg), true, instr.op1);
+					} else {
+						cannot_encode(instr);
+					}
+				}
+
+				// Encodes an instruction that reads `op1` and writes to the
+				// register `op2` via the ModR/M operand.
+				void _load(const std::vector<int>& opcodes, const bit_width width, const real_instruction& instr)
+				{
+					const auto dstreg = get_register(instr.op2);
+					if (dstreg == nullptr) {
+						cannot_encode(instr);
+					}
+					_modrm(opcodes, width, encoding(*dstreg), true, instr.op1);
+				}
+
+				// Encodes an instruction with a single register or memory
+				// operand `op1` and the given opcode extension.
+				void _unary(const std::vector<int>& opcodes, const bit_width width, const int ext,
+				            const real_instruction& instr)
+				{
+					if (get_register(instr.op1) || get_address(instr.op1)) {
+						_modrm(opcodes, width, ext, false, instr.op1);
+					} else {
+						cannot_encode(instr);
+					}
+				}
+
+				void _encode(const real_instruction& instr)
+				{
+					const auto byte = (instr.width == bit_width::viii) ? 0 : 1;
+					switch (instr.code) {
+					case opcode::none:
+						return;
+					case opcode::op_mov:
+						_mov(instr);
+						return;
+					case opcode::op_movslq:
+						_load({0x63}, bit_width::lxiv, instr);
+						return;
+					case opcode::op_lea:
+						_load({0x8d}, bit_width::lxiv, instr);
+						return;
+					case opcode::op_add:
+						_arithmetic(instr, 0);
+						return;
+					case opcode::op_or:
+						_arithmetic(instr, 1);
+						return;
+					case opcode::op_and:
+						_arithmetic(instr, 4);
+						return;
+					case opcode::op_sub:
+						_arithmetic(instr, 5);
+						return;
+					case opcode::op_xor:
+						_arithmetic(instr, 6);
+						return;
+					case opcode::op_cmp:
+						_arithmetic(instr, 7);
+						return;
+					case opcode::op_test:
+						if (const auto srcreg = get_register(instr.op1)) {
+							_modrm({0x84 | byte}, instr.width, encoding(*srcreg), true, instr.op2);
+						} else if (const auto dstreg = get_register(instr.op2)) {
+							_modrm({0x84 | byte}, instr.width, encoding(*dstreg), true, instr.op1);
+						} else {
+							cannot_encode(instr);
+						}
+						return;
+					case opcode::op_imul:
+						if (const auto imm = get_immediate(instr.op1)) {
+							const auto dstreg = get_register(instr.op2);
+							if ((dstreg == nullptr) || !fits_int32(*imm) || (instr.width == bit_width::viii)) {
+								cannot_encode(instr);
+							}
+							const auto small = fits_int8(*imm);
+							_modrm({small ? 0x6b : 0x69}, instr.width, encoding(*dstreg), false, instr.op2);
+							_int(*imm, small ? 1 : (instr.width == bit_width::xvi) ? 2 : 4);
+						} else {
+							_load({0x0f, 0xaf}, instr.width, instr);
+						}
+						return;
+					case opcode::op_neg:
+						_unary({0xf6 | byte}, instr.width, 3, instr);
+						return;
+					case opcode::op_not:
+						_unary({0xf6 | byte}, instr.width, 2, instr);
+						return;
+					case opcode::op_idiv:
+						_unary({0xf6 | byte}, instr.width, 7, instr);
+						return;
+					case opcode::op_cqo:
+						_byte(0x48);
+						_byte(0x99);
+						return;
+					case opcode::op_push:
+						if (const auto reg = get_register(instr.op1)) {
+							const auto enc = encoding(*reg);
+							if (enc >= 8) {
+								_byte(0x41);
+							}
+							_byte(0x50 | (enc & 7));
+						} else if (const auto imm = get_immediate(instr.op1)) {
+							if (fits_int8(*imm)) {
+								_byte(0x6a);
+								_int(*imm, 1);
+							} else if (fits_int32(*imm)) {
+								_byte(0x68);
+								_int(*imm, 4);
+							} else {
+								cannot_encode(instr);
+							}
+						} else {
+							_unary({0xff}, bit_width{}, 6, instr);
+						}
+						return;
+					case opcode::op_pop:
+						if (const auto reg = get_register(instr.op1)) {
+							const auto enc = encoding(*reg);
+							if (enc >= 8) {
+								_byte(0x41);
+							}
+							_byte(0x58 | (enc & 7));
+						} else {
+							_unary({0x8f}, bit_width{}, 0, instr);
+						}
+						return;
+					case opcode::op_call:
+						_branch({0xe8}, instr, true);
+						return;
+					case opcode::op_jmp:
+						_branch({0xe9}, instr, false);
+						return;
+					case opcode::op_ret:
+						_byte(0xc3);
+						return;
+					case opcode::op_nop:
+						_byte(0x90);
+						return;
+					default:
+						break;
+					}
+					const auto jcc = condition_code(instr.code, "j");
+					const auto cmovcc = condition_code(instr.code, "cmov");
+					const auto setcc = condition_code(instr.code, "set");
+					if (jcc >= 0) {
+						_branch({0x0f, 0x80 | jcc}, instr, false);
+					} else if ((cmovcc >= 0) && (instr.width != bit_width::viii)) {
+						_load({0x0f, 0x40 | cmovcc}, instr.width, instr);
+					} else if (setcc >= 0) {
+						_unary({0x0f, 0x90 | setcc}, bit_width::viii, 0, instr);
+					} else {
+						cannot_encode(instr);
+					}
+				}
+
+			};
+
+		}  // namespace /* anonymous */
+
+
+		void encode_text(const real_assembly& realasm, const bool global, object_file& obj)
+		{
+			auto sym = object_symbol{};
+			sym.name = realasm.ldname;
+			sym.section = object_section::text;
+			sym.kind = symbol_kind::function;
+			sym.global = global;
+			sym.offset = obj.text.size();
+			auto encoder = function_encoder{realasm, obj};
+			encoder.encode();
+			sym.size = obj.text.size() - sym.offset;
+			obj.symbols.push_back(std::move(sym));
+		}
+
+	}  // namespace backend
+
+}  // namespace minijava
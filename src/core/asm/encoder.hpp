@@ -0,0 +1,49 @@
+/**
+ * @file encoder.hpp
+ *
+ * @brief
+ *     Binary encoding of x64 machine code.
+ *
+ */
+
+#pragma once
+
+#include "asm/assembly.hpp"
+#include "asm/elf.hpp"
+
+
+namespace minijava
+{
+
+	namespace backend
+	{
+
+		/**
+		 * @brief
+		 *     Encodes a macro-expanded function as x64 machine code and appends
+		 *     it to the text section of an object file.
+		 *
+		 * The function is defined as a symbol named after its linker name.
+		 * Jumps to labels of its own basic blocks are resolved directly, all
+		 * other references to names become relocations.  Branches are always
+		 * encoded with 32 bit displacements.
+		 *
+		 * Only the instructions that are produced by the backend are
+		 * supported.  If an instruction cannot be encoded, an
+		 * `internal_compiler_error` is `throw`n.
+		 *
+		 * @param realasm
+		 *     real assembly listing without macros
+		 *
+		 * @param global
+		 *     whether the function should be visible to other objects
+		 *
+		 * @param obj
+		 *     object file to append to
+		 *
+		 */
+		void encode_text(const real_assembly& realasm, bool global, object_file& obj);
+
+	}  // namespace backend
+
+}  // namespace minijava
@@ -6,6 +6,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <iterator>
 #include <map>
 #include <memory>
@@ -13,7 +14,6 @@
 #include <utility>
 #include <vector>
 
-#include <boost/variant/apply_visitor.hpp>
 #include <iostream>
 
 #include "exceptions.hpp"
@@ -233,6 +233,122 @@ namespace minijava
 				}
 			}
 
+			opcode get_conditional_move_op(const firm::ir_relation rel)
+			{
+				switch (rel) {
+				case firm::ir_relation_equal:
+					return opcode::op_cmove;
+				case firm::ir_relation_less:
+					return opcode::op_cmovl;
+				case firm::ir_relation_greater:
+					return opcode::op_cmovg;
+				case firm::ir_relation_less_equal:
+					return opcode::op_cmovle;
+				case firm::ir_relation_greater_equal:
+					return opcode::op_cmovge;
+				case firm::ir_relation_less_greater:  // a.k.a. "not equal"
+					return opcode::op_cmovne;
+				default:
+					MINIJAVA_NOT_IMPLEMENTED_MSG(firm::get_relation_string(rel));
+				}
+			}
+
+			bool is_const_with_value(firm::ir_node*const irn, const long value)
+			{
+				return firm::is_Const(irn)
+					&& (firm::get_tarval_long(firm::get_Const_tarval(irn)) == value);
+			}
+
+			// Largest allocation (in bytes) that is performed inline by
+			// bumping the heap pointer of the runtime.
+			constexpr long max_inline_allocation = 4096;
+
+			// If `irn` is a call to `mj_runtime_new` with constant arguments
+			// that can be served inline, `return`s the number of bytes to
+			// allocate (rounded up to a multiple of 8).  Otherwise, `return`s
+			// 0.  Calls that would fail at run-time are never inlined so the
+			// runtime can report the error.
+			long get_inline_allocation_size(firm::ir_node*const irn)
+			{
+				assert(firm::is_Call(irn));
+				const auto callee = firm::get_Call_callee(irn);
+				if (std::strcmp(firm::get_entity_ld_name(callee), "mj_runtime_new") != 0) {
+					return 0;
+				}
+				const auto nmembirn = firm::get_Call_param(irn, 0);
+				const auto sizeirn = firm::get_Call_param(irn, 1);
+				if (!firm::is_Const(nmembirn) || !firm::is_Const(sizeirn)) {
+					return 0;
+				}
+				const auto nmemb = firm::get_tarval_long(firm::get_Const_tarval(nmembirn));
+				const auto size = firm::get_tarval_long(firm::get_Const_tarval(sizeirn));
+				if ((nmemb < 0) || (size <= 0) || (nmemb > max_inline_allocation) || (size > max_inline_allocation)) {
+					return 0;
+				}
+				const auto bytes = (std::max(nmemb, 1L) * size + 7) / 8 * 8;
+				return (bytes <= max_inline_allocation) ? bytes : 0;
+			}
+
+
+			// A single copy that is part of the parallel copy performed by all
+			// (data) Phis of a block along one of its incoming edges.
+			struct phi_copy
+			{
+				virtual_register dst{};
+				virtual_operand src{};
+				bit_width width{};
+			};
+
+			// Turns the parallel copy `pending` into a sequence of moves.
+			// Copies whose source and destination are the same are dropped.
+			// A copy is performed as soon as its destination is no longer
+			// read by any other pending copy.  If no such copy exists, the
+			// remaining copies form cycles and one of them is broken by saving
+			// the blocked destination in a temporary obtained from
+			// `next_temp`.  This needs one move per copy plus one per cycle.
+			template <typename TempRegFuncT>
+			std::vector<virtual_instruction>
+			sequentialize_parallel_copy(std::vector<phi_copy> pending, TempRegFuncT&& next_temp)
+			{
+				const auto reads = [](const phi_copy& copy, const virtual_register reg){
+					const auto src = get_register(copy.src);
+					return (src != nullptr) && (*src == reg);
+				};
+				pending.erase(
+					std::remove_if(
+						std::begin(pending), std::end(pending),
+						[reads](const phi_copy& copy){ return reads(copy, copy.dst); }
+					),
+					std::end(pending)
+				);
+				auto code = std::vector<virtual_instruction>{};
+				while (!pending.empty()) {
+					const auto ready = std::find_if(
+						std::begin(pending), std::end(pending),
+						[&pending, reads](const phi_copy& copy){
+							return std::none_of(
+								std::begin(pending), std::end(pending),
+								[&copy, reads](const phi_copy& other){ return reads(other, copy.dst); }
+							);
+						}
+					);
+					if (ready != std::end(pending)) {
+						code.emplace_back(opcode::op_mov, ready->width, ready->src, ready->dst);
+						pending.erase(ready);
+						continue;
+					}
+					const auto blocked = pending.front().dst;
+					const auto temp = next_temp();
+					code.emplace_back(opcode::op_mov, bit_width::lxiv, blocked, temp);
+					for (auto& copy : pending) {
+						if (reads(copy, blocked)) {
+							copy.src = temp;
+						}
+					}
+				}
+				return code;
+			}
+
 
 			class bb_meta
 			{
@@ -240,8 +356,10 @@ namespace minijava
 
 				std::vector<virtual_instruction> body{};
 				std::vector<virtual_instruction> phis_on_cond_branch{};
+				std::vector<phi_copy> copies_on_cond_branch{};
 				std::vector<virtual_instruction> jump_on_cond_branch{};
 				std::vector<virtual_instruction> phis_on_fall_through{};
+				std::vector<phi_copy> copies_on_fall_through{};
 				std::vector<virtual_instruction> jump_on_fall_through{};
 
 				bb_meta(const std::size_t index) noexcept : _index{index}
@@ -421,6 +539,9 @@ namespace minijava
 					case firm::iro_Cond:
 						_visit_cond(irn);
 						break;
+					case firm::iro_Mux:
+						_visit_mux(irn);
+						break;
 					case firm::iro_Phi:
 						_visit_phi(irn);
 						break;
@@ -448,6 +569,7 @@ namespace minijava
 							return p->second.index() < q->second.index();
 						}
 					);
+					const auto next_temp = [this](){ return _next_data_register(); };
 					for (auto it : iterators) {
 						auto& meta = it->second;
 						const auto docopy = [](auto& dst, const auto& src){
@@ -460,18 +582,23 @@ namespace minijava
 						virtasm.blocks.emplace_back(make_label(it->first));
 						docopy(virtasm.blocks.back(), meta.body);
 						docopy(virtasm.blocks.back(), meta.jump_on_cond_branch);
+						// Flag Phis only read values so they must go before the
+						// parallel copy of the data Phis overwrites them.
 						virtasm.blocks.emplace_back(make_label_fall_through_phis(it->first));
 						docopy(virtasm.blocks.back(), meta.phis_on_fall_through);
+						docopy(virtasm.blocks.back(), sequentialize_parallel_copy(meta.copies_on_fall_through, next_temp));
 						docopy(virtasm.blocks.back(), meta.jump_on_fall_through);
 						virtasm.blocks.emplace_back(make_label_cond_branch_phis(it->first));
 						docopy(virtasm.blocks.back(), meta.phis_on_cond_branch);
+						docopy(virtasm.blocks.back(), sequentialize_parallel_copy(meta.copies_on_cond_branch, next_temp));
 						if (meta.get_succ_cond_branch()) {
 							virtasm.blocks.back().code.emplace_back(
 								opcode::op_jmp, bit_width{},
-								make_label(meta.get_succ_cond_branch())
+								_intern_label(make_label(meta.get_succ_cond_branch()))
 							);
 						}
 					}
+					virtasm.labels = std::move(_labels);
 					return virtasm;
 				}
 
@@ -484,6 +611,12 @@ namespace minijava
 				std::map<firm::ir_entity*, virtual_register> _addresses{};
 				firm::ir_node* _current_block{};
 				virtual_register _nextreg;
+				label_table _labels{};
+
+				label_id _intern_label(const std::string& name)
+				{
+					return _labels.intern(name);
+				}
 
 				bb_meta& _provide_bb(firm::ir_node*const blk)
 				{
@@ -581,6 +714,24 @@ namespace minijava
 					}
 				}
 
+				void _add_phi_copy(const bool taken,
+				                   firm::ir_node*const blksrc,
+				                   firm::ir_node*const blkdst,
+				                   phi_copy copy)
+				{
+					(void) blkdst;
+					assert(firm::is_Block(blksrc));
+					assert(firm::is_Block(blkdst));
+					auto& srcmeta = _provide_bb(blksrc);
+					if (taken) {
+						assert(srcmeta.get_succ_cond_branch() == blkdst);
+						srcmeta.copies_on_cond_branch.push_back(std::move(copy));
+					} else {
+						assert(srcmeta.get_succ_fall_through() == blkdst);
+						srcmeta.copies_on_fall_through.push_back(std::move(copy));
+					}
+				}
+
 				virtual_operand _get_irn_as_operand(firm::ir_node*const irn)
 				{
 					assert(can_be_in_register(irn));
@@ -624,7 +775,7 @@ namespace minijava
 					assert(firm::is_Start(irn));
 					const auto blk = _blockmap.at(irn);
 					_metamap.at(nullptr).jump_on_fall_through.emplace_back(
-						opcode::op_jmp, bit_width{}, make_label(blk)
+						opcode::op_jmp, bit_width{}, _intern_label(make_label(blk))
 					);
 				}
 
@@ -742,7 +893,7 @@ namespace minijava
 					}
 					const auto ldname = firm::get_entity_ld_name(entity);
 					const auto reg = _next_data_register();
-					_emplace_instruction(opcode::op_lea, bit_width{}, ldname, reg);
+					_emplace_instruction(opcode::op_lea, bit_width{}, _intern_label(ldname), reg);
 					_addresses[entity] = reg;
 					_set_register(irn, reg);
 				}
@@ -781,6 +932,26 @@ namespace minijava
 					const auto arg_arity = firm::get_method_n_params(method_type);
 					const auto res_arity = firm::get_method_n_ress(method_type);
 					assert(arg_arity <= INT_MAX);  // libfirm's randomly chosen integer types...
+					if (const auto bytes = get_inline_allocation_size(irn)) {
+						const auto resreg = _next_data_register();
+						_emplace_instruction(opcode::mac_new, bit_width::lxiv, std::int64_t{bytes}, resreg);
+						_set_register(irn, resreg);
+						return;
+					}
+					const auto ldname = firm::get_entity_ld_name(method_entity);
+					if (std::strcmp(ldname, "mj_runtime_write") == 0) {
+						// The byte is stored in the output buffer inline.
+						const auto node = firm::get_Call_param(irn, 0);
+						_emplace_instruction(opcode::mac_write, bit_width::xxxii, _get_irn_as_operand(node));
+						return;
+					}
+					if (std::strcmp(ldname, "mj_runtime_read") == 0) {
+						// The byte is taken from the input buffer inline.
+						const auto resreg = _next_data_register();
+						_emplace_instruction(opcode::mac_read, bit_width::xxxii, resreg);
+						_set_register(irn, resreg);
+						return;
+					}
 					auto argreg = virtual_register::argument;
 					for (auto i = 0; i < static_cast<int>(arg_arity); ++i) {
 						const auto node = firm::get_Call_param(irn, i);
@@ -790,7 +961,7 @@ namespace minijava
 						_emplace_instruction(opcode::op_mov, width, srcval, argreg);
 						argreg = next_argument_register(argreg);
 					}
-					const auto label = firm::get_entity_ld_name(method_entity);
+					const auto label = _intern_label(ldname);
 					_emplace_instruction(opcode::mac_call_aligned, bit_width{}, label);
 					if (res_arity) {
 						assert(res_arity == 1);
@@ -823,6 +994,60 @@ namespace minijava
 					_set_register(irn, virtual_register::flags);
 				}
 
+				void _visit_mux(firm::ir_node*const irn)
+				{
+					assert(firm::is_Mux(irn));
+					const auto selector = firm::get_Mux_sel(irn);
+					const auto falseirn = firm::get_Mux_false(irn);
+					const auto trueirn = firm::get_Mux_true(irn);
+					if (!firm::is_Cmp(selector) || is_flag(falseirn) || is_flag(trueirn)) {
+						// These should have been lowered to control flow.
+						MINIJAVA_NOT_IMPLEMENTED_MSG(firm::get_irn_opname(selector));
+					}
+					const auto width = get_width(irn);
+					const auto dstreg = _next_data_register();
+					auto relation = firm::get_Cmp_relation(selector);
+					const auto lhsirn = firm::get_Cmp_left(selector);
+					const auto rhsirn = firm::get_Cmp_right(selector);
+					const auto cmpwidth = std::max(get_width(lhsirn), get_width(rhsirn));
+					const auto is_bool_result = (width == bit_width::viii);
+					if (is_bool_result && is_const_with_value(falseirn, 0) && is_const_with_value(trueirn, 1)) {
+						// Materialized comparison: use SETcc directly.
+					} else if (is_bool_result && is_const_with_value(falseirn, 1) && is_const_with_value(trueirn, 0)) {
+						// Negated materialized comparison.  Negating sets the
+						// unordered bit which is meaningless for integers.
+						relation = static_cast<firm::ir_relation>(
+							firm::get_negated_relation(relation) & ~firm::ir_relation_unordered
+						);
+					} else {
+						// CMOVcc cannot take an immediate source operand and
+						// is not available for 8 bit operands.  Since every
+						// register has a full quad word, using a wider width
+						// is harmless.
+						const auto movwidth = std::max(width, bit_width::xxxii);
+						const auto falseval = _get_irn_as_operand(falseirn);
+						auto truereg = virtual_register::dummy;
+						if (firm::is_Const(trueirn)) {
+							truereg = _next_data_register();
+							_emplace_instruction(opcode::op_mov, width, _get_irn_as_operand(trueirn), truereg);
+						} else {
+							truereg = _get_data_register(trueirn);
+						}
+						_emplace_instruction(opcode::op_mov, width, falseval, dstreg);
+						const auto lhsreg = _get_irn_as_register_operand(lhsirn);
+						const auto rhsval = _get_irn_as_operand(rhsirn);
+						_emplace_instruction(opcode::op_cmp, cmpwidth, rhsval, lhsreg);
+						_emplace_instruction(get_conditional_move_op(relation), movwidth, truereg, dstreg);
+						_set_register(irn, dstreg);
+						return;
+					}
+					const auto lhsreg = _get_irn_as_register_operand(lhsirn);
+					const auto rhsval = _get_irn_as_operand(rhsirn);
+					_emplace_instruction(opcode::op_cmp, cmpwidth, rhsval, lhsreg);
+					_emplace_instruction(get_conditional_set_op(relation), bit_width{}, dstreg);
+					_set_register(irn, dstreg);
+				}
+
 				void _visit_jmp(firm::ir_node*const irn)
 				{
 					assert(firm::is_Jmp(irn));
@@ -830,7 +1055,7 @@ namespace minijava
 					const auto targirn = firm::get_irn_out(irn, 0);
 					const auto targblk = _blockmap.at(targirn);
 					_emplace_fall_through_jump(
-						opcode::op_jmp, bit_width{}, make_label(targblk)
+						opcode::op_jmp, bit_width{}, _intern_label(make_label(targblk))
 					);
 				}
 
@@ -838,8 +1063,8 @@ namespace minijava
 				{
 					assert(firm::is_Cond(irn));
 					const auto targets = get_cond_targets(irn);
-					const auto thenlab = make_label_cond_branch_phis(_current_block);
-					const auto elselab = make_label(targets.else_block);
+					const auto thenlab = _intern_label(make_label_cond_branch_phis(_current_block));
+					const auto elselab = _intern_label(make_label(targets.else_block));
 					const auto selector = firm::get_Cond_selector(irn);
 					if (firm::is_Cmp(selector)) {
 						const auto lhsirn = firm::get_Cmp_left(selector);
@@ -906,10 +1131,7 @@ namespace minijava
 						const auto phiblk = me->_blockmap.at(irn);
 						const auto predval = me->_get_irn_as_operand(predirn);
 						const auto width = get_width(irn);
-						me->_emplace_instruction_before_jmp(
-							taken, predblk, phiblk,
-							opcode::op_mov, width, predval, phireg
-						);
+						me->_add_phi_copy(taken, predblk, phiblk, {phireg, predval, width});
 					};
 					_visit_phi_generic(irn, foreach);
 				}
@@ -8,11 +8,13 @@
 
 #pragma once
 
+#include <cassert>
 #include <cstdint>
-#include <string>
+#include <type_traits>
+#include <utility>
 
-#include <boost/optional.hpp>
-#include <boost/variant.hpp>
+#include <boost/blank.hpp>
+#include <boost/none.hpp>
 
 #include "asm/opcode.hpp"
 #include "asm/register.hpp"
@@ -24,6 +26,104 @@ namespace minijava
 	namespace backend
 	{
 
+		/**
+		 * @brief
+		 *     Identifier of a label in the label table of an `assembly`.
+		 *
+		 * Labels are interned per function so operands referring to them
+		 * only need to store this small integer instead of a string.
+		 *
+		 */
+		enum class label_id : std::uint32_t {};
+
+
+		/**
+		 * @brief
+		 *     Optional component of an address.
+		 *
+		 * This is a minimal, trivially copyable replacement for
+		 * `boost::optional` that only supports the operations needed by
+		 * `address`.  It stores the value in place next to a flag so an
+		 * `address` has a fixed size and layout.
+		 *
+		 * @tparam T
+		 *     trivially copyable value type
+		 *
+		 */
+		template <typename T>
+		struct address_field final
+		{
+
+			/** @brief Creates an absent field. */
+			constexpr address_field() noexcept = default;
+
+			/** @brief Creates an absent field. */
+			constexpr address_field(boost::none_t) noexcept {}
+
+			/**
+			 * @brief
+			 *     Creates a present field with the given value.
+			 *
+			 * @param value
+			 *     value of the field
+			 *
+			 */
+			constexpr address_field(const T value) noexcept
+				: _value{value}, _present{true}
+			{
+			}
+
+			/**
+			 * @brief
+			 *     Tests whether the field is present.
+			 *
+			 * @returns
+			 *     whether the field is present
+			 *
+			 */
+			constexpr explicit operator bool() const noexcept
+			{
+				return _present;
+			}
+
+			/**
+			 * @brief
+			 *     `return`s the value of a present field.
+			 *
+			 * @returns
+			 *     value of the field
+			 *
+			 */
+			constexpr const T& operator*() const noexcept
+			{
+				return _value;
+			}
+
+			/**
+			 * @brief
+			 *     `return`s the value of a present field.
+			 *
+			 * @returns
+			 *     value of the field
+			 *
+			 */
+			const T& get() const noexcept
+			{
+				assert(_present);
+				return _value;
+			}
+
+		private:
+
+			/** @brief Value of the field (meaningless if not present). */
+			T _value{};
+
+			/** @brief Whether the field is present. */
+			bool _present{};
+
+		};
+
+
 		/**
 		 * @brief
 		 *     An x64 address.
@@ -37,16 +137,16 @@ namespace minijava
 		{
 
 			/** @brief Constant offset. */
-			boost::optional<std::int32_t> constant{};
+			address_field<std::int32_t> constant{};
 
 			/** @brief Base register. */
-			boost::optional<RegT> base{};
+			address_field<RegT> base{};
 
 			/** @brief Index register (must not be SP). */
-			boost::optional<RegT> index{};
+			address_field<RegT> index{};
 
 			/** @brief Element size (must be 1, 2, 4, or 8). */
-			boost::optional<std::int8_t> scale{};
+			address_field<std::int8_t> scale{};
 
 		};
 
@@ -70,27 +170,171 @@ namespace minijava
 		 *    (accessible via `get_register`)
 		 *  - `address` is used for addresses
 		 *    (accessible via `get_address`)
-		 *  - `std::string` is used for names (labels)
-		 *    (accessible via `get_name`)
+		 *  - `label_id` is used for names (labels)
+		 *    (accessible via `get_label`)
 		 *
 		 * Since these types are not self-explanatory, instead of accessing
 		 * them directly, the use of the `get_*` functions is recommended.
 		 *
-		 * The name is stored in a `std::string` rather than in a
-		 * `boost::string_ref` because people will want to store labels in
-		 * `std::string`s which might use SSO so moving the referenced
-		 * `std::string` would cause the referenced pointer to dangle.  Making
-		 * a copy is a potentially wasteful but effectiveway to avoid this
-		 * problem.  A smarter way could certeinly be thought of but at this
-		 * time, there are no human resources left to waste on debugging
-		 * awkward memory access bugs.
+		 * Unlike a `boost::variant` holding a `std::string`, this type is
+		 * trivially copyable and never allocates.  Names are not stored in
+		 * the operand but interned in the `label_table` of the `assembly`
+		 * the instruction belongs to.
 		 *
 		 * @tparam RegT
 		 *     register type (virtual or real)
 		 *
 		 */
 		template <typename RegT>
-		using operand = boost::variant<boost::blank, std::int64_t, RegT, address<RegT>, std::string>;
+		class operand final
+		{
+		public:
+
+			/** @brief Type of the value stored in an operand. */
+			enum class kind : std::uint8_t
+			{
+				none,       ///< no operand (`boost::blank`)
+				immediate,  ///< `std::int64_t`
+				reg,        ///< `RegT`
+				addr,       ///< `address<RegT>`
+				label,      ///< `label_id`
+			};
+
+			/** @brief Creates an empty operand. */
+			operand() noexcept {}
+
+			/** @brief Creates an empty operand. */
+			operand(boost::blank) noexcept {}
+
+			/**
+			 * @brief
+			 *     Creates an immediate operand.
+			 *
+			 * @param imm
+			 *     value of the immediate
+			 *
+			 */
+			operand(const std::int64_t imm) noexcept : _kind{kind::immediate}
+			{
+				_value.imm = imm;
+			}
+
+			/**
+			 * @brief
+			 *     Creates a register operand.
+			 *
+			 * @param reg
+			 *     register
+			 *
+			 */
+			operand(const RegT reg) noexcept : _kind{kind::reg}
+			{
+				_value.reg = reg;
+			}
+
+			/**
+			 * @brief
+			 *     Creates an address operand.
+			 *
+			 * @param addr
+			 *     address
+			 *
+			 */
+			operand(const address<RegT>& addr) noexcept : _kind{kind::addr}
+			{
+				_value.addr = addr;
+			}
+
+			/**
+			 * @brief
+			 *     Creates a name operand.
+			 *
+			 * @param label
+			 *     interned label
+			 *
+			 */
+			operand(const label_id label) noexcept : _kind{kind::label}
+			{
+				_value.label = label;
+			}
+
+			/**
+			 * @brief
+			 *     `return`s the type of the value stored in the operand.
+			 *
+			 * @returns
+			 *     type of the value
+			 *
+			 */
+			kind which() const noexcept
+			{
+				return _kind;
+			}
+
+			/**
+			 * @brief
+			 *     Calls the overload of `visitor` that accepts the stored
+			 *     value and `return`s its result.
+			 *
+			 * The visitor must be callable with `boost::blank`,
+			 * `std::int64_t`, `RegT`, `const address<RegT>&` and `label_id`.
+			 *
+			 * @tparam VisitorT
+			 *     type of the visitor
+			 *
+			 * @param visitor
+			 *     visitor to call
+			 *
+			 * @returns
+			 *     result of the visitor
+			 *
+			 */
+			template <typename VisitorT>
+			auto apply_visitor(VisitorT&& visitor) const
+				-> decltype(visitor(boost::blank{}));
+
+			/** @brief Pointer to the immediate or `nullptr`. */
+			const std::int64_t* immediate_ptr() const noexcept
+			{
+				return (_kind == kind::immediate) ? &_value.imm : nullptr;
+			}
+
+			/** @brief Pointer to the register or `nullptr`. */
+			const RegT* register_ptr() const noexcept
+			{
+				return (_kind == kind::reg) ? &_value.reg : nullptr;
+			}
+
+			/** @brief Pointer to the address or `nullptr`. */
+			const address<RegT>* address_ptr() const noexcept
+			{
+				return (_kind == kind::addr) ? &_value.addr : nullptr;
+			}
+
+			/** @brief Pointer to the label or `nullptr`. */
+			const label_id* label_ptr() const noexcept
+			{
+				return (_kind == kind::label) ? &_value.label : nullptr;
+			}
+
+		private:
+
+			/** @brief Storage for the value (active member is `_kind`). */
+			union storage
+			{
+				std::int64_t imm = 0;
+				RegT reg;
+				address<RegT> addr;
+				label_id label;
+			};
+
+			/** @brief Type of the stored value. */
+			kind _kind{kind::none};
+
+			/** @brief Stored value. */
+			storage _value{};
+
+		};
 
 		/** @brief Type for operandes using virtual registers. */
 		using virtual_operand = operand<virtual_register>;
@@ -115,7 +359,7 @@ namespace minijava
 		template <typename RegT>
 		bool empty(const operand<RegT>& op) noexcept
 		{
-			return boost::get<boost::blank>(&op);
+			return op.which() == operand<RegT>::kind::none;
 		}
 
 		/**
@@ -136,7 +380,7 @@ namespace minijava
 		template <typename RegT>
 		const std::int64_t* get_immediate(const operand<RegT>& op) noexcept
 		{
-			return boost::get<std::int64_t>(&op);
+			return op.immediate_ptr();
 		}
 
 		/**
@@ -157,7 +401,7 @@ namespace minijava
 		template <typename RegT>
 		const RegT* get_register(const operand<RegT>& op) noexcept
 		{
-			return boost::get<RegT>(&op);
+			return op.register_ptr();
 		}
 
 		/**
@@ -178,13 +422,16 @@ namespace minijava
 		template <typename RegT>
 		const address<RegT>* get_address(const operand<RegT>& op) noexcept
 		{
-			return boost::get<address<RegT>>(&op);
+			return op.address_ptr();
 		}
 
 		/**
 		 * @brief
-		 *     `return`s a pointer to the name value of an operand or
-		 *     `nullptr` if the operand is not a name.
+		 *     `return`s a pointer to the label of an operand or `nullptr` if
+		 *     the operand is not a name.
+		 *
+		 * The name itself can be looked up in the `label_table` of the
+		 * `assembly` the operand belongs to.
 		 *
 		 * @tparam RegT
 		 *     register type (virtual or real)
@@ -193,13 +440,13 @@ namespace minijava
 		 *     operand
 		 *
 		 * @returns
-		 *     pointer to name
+		 *     pointer to label
 		 *
 		 */
 		template <typename RegT>
-		const std::string* get_name(const operand<RegT>& op) noexcept
+		const label_id* get_label(const operand<RegT>& op) noexcept
 		{
-			return boost::get<std::string>(&op);
+			return op.label_ptr();
 		}
 
 		/**
@@ -272,6 +519,9 @@ namespace minijava
 		/** @brief Type for x64 instructions using real registers. */
 		using real_instruction = instruction<real_register>;
 
+		static_assert(std::is_trivially_copyable<virtual_instruction>{}, "");
+		static_assert(std::is_trivially_copyable<real_instruction>{}, "");
+
 		/**
 		 * @brief
 		 *     Returns the bit widths of the operands of the given instruction.
@@ -5,6 +5,8 @@
 #include <cassert>
 #include <utility>
 
+#include "exceptions.hpp"
+
 
 namespace minijava
 {
@@ -12,6 +14,26 @@ namespace minijava
 	namespace backend
 	{
 
+		template <typename RegT>
+		template <typename VisitorT>
+		auto operand<RegT>::apply_visitor(VisitorT&& visitor) const
+			-> decltype(visitor(boost::blank{}))
+		{
+			switch (_kind) {
+			case kind::none:
+				return visitor(boost::blank{});
+			case kind::immediate:
+				return visitor(_value.imm);
+			case kind::reg:
+				return visitor(_value.reg);
+			case kind::addr:
+				return visitor(_value.addr);
+			case kind::label:
+				return visitor(_value.label);
+			}
+			MINIJAVA_NOT_REACHED();
+		}
+
 		template <typename RegT>
 		std::pair<bit_width, bit_width> get_operand_widths(const instruction<RegT>& instr)
 		{
@@ -6,7 +6,6 @@
 #include <string>
 
 #include <boost/utility/string_ref.hpp>
-#include <boost/variant/apply_visitor.hpp>
 
 #include "asm/instruction.hpp"
 #include "exceptions.hpp"
@@ -113,15 +112,17 @@ namespace minijava
 			// Returns the AT&T representation of an operand or the empty
 			// string if `empty(op)`.
 			template <typename RegT>
-			std::string format(const operand<RegT>& op, const bit_width width)
+			std::string format(const operand<RegT>& op, const bit_width width, const label_table& labels)
 			{
 				using namespace std::string_literals;
 				using address_type = address<RegT>;
-				struct visitor : boost::static_visitor<std::string>
+				struct visitor
 				{
 					bit_width width;
 
-					visitor(const bit_width bw) : width{bw} {}
+					const label_table& labels;
+
+					visitor(const bit_width bw, const label_table& lt) : width{bw}, labels{lt} {}
 
 					std::string operator()(const boost::blank) const
 					{
@@ -143,75 +144,87 @@ namespace minijava
 						return format(addr, bit_width::lxiv);
 					}
 
-					std::string operator()(const boost::string_ref name) const
+					std::string operator()(const label_id label) const
 					{
-						return std::string{name.data(), name.size()};
+						return this->labels.name(label);
 					}
 
 				};
-				return boost::apply_visitor(visitor{width}, op);
+				return op.apply_visitor(visitor{width, labels});
 			}
 
-			void write_label(const boost::string_ref label, file_output& out)
+			void append_label(const boost::string_ref label, std::string& text)
 			{
-				// Cannot use `print()` because `boost::string_ref` is not NUL
-				// terminated.
 				if (!label.empty()) {
-					out.write(label.data(), label.size());
-					out.write(":\n");
+					text.append(label.data(), label.size());
+					text += ":\n";
 				}
 			}
 
 			template <typename RegT>
-			void write_text_impl(const assembly<RegT>& assembly, file_output& out)
+			std::string format_text_impl(const assembly<RegT>& assembly)
 			{
+				const auto& ldname = assembly.ldname;
+				auto text = std::string{};
 				if (MINIJAVA_WINDOWS_ASSEMBLY) {
-					out.print("\t.def %s; .scl 2; .type 32; .endef\n", assembly.ldname.c_str());
+					text += "\t.def " + ldname + "; .scl 2; .type 32; .endef\n";
 				} else {
-					out.print("\t.type %s, @function\n", assembly.ldname.c_str());
+					text += "\t.type " + ldname + ", @function\n";
 				}
-				write_label(assembly.ldname, out);
+				append_label(ldname, text);
 				for (const auto& bb : assembly.blocks) {
-					write_label(bb.label, out);
+					append_label(bb.label, text);
 					for (const auto& instr : bb.code) {
 						const auto mnemotic = format(instr.code, instr.width);
 						if (mnemotic.empty()) {
 							continue;
 						}
 						const auto width = get_operand_widths(instr);
-						const auto op1 = format(instr.op1, width.first);
-						const auto op2 = format(instr.op2, width.second);
+						const auto op1 = format(instr.op1, width.first, assembly.labels);
+						const auto op2 = format(instr.op2, width.second, assembly.labels);
 						const auto arity = 0 + !op2.empty() + !op1.empty();
+						text += '\t';
+						text += mnemotic;
 						switch (arity) {
 						case 0:
-							out.print("\t%s\n", mnemotic.c_str());
 							break;
 						case 1:
-							out.print("\t%s %s\n", mnemotic.c_str(), op1.c_str());
+							text += ' ';
+							text += op1;
 							break;
 						case 2:
-							out.print("\t%s %s, %s\n", mnemotic.c_str(), op1.c_str(), op2.c_str());
+							text += ' ';
+							text += op1;
+							text += ", ";
+							text += op2;
 							break;
 						default:
 							MINIJAVA_NOT_REACHED();
 						}
+						text += '\n';
 					}
 				}
 				if (!MINIJAVA_WINDOWS_ASSEMBLY) {
-					out.print("\t.size %s, .-%s\n", assembly.ldname.c_str(), assembly.ldname.c_str());
+					text += "\t.size " + ldname + ", .-" + ldname + "\n";
 				}
+				return text;
 			}
 
 		}  // namespace /* anonymous */
 
 		void write_text(const virtual_assembly& asmcode, file_output& out)
 		{
-			write_text_impl(asmcode, out);
+			out.write(format_text_impl(asmcode));
+		}
+
+		std::string format_text(const real_assembly& asmcode)
+		{
+			return format_text_impl(asmcode);
 		}
 
 		void write_text(const real_assembly& asmcode, file_output& out)
 		{
-			write_text_impl(asmcode, out);
+			out.write(format_text_impl(asmcode));
 		}
 
 	}  // namespace backend
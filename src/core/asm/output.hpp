@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "asm/assembly.hpp"
 #include "io/file_output.hpp"
 
@@ -45,6 +47,23 @@ namespace minijava
 		 */
 		void write_text(const real_assembly& realasm, file_output& out);
 
+		/**
+		 * @brief
+		 *     Formats x64 assembly code in AT&T syntax as a string.
+		 *
+		 * The text is the same that `write_text` would write.  Since the
+		 * function only reads `realasm`, it may be called for different
+		 * functions on different threads at the same time.
+		 *
+		 * @param realasm
+		 *     real assembly listing to format
+		 *
+		 * @returns
+		 *     assembly text
+		 *
+		 */
+		std::string format_text(const real_assembly& realasm);
+
 	}  // namespace backend
 
 }  // namespace minijava
@@ -1,8 +1,13 @@
 #include "cli.hpp"
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
+#include <ctime>
 #include <initializer_list>
 #include <iterator>
+#include <memory>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -13,6 +18,7 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/program_options.hpp>
@@ -21,6 +27,7 @@
 #include "asm/firm_backend.hpp"
 #include "exceptions.hpp"
 #include "global.hpp"
+#include "io/compilation_cache.hpp"
 #include "io/file_cleanup.hpp"
 #include "io/file_data.hpp"
 #include "io/file_output.hpp"
@@ -29,13 +36,19 @@
 #include "lexer/token_iterator.hpp"
 #include "opt/opt.hpp"
 #include "parser/ast_misc.hpp"
+#include "parser/parallel_parser.hpp"
 #include "parser/parser.hpp"
 #include "runtime/host_cc.hpp"
+#include "runtime/jit.hpp"
 #include "semantic/semantic.hpp"
 #include "source_error.hpp"
+#include "symbol/concurrent_symbol_pool.hpp"
 #include "symbol/symbol_pool.hpp"
 #include "system/logger.hpp"
+#include "system/server.hpp"
 #include "system/system.hpp"
+#include "system/workers.hpp"
+#include "util/sha256.hpp"
 
 
 namespace algo = boost::algorithm;
@@ -71,12 +84,52 @@ namespace minijava
 			// Name of the input file (may be `-` to read from stdin).
 			std::string input{};
 
+			// Names of all input files given on the command-line.
+			std::vector<std::string> inputs{};
+
+			// Compile each input file into its own executable?
+			bool batch = false;
+
+			// Name of a file with additional input files for batch mode
+			// (may be `-` to read from stdin).
+			std::string batch_file{};
+
+			// Number of worker processes for batch mode.
+			unsigned int workers = 1;
+
+			// Name of the socket to listen on for compile requests (empty
+			// unless running as a server).
+			std::string serve{};
+
+			// Directory of the compilation cache (empty if no cache should
+			// be used).
+			std::string cache{};
+
+			// Maximum size of the compilation cache in MiB.
+			unsigned int cache_size = 256;
+
+			// Print statistics of the compilation cache when done?
+			bool cache_stats = false;
+
 			// Name of the output file (may be `-` to write to stdout).
 			std::string output{};
 
 			// Name of the C compiler executable (for linking the runtime)
 			std::string cc{};
 
+			// Assemble textual assembly with the C compiler instead of
+			// emitting object code directly?
+			bool host_assembler = false;
+
+			// Run the program in-process instead of writing an executable?
+			bool run = false;
+
+			// Number of threads to use for compiling a single program.
+			unsigned int jobs = 1;
+
+			// Implementation of the runtime support library to link
+			runtime_library runtime = runtime_library::libc;
+
 			// Prevent output to the log?
 			bool quiet = false;
 
@@ -122,7 +175,9 @@ namespace minijava
 		// the option groups to include in the help text.
 		void print_help(file_output& out, std::initializer_list<po::options_description*> groups)
 		{
-			out.print("usage: %s [OPTIONS] FILE\n\n", MINIJAVA_PROJECT_NAME);
+			out.print("usage: %s [OPTIONS] FILE\n", MINIJAVA_PROJECT_NAME);
+			out.print("       %s --batch [OPTIONS] [FILE...]\n", MINIJAVA_PROJECT_NAME);
+			out.print("       %s --serve SOCKET [--cc CC] [--nolibc]\n\n", MINIJAVA_PROJECT_NAME);
 			auto oss = std::ostringstream{};
 			for (auto&& gp : groups) {
 				oss << *gp << '\n';
@@ -247,6 +302,26 @@ namespace minijava
 		}
 
 
+		// Checks that the options in `setup` can be used in batch mode and
+		// `throw`s a `po::error` with an appropriate message otherwise.
+		void check_batch_options(const program_setup& setup)
+		{
+			if (setup.run) {
+				throw po::error{"Option --run cannot be combined with --batch"};
+			}
+			const auto stage = setup.stage;
+			if ((stage != compilation_stage{})
+			    && (stage != compilation_stage::parser)
+			    && (stage != compilation_stage::semantic)
+			    && (stage != compilation_stage::compile_firm)) {
+				throw po::error{"Option --batch can only be combined with --parsetest, --check or --compile-firm"};
+			}
+			if (setup.workers < 1) {
+				throw po::error{"Option --workers needs at least one worker"};
+			}
+		}
+
+
 		// Parses the command-line arguments in `args` (which must include the
 		// executable path, or any dummy string, as its first element) and sets
 		// the values of `setup` accordingly.  If the command-line was not
@@ -276,10 +351,27 @@ namespace minijava
 			auto other = po::options_description{"Other Options"};
 			other.add_options()
 				("cc", po::value<std::string>(&setup.cc)->default_value(get_default_c_compiler()), "C compiler to use for linking the runtime")
+				("host-assembler", "emit textual assembly and assemble it using the C compiler instead of writing object code directly (always done on hosts other than x86-64 Linux)")
+				("nolibc", "link a runtime that uses Linux system calls directly instead of the C library (x86-64 Linux only)")
+				("run", "run the program in-process instead of writing an executable")
+				("jobs,j", po::value<unsigned int>(&setup.jobs)->default_value(1), "number of threads to use for parsing, semantic analysis and code generation; the output does not depend on it")
 				("output", po::value<std::string>(&setup.output)->default_value("-"), "redirect output to file");
+			auto batch = po::options_description{"Batch Compilation"};
+			batch.add_options()
+				("batch", "compile each input file into its own executable in a single process; the executables are put into the directory given by --output or next to the input files")
+				("batch-file", po::value<std::string>(&setup.batch_file), "read additional input files for --batch from a file with one name per line, optionally followed by a tab and the name of the executable (implies --batch)")
+				("workers", po::value<unsigned int>(&setup.workers)->default_value(1), "number of worker processes to use for --batch");
+			auto cache = po::options_description{"Compilation Cache"};
+			cache.add_options()
+				("cache", po::value<std::string>(&setup.cache), "reuse the results of earlier compilations of the same program with the same options from a cache in the given directory (applies to --parsetest, --check, --compile-firm and normal compilation)")
+				("cache-size", po::value<unsigned int>(&setup.cache_size)->default_value(256), "maximum size of the cache in MiB; the least recently used results are removed first")
+				("cache-stats", "print statistics of the cache when done");
+			auto server = po::options_description{"Compiler Server"};
+			server.add_options()
+				("serve", po::value<std::string>(&setup.serve), "keep running and compile the programs sent by minijava-client over the Unix socket with the given name, sharing the Firm state and the precompiled runtime between them");
 			auto inputfiles = po::options_description{"Input Files"};
 			inputfiles.add_options()
-				("input", po::value<std::string>(&setup.input)->default_value("-"), "");
+				("input", po::value<std::vector<std::string>>(&setup.inputs), "");
 			auto opts = po::options_description{"Optimization"};
 			opts.add_options()
 				("O,O", po::value<unsigned int>(), "Optimization level (-O0, -O1, -O3)")
@@ -287,15 +379,15 @@ namespace minijava
 				("opts", po::value<std::string>(), "turn on specific optimizations")
 				("opts-ordered", po::value<std::string>(), "turn on specific optimizations in defined order");
 			auto options = po::options_description{};
-			options.add(generic).add(interception).add(other).add(inputfiles).add(opts);
+			options.add(generic).add(interception).add(other).add(batch).add(cache).add(server).add(inputfiles).add(opts);
 			auto positional = po::positional_options_description{};
-			positional.add("input", 1);
+			positional.add("input", -1);
 			auto varmap = po::variables_map{};
 			const int argc = static_cast<int>(args.size());  // safe cast
 			po::store(po::command_line_parser(argc, args.data())
 			         .options(options).positional(positional).run(), varmap);
 			if (varmap.count("help")) {
-				print_help(out, {&generic, &interception, &opts, &other});
+				print_help(out, {&generic, &interception, &opts, &other, &batch, &cache, &server});
 				return false;
 			}
 			if (varmap.count("version")) {
@@ -307,6 +399,14 @@ namespace minijava
 				setup.quiet = true;
 			}
 
+			if (varmap.count("nolibc")) {
+				setup.runtime = runtime_library::nolibc;
+			}
+
+			if (varmap.count("host-assembler") || !MINIJAVA_DIRECT_OBJECT_FILES) {
+				setup.host_assembler = true;
+			}
+
 			if (varmap.count("opts-list")) {
 				print_opts_list(out);
 				return false;
@@ -314,11 +414,77 @@ namespace minijava
 			po::notify(varmap);
 			check_mutex_option_group(interception, varmap);
 			setup.stage = get_interception_stage(varmap);
+			if (varmap.count("run")) {
+				if (setup.stage != compilation_stage{}) {
+					throw po::error{"Option --run cannot be combined with intercepting the compilation"};
+				}
+				setup.run = true;
+			}
+			if (setup.jobs < 1) {
+				throw po::error{"Option --jobs needs at least one thread"};
+			}
+			setup.batch = varmap.count("batch") || varmap.count("batch-file");
+			setup.cache_stats = varmap.count("cache-stats");
+			if (setup.cache.empty() && (setup.cache_stats || !varmap["cache-size"].defaulted())) {
+				throw po::error{"Options --cache-size and --cache-stats require --cache"};
+			}
+			if (varmap.count("serve")) {
+				if (setup.batch || setup.run || (setup.stage != compilation_stage{})
+				    || !setup.inputs.empty() || !varmap["output"].defaulted()) {
+					throw po::error{"Option --serve cannot be combined with input files, --output, --run, --batch or intercepting the compilation"};
+				}
+				if (setup.serve.empty()) {
+					throw po::error{"Option --serve needs the name of a socket"};
+				}
+			}
+			if (setup.batch) {
+				check_batch_options(setup);
+			} else {
+				if (!varmap["workers"].defaulted()) {
+					throw po::error{"Option --workers requires --batch"};
+				}
+				if (setup.inputs.size() > 1) {
+					throw po::error{"Multiple input files require --batch"};
+				}
+				setup.input = setup.inputs.empty() ? "-" : setup.inputs.front();
+			}
 			setup.optimizations = get_optimizations(varmap, out);
 			return true;
 		}
 
 
+		// State that is expensive to set up and can be shared by all
+		// programs compiled in the same process.
+		struct compiler_state
+		{
+			// Global Firm state (created on first use).
+			std::unique_ptr<global_firm_state> firm{};
+
+			// Precompiled runtimes for the combinations of C compiler and
+			// runtime library used so far (if there is none for a program,
+			// the runtime is compiled from source when it is linked).
+			std::vector<std::unique_ptr<runtime_object>> runtimes{};
+
+			// Cache for compilation results (if enabled).
+			std::unique_ptr<compilation_cache> cache{};
+		};
+
+
+		// `return`s the precompiled runtime in `state` that matches the C
+		// compiler and runtime library selected by `setup` or `nullptr` if
+		// there is none.
+		const runtime_object* find_runtime(const compiler_state& state, const program_setup& setup)
+		{
+			const auto pos = std::find_if(
+				std::begin(state.runtimes), std::end(state.runtimes),
+				[&setup](auto&& rt){
+					return (rt->compiler() == setup.cc) && (rt->library() == setup.runtime);
+				}
+			);
+			return (pos != std::end(state.runtimes)) ? pos->get() : nullptr;
+		}
+
+
 		// Prints the token `tok` to `out` in the format required for
 		// `--lextest`.  This function could be optimized to avoid the string
 		// formatting but the fun for tweaking this stage is probably over now.
@@ -331,64 +497,114 @@ namespace minijava
 			}
 		}
 
-		void run_compiler_stages(file_data& in, file_output& out,
-		                         const compilation_stage stage, const std::string& cc, symbol_pool<>& pool,
-		                         const std::vector<std::string>& optimizations)
+		// Makes `out` refer to the default executable 'a.out'/'a.exe' unless
+		// it already refers to a named file.  The output of the stages that
+		// produce an executable defaults to that file, not to stdout.
+		void use_default_executable(file_output& out)
+		{
+			if (out.filename().empty()) {
+				out = file_output{MINIJAVA_WINDOWS_ASSEMBLY ? "a.exe" : "a.out"};
+			}
+		}
+
+		// Runs the compiler stages selected by `setup`, using and updating
+		// the shared `state`.  If the program is run in-process, it reads
+		// from `thestdin`, writes to `out` and reports runtime errors to
+		// `thestderr` and its exit status is `return`ed.  Otherwise,
+		// `EXIT_SUCCESS` is `return`ed.
+		template <typename PoolT>
+		int run_compiler_stages(file_data& in, file_output& out, const program_setup& setup,
+		                        PoolT& pool, compiler_state& state,
+		                        std::FILE* thestdin, std::FILE* thestderr)
 		{
 			namespace fs = boost::filesystem;
 			using namespace std::string_literals;
+			const auto stage = setup.stage;
 
-			auto lex = make_lexer(std::begin(in), std::end(in), pool, pool);
-			const auto tokfirst = token_begin(lex);
-			const auto toklast = token_end(lex);
 			if (stage == compilation_stage::lexer) {
-				std::for_each(tokfirst, toklast, [&out](auto&& t){ print_token(out, t); });
-				return;
+				auto lex = make_lexer(std::begin(in), std::end(in), pool, pool);
+				std::for_each(token_begin(lex), token_end(lex), [&out](auto&& t){ print_token(out, t); });
+				return EXIT_SUCCESS;
 			}
 			auto factory = ast_factory{};
-			auto ast = parse_program(tokfirst, toklast, factory);
+			auto ast = parse_source(std::begin(in), std::end(in), pool, factory, setup.jobs);
 			if (stage == compilation_stage::parser) {
-				return;
+				return EXIT_SUCCESS;
 			}
 			if (stage == compilation_stage::print_ast) {
 				out.write(to_text(*ast));
-				return;
+				return EXIT_SUCCESS;
 			}
-			auto sem_info = check_program(*ast, pool, factory);
+			auto sem_info = std::make_unique<semantic_info>(check_program(*ast, pool, factory, setup.jobs));
 			if (stage == compilation_stage::semantic) {
-				return;
+				return EXIT_SUCCESS;
 			}
-			auto firm = initialize_firm();
-			auto ir = create_firm_ir(*firm, *ast, sem_info, in.filename());
+			if (!state.firm) {
+				state.firm = initialize_firm();
+			}
+			auto ir = create_firm_ir(*state.firm, *ast, *sem_info, in.filename());
+			// Nothing after this point needs the front-end data any more and
+			// for large programs it is worth giving the memory back early.
+			sem_info.reset();
+			ast.reset();
+			pool = PoolT{};
 			if (stage == compilation_stage::dump_ir) {
 				dump_firm_ir(ir);  // TODO: allow setting directory
-				return;
+				return EXIT_SUCCESS;
 			}
 			// optimize
-			for(const auto& opt_name : optimizations) {
+			clear_optimizations();
+			for(const auto& opt_name : setup.optimizations) {
 				register_optimization(opt_name);
 			}
-			optimize(ir);
+			// Only our own backend can select Mux nodes.
+			optimize(ir, stage != compilation_stage::compile_firm);
 			if (stage == compilation_stage::dump_ir_opt) {
 				dump_firm_ir(ir);  // TODO: allow setting directory
-				return;
+				return EXIT_SUCCESS;
 			}
-			// From now on, output defaults to 'a.out'/'a.exe', not to stdout.
-			if (out.filename().empty()) {
-				out = file_output{MINIJAVA_WINDOWS_ASSEMBLY ? "a.exe" : "a.out"};
+			if (setup.run) {
+				const auto obj = encode_object(ir, setup.jobs);
+				out.flush();
+				return run_object(obj, in.filename(), thestdin, out.handle(), thestderr);
+			}
+			use_default_executable(out);
+			const auto direct = !setup.host_assembler && (stage != compilation_stage::compile_firm);
+			if (!direct && !keep_temporary_files()) {
+				// Stream the assembly right into the C compiler so it can
+				// assemble while we are still emitting code.
+				const auto runtime = find_runtime(state, setup);
+				auto pipe = runtime
+					? std::make_unique<assembly_pipe>(setup.cc, out.filename(), *runtime)
+					: std::make_unique<assembly_pipe>(setup.cc, out.filename(), setup.runtime);
+				if (stage == compilation_stage::compile_firm) {
+					emit_x64_assembly_firm(ir, pipe->assembly());
+				} else {
+					assert(stage == compilation_stage{});
+					assemble(ir, pipe->assembly(), setup.jobs);
+				}
+				pipe->finish();
+				return EXIT_SUCCESS;
 			}
 			const auto tempdir = fs::temp_directory_path();
-			const auto asmname = fs::unique_path(tempdir / "%%%%%%%%%%%%.s").string();
+			const auto asmname = fs::unique_path(tempdir / (direct ? "%%%%%%%%%%%%.o" : "%%%%%%%%%%%%.s")).string();
 			const file_cleanup asm_cleanup_guard{asmname};
 			auto asmout = file_output{asmname};
 			if (stage == compilation_stage::compile_firm) {
 				emit_x64_assembly_firm(ir, asmout);
+			} else if (direct) {
+				assemble_object(ir, asmout, setup.jobs);
 			} else {
 				assert(stage == compilation_stage{});
-				assemble(ir, asmout);
+				assemble(ir, asmout, setup.jobs);
 			}
 			asmout.close();
-			link_runtime(cc, out.filename(), asmname);
+			if (const auto runtime = find_runtime(state, setup)) {
+				link_runtime(setup.cc, out.filename(), asmname, *runtime);
+			} else {
+				link_runtime(setup.cc, out.filename(), asmname, setup.runtime);
+			}
+			return EXIT_SUCCESS;
 		}
 
 		std::tuple<std::size_t, std::size_t, std::string>
@@ -465,21 +681,112 @@ namespace minijava
 			}
 		}
 
-		// Runs the compiler reading input from `istr`, writing output to
-		// `ostr` and optionally intercepting compilation at `stage`.
-		void run_compiler(file_data& in, file_output& out, logger& log,
-		                  const compilation_stage stage, const std::string& cc,
-		                  const std::vector<std::string>& optimizations)
+		// `return`s whether the stage selected by `setup` links an
+		// executable.
+		bool links_executable(const program_setup& setup)
+		{
+			return !setup.run && ((setup.stage == compilation_stage{})
+			                      || (setup.stage == compilation_stage::compile_firm));
+		}
+
+		// `return`s a string that identifies the build of the running
+		// compiler so results cached by a different build are not reused.
+		// Where available, the size and time stamp of the executable are
+		// used, otherwise only the version.
+		const std::string& get_compiler_identity()
+		{
+			static const auto identity = []{
+				namespace fs = boost::filesystem;
+				auto id = std::string{MINIJAVA_PROJECT_VERSION};
+				const auto self = fs::path{"/proc/self/exe"};
+				auto ec = boost::system::error_code{};
+				const auto size = fs::file_size(self, ec);
+				const auto mtime = ec ? std::time_t{} : fs::last_write_time(self, ec);
+				if (!ec) {
+					id += " " + std::to_string(size) + " " + std::to_string(mtime);
+				}
+				return id;
+			}();
+			return identity;
+		}
+
+		// Computes the key for caching the result of compiling `in` with the
+		// options in `setup`.  Only the verdicts of `--parsetest` and
+		// `--check` and linked executables are cached.  For other stages, an
+		// empty string is `return`ed.
+		std::string get_cache_key(file_data& in, const program_setup& setup)
+		{
+			const auto stage = setup.stage;
+			const auto links = links_executable(setup);
+			if (!links && (stage != compilation_stage::parser) && (stage != compilation_stage::semantic)) {
+				return std::string{};
+			}
+			auto hasher = sha256{};
+			// Every part is prefixed with its length so parts cannot run into
+			// each other.
+			const auto add = [&hasher](const void*const data, const std::size_t size){
+				hasher.update(std::to_string(size) + ":");
+				hasher.update(data, size);
+			};
+			const auto add_string = [&add](const std::string& text){
+				add(text.data(), text.size());
+			};
+			add_string(get_compiler_identity());
+			add_string(std::to_string(static_cast<int>(stage)));
+			if (links) {
+				// The file name goes into the debug information.
+				add_string(in.filename());
+				add_string(algo::join(setup.optimizations, ","));
+				add_string(setup.host_assembler ? "host-assembler" : "object");
+				add_string((setup.runtime == runtime_library::nolibc) ? "nolibc" : "libc");
+				add_string(setup.cc);
+			}
+			add(in.data(), in.size());
+			return hasher.hexdigest();
+		}
+
+		// Runs the compiler reading input from `in`, writing output to `out`
+		// and optionally intercepting compilation at the stage selected by
+		// `setup`.  If `state` has a cache, the result is taken from there if
+		// possible and stored there otherwise.  `return`s the exit status of
+		// the program if it was run in-process and `EXIT_SUCCESS` otherwise.
+		int run_compiler(file_data& in, file_output& out, logger& log, const program_setup& setup,
+		                 compiler_state& state, std::FILE* thestdin, std::FILE* thestderr)
 		{
 			using namespace std::string_literals;
-			if (stage == compilation_stage::input) {
+			if (setup.stage == compilation_stage::input) {
 				out.write(in.data(), in.size());
-				return;
+				return EXIT_SUCCESS;
+			}
+			const auto key = state.cache ? get_cache_key(in, setup) : std::string{};
+			const auto produces_executable = links_executable(setup);
+			if (produces_executable && !key.empty()) {
+				use_default_executable(out);
+			}
+			if (!key.empty()) {
+				const auto hit = produces_executable
+					? state.cache->lookup(key, out.filename())
+					: state.cache->lookup(key);
+				if (hit) {
+					return EXIT_SUCCESS;
+				}
 			}
-			auto pool = symbol_pool<>{};  // TODO: Use an appropriate allocator
-
 			try {
-				run_compiler_stages(in, out, stage, cc, pool, optimizations);
+				auto status = EXIT_FAILURE;
+				if (setup.jobs < 2) {
+					// Without threads, there is no need to pay for locking.
+					auto pool = symbol_pool<>{};  // TODO: Use an appropriate allocator
+					status = run_compiler_stages(in, out, setup, pool, state, thestdin, thestderr);
+				} else {
+					auto pool = concurrent_symbol_pool<>{};  // TODO: Use an appropriate allocator
+					status = run_compiler_stages(in, out, setup, pool, state, thestdin, thestderr);
+				}
+				if (produces_executable && !key.empty()) {
+					state.cache->store(key, out.filename());
+				} else if (!key.empty()) {
+					state.cache->store(key);
+				}
+				return status;
 			} catch(lexical_error& e) {
 				print_source_error(log, e, in, "tokenizing");
 				throw;
@@ -496,6 +803,123 @@ namespace minijava
 		}
 
 
+		// Input and output file of a program compiled in batch mode.
+		struct batch_job
+		{
+			// Name of the input file.
+			std::string input{};
+
+			// Name of the executable.
+			std::string output{};
+		};
+
+
+		// Derives the name of the executable for `input` in batch mode by
+		// dropping its extension (or appending `.out` if it has none).  If
+		// `directory` is not empty, the executable is put there, otherwise
+		// next to the input file.
+		std::string get_batch_output(const std::string& input, const std::string& directory)
+		{
+			namespace fs = boost::filesystem;
+			const auto path = fs::path{input};
+			const auto exe = path.has_extension()
+				? path.stem()
+				: fs::path{path.filename().string() + ".out"};
+			const auto parent = directory.empty() ? path.parent_path() : fs::path{directory};
+			return (parent / exe).string();
+		}
+
+
+		// Collects the programs to compile in batch mode from the input files
+		// and the batch file in `setup`.  If the batch file is `-`, it is read
+		// from `thestdin`.
+		std::vector<batch_job> get_batch_jobs(const program_setup& setup, std::FILE* thestdin)
+		{
+			const auto directory = (setup.output == "-") ? std::string{} : setup.output;
+			auto jobs = std::vector<batch_job>{};
+			for (const auto& input : setup.inputs) {
+				jobs.push_back({input, get_batch_output(input, directory)});
+			}
+			if (!setup.batch_file.empty()) {
+				const auto list = (setup.batch_file == "-")
+					? file_data{thestdin}
+					: file_data{setup.batch_file};
+				auto lines = std::vector<std::string>{};
+				algo::split(lines, std::string{list.begin(), list.end()}, algo::is_any_of("\n"));
+				for (auto& line : lines) {
+					algo::trim_right_if(line, algo::is_any_of("\r"));
+					if (line.empty() || (line.front() == '#')) {
+						continue;
+					}
+					const auto tab = line.find('\t');
+					if (tab == std::string::npos) {
+						jobs.push_back({line, get_batch_output(line, directory)});
+					} else {
+						jobs.push_back({line.substr(0, tab), line.substr(tab + 1)});
+					}
+				}
+			}
+			for (const auto& job : jobs) {
+				if (job.input == "-") {
+					throw std::runtime_error{"Cannot read a program from standard input in batch mode"};
+				}
+			}
+			if (!directory.empty()) {
+				boost::filesystem::create_directories(directory);
+			}
+			return jobs;
+		}
+
+
+		// Compiles every program listed in `setup` into its own executable,
+		// sharing the Firm state and the precompiled runtime in `state`
+		// between them.  Errors for individual programs are reported to `log`
+		// and don't stop the others from being compiled.  If any program
+		// could not be compiled, an exception is `throw`n at the end.
+		void run_batch(logger& log, const program_setup& setup, compiler_state& state,
+		               std::FILE* thestdin, std::FILE* thestderr)
+		{
+			namespace fs = boost::filesystem;
+			const auto jobs = get_batch_jobs(setup, thestdin);
+			const auto link = (setup.stage == compilation_stage{})
+				|| (setup.stage == compilation_stage::compile_firm);
+			if (link) {
+				// Set up the shared state before any worker processes are
+				// forked so they can all use it.
+				if (!state.firm) {
+					state.firm = initialize_firm();
+				}
+				if (!find_runtime(state, setup)) {
+					state.runtimes.push_back(std::make_unique<runtime_object>(setup.cc, setup.runtime));
+				}
+			}
+			const auto compile = [&](const std::size_t i){
+				const auto& job = jobs[i];
+				try {
+					auto in = file_data{job.input};
+					auto out = link ? file_output{job.output} : file_output{};
+					run_compiler(in, out, log, setup, state, thestdin, thestderr);
+					out.finalize();
+					return true;
+				} catch (const std::exception& e) {
+					log.printf("%s: error: %s: %s\n", MINIJAVA_PROJECT_NAME, job.input.c_str(), e.what());
+					if (link) {
+						auto ec = boost::system::error_code{};
+						fs::remove(job.output, ec);
+					}
+					return false;
+				}
+			};
+			const auto failures = run_worker_processes(jobs.size(), setup.workers, compile);
+			if (failures > 0) {
+				throw std::runtime_error{
+					std::to_string(failures) + " of " + std::to_string(jobs.size())
+					+ " programs could not be compiled"
+				};
+			}
+		}
+
+
 		// Checks the environment variable `MINIJAVA_STACK_LIMIT` and
 		// `return`s its value.  If the variable is set in the environment and
 		// has a valid value, its value is `return`ed.  Otherwise, 0 (which is
@@ -532,10 +956,12 @@ namespace minijava
 		// Checks the environment variable `MINIJAVA_STACK_LIMIT` and, if it
 		// is set, adjust the resource limt accordingly.  This function handles
 		// erros by printing a warning to `err` and otherwise ignoring them,
-		// letting the stack limit as it is.
-		void try_adjust_stack_limit(logger& log)
+		// letting the stack limit as it is.  The value of the variable (as
+		// `return`ed by `get_stack_limit`) is `return`ed.
+		std::ptrdiff_t try_adjust_stack_limit(logger& log)
 		{
-			if (const auto limit = get_stack_limit(log)) {
+			const auto limit = get_stack_limit(log);
+			if (limit != 0) {
 				try {
 					set_max_stack_size_limit(limit);
 				} catch (const std::system_error& e) {
@@ -547,36 +973,162 @@ namespace minijava
 					);
 				}
 			}
+			return limit;
 		}
 
-	}  // namespace /* anonymous */
-
+		// Stack size of the thread that runs the compiler if
+		// `MINIJAVA_STACK_LIMIT` doesn't ask for a specific size.  The parser
+		// and the passes over the AST and the IR recurse once per nesting
+		// level of the program.  Only address space is reserved up front so
+		// a generous size costs nothing for ordinary programs.
+		constexpr std::size_t default_compiler_stack_size = std::size_t{1} << 30;
 
-	void real_main(const std::vector<const char*>& args,
-	               std::FILE* thestdin,
-	               std::FILE* thestdout,
-	               std::FILE* thestderr)
-	{
-		auto setup = program_setup{};
+		// Parses the command-line arguments in `args` like the other overload
+		// but writes the `--help` or `--version` text to `thestdout`
+		// directly.
+		bool parse_cmd_options(const std::vector<const char *>& args,
+		                       std::FILE* thestdout, program_setup& setup)
 		{
 			auto out = file_output{thestdout};
 			if (!parse_cmd_options(args, out, setup)) {
 				out.flush();
-				return;
+				return false;
 			}
+			return true;
 		}
 
-		logger log = setup.quiet? logger{} : logger{thestderr};
+		// Prints the statistics of `cache` to `log`.
+		void print_cache_statistics(logger& log, const compilation_cache& cache)
+		{
+			const auto stats = cache.statistics();
+			log.printf(
+				"%s: cache %s: %ju hits, %ju misses, %ju entries, %ju of %ju bytes used\n",
+				MINIJAVA_PROJECT_NAME, cache.directory().c_str(), stats.hits, stats.misses,
+				stats.entries, stats.size, cache.size_limit()
+			);
+		}
+
+		// Runs the compiler as requested by `setup` (which must not ask for
+		// running a server) using and updating the shared `state`.
+		int run_program_setup(logger& log, const program_setup& setup, compiler_state& state,
+		                      std::FILE* thestdin, std::FILE* thestdout, std::FILE* thestderr)
+		{
+			if (!setup.cache.empty()) {
+				const auto size_limit = std::uintmax_t{setup.cache_size} * 1024 * 1024;
+				state.cache = std::make_unique<compilation_cache>(setup.cache, size_limit);
+			}
+			const auto print_stats = [&log, &setup, &state](){
+				if (setup.cache_stats) {
+					print_cache_statistics(log, *state.cache);
+				}
+			};
+			try {
+				if (setup.batch) {
+					run_batch(log, setup, state, thestdin, thestderr);
+					print_stats();
+					return EXIT_SUCCESS;
+				}
+				auto in = (setup.input == "-")
+					? file_data{thestdin}
+					: file_data{setup.input};
+				auto out = (setup.output == "-")
+					? file_output{thestdout}
+					: file_output{setup.output};
+				const auto status = run_compiler(in, out, log, setup, state, thestdin, thestderr);
+				out.finalize();
+				print_stats();
+				return status;
+			} catch (const std::exception&) {
+				print_stats();
+				throw;
+			}
+		}
 
-		try_adjust_stack_limit(log);
-		auto in = (setup.input == "-")
-			? file_data{thestdin}
-			: file_data{setup.input};
-		auto out = (setup.output == "-")
-			? file_output{thestdout}
-			: file_output{setup.output};
-		run_compiler(in, out, log, setup.stage, setup.cc, setup.optimizations);
-		out.finalize();
+		// Runs `run_program_setup` on a thread with a stack of `stack_limit`
+		// bytes (or `default_compiler_stack_size` if `stack_limit` is not
+		// positive), so deeply nested programs can be compiled even if the
+		// stack limit of the process cannot be raised.  The threads used for
+		// `--jobs` get a stack of the same size.
+		int run_program_setup_on_large_stack(logger& log, const std::ptrdiff_t stack_limit,
+		                                     const program_setup& setup, compiler_state& state,
+		                                     std::FILE* thestdin, std::FILE* thestdout, std::FILE* thestderr)
+		{
+			const auto stack_size = (stack_limit > 0)
+				? static_cast<std::size_t>(stack_limit)
+				: default_compiler_stack_size;
+			auto status = EXIT_FAILURE;
+			call_with_stack_size(stack_size, [&](){
+				status = run_program_setup(log, setup, state, thestdin, thestdout, thestderr);
+			});
+			return status;
+		}
+
+		// Executes a single request to the compiler server.  `args` is the
+		// command line of the client and the streams are the client's
+		// standard streams.
+		int run_server_request(const std::vector<const char*>& args, compiler_state& state,
+		                       std::FILE* thestdin, std::FILE* thestdout, std::FILE* thestderr)
+		{
+			auto setup = program_setup{};
+			if (!parse_cmd_options(args, thestdout, setup)) {
+				return EXIT_SUCCESS;
+			}
+			if (!setup.serve.empty()) {
+				throw po::error{"Option --serve cannot be sent to a running server"};
+			}
+			logger log = setup.quiet? logger{} : logger{thestderr};
+			const auto stack_limit = try_adjust_stack_limit(log);
+			return run_program_setup_on_large_stack(log, stack_limit, setup, state, thestdin, thestdout, thestderr);
+		}
+
+		// Sets up the Firm state and the precompiled runtime selected by
+		// `setup` in `state` and then serves compile requests on the socket
+		// named in `setup` until the process is asked to terminate.  Each
+		// request runs in its own process `fork`ed from the server so it
+		// starts with the warm `state` but cannot change it for later
+		// requests.
+		void run_compiler_server(logger& log, const program_setup& setup, compiler_state& state)
+		{
+			state.firm = initialize_firm();
+			state.runtimes.push_back(std::make_unique<runtime_object>(setup.cc, setup.runtime));
+			log.printf("%s: listening on %s\n", MINIJAVA_PROJECT_NAME, setup.serve.c_str());
+			const auto handler = [&state](const auto& args, auto thestdin, auto thestdout, auto thestderr){
+				// Runtimes compiled for this request belong to its process
+				// and must be cleaned up before it exits.
+				const auto runtimes = state.runtimes.size();
+				auto status = EXIT_FAILURE;
+				try {
+					status = run_server_request(args, state, thestdin, thestdout, thestderr);
+				} catch (const std::exception& e) {
+					// NB: Don't alter the string "error: " -- it is required output.
+					std::fprintf(thestderr, "%s: error: %s\n", MINIJAVA_PROJECT_NAME, e.what());
+				}
+				state.runtimes.resize(runtimes);
+				return status;
+			};
+			run_server(setup.serve, handler);
+		}
+
+	}  // namespace /* anonymous */
+
+
+	int real_main(const std::vector<const char*>& args,
+	              std::FILE* thestdin,
+	              std::FILE* thestdout,
+	              std::FILE* thestderr)
+	{
+		auto setup = program_setup{};
+		if (!parse_cmd_options(args, thestdout, setup)) {
+			return EXIT_SUCCESS;
+		}
+		logger log = setup.quiet? logger{} : logger{thestderr};
+		const auto stack_limit = try_adjust_stack_limit(log);
+		auto state = compiler_state{};
+		if (!setup.serve.empty()) {
+			run_compiler_server(log, setup, state);
+			return EXIT_SUCCESS;
+		}
+		return run_program_setup_on_large_stack(log, stack_limit, setup, state, thestdin, thestdout, thestderr);
 	}
 
 }  // namespace minijava
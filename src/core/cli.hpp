@@ -30,14 +30,18 @@ namespace minijava
 	 * @param thestderr
 	 *     destination for error output
 	 *
+	 * @returns
+	 *     the exit status of the program if it was run in-process with
+	 *     `--run` and `EXIT_SUCCESS` otherwise
+	 *
 	 * @throws std::exception
 	 *     on failure to successfully complete the requested task
 	 *
 	 */
-	void real_main(const std::vector<const char*>& args,
-	               std::FILE* thestdin,
-	               std::FILE* thestdout,
-	               std::FILE* thestderr);
+	int real_main(const std::vector<const char*>& args,
+	              std::FILE* thestdin,
+	              std::FILE* thestdout,
+	              std::FILE* thestderr);
 
 	// `stdin`, `stdout` and `stderr` are standard-library macros so we cannot
 	// use them as parameter names.
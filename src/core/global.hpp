@@ -34,6 +34,10 @@
  * @brief
  *     Environment variable that can be used to set the maximum stack size.
  *
+ * A positive value is also used as the stack size of the thread the compiler
+ * runs on.  Otherwise, that thread gets a large default stack, so deeply
+ * nested programs can be compiled even if the limit cannot be raised.
+ *
  */
 #define MINIJAVA_ENVVAR_STACK_LIMIT "MINIJAVA_STACK_LIMIT"
 
@@ -54,6 +58,14 @@
 #define MINIJAVA_ENVVAR_KEEP_TEMPORARY_FILES "MINIJAVA_KEEP_TEMPORARY_FILES"
 
 
+/**
+ * @brief
+ *     Environment variable that names the socket of the compiler server.
+ *
+ */
+#define MINIJAVA_ENVVAR_SERVER "MINIJAVA_SERVER"
+
+
 #if defined (_WIN32) || MINIJAVA_PARSED_BY_DOXYGEN
 /**
  * @brief
@@ -65,6 +77,18 @@
 #endif
 
 
+#if (defined (__linux__) && defined (__ELF__) && defined (__x86_64__)) || MINIJAVA_PARSED_BY_DOXYGEN
+/**
+ * @brief
+ *     Controls whether object files are written directly by default, which
+ *     is only possible for x86-64 ELF targets
+ */
+#   define MINIJAVA_DIRECT_OBJECT_FILES 1
+#else
+#   define MINIJAVA_DIRECT_OBJECT_FILES 0
+#endif
+
+
 /**
  * @brief
  *     Top-level `namespace` for everything in this project.
@@ -0,0 +1,195 @@
+#include "io/compilation_cache.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem.hpp>
+
+
+namespace fs = boost::filesystem;
+
+namespace minijava
+{
+
+	namespace /* anonymous */
+	{
+
+		// Files in the cache directory whose name starts with this prefix
+		// are not entries.
+		constexpr char meta_prefix = '.';
+
+		// Files recording hits and misses.  Each event appends a single
+		// byte so concurrent processes can record them without locking and
+		// the count is the size of the file.
+		constexpr auto hits_filename = ".hits";
+		constexpr auto misses_filename = ".misses";
+
+		// Temporary files older than this many seconds are assumed to be
+		// left over from a process that crashed while storing an entry.
+		constexpr std::time_t stale_seconds = 3600;
+
+		bool is_entry(const fs::path& path)
+		{
+			const auto name = path.filename().string();
+			return !name.empty() && (name.front() != meta_prefix);
+		}
+
+		bool is_temporary(const fs::path& path)
+		{
+			return boost::starts_with(path.filename().string(), ".tmp-");
+		}
+
+		std::uintmax_t file_size_or_zero(const fs::path& path)
+		{
+			auto ec = boost::system::error_code{};
+			const auto size = fs::file_size(path, ec);
+			return ec ? 0 : size;
+		}
+
+		fs::path make_temporary_name(const fs::path& directory)
+		{
+			return directory / fs::unique_path(".tmp-%%%%-%%%%-%%%%-%%%%");
+		}
+
+	}  // namespace /* anonymous */
+
+
+	compilation_cache::compilation_cache(std::string directory, const std::uintmax_t size_limit)
+		: _directory{std::move(directory)}, _size_limit{size_limit}
+	{
+		fs::create_directories(_directory);
+	}
+
+	bool compilation_cache::lookup(const std::string& key)
+	{
+		const auto entry = fs::path{_directory} / key;
+		auto ec = boost::system::error_code{};
+		const auto hit = fs::is_regular_file(entry, ec);
+		if (hit) {
+			fs::last_write_time(entry, std::time(nullptr), ec);
+		}
+		_record(hit);
+		return hit;
+	}
+
+	bool compilation_cache::lookup(const std::string& key, const std::string& filename)
+	{
+		const auto entry = fs::path{_directory} / key;
+		auto ec = boost::system::error_code{};
+		const auto perms = fs::status(entry, ec).permissions();
+		if (!ec) {
+			fs::copy_file(entry, filename, fs::copy_option::overwrite_if_exists, ec);
+		}
+		const auto hit = !ec;
+		if (hit) {
+			fs::permissions(filename, perms, ec);
+			fs::last_write_time(entry, std::time(nullptr), ec);
+		}
+		_record(hit);
+		return hit;
+	}
+
+	void compilation_cache::store(const std::string& key)
+	{
+		const auto tempname = make_temporary_name(_directory);
+		if (const auto fp = std::fopen(tempname.c_str(), "wb")) {
+			if (std::fclose(fp) == 0) {
+				_commit(tempname.string(), key);
+			}
+		}
+	}
+
+	void compilation_cache::store(const std::string& key, const std::string& filename)
+	{
+		if (file_size_or_zero(filename) > _size_limit) {
+			return;
+		}
+		const auto tempname = make_temporary_name(_directory);
+		auto ec = boost::system::error_code{};
+		fs::copy_file(filename, tempname, ec);
+		if (ec) {
+			fs::remove(tempname, ec);
+			return;
+		}
+		_commit(tempname.string(), key);
+	}
+
+	cache_statistics compilation_cache::statistics() const
+	{
+		auto stats = cache_statistics{};
+		const auto dir = fs::path{_directory};
+		auto ec = boost::system::error_code{};
+		for (auto it = fs::directory_iterator{dir, ec}; !ec && (it != fs::directory_iterator{}); it.increment(ec)) {
+			if (is_entry(it->path())) {
+				stats.entries += 1;
+				stats.size += file_size_or_zero(it->path());
+			}
+		}
+		stats.hits = file_size_or_zero(dir / hits_filename);
+		stats.misses = file_size_or_zero(dir / misses_filename);
+		return stats;
+	}
+
+	void compilation_cache::_record(const bool hit) const noexcept
+	{
+		try {
+			const auto filename = fs::path{_directory} / (hit ? hits_filename : misses_filename);
+			if (const auto fp = std::fopen(filename.c_str(), "ab")) {
+				std::fputc(hit ? 'h' : 'm', fp);
+				std::fclose(fp);
+			}
+		} catch (const std::exception&) { /* statistics are best-effort */ }
+	}
+
+	void compilation_cache::_commit(const std::string& tempname, const std::string& key)
+	{
+		auto ec = boost::system::error_code{};
+		fs::rename(tempname, fs::path{_directory} / key, ec);
+		if (ec) {
+			fs::remove(tempname, ec);
+			return;
+		}
+		_evict();
+	}
+
+	void compilation_cache::_evict() const
+	{
+		using entry_info = std::tuple<std::time_t, std::uintmax_t, fs::path>;
+		const auto now = std::time(nullptr);
+		auto entries = std::vector<entry_info>{};
+		auto total = std::uintmax_t{};
+		auto ec = boost::system::error_code{};
+		for (auto it = fs::directory_iterator{_directory, ec}; !ec && (it != fs::directory_iterator{}); it.increment(ec)) {
+			const auto& path = it->path();
+			auto ec2 = boost::system::error_code{};
+			const auto mtime = fs::last_write_time(path, ec2);
+			if (ec2) {
+				continue;
+			}
+			if (is_entry(path)) {
+				const auto size = file_size_or_zero(path);
+				entries.emplace_back(mtime, size, path);
+				total += size;
+			} else if (is_temporary(path) && (now - mtime > stale_seconds)) {
+				fs::remove(path, ec2);
+			}
+		}
+		if (total <= _size_limit) {
+			return;
+		}
+		std::sort(std::begin(entries), std::end(entries));
+		for (const auto& info : entries) {
+			if (total <= _size_limit) {
+				break;
+			}
+			fs::remove(std::get<2>(info), ec);
+			total -= std::get<1>(info);
+		}
+	}
+
+}  // namespace minijava
@@ -0,0 +1,192 @@
+/**
+ * @file compilation_cache.hpp
+ *
+ * @brief
+ *     On-disk cache for compilation results.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     Statistics of a `compilation_cache`.
+	 *
+	 */
+	struct cache_statistics
+	{
+		/** @brief Number of entries currently in the cache. */
+		std::uintmax_t entries{};
+
+		/** @brief Total size of all entries in bytes. */
+		std::uintmax_t size{};
+
+		/** @brief Number of successful lookups so far. */
+		std::uintmax_t hits{};
+
+		/** @brief Number of failed lookups so far. */
+		std::uintmax_t misses{};
+	};
+
+	/**
+	 * @brief
+	 *     Content-addressed cache for compilation results in a directory.
+	 *
+	 * Entries are files named after a key that the caller derives from
+	 * everything that influences the result, usually a hash of the input and
+	 * the options.  An entry is either a copy of an output file or empty if
+	 * it only records that an input was found to be valid.
+	 *
+	 * Several processes may use the same directory concurrently.  Entries
+	 * are written to a temporary file first and then renamed, so a lookup
+	 * never sees a partially written entry.  A lookup refreshes the time
+	 * stamp of the entry and whenever the total size exceeds the limit after
+	 * storing an entry, the least recently used entries are removed.  The
+	 * number of hits and misses is recorded in the directory as well so it
+	 * accumulates over all processes using the cache.
+	 *
+	 * Failure to access the cache after it was set up is not an error.  A
+	 * lookup that fails for any reason is a miss and an entry that cannot be
+	 * stored is silently dropped.
+	 *
+	 */
+	class compilation_cache final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Uses the cache in `directory`, creating it if necessary.
+		 *
+		 * @param directory
+		 *     directory with the cache entries
+		 *
+		 * @param size_limit
+		 *     maximum total size of all entries in bytes
+		 *
+		 * @throws std::exception
+		 *     if the directory cannot be created
+		 *
+		 */
+		compilation_cache(std::string directory, std::uintmax_t size_limit);
+
+		/**
+		 * @brief
+		 *     `return`s the directory of the cache.
+		 *
+		 * @returns
+		 *     directory name
+		 *
+		 */
+		const std::string& directory() const noexcept
+		{
+			return _directory;
+		}
+
+		/**
+		 * @brief
+		 *     `return`s the maximum total size of all entries in bytes.
+		 *
+		 * @returns
+		 *     size limit
+		 *
+		 */
+		std::uintmax_t size_limit() const noexcept
+		{
+			return _size_limit;
+		}
+
+		/**
+		 * @brief
+		 *     Checks whether there is an entry for `key`.
+		 *
+		 * @param key
+		 *     key of the entry
+		 *
+		 * @returns
+		 *     whether the entry was found
+		 *
+		 */
+		bool lookup(const std::string& key);
+
+		/**
+		 * @brief
+		 *     Copies the entry for `key` to the file `filename`.
+		 *
+		 * The file is overwritten and gets the permissions of the file that
+		 * was stored in the cache.
+		 *
+		 * @param key
+		 *     key of the entry
+		 *
+		 * @param filename
+		 *     file to copy the entry to
+		 *
+		 * @returns
+		 *     whether the entry was found and copied
+		 *
+		 */
+		bool lookup(const std::string& key, const std::string& filename);
+
+		/**
+		 * @brief
+		 *     Stores an empty entry for `key`.
+		 *
+		 * @param key
+		 *     key of the entry
+		 *
+		 */
+		void store(const std::string& key);
+
+		/**
+		 * @brief
+		 *     Stores a copy of the file `filename` as the entry for `key`.
+		 *
+		 * Files larger than the size limit are not stored.
+		 *
+		 * @param key
+		 *     key of the entry
+		 *
+		 * @param filename
+		 *     file to copy into the cache
+		 *
+		 */
+		void store(const std::string& key, const std::string& filename);
+
+		/**
+		 * @brief
+		 *     Collects the current statistics of the cache.
+		 *
+		 * @returns
+		 *     statistics
+		 *
+		 */
+		cache_statistics statistics() const;
+
+	private:
+
+		/** @brief Directory with the cache entries. */
+		std::string _directory{};
+
+		/** @brief Maximum total size of all entries in bytes. */
+		std::uintmax_t _size_limit{};
+
+		/** @brief Counts a hit or a miss. */
+		void _record(bool hit) const noexcept;
+
+		/** @brief Moves the temporary file `tempname` into place as entry `key`. */
+		void _commit(const std::string& tempname, const std::string& key);
+
+		/** @brief Removes the least recently used entries to meet the size limit. */
+		void _evict() const;
+
+	};
+
+}  // namespace minijava
@@ -10,7 +10,7 @@
 #include "global.hpp"
 
 
-namespace /*anonymous*/
+namespace minijava
 {
 
 	bool keep_temporary_files()
@@ -22,12 +22,6 @@ namespace /*anonymous*/
 		return answer;
 	}
 
-}  // namespace /*anonymous*/
-
-
-namespace minijava
-{
-
 	file_cleanup::file_cleanup(std::string filename)
 		: _filename{std::move(filename)}
 	{
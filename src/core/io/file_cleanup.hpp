@@ -14,6 +14,19 @@
 namespace minijava
 {
 
+	/**
+	 * @brief
+	 *     Tells whether temporary files should be kept for debugging.
+	 *
+	 * This is the case if the environment variable
+	 * `MINIJAVA_KEEP_TEMPORARY_FILES` is set to a non-empty string.
+	 *
+	 * @returns
+	 *     whether temporary files should be kept
+	 *
+	 */
+	bool keep_temporary_files();
+
 	/**
 	 * @brief
 	 *     RAII guard for reliable removal of temporary files.
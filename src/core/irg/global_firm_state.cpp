@@ -65,6 +65,7 @@ namespace minijava
 	{
 		assert(p != nullptr);
 		assert(p != _irp);
+		irg::primitive_types::release(p);
 		firm::set_irp(p);
 		firm::free_ir_prog();
 		firm::set_irp(_irp);
@@ -271,9 +271,20 @@ namespace minijava
 		}  // namespace /* anonymous */
 
 
+		namespace /* anonymous */
+		{
+
+			// Primitive types of the program `primitive_types_owner` (if it
+			// is not `nullptr`).
+			primitive_types the_primitive_types{};
+			firm::ir_prog* primitive_types_owner{};
+
+		}  // namespace /* anonymous */
+
 		const primitive_types& primitive_types::get_instance()
 		{
-			static const auto instance = [](){
+			const auto irp = firm::get_irp();
+			if (primitive_types_owner != irp) {
 				auto pt = primitive_types{};
 				pt.boolean_mode = firm::mode_Bs;
 				pt.int_mode = firm::mode_Is;
@@ -281,9 +292,18 @@ namespace minijava
 				pt.boolean_type = firm::new_type_primitive(pt.boolean_mode);
 				pt.int_type = firm::new_type_primitive(pt.int_mode);
 				pt.pointer_type = firm::new_type_primitive(pt.pointer_mode);
-				return pt;
-			}();
-			return instance;
+				the_primitive_types = pt;
+				primitive_types_owner = irp;
+			}
+			return the_primitive_types;
+		}
+
+		void primitive_types::release(firm::ir_prog*const prog) noexcept
+		{
+			if (primitive_types_owner == prog) {
+				the_primitive_types = primitive_types{};
+				primitive_types_owner = nullptr;
+			}
 		}
 
 		ir_types create_types(const ast::program& ast, const semantic_info& seminfo)
@@ -155,7 +155,7 @@ namespace minijava
 		 *
 		 * A default-constructed struct will hold four `nullptr`s.  In order to
 		 * get an initialized object, use the `get_instance` function to obtain
-		 * a reference to the singleton instance.
+		 * a reference to the instance for the current Firm program.
 		 *
 		 * As this `struct` merely stores four pointers, it can be freely
 		 * copied.  It's the pointer members that won't change value.
@@ -173,18 +173,39 @@ namespace minijava
 
 			/**
 			 * @brief
-			 *     Obtains a reference to the singleton instance, lazily
-			 *     initializing it in a race-free manner if necessary.
+			 *     Obtains a reference to the instance for the current Firm
+			 *     program, lazily initializing it if necessary.
+			 *
+			 * The Firm types are owned by the program that is current when
+			 * they are created and are freed together with it.  Therefore,
+			 * a new instance is created whenever this function is called
+			 * with a different current program than before.  The returned
+			 * reference is only valid until the next call.
 			 *
 			 * If `libfirm` is not initialized prior to calling this function,
-			 * the behavior is undefined.
+			 * the behavior is undefined.  Like anything else that uses
+			 * `libfirm`, this function is not thread-safe.
 			 *
 			 * @returns
-			 *     reference to initialized singleton
+			 *     reference to initialized instance
 			 *
 			 */
 			static const primitive_types& get_instance();
 
+			/**
+			 * @brief
+			 *     Forgets the instance for `prog` if there is one.
+			 *
+			 * This function must be called before a Firm program is freed so
+			 * a later program that happens to be allocated at the same
+			 * address doesn't pick up the dangling types.
+			 *
+			 * @param prog
+			 *     Firm program that is about to be freed
+			 *
+			 */
+			static void release(firm::ir_prog* prog) noexcept;
+
 			/** @brief Unique pointer to Firm mode for MiniJava's `int` type.  */
 			firm::ir_mode* int_mode{};
 
@@ -15,6 +15,7 @@
 #include <type_traits>
 
 #include "lexer/token.hpp"
+#include "position.hpp"
 #include "source_error.hpp"
 
 
@@ -108,13 +109,17 @@ namespace minijava
 		 * @param alloc
 		 *     allocator to use for allocating internal working buffers
 		 *
+		 * @param start
+		 *     position of the first character of the input (useful if the
+		 *     input is only a part of a larger source file)
+		 *
 		 * @throws lexical_error
 		 *     if the input does not start with a valid token
 		 *
 		 */
 		lexer(InIterT first, InIterT last,
 			  IdPoolT& id_pool, LitPoolT& lit_pool,
-			  const AllocT& alloc);
+			  const AllocT& alloc, position start = position{1, 1});
 
 		/**
 		 * @brief
@@ -281,11 +281,11 @@ namespace minijava
 	lexer<InIterT, IdPoolT, LitPoolT, AllocT>::lexer(
 		const InIterT first, const InIterT last,
 		IdPoolT& id_pool, LitPoolT& lit_pool,
-		const AllocT& alloc) :
+		const AllocT& alloc, const position start) :
 		_current_token{token::create(token_type::eof)},
 		_current_it{first}, _last_it{last},
 		_id_pool{id_pool}, _lit_pool{lit_pool},
-		_line{1}, _column{1},
+		_line{start.line()}, _column{start.column()},
 		_lexbuf{alloc}
 	{
 		advance();
@@ -49,23 +49,73 @@ namespace minijava
 					}
 				}
 			}
+
+			// A value can be selected by a conditional move if it is a plain
+			// integer or reference value.  Flags (mode b) never live in data
+			// registers so they must still be handled via control flow.
+			bool is_cmov_value(const firm::ir_node* node)
+			{
+				const auto mode = firm::get_irn_mode(node);
+				return (mode != firm::mode_b)
+					&& (firm::mode_is_int(mode) || firm::mode_is_reference(mode));
+			}
+
+			// Our own backend can select a Mux with `setcc` or `cmov` if its
+			// selector is a comparison of two data values and both
+			// alternatives are data values.  Both alternatives are already
+			// computed in Firm so keeping such a Mux never adds side effects.
+			bool is_cheap_mux(const firm::ir_node* sel,
+			                  const firm::ir_node* mux_false,
+			                  const firm::ir_node* mux_true)
+			{
+				if (!firm::is_Cmp(sel)) {
+					return false;
+				}
+				return is_cmov_value(firm::get_Cmp_left(sel))
+					&& is_cmov_value(firm::get_Cmp_right(sel))
+					&& is_cmov_value(mux_false)
+					&& is_cmov_value(mux_true);
+			}
+
+			int allow_if_conversion(const firm::ir_node* sel,
+			                        const firm::ir_node* mux_false,
+			                        const firm::ir_node* mux_true)
+			{
+				return is_cheap_mux(sel, mux_false, mux_true);
+			}
+
+			// Callback for `firm::lower_mux` that returns non-zero if the Mux
+			// has to be turned into control flow.
+			int must_lower_mux(firm::ir_node* mux)
+			{
+				const auto sel = firm::get_Mux_sel(mux);
+				const auto mux_false = firm::get_Mux_false(mux);
+				const auto mux_true = firm::get_Mux_true(mux);
+				return !is_cheap_mux(sel, mux_false, mux_true);
+			}
 		}
 
-		void layout_graphs()
+		void layout_graphs(const bool keep_cheap_muxes)
 		{
 			auto num_graphs = firm::get_irp_n_irgs();
 			for (size_t i = 0; i < num_graphs; i++) {
 				auto irg = firm::get_irp_irg(i);
-				firm::lower_mux(irg, nullptr);
+				if (keep_cheap_muxes) {
+					// turn small diamonds (min, max, abs, ...) into Mux nodes
+					firm::opt_if_conv_cb(irg, allow_if_conversion);
+					firm::lower_mux(irg, must_lower_mux);
+				} else {
+					firm::lower_mux(irg, nullptr);
+				}
 			}
 		}
 
-		void lower()
+		void lower(const bool keep_cheap_muxes)
 		{
 			// layout all types for later use
 			layout_types();
 			// layout graphs
-			layout_graphs();
+			layout_graphs(keep_cheap_muxes);
 			// replaces Offsets, TypeConsts by real constants(if possible)
 			// replaces Members and Sel nodes by address computation
 			firm::lower_highlevel();
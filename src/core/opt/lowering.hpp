@@ -18,8 +18,18 @@ namespace minijava
 		 * @brief
 		 *     Prepares the firm graph for conversion to assembly code.
 		 *
+		 * If `keep_cheap_muxes` is set, small diamonds are converted into Mux
+		 * nodes.  Mux nodes that select between two data values based on a
+		 * comparison are kept so our own backend can emit `setcc` or `cmov`
+		 * for them; all other Mux nodes are lowered to control flow.
+		 * Otherwise, all Mux nodes are lowered to control flow, which is what
+		 * libFirm's backend expects from us.
+		 *
+		 * @param keep_cheap_muxes
+		 *     whether to keep Mux nodes our own backend can select
+		 *
 		 */
-		void lower();
+		void lower(bool keep_cheap_muxes);
 
 	}  // namespace opt
 
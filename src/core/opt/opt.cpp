@@ -69,7 +69,7 @@ namespace minijava
 		}
 	}
 
-	void optimize(firm_ir& ir)
+	void optimize(firm_ir& ir, const bool keep_cheap_muxes)
 	{
 		const auto guard = make_irp_guard(*ir->second, ir->first);
 		bool changed;
@@ -84,7 +84,7 @@ namespace minijava
 		} while (changed && count++ < max_count);
 		auto helper = opt::ssa_helper();
 		helper.optimize(ir);
-		opt::lower();
+		opt::lower(keep_cheap_muxes);
 	}
 
 	void register_optimization(std::unique_ptr<minijava::opt::optimization> opt)
@@ -92,6 +92,11 @@ namespace minijava
 		optimizations.push_back(std::move(opt));
 	}
 
+	void clear_optimizations()
+	{
+		optimizations.clear();
+	}
+
 	void register_all_optimizations()
 	{
 		// loop over all optimizations and add them
@@ -258,6 +263,11 @@ namespace minijava
 	}
 
 	void register_optimization(const std::string& opt)
+	{
+		register_optimization(create_optimization(opt));
+	}
+
+	std::unique_ptr<minijava::opt::optimization> create_optimization(const std::string& opt)
 	{
 		auto& mapping = get_opt_constr_mapping();
 		auto it = mapping.find(opt);
@@ -266,7 +276,7 @@ namespace minijava
 		{
 			throw std::runtime_error("no known optimization '" + opt + "'");
 		}
-		register_optimization(it->second());
+		return it->second();
 	}
 
 	const std::vector<std::string>& get_optimization_names()
@@ -188,11 +188,18 @@ namespace minijava
 	 * @brief
 	 *     Optimizes the given Firm IRG.
 	 *
+	 * Mux nodes are only kept for the comparisons our own backend can select
+	 * with `setcc` or `cmov` if `keep_cheap_muxes` is set.  Pass `false` if
+	 * the IRG is handed to libFirm's backend.
+	 *
 	 * @param ir
 	 *     IRG to optimize
 	 *
+	 * @param keep_cheap_muxes
+	 *     whether the IRG will be lowered for our own backend
+	 *
 	 */
-	void optimize(firm_ir& ir);
+	void optimize(firm_ir& ir, bool keep_cheap_muxes = true);
 
 	/**
 	 * @brief
@@ -208,6 +215,15 @@ namespace minijava
 	 */
 	void register_optimization(std::unique_ptr<minijava::opt::optimization> opt);
 
+	/**
+	 * @brief
+	 *     Unregisters all optimizations registered so far
+	 *
+	 * This is needed before compiling another program in the same process
+	 * because optimizations may keep state between runs.
+	 */
+	void clear_optimizations();
+
 	/**
 	 * @brief
 	 *     Registers a single optimization by name to be evaluated before running the backend
@@ -217,6 +233,24 @@ namespace minijava
 	 */
 	void register_optimization(const std::string& opt);
 
+	/**
+	 * @brief
+	 *     Creates a single optimization by name without registering it.
+	 *
+	 * This is useful for running an optimization in isolation, for example,
+	 * in benchmarks.
+	 *
+	 * @param opt
+	 *     Name of the optimization
+	 *
+	 * @returns
+	 *     new optimization object
+	 *
+	 * @throws std::runtime_error
+	 *     if there is no optimization with that name
+	 */
+	std::unique_ptr<minijava::opt::optimization> create_optimization(const std::string& opt);
+
 	/**
 	 * @brief
 	 *     Returns the names of all optimizations.
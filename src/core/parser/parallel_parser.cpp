@@ -0,0 +1,143 @@
+#include "parser/parallel_parser.hpp"
+
+#include "global.hpp"
+#include "parser/for_each_node.hpp"
+
+
+namespace minijava
+{
+
+	namespace /* anonymous */
+	{
+
+		// Whether the lexer accepts line comments.
+		constexpr bool line_comments() noexcept
+		{
+#if MINIJAVA_LINE_COMMENTS
+			return true;
+#else
+			return false;
+#endif
+		}
+
+		class id_shifter final : public for_each_node
+		{
+		public:
+
+			explicit id_shifter(const std::size_t offset) noexcept : _offset{offset}
+			{
+			}
+
+			using for_each_node::visit;
+
+		protected:
+
+			void visit_node(const ast::node& node) override
+			{
+				if (node.id() == 0) {
+					return;
+				}
+				auto mutator = ast::node::mutator{};
+				mutator.id = node.id() + _offset;
+				mutator.position = node.position();
+				// All nodes come from the non-`const` `class_declaration`
+				// that was passed to `shift_node_ids`.
+				mutator(const_cast<ast::node&>(node));
+			}
+
+		private:
+
+			std::size_t _offset{};
+
+		};
+
+	}  // namespace /* anonymous */
+
+
+	namespace detail
+	{
+
+		void shift_node_ids(ast::class_declaration& node, const std::size_t offset)
+		{
+			auto shifter = id_shifter{offset};
+			node.accept(shifter);
+		}
+
+	}  // namespace detail
+
+
+	std::vector<source_chunk> split_class_declarations(const char*const first, const char*const last)
+	{
+		auto chunks = std::vector<source_chunk>{};
+		auto chunk_first = first;
+		auto chunk_start = position{1, 1};
+		auto line = std::size_t{1};
+		auto column = std::size_t{1};
+		auto depth = std::size_t{};
+		auto it = first;
+		// Moves to the next character and updates the position the same way
+		// the lexer does.
+		const auto next = [&](){
+			++it;
+			if (it == last) {
+				return;
+			} else if (*it == '\n') {
+				line += 1;
+				column = 0;
+			} else {
+				column += 1;
+			}
+		};
+		const auto looking_at = [&](const char c1, const char c2){
+			return (last - it >= 2) && (it[0] == c1) && (it[1] == c2);
+		};
+		while (it != last) {
+			if (looking_at('/', '*')) {
+				next();
+				next();
+				while (!looking_at('*', '/')) {
+					if (it == last) {
+						return {};
+					}
+					next();
+				}
+				next();
+				next();
+				continue;
+			}
+			if (line_comments() && looking_at('/', '/')) {
+				while ((it != last) && (*it != '\n') && (*it != '\r')) {
+					next();
+				}
+				continue;
+			}
+			const auto c = *it;
+			next();
+			if (c == '{') {
+				depth += 1;
+			} else if (c == '}') {
+				if (depth == 0) {
+					return {};
+				}
+				depth -= 1;
+				if (depth == 0) {
+					chunks.push_back({chunk_first, it, chunk_start});
+					chunk_first = it;
+					chunk_start = position{line, column};
+				}
+			}
+		}
+		if (depth > 0) {
+			return {};
+		}
+		if (chunk_first != last) {
+			if (chunks.empty()) {
+				chunks.push_back({chunk_first, last, chunk_start});
+			} else {
+				chunks.back().last = last;
+			}
+		}
+		return chunks;
+	}
+
+}  // namespace minijava
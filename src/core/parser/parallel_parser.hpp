@@ -0,0 +1,122 @@
+/**
+ * @file parallel_parser.hpp
+ *
+ * @brief
+ *     Lexing and parsing of the class declarations of a program on multiple
+ *     threads.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "parser/ast.hpp"
+#include "parser/ast_factory.hpp"
+#include "position.hpp"
+
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     Part of a source file that can be lexed and parsed on its own.
+	 *
+	 */
+	struct source_chunk
+	{
+		/** @brief Pointer to the first character of the chunk. */
+		const char* first;
+
+		/** @brief Pointer after the last character of the chunk. */
+		const char* last;
+
+		/** @brief Position of the first character as the lexer sees it. */
+		minijava::position start;
+	};
+
+	/**
+	 * @brief
+	 *     Splits a source file into chunks with one top-level class
+	 *     declaration each.
+	 *
+	 * This is a purely structural scan that only looks at braces and comments.
+	 * A chunk ends after each `}` that closes the outermost pair of braces.
+	 * Any text after the last such `}` is added to the last chunk.  The
+	 * chunks are contiguous and cover the entire input.
+	 *
+	 * If the braces are not balanced or a comment is not closed, an empty
+	 * vector is `return`ed.  The scan doesn't verify anything else, so the
+	 * chunks may still contain syntax errors.
+	 *
+	 * @param first
+	 *     pointer to the first character of the source
+	 *
+	 * @param last
+	 *     pointer after the last character of the source
+	 *
+	 * @returns
+	 *     chunks in source order or an empty vector
+	 *
+	 */
+	std::vector<source_chunk> split_class_declarations(const char* first, const char* last);
+
+	/**
+	 * @brief
+	 *     Lexes and parses a MiniJava program, using up to `threads` threads.
+	 *
+	 * The input is split with `split_class_declarations` and each chunk is
+	 * lexed and parsed on its own.  Afterwards, the IDs of the nodes are
+	 * adjusted so the result is exactly the same as if the whole input had
+	 * been parsed sequentially with `factory`, including the IDs of the nodes
+	 * and the state of `factory` afterwards.
+	 *
+	 * If the input cannot be split or if any chunk has a lexical or syntax
+	 * error, the whole input is parsed again sequentially, so the reported
+	 * error is always the one of a sequential parse.
+	 *
+	 * A `concurrent_symbol_pool` is shared by the threads as it is.  Access to
+ * any other kind of `pool` is serialized so it need not be thread-safe
+ * itself.
+	 *
+	 * @tparam PoolT
+	 *     symbol pool type
+	 *
+	 * @param first
+	 *     pointer to the first character of the source
+	 *
+	 * @param last
+	 *     pointer after the last character of the source
+	 *
+	 * @param pool
+	 *     symbol pool for identifiers and integer literals
+	 *
+	 * @param factory
+	 *     factory to create AST nodes
+	 *
+	 * @param threads
+	 *     maximum number of threads to use
+	 *
+	 * @returns
+	 *     AST for the given program
+	 *
+	 * @throws lexical_error
+	 *     if the input contains invalid tokens
+	 *
+	 * @throws syntax_error
+	 *     if the input is not a syntactical correct MiniJava program
+	 *
+	 */
+	template <typename PoolT>
+	std::unique_ptr<ast::program>
+	parse_source(const char* first, const char* last, PoolT& pool, ast_factory& factory, std::size_t threads = 1);
+
+}  // namespace minijava
+
+
+#define MINIJAVA_INCLUDED_FROM_PARSER_PARALLEL_PARSER_HPP
+#include "parser/parallel_parser.tpp"
+#undef MINIJAVA_INCLUDED_FROM_PARSER_PARALLEL_PARSER_HPP
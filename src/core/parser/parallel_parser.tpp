@@ -0,0 +1,144 @@
+#ifndef MINIJAVA_INCLUDED_FROM_PARSER_PARALLEL_PARSER_HPP
+#error "Never `#include <parser/parallel_parser.tpp>` directly; `#include <parser/parallel_parser.hpp>` instead."
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+#include "lexer/lexer.hpp"
+#include "lexer/token_iterator.hpp"
+#include "parser/parser.hpp"
+#include "source_error.hpp"
+#include "symbol/concurrent_symbol_pool.hpp"
+#include "system/workers.hpp"
+
+
+namespace minijava
+{
+
+	namespace detail
+	{
+
+		// Adds `offset` to the IDs of all nodes in the AST rooted at `node`
+		// that have a non-zero ID.
+		void shift_node_ids(ast::class_declaration& node, std::size_t offset);
+
+		// Symbol pool adapter that serializes the access to a symbol pool so
+		// the lexers on different threads can share it.
+		template <typename PoolT>
+		class locked_pool final
+		{
+		public:
+
+			explicit locked_pool(PoolT& pool) : _pool{pool}
+			{
+			}
+
+			template <typename StringT>
+			auto normalize(const StringT& text)
+			{
+				const std::lock_guard<std::mutex> lock{_mutex};
+				return _pool.normalize(text);
+			}
+
+		private:
+
+			PoolT& _pool;
+
+			std::mutex _mutex{};
+
+		};
+
+		// Type through which the lexers on different threads access a symbol
+		// pool of type `PoolT`.  A `concurrent_symbol_pool` can be shared as
+		// it is; any other pool is wrapped in a `locked_pool`.
+		template <typename PoolT>
+		struct shared_pool
+		{
+			using type = locked_pool<PoolT>;
+		};
+
+		template <typename AllocT>
+		struct shared_pool<concurrent_symbol_pool<AllocT>>
+		{
+			using type = concurrent_symbol_pool<AllocT>&;
+		};
+
+		// Class declarations of a single `source_chunk` and the number of
+		// IDs their nodes use.
+		struct parsed_chunk
+		{
+			std::vector<std::unique_ptr<ast::class_declaration>> classes{};
+			std::size_t ids{};
+		};
+
+	}  // namespace detail
+
+
+	template <typename PoolT>
+	std::unique_ptr<ast::program>
+	parse_source(const char* first, const char* last, PoolT& pool, ast_factory& factory, const std::size_t threads)
+	{
+		const auto parse_sequentially = [&](){
+			auto lex = make_lexer(first, last, pool, pool);
+			return parse_program(token_begin(lex), token_end(lex), factory);
+		};
+		if (threads < 2) {
+			return parse_sequentially();
+		}
+		const auto chunks = split_class_declarations(first, last);
+		if (chunks.size() < 2) {
+			return parse_sequentially();
+		}
+		using shared_type = typename detail::shared_pool<PoolT>::type;
+		using shared_pool_type = std::remove_reference_t<shared_type>;
+		shared_type shared{pool};
+		auto parts = std::vector<detail::parsed_chunk>(chunks.size());
+		std::atomic<bool> failed{false};
+		run_worker_threads(chunks.size(), threads, [&](const std::size_t i){
+			if (failed) {
+				return;
+			}
+			const auto& chunk = chunks[i];
+			auto chunk_factory = ast_factory{};
+			try {
+				auto lex = lexer<const char*, shared_pool_type, shared_pool_type>{
+					chunk.first, chunk.last, shared, shared, std::allocator<char>{}, chunk.start
+				};
+				parts[i].classes = parse_class_declarations(token_begin(lex), token_end(lex), chunk_factory);
+				parts[i].ids = chunk_factory.id();
+			} catch (const source_error&) {
+				failed = true;
+			}
+		});
+		if (failed) {
+			return parse_sequentially();
+		}
+		// Each chunk starts with ID 1, so the IDs have to be shifted by the
+		// number of IDs in all previous chunks to match a sequential parse.
+		auto offsets = std::vector<std::size_t>(parts.size());
+		auto lastid = factory.id();
+		for (auto i = std::size_t{}; i < parts.size(); ++i) {
+			offsets[i] = lastid;
+			lastid += parts[i].ids;
+		}
+		run_worker_threads(parts.size(), threads, [&parts, &offsets](const std::size_t i){
+			for (auto& clazz : parts[i].classes) {
+				detail::shift_node_ids(*clazz, offsets[i]);
+			}
+		});
+		auto classes = std::vector<std::unique_ptr<ast::class_declaration>>{};
+		for (auto& part : parts) {
+			std::move(std::begin(part.classes), std::end(part.classes), std::back_inserter(classes));
+		}
+		factory = ast_factory{lastid};
+		return factory.make<ast::program>()(std::move(classes));
+	}
+
+}  // namespace minijava
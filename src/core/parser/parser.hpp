@@ -8,8 +8,10 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <stdexcept>
+#include <vector>
 
 #include "lexer/token.hpp"
 #include "parser/ast.hpp"
@@ -107,6 +109,38 @@ namespace minijava
 	template<typename InIterT>
 	std::unique_ptr<ast::program> parse_program(InIterT first, InIterT last);
 
+	/**
+	 * @brief
+	 *     Parses a sequence of tokens as the class declarations of a MiniJava
+	 *     program.
+	 *
+	 * This function accepts the same input as `parse_program` and creates the
+	 * same nodes in the same order except for the final `ast::program` node.
+	 *
+	 * @tparam InIterT
+	 *     input iterator type of the token iterator
+	 *
+	 * @param first
+	 *     iterator pointing at the first token of the program
+	 *
+	 * @param last
+	 *     iterator pointing after the last token of the program
+	 *
+	 * @param factory
+	 *     factory to create AST nodes
+	 *
+	 * @returns
+	 *     ASTs for the class declarations in the given program
+	 *
+	 * @throws syntax_error
+	 *     if the token sequence `[first, last)` is not a syntactical correct
+	 *     MiniJava program
+	 *
+	 */
+	template<typename InIterT>
+	std::vector<std::unique_ptr<ast::class_declaration>>
+	parse_class_declarations(InIterT first, InIterT last, ast_factory& factory);
+
 }  // namespace minijava
 
 
@@ -8,6 +8,7 @@
 #include <memory>
 #include <utility>
 #include <stack>
+#include <vector>
 
 #include "exceptions.hpp"
 #include "lexer/token_type.hpp"
@@ -107,6 +108,12 @@ namespace minijava
 			}
 
 			ast_ptr<ast::program> parse_program()
+			{
+				auto classes = parse_class_declarations();
+				return make<ast::program>()(std::move(classes));
+			}
+
+			std::vector<ast_ptr<ast::class_declaration>> parse_class_declarations()
 			{
 				std::vector<ast_ptr<ast::class_declaration>> classes;
 				while (!current_is(token_type::eof)) {
@@ -114,7 +121,7 @@ namespace minijava
 					auto decl = parse_class_declaration();
 					classes.push_back(std::move(decl));
 				}
-				return make<ast::program>()(std::move(classes));
+				return classes;
 			}
 
 			ast_ptr<ast::class_declaration> parse_class_declaration()
@@ -828,4 +835,12 @@ namespace minijava
 		return parse_program(first, last, factory);
 	}
 
+	template<typename InIterT>
+	std::vector<std::unique_ptr<ast::class_declaration>>
+	parse_class_declarations(const InIterT first, const InIterT last, ast_factory& factory)
+	{
+		auto parser = detail::parser<InIterT>(first, last, factory);
+		return parser.parse_class_declarations();
+	}
+
 }  // namespace minijava
@@ -1,8 +1,11 @@
 #include "runtime/host_cc.hpp"
 
+#include <cstdio>
 #include <cstdlib>
 #include <stdexcept>
 #include <string>
+#include <system_error>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
@@ -28,40 +31,192 @@ namespace minijava
 #endif
 	}
 
+	namespace /* anonymous */
+	{
+
+		// Runs the C compiler with the given command line and translates
+		// any error into a `std::runtime_error`.
+		void run_host_cc(const std::vector<std::string>& command)
+		{
+			using namespace std::string_literals;
+			try {
+				run_subprocess(command);
+			} catch (const std::exception& e) {
+				throw std::runtime_error{
+					"Cannot run host assembler and linker: "s + e.what()
+				};
+			}
+		}
+
+		// `return`s a unique name for a temporary file with the extension
+		// `ext` (which must include the leading dot).
+		std::string make_temporary_filename(const std::string& ext)
+		{
+			namespace fs = boost::filesystem;
+			const auto pattern = fs::temp_directory_path() / ("%%%%%%%%%%%%" + ext);
+			return fs::unique_path(pattern).string();
+		}
+
+		// Writes the source code of the runtime `library` into a new
+		// temporary file and `return`s its name.  The caller is responsible
+		// for deleting the file again.
+		std::string write_runtime_source(const runtime_library library)
+		{
+			auto runtime_filename = make_temporary_filename(".c");
+			auto runtime_file = file_output{runtime_filename};
+			runtime_file.write(runtime_source(library));
+			runtime_file.close();
+			return runtime_filename;
+		}
+
+		// Flags needed to compile the runtime `library`.
+		std::vector<std::string> runtime_compile_flags(const runtime_library library)
+		{
+			if (library == runtime_library::nolibc) {
+				// The runtime brings its own entry point and must not depend
+				// on anything from libc (such as the stack protector).
+				return {"-ffreestanding", "-fno-stack-protector"};
+			}
+			return {};
+		}
+
+		// Command line for linking with the runtime `library`, except for
+		// the input and output files.
+		std::vector<std::string> link_command(const std::string& compiler_executable,
+		                                      const runtime_library library)
+		{
+			auto command = std::vector<std::string>{
+				compiler_executable,
+				"-g",
+				/* On some systems, ld creates position-independent
+				 * executables by default (for ASLR), which causes a linker
+				 * error since our assembly is not position-independent.
+				 * The easiest way to disable this behavior in a portable
+				 * manner is to link everything statically. */
+				"-static",
+				"-m64",
+			};
+			if (library == runtime_library::nolibc) {
+				command.push_back("-nostdlib");
+			}
+			return command;
+		}
+
+		// Command line for linking assembly read from standard input with
+		// the runtime `library` in `runtime_filename` which is either its
+		// source code or a precompiled object file.
+		std::vector<std::string> piped_link_command(const std::string& compiler_executable,
+		                                            const std::string& output_filename,
+		                                            const runtime_library library,
+		                                            const std::string& runtime_filename,
+		                                            const bool from_source)
+		{
+			auto command = link_command(compiler_executable, library);
+			if (from_source) {
+				const auto flags = runtime_compile_flags(library);
+				command.insert(command.end(), flags.begin(), flags.end());
+			}
+			command.insert(command.end(), {
+				"-o", output_filename,
+				"-x", "assembler", "-",
+				"-x", "none", runtime_filename,
+			});
+			return command;
+		}
+
+	}  // namespace /* anonymous */
+
+	void link_runtime(const std::string& compiler_executable,
+	                  const std::string& output_filename,
+	                  const std::string& assembly_filename,
+	                  const runtime_library library)
+	{
+		const auto runtime_filename = write_runtime_source(library);
+		const file_cleanup rtlib_cleanup_guard{runtime_filename};
+		auto command = link_command(compiler_executable, library);
+		const auto flags = runtime_compile_flags(library);
+		command.insert(command.end(), flags.begin(), flags.end());
+		command.insert(command.end(), {"-o", output_filename, assembly_filename, runtime_filename});
+		run_host_cc(command);
+	}
+
+	runtime_object::runtime_object(const std::string& compiler_executable,
+	                               const runtime_library library)
+		: _filename{make_temporary_filename(".o")}
+		, _cleanup{_filename}
+		, _compiler{compiler_executable}
+		, _library{library}
+	{
+		const auto runtime_filename = write_runtime_source(library);
+		const file_cleanup rtlib_cleanup_guard{runtime_filename};
+		auto command = std::vector<std::string>{compiler_executable, "-g", "-m64", "-c"};
+		const auto flags = runtime_compile_flags(library);
+		command.insert(command.end(), flags.begin(), flags.end());
+		command.insert(command.end(), {"-o", _filename, runtime_filename});
+		run_host_cc(command);
+	}
+
 	void link_runtime(const std::string& compiler_executable,
 	                  const std::string& output_filename,
-	                  const std::string& assembly_filename)
+	                  const std::string& assembly_filename,
+	                  const runtime_object& runtime)
+	{
+		auto command = link_command(compiler_executable, runtime.library());
+		command.insert(command.end(), {"-o", output_filename, assembly_filename, runtime.filename()});
+		run_host_cc(command);
+	}
+
+	assembly_pipe::assembly_pipe(const std::string& compiler_executable,
+	                             const std::string& output_filename,
+	                             const runtime_library library)
+		: _runtime_source{write_runtime_source(library)}
+		, _cleanup{_runtime_source}
+		, _compiler{piped_link_command(compiler_executable, output_filename, library, _runtime_source, true), true}
+		, _assembly{_compiler.input(), "<pipe to " + compiler_executable + ">"}
+	{
+	}
+
+	assembly_pipe::assembly_pipe(const std::string& compiler_executable,
+	                             const std::string& output_filename,
+	                             const runtime_object& runtime)
+		: _runtime_source{}
+		, _cleanup{_runtime_source}
+		, _compiler{piped_link_command(compiler_executable, output_filename, runtime.library(), runtime.filename(), false), true}
+		, _assembly{_compiler.input(), "<pipe to " + compiler_executable + ">"}
+	{
+	}
+
+	assembly_pipe::~assembly_pipe()
+	{
+		// The C compiler would otherwise happily link the partial assembly.
+		if (const auto fp = _assembly.handle()) {
+			std::fputs("\n\t.error \"incomplete assembly\"\n", fp);
+		}
+	}
+
+	void assembly_pipe::finish()
 	{
-		namespace fs = boost::filesystem;
 		using namespace std::string_literals;
-		const auto pattern = fs::temp_directory_path() / "%%%%%%%%%%%%.c";
-		auto tmp_path = fs::unique_path(pattern);
-		const file_cleanup rtlib_cleanup_guard{tmp_path.string()};
-		auto runtime_filename = tmp_path.string();
-		auto runtime_file = file_output{runtime_filename};
-		runtime_file.write(runtime_source());
-		runtime_file.close();
+		auto write_error = std::string{};
 		try {
-			run_subprocess({
-					compiler_executable,
-					"-g",
-					/* On some systems, ld creates position-independent
-					 * executables by default (for ASLR), which causes a linker
-					 * error since our assembly is not position-independent.
-					 * The easiest way to disable this behavior in a portable
-					 * manner is to link everything statically. */
-					"-static",
-					"-m64",
-					"-o",
-					output_filename,
-					assembly_filename,
-					runtime_filename,
-			});
+			_assembly.flush();
+		} catch (const std::system_error& e) {
+			// Most likely the compiler has died, which is reported below.
+			write_error = e.what();
+		}
+		_assembly = file_output{};
+		try {
+			_compiler.wait();
 		} catch (const std::exception& e) {
 			throw std::runtime_error{
 				"Cannot run host assembler and linker: "s + e.what()
 			};
 		}
+		if (!write_error.empty()) {
+			throw std::runtime_error{
+				"Cannot write assembly to host assembler: " + write_error
+			};
+		}
 	}
 
 }  // namespace minijava
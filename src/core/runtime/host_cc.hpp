@@ -10,6 +10,11 @@
 
 #include <string>
 
+#include "io/file_cleanup.hpp"
+#include "io/file_output.hpp"
+#include "runtime/runtime.hpp"
+#include "system/subprocess.hpp"
+
 namespace minijava
 {
 
@@ -29,6 +34,9 @@ namespace minijava
 	 *     Links the given assembly against the minijava runtime using the
 	 *     given C compiler.
 	 *
+	 * The assembly may also be an object file (with the extension `.o`) in
+	 * which case the C compiler only has to link it.
+	 *
 	 * @param compiler_executable
 	 *     executable of the (GCC-compatible) C compiler
 	 *
@@ -36,7 +44,10 @@ namespace minijava
 	 *     path to the output file
 	 *
 	 * @param assembly_filename
-	 *     path to the assembly file containing the minijava program
+	 *     path to the assembly or object file containing the minijava program
+	 *
+	 * @param library
+	 *     implementation of the runtime support library to link
 	 *
 	 * @throws std::runtime_error
 	 *     if the compiler did not execute successfully
@@ -44,6 +55,258 @@ namespace minijava
 	 */
 	void link_runtime(const std::string& compiler_executable,
 	                  const std::string& output_filename,
-	                  const std::string& assembly_filename);
+	                  const std::string& assembly_filename,
+	                  runtime_library library = runtime_library::libc);
+
+	/**
+	 * @brief
+	 *     Object file with the compiled minijava runtime that can be linked
+	 *     into any number of programs.
+	 *
+	 * Compiling the runtime takes much longer than linking it.  When many
+	 * programs are compiled in one process, the runtime should therefore
+	 * only be compiled once.  The object file is a temporary file that is
+	 * deleted again when the `runtime_object` is destroyed.
+	 *
+	 */
+	class runtime_object final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Compiles the runtime into a temporary object file.
+		 *
+		 * @param compiler_executable
+		 *     executable of the (GCC-compatible) C compiler
+		 *
+		 * @param library
+		 *     implementation of the runtime support library to compile
+		 *
+		 * @throws std::runtime_error
+		 *     if the compiler did not execute successfully
+		 *
+		 */
+		runtime_object(const std::string& compiler_executable, runtime_library library);
+
+		/**
+		 * @brief
+		 *     `return`s the file name of the object file.
+		 *
+		 * @returns
+		 *     file name
+		 *
+		 */
+		const std::string& filename() const noexcept
+		{
+			return _filename;
+		}
+
+		/**
+		 * @brief
+		 *     `return`s the C compiler that compiled the object file.
+		 *
+		 * @returns
+		 *     compiler executable
+		 *
+		 */
+		const std::string& compiler() const noexcept
+		{
+			return _compiler;
+		}
+
+		/**
+		 * @brief
+		 *     `return`s the implementation of the runtime in the object file.
+		 *
+		 * @returns
+		 *     runtime library
+		 *
+		 */
+		runtime_library library() const noexcept
+		{
+			return _library;
+		}
+
+	private:
+
+		/** @brief Name of the object file. */
+		std::string _filename;
+
+		/** @brief Guard that deletes the object file again. */
+		file_cleanup _cleanup;
+
+		/** @brief C compiler that compiled the object file. */
+		std::string _compiler;
+
+		/** @brief Implementation of the runtime in the object file. */
+		runtime_library _library;
+
+	};
+
+	/**
+	 * @brief
+	 *     Links the given assembly against a precompiled minijava runtime
+	 *     using the given C compiler.
+	 *
+	 * This function behaves like the overload that compiles the runtime from
+	 * source except that it only has to run the linker.
+	 *
+	 * @param compiler_executable
+	 *     executable of the (GCC-compatible) C compiler
+	 *
+	 * @param output_filename
+	 *     path to the output file
+	 *
+	 * @param assembly_filename
+	 *     path to the assembly or object file containing the minijava program
+	 *
+	 * @param runtime
+	 *     precompiled runtime
+	 *
+	 * @throws std::runtime_error
+	 *     if the compiler did not execute successfully
+	 *
+	 */
+	void link_runtime(const std::string& compiler_executable,
+	                  const std::string& output_filename,
+	                  const std::string& assembly_filename,
+	                  const runtime_object& runtime);
+
+	/**
+	 * @brief
+	 *     Links assembly against the minijava runtime while the assembly is
+	 *     still being generated.
+	 *
+	 * The constructor starts the C compiler reading the assembly from a pipe.
+	 * The caller writes the assembly to `assembly` and then calls `finish`
+	 * to wait for the compiler.  That way, assembling overlaps with code
+	 * generation and no temporary file is needed for the assembly.  The
+	 * assembly must be textual; object code cannot be linked from a pipe.
+	 *
+	 * If the object is destroyed without calling `finish` (for example,
+	 * because generating the assembly failed), the assembly is terminated
+	 * with an error directive so the compiler fails and produces no output.
+	 *
+	 */
+	class assembly_pipe final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Starts the C compiler linking against a runtime that it
+		 *     compiles from source.
+		 *
+		 * @param compiler_executable
+		 *     executable of the (GCC-compatible) C compiler
+		 *
+		 * @param output_filename
+		 *     path to the output file
+		 *
+		 * @param library
+		 *     implementation of the runtime support library to link
+		 *
+		 * @throws std::runtime_error
+		 *     if the compiler cannot be started
+		 *
+		 */
+		assembly_pipe(const std::string& compiler_executable,
+		              const std::string& output_filename,
+		              runtime_library library = runtime_library::libc);
+
+		/**
+		 * @brief
+		 *     Starts the C compiler linking against a precompiled runtime.
+		 *
+		 * @param compiler_executable
+		 *     executable of the (GCC-compatible) C compiler
+		 *
+		 * @param output_filename
+		 *     path to the output file
+		 *
+		 * @param runtime
+		 *     precompiled runtime
+		 *
+		 * @throws std::runtime_error
+		 *     if the compiler cannot be started
+		 *
+		 */
+		assembly_pipe(const std::string& compiler_executable,
+		              const std::string& output_filename,
+		              const runtime_object& runtime);
+
+		/**
+		 * @brief
+		 *     Makes the compiler fail unless `finish` was called.
+		 *
+		 */
+		~assembly_pipe();
+
+		/**
+		 * @brief
+		 *     `delete`d copy constructor.
+		 *
+		 * `assembly_pipe` objects are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 */
+		assembly_pipe(const assembly_pipe& other) = delete;
+
+		/**
+		 * @brief
+		 *     `delete`d copy-assignment operator.
+		 *
+		 * `assembly_pipe` objects are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 * @returns
+		 *     *N/A*
+		 *
+		 */
+		assembly_pipe& operator=(const assembly_pipe& other) = delete;
+
+		/**
+		 * @brief
+		 *     `return`s the stream to write the assembly to.
+		 *
+		 * @returns
+		 *     output connected to the C compiler
+		 *
+		 */
+		file_output& assembly() noexcept
+		{
+			return _assembly;
+		}
+
+		/**
+		 * @brief
+		 *     Signals the end of the assembly and waits for the C compiler.
+		 *
+		 * @throws std::runtime_error
+		 *     if the compiler did not execute successfully
+		 *
+		 */
+		void finish();
+
+	private:
+
+		/** @brief Name of the temporary runtime source file (if any). */
+		std::string _runtime_source;
+
+		/** @brief Guard that deletes the runtime source file again. */
+		file_cleanup _cleanup;
+
+		/** @brief The running C compiler. */
+		subprocess _compiler;
+
+		/** @brief Stream connected to the standard input of the compiler. */
+		file_output _assembly;
+
+	};
 
 }
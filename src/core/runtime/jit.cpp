@@ -0,0 +1,384 @@
+#include "runtime/jit.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include "exceptions.hpp"
+
+
+// Interface of the runtime support library `mj_runtime.c` compiled with
+// `MJ_RUNTIME_EMBEDDED` defined, which is linked into the compiler.  The
+// declarations must match the C source code.
+extern "C"
+{
+
+	struct mj_runtime_variables
+	{
+		char* heap_next;
+		char* heap_limit;
+		char* output_next;
+		char* output_limit;
+		char* input_next;
+		char* input_limit;
+	};
+
+	struct mj_runtime_host
+	{
+		const char* program_name;
+		std::FILE* input;
+		std::FILE* output;
+		std::FILE* error;
+		mj_runtime_variables* variables;
+		const char* data_start;
+		const char* data_end;
+	};
+
+	int mj_runtime_run(void (*entry)(), const mj_runtime_host* host);
+
+	void* mj_runtime_new(std::int32_t nmemb, std::int32_t size);
+	std::int32_t mj_runtime_id(std::int32_t x);
+	void mj_runtime_exit(std::int32_t status);
+	void mj_runtime_println(std::int32_t n);
+	void mj_runtime_write(std::int32_t b);
+	void mj_runtime_flush();
+	std::int32_t mj_runtime_read();
+
+}
+
+
+namespace minijava
+{
+
+	namespace /* anonymous */
+	{
+
+		// Platform specific memory management (see the included `.tpp`
+		// files at the end of this file).  `map_memory` must return
+		// readable and writable memory that can be addressed with 32 bit
+		// signed absolute addresses.  `protect_memory` makes the first
+		// `size` bytes read-only and executable.
+		std::size_t page_size();
+		std::uint8_t* map_memory(std::size_t size);
+		void protect_memory(std::uint8_t* data, std::size_t size);
+		void unmap_memory(std::uint8_t* data, std::size_t size) noexcept;
+
+
+		// Returns the offset of the runtime variable `name` in
+		// `mj_runtime_variables` or -1 if there is no such variable.
+		std::ptrdiff_t runtime_variable(const std::string& name)
+		{
+			if (name == "mj_runtime_heap_next") {
+				return offsetof(mj_runtime_variables, heap_next);
+			}
+			if (name == "mj_runtime_heap_limit") {
+				return offsetof(mj_runtime_variables, heap_limit);
+			}
+			if (name == "mj_runtime_output_next") {
+				return offsetof(mj_runtime_variables, output_next);
+			}
+			if (name == "mj_runtime_output_limit") {
+				return offsetof(mj_runtime_variables, output_limit);
+			}
+			if (name == "mj_runtime_input_next") {
+				return offsetof(mj_runtime_variables, input_next);
+			}
+			if (name == "mj_runtime_input_limit") {
+				return offsetof(mj_runtime_variables, input_limit);
+			}
+			return -1;
+		}
+
+		// Returns the address of the runtime function `name` or 0 if there
+		// is no such function.
+		std::uint64_t runtime_symbol(const std::string& name)
+		{
+			static const auto symbols = std::map<std::string, std::uint64_t>{
+				{"mj_runtime_new",     reinterpret_cast<std::uint64_t>(&mj_runtime_new)},
+				{"mj_runtime_id",      reinterpret_cast<std::uint64_t>(&mj_runtime_id)},
+				{"mj_runtime_exit",    reinterpret_cast<std::uint64_t>(&mj_runtime_exit)},
+				{"mj_runtime_println", reinterpret_cast<std::uint64_t>(&mj_runtime_println)},
+				{"mj_runtime_write",   reinterpret_cast<std::uint64_t>(&mj_runtime_write)},
+				{"mj_runtime_flush",   reinterpret_cast<std::uint64_t>(&mj_runtime_flush)},
+				{"mj_runtime_read",    reinterpret_cast<std::uint64_t>(&mj_runtime_read)},
+			};
+			const auto pos = symbols.find(name);
+			return (pos != symbols.end()) ? pos->second : 0;
+		}
+
+		// The runtime keeps its state in global variables so only one
+		// program may run at a time.
+		std::mutex runtime_mutex{};
+
+
+		// RAII wrapper for the memory the program is loaded into.
+		class jit_memory final
+		{
+		public:
+
+			explicit jit_memory(const std::size_t size)
+				: _data{map_memory(size)}, _size{size}
+			{
+			}
+
+			jit_memory(const jit_memory&) = delete;
+
+			jit_memory& operator=(const jit_memory&) = delete;
+
+			~jit_memory()
+			{
+				unmap_memory(_data, _size);
+			}
+
+			std::uint8_t* data() noexcept
+			{
+				return _data;
+			}
+
+		private:
+
+			std::uint8_t* _data;
+
+			std::size_t _size;
+
+		};
+
+		// Size of a stub that jumps to an external function.  The stub is
+		// `jmp *0(%rip)` followed by the absolute target address.
+		constexpr std::size_t stub_size = 16;
+
+		std::size_t align_up(const std::size_t n, const std::size_t alignment)
+		{
+			assert((alignment > 0) && ((alignment & (alignment - 1)) == 0));
+			return (n + alignment - 1) & ~(alignment - 1);
+		}
+
+		void patch(std::uint8_t* const where, const std::uint64_t value, const std::size_t size)
+		{
+			for (std::size_t i = 0; i < size; ++i) {
+				where[i] = static_cast<std::uint8_t>(value >> (8 * i));
+			}
+		}
+
+		bool fits_int32(const std::int64_t value)
+		{
+			return (value >= INT32_MIN) && (value <= INT32_MAX);
+		}
+
+		// Layout of a program in memory.  Calls to external functions go
+		// through stubs placed right after the code so they can be reached
+		// with 32 bit displacements.  Code and stubs are on their own pages
+		// so they can be made executable without making data executable.
+		// The runtime variables follow the BSS section.
+		class program_image final
+		{
+		public:
+
+			explicit program_image(const backend::object_file& obj)
+				: _obj{obj}
+			{
+				for (const auto& sym : obj.symbols) {
+					if (sym.section != backend::object_section::undefined) {
+						_defined.emplace(sym.name, &sym);
+					}
+				}
+				for (const auto& rel : obj.relocations) {
+					if ((_defined.count(rel.symbol) == 0) && (_externals.count(rel.symbol) == 0)
+							&& (runtime_variable(rel.symbol) < 0)) {
+						const auto address = runtime_symbol(rel.symbol);
+						if (address == 0) {
+							throw std::runtime_error{"Undefined reference to '" + rel.symbol + "'"};
+						}
+						_externals.emplace(rel.symbol, address);
+					}
+				}
+				const auto pagesize = page_size();
+				_stubs_offset = align_up(obj.text.size(), stub_size);
+				_code_size = _stubs_offset + stub_size * _externals.size();
+				_data_offset = align_up(_code_size, pagesize);
+				_bss_offset = align_up(_data_offset + obj.data.size(), std::max<std::size_t>(obj.bss_alignment, 1));
+				_variables_offset = align_up(_bss_offset + obj.bss_size, alignof(mj_runtime_variables));
+				_size = align_up(_variables_offset + sizeof(mj_runtime_variables), pagesize);
+				assert(obj.data_alignment <= pagesize);
+			}
+
+			std::size_t size() const noexcept
+			{
+				return _size;
+			}
+
+			std::size_t code_size() const noexcept
+			{
+				return _code_size;
+			}
+
+			// Copies the program to `base`, which must point to `size()`
+			// zero-initialized bytes, and resolves all relocations.
+			void load(std::uint8_t* const base) const
+			{
+				std::copy(_obj.text.begin(), _obj.text.end(), base);
+				std::copy(_obj.data.begin(), _obj.data.end(), base + _data_offset);
+				auto stub = base + _stubs_offset;
+				for (const auto& ext : _externals) {
+					const std::uint8_t jmp[] = {0xff, 0x25, 0x00, 0x00, 0x00, 0x00};
+					std::copy(std::begin(jmp), std::end(jmp), stub);
+					patch(stub + sizeof(jmp), ext.second, 8);
+					std::fill(stub + sizeof(jmp) + 8, stub + stub_size, 0xcc);
+					stub += stub_size;
+				}
+				for (const auto& rel : _obj.relocations) {
+					_relocate(base, rel);
+				}
+			}
+
+			// Returns the runtime variables in the image loaded at `base`.
+			mj_runtime_variables* variables(std::uint8_t* const base) const noexcept
+			{
+				return reinterpret_cast<mj_runtime_variables*>(base + _variables_offset);
+			}
+
+			// Returns the start of the static data (including the runtime
+			// variables) in the image loaded at `base`.
+			const char* data_start(std::uint8_t* const base) const noexcept
+			{
+				return reinterpret_cast<const char*>(base + _data_offset);
+			}
+
+			// Returns the end of the static data in the image loaded at
+			// `base`.
+			const char* data_end(std::uint8_t* const base) const noexcept
+			{
+				return reinterpret_cast<const char*>(base + _variables_offset + sizeof(mj_runtime_variables));
+			}
+
+			// Returns the offset of the symbol `name` in the image.
+			std::size_t offset_of(const std::string& name) const
+			{
+				const auto pos = _defined.find(name);
+				if (pos == _defined.end()) {
+					throw std::runtime_error{"Undefined reference to '" + name + "'"};
+				}
+				return _section_offset(pos->second->section) + pos->second->offset;
+			}
+
+		private:
+
+			const backend::object_file& _obj;
+
+			std::map<std::string, const backend::object_symbol*> _defined{};
+
+			std::map<std::string, std::uint64_t> _externals{};
+
+			std::size_t _stubs_offset{};
+
+			std::size_t _code_size{};
+
+			std::size_t _data_offset{};
+
+			std::size_t _bss_offset{};
+
+			std::size_t _variables_offset{};
+
+			std::size_t _size{};
+
+			std::size_t _section_offset(const backend::object_section section) const
+			{
+				switch (section) {
+				case backend::object_section::text:
+					return 0;
+				case backend::object_section::data:
+					return _data_offset;
+				case backend::object_section::bss:
+					return _bss_offset;
+				case backend::object_section::undefined:
+					break;
+				}
+				MINIJAVA_NOT_REACHED();
+			}
+
+			void _relocate(std::uint8_t* const base, const backend::relocation& rel) const
+			{
+				using backend::relocation_kind;
+				const auto where = _section_offset(rel.section) + rel.offset;
+				const auto place = reinterpret_cast<std::int64_t>(base + where);
+				const auto pos = _externals.find(rel.symbol);
+				const auto variable = runtime_variable(rel.symbol);
+				auto target = std::int64_t{};
+				if (variable >= 0) {
+					target = reinterpret_cast<std::int64_t>(base + _variables_offset + variable);
+				} else if (pos == _externals.end()) {
+					target = reinterpret_cast<std::int64_t>(base + offset_of(rel.symbol));
+				} else if (rel.kind == relocation_kind::abs64) {
+					target = static_cast<std::int64_t>(pos->second);
+				} else {
+					const auto index = std::distance(_externals.begin(), pos);
+					target = reinterpret_cast<std::int64_t>(base + _stubs_offset + stub_size * static_cast<std::size_t>(index));
+				}
+				const auto value = target + rel.addend;
+				switch (rel.kind) {
+				case relocation_kind::abs64:
+					patch(base + where, static_cast<std::uint64_t>(value), 8);
+					return;
+				case relocation_kind::pc32:
+				case relocation_kind::plt32:
+					if (!fits_int32(value - place)) {
+						throw std::runtime_error{"Relocation to '" + rel.symbol + "' out of range"};
+					}
+					patch(base + where, static_cast<std::uint64_t>(value - place), 4);
+					return;
+				case relocation_kind::abs32s:
+					if (!fits_int32(value)) {
+						throw std::runtime_error{"Relocation to '" + rel.symbol + "' out of range"};
+					}
+					patch(base + where, static_cast<std::uint64_t>(value), 4);
+					return;
+				}
+				MINIJAVA_NOT_REACHED();
+			}
+
+		};
+
+	}  // namespace /* anonymous */
+
+
+	int run_object(const backend::object_file& obj, const std::string& name,
+	               std::FILE* in, std::FILE* out, std::FILE* err)
+	{
+		const program_image image{obj};
+		const auto entry_offset = image.offset_of("minijava_main");
+		jit_memory memory{image.size()};
+		image.load(memory.data());
+		protect_memory(memory.data(), image.code_size());
+		const auto entry = reinterpret_cast<void(*)()>(memory.data() + entry_offset);
+		auto host = mj_runtime_host{};
+		host.program_name = name.c_str();
+		host.input = in;
+		host.output = out;
+		host.error = err;
+		host.variables = image.variables(memory.data());
+		host.data_start = image.data_start(memory.data());
+		host.data_end = image.data_end(memory.data());
+		// The runtime writes to the file descriptor directly.
+		std::fflush(out);
+		const std::lock_guard<std::mutex> guard{runtime_mutex};
+		return mj_runtime_run(entry, &host);
+	}
+
+}  // namespace minijava
+
+
+#define MINIJAVA_INCLUDED_FROM_RUNTIME_JIT_CPP
+#  if defined (__linux__) && defined (__x86_64__)
+#    include "runtime/jit_linux.tpp"
+#  else
+#    include "runtime/jit_generic.tpp"
+#  endif
+#undef MINIJAVA_INCLUDED_FROM_RUNTIME_JIT_CPP
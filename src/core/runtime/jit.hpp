@@ -0,0 +1,68 @@
+/**
+ * @file jit.hpp
+ *
+ * @brief
+ *     Running compiled MiniJava programs inside the compiler process.
+ *
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+
+#include "asm/elf.hpp"
+
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     Loads an object file into executable memory and runs its
+	 *     `minijava_main` function.
+	 *
+	 * References to the symbols of the MiniJava runtime support library
+	 * (see `runtime.hpp`) are resolved against the C runtime, which is linked
+	 * into the compiler, so the program behaves exactly like the executable
+	 * would.  It only reads from `in` and writes to `out` and `err` instead of
+	 * the standard streams, and `System.exit` makes this function `return`
+	 * instead of terminating the process.  All memory of the program is freed
+	 * before this function `return`s.
+	 *
+	 * The program runs on the stack of the calling thread.  Since the runtime
+	 * keeps global state, only one program runs at a time and calls from
+	 * other threads block until it terminated.
+	 *
+	 * This function is only available on x86-64 Linux.  On other platforms,
+	 * it always `throw`s a `std::system_error` with an error code of
+	 * `ENOSYS`.
+	 *
+	 * @param obj
+	 *     object file with the compiled program
+	 *
+	 * @param name
+	 *     name of the program in diagnostics of the runtime, like `argv[0]`
+	 *     of an executable
+	 *
+	 * @param in
+	 *     stream the program reads its input from
+	 *
+	 * @param out
+	 *     stream the program writes its output to
+	 *
+	 * @param err
+	 *     stream for error messages of the runtime
+	 *
+	 * @returns
+	 *     the exit status the program would have had as an executable
+	 *
+	 * @throws std::runtime_error
+	 *     if the object file references an unknown symbol or cannot be
+	 *     loaded
+	 *
+	 */
+	int run_object(const backend::object_file& obj, const std::string& name,
+	               std::FILE* in, std::FILE* out, std::FILE* err);
+
+}  // namespace minijava
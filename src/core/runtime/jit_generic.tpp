@@ -0,0 +1,35 @@
+#ifndef MINIJAVA_INCLUDED_FROM_RUNTIME_JIT_CPP
+#error "Never `#include` the source file `<runtime/jit_generic.tpp>`"
+#endif
+
+
+namespace minijava
+{
+
+	namespace /* anonymous */
+	{
+
+		std::size_t page_size()
+		{
+			return 4096;
+		}
+
+		std::uint8_t* map_memory(const std::size_t /* size */)
+		{
+			const auto ec = std::error_code{ENOSYS, std::system_category()};
+			throw std::system_error{ec, "Running programs in-process is not supported on this platform"};
+		}
+
+		void protect_memory(std::uint8_t* const /* data */, const std::size_t /* size */)
+		{
+			const auto ec = std::error_code{ENOSYS, std::system_category()};
+			throw std::system_error{ec};
+		}
+
+		void unmap_memory(std::uint8_t* const /* data */, const std::size_t /* size */) noexcept
+		{
+		}
+
+	}  // namespace /* anonymous */
+
+}  // namespace minijava
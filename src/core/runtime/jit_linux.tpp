@@ -0,0 +1,53 @@
+#ifndef MINIJAVA_INCLUDED_FROM_RUNTIME_JIT_CPP
+#error "Never `#include` the source file `<runtime/jit_linux.tpp>`"
+#endif
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+namespace minijava
+{
+
+	namespace /* anonymous */
+	{
+
+		std::size_t page_size()
+		{
+			const auto size = sysconf(_SC_PAGESIZE);
+			return (size > 0) ? static_cast<std::size_t>(size) : 4096;
+		}
+
+		std::uint8_t* map_memory(const std::size_t size)
+		{
+			// The code uses 32 bit absolute addresses for global data so it
+			// has to live in the lower 2 GiB of the address space.
+			const auto data = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+			                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+			if (data == MAP_FAILED) {
+				const auto ec = std::error_code{errno, std::system_category()};
+				throw std::system_error{ec, "Cannot allocate memory for program"};
+			}
+			return static_cast<std::uint8_t*>(data);
+		}
+
+		void protect_memory(std::uint8_t* const data, const std::size_t size)
+		{
+			if (size == 0) {
+				return;
+			}
+			const auto length = align_up(size, page_size());
+			if (mprotect(data, length, PROT_READ | PROT_EXEC) != 0) {
+				const auto ec = std::error_code{errno, std::system_category()};
+				throw std::system_error{ec, "Cannot make program executable"};
+			}
+		}
+
+		void unmap_memory(std::uint8_t* const data, const std::size_t size) noexcept
+		{
+			munmap(data, size);
+		}
+
+	}  // namespace /* anonymous */
+
+}  // namespace minijava
@@ -1,16 +1,28 @@
 #include "runtime/runtime.hpp"
 
+#include "exceptions.hpp"
+
 static const char source_code[] = {
 #include "runtime/runtime.tpp"
 };
 
+static const char source_code_nolibc[] = {
+#include "runtime/runtime_nolibc.tpp"
+};
+
 
 namespace minijava
 {
 
-	std::string runtime_source()
+	std::string runtime_source(const runtime_library library)
 	{
-		return source_code;
+		switch (library) {
+		case runtime_library::libc:
+			return source_code;
+		case runtime_library::nolibc:
+			return source_code_nolibc;
+		}
+		MINIJAVA_NOT_REACHED();
 	}
 
 }  // namespace minijava
@@ -38,6 +38,32 @@
  *
  * The whole program must still be linked to the target's C standard library.
  *
+ * Every block on the heap is preceded by a header word that holds its size in
+ * bytes (including the header).  Small objects are allocated by bumping the
+ * variable `mj_runtime_heap_next` towards `mj_runtime_heap_limit`, which the
+ * compiled code may also do inline.  Unreachable objects are reclaimed by a
+ * conservative mark-sweep garbage collector.  If the environment variable
+ * `MINIJAVA_GC_STATS` is set to a non-empty value, the program reports the
+ * pause time and heap size of each collection on standard error output.
+ *
+ * Standard input and output are buffered by the library.  The current
+ * positions and limits of the buffers are exported as `mj_runtime_input_next`,
+ * `mj_runtime_input_limit`, `mj_runtime_output_next` and
+ * `mj_runtime_output_limit` so the compiled code can read and write single
+ * bytes inline and only calls `mj_runtime_read` or `mj_runtime_write` when a
+ * position reaches its limit.
+ *
+ * On x86-64 Linux, an alternative implementation of the library is available
+ * that uses system calls directly instead of the C standard library.  It also
+ * provides the `_start` entry point instead of `main` and must be linked with
+ * `-nostdlib`.  It uses the same heap layout but never collects garbage.
+ *
+ * For running programs in-process (see `jit.hpp`), the compiler links the C
+ * implementation compiled with `MJ_RUNTIME_EMBEDDED` defined.  It provides
+ * `mj_runtime_run` instead of `main`, uses the streams and static data it is
+ * given and makes `mj_runtime_exit` `return` to the caller of
+ * `mj_runtime_run`.
+ *
  */
 
 #pragma once
@@ -48,16 +74,30 @@
 namespace minijava
 {
 
+	/**
+	 * @brief
+	 *     Implementations of the runtime support library.
+	 *
+	 */
+	enum class runtime_library
+	{
+		libc,    ///< portable implementation on top of the C standard library
+		nolibc,  ///< implementation for x86-64 Linux using system calls directly
+	};
+
 	/**
 	 * @brief
 	 *     `return`s the C source code of the runtime support library as one
 	 *     large string.
 	 *
+	 * @param library
+	 *     implementation of the library
+	 *
 	 * @returns
 	 *     C source code for runtime support library
 	 *
 	 */
 	// TODO: Return a `boost::string_ref` one we finally switch to that.
-	std::string runtime_source();
+	std::string runtime_source(runtime_library library = runtime_library::libc);
 
 }  // namespace minijava
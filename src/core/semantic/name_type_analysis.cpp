@@ -8,6 +8,7 @@
 #include <sstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include <boost/optional.hpp>
 
@@ -15,6 +16,7 @@
 #include "semantic/semantic_error.hpp"
 #include "semantic/symbol_table.hpp"
 #include "symbol/symbol.hpp"
+#include "system/workers.hpp"
 #include "util/raii.hpp"
 
 using namespace std::string_literals;
@@ -390,13 +392,17 @@ namespace minijava
 
 			public:
 
+				// The types of nodes that are not annotated by this visitor
+				// are looked up in `shared_types`, which may be the same
+				// container as `type_annotations`.
 				name_type_visitor(const class_definitions& classes,
-								  const globals_vector&    globals,
+								  const type_attributes&   shared_types,
 								  type_attributes&         type_annotations,
 								  locals_attributes&       locals_annotations,
 								  vardecl_attributes&      vardecl_annotations,
 								  method_attributes&       method_annotations)
-						: _classes{classes}, _globals{globals},
+						: _classes{classes},
+						  _shared_types{shared_types},
 						  _type_annotations{type_annotations},
 						  _locals_annotations{locals_annotations},
 						  _vardecl_annotations{vardecl_annotations},
@@ -456,8 +462,8 @@ namespace minijava
 					const auto& rhs = node.rhs();
 					lhs.accept(*this);
 					rhs.accept(*this);
-					const auto lhs_type = _type_annotations.at(lhs);
-					const auto rhs_type = _type_annotations.at(rhs);
+					const auto lhs_type = _type_of(lhs);
+					const auto rhs_type = _type_of(rhs);
 					switch (node.type()) {
 					case ast::binary_operation_type::assign:
 					{
@@ -560,7 +566,7 @@ namespace minijava
 					const auto& target = node.target();
 					const auto& index = node.index();
 					target.accept(*this);
-					auto target_type = _type_annotations.at(target);
+					auto target_type = _type_of(target);
 					if (target_type.rank == 0) {
 						throw_invalid_subscript(target_type, node);
 					}
@@ -575,7 +581,7 @@ namespace minijava
 				{
 					if (const auto target = node.target()) {
 						target->accept(*this);
-						const auto target_type = _type_annotations.at(*target);
+						const auto target_type = _type_of(*target);
 						if (target_type.rank > 0 || !target_type.info.is_reference() || target_type.info.is_null()) {
 							throw_invalid_field_access(target_type, node);
 						}
@@ -583,7 +589,7 @@ namespace minijava
 						assert(clazz);
 						if (const auto decl = clazz->get_field(node.name())) {
 							_vardecl_annotations.put(node, decl);
-							_type_annotations.put(node, _type_annotations.at(*decl));
+							_type_annotations.put(node, _type_of(*decl));
 						} else {
 							throw_unknown_field(*clazz, node);
 						}
@@ -594,7 +600,7 @@ namespace minijava
 						}
 						if (auto decl = _symbols.lookup(name)) {
 							_vardecl_annotations.put(node, decl);
-							_type_annotations.put(node, _type_annotations.at(*decl));
+							_type_annotations.put(node, _type_of(*decl));
 						} else {
 							throw_unknown_local_or_field(node);
 						}
@@ -606,7 +612,7 @@ namespace minijava
 					const ast::class_declaration* clazz = nullptr;
 					if (const auto target = node.target()) {
 						target->accept(*this);
-						const auto target_type = _type_annotations.at(*target);
+						const auto target_type = _type_of(*target);
 						if (target_type.rank > 0 || !target_type.info.is_reference() || target_type.info.is_null()) {
 							throw_invalid_method_access(target_type, node);
 						}
@@ -629,10 +635,10 @@ namespace minijava
 							const auto& argument = *arguments[i];
 							const auto& parameter = *parameters[i];
 							argument.accept(*this);
-							_check_type(_type_annotations.at(parameter), argument);
+							_check_type(_type_of(parameter), argument);
 						}
 						_method_annotations.put(node, decl);
-						_type_annotations.put(node, _type_annotations.at(*decl));
+						_type_annotations.put(node, _type_of(*decl));
 					} else {
 						throw_unknown_method(*clazz, node);
 					}
@@ -674,7 +680,7 @@ namespace minijava
 					visit(decl);
 					if (initial_expr) {
 						initial_expr->accept(*this);
-						_check_type(_type_annotations.at(decl), *initial_expr);
+						_check_type(_type_of(decl), *initial_expr);
 					}
 				}
 
@@ -713,7 +719,7 @@ namespace minijava
 				void visit(const ast::return_statement& node) override
 				{
 					assert(_cur_method);
-					const auto return_type = _type_annotations.at(*_cur_method);
+					const auto return_type = _type_of(*_cur_method);
 					const auto expr = node.value();
 					if (return_type.info.is_void()) {
 						if (expr) {
@@ -734,36 +740,23 @@ namespace minijava
 					visit_method(node);
 				}
 
-				void visit(const ast::class_declaration& node) override
+				// Analyzes a single method of `clazz` with the definitions in
+				// `scopes` visible, which are the globals and (except for
+				// `main` methods) the fields of `clazz`.  They are only read
+				// and may be shared with other visitors.
+				void visit_method_of(const ast::class_declaration& clazz,
+									 const ast::method& method,
+									 const symbol_table& scopes)
 				{
-					const auto stck_guard = _stack_scope(true);
-					const auto this_guard = set_temporarily(_this_type, _classes.at(node.name()));
-					for (const auto& main : node.main_methods()) {
-						visit(*main);
-					}
-					for (const auto& field : node.fields()) {
-						_symbols.add_def(field.get());
-					}
-					for (const auto& method : node.instance_methods()) {
-						visit(*method);
-					}
-				}
-
-				void visit(const ast::program& node) override
-				{
-					const auto stck_guard = _stack_scope(true);
-					for (const auto& glob : _globals) {
-						visit(*glob);
-					}
-					for (const auto& clazz : node.classes()) {
-						visit(*clazz);
-					}
+					_symbols = symbol_table{&scopes};
+					const auto this_guard = set_temporarily(_this_type, _classes.at(clazz.name()));
+					method.accept(*this);
 				}
 
 			private:
 
 				const class_definitions& _classes;
-				const globals_vector& _globals;
+				const type_attributes& _shared_types;
 				type_attributes& _type_annotations;
 				locals_attributes& _locals_annotations;
 				vardecl_attributes& _vardecl_annotations;
@@ -774,6 +767,16 @@ namespace minijava
 				const ast::method* _cur_method{nullptr};
 				symbol _poisoned_symbol{};
 
+				template <typename NodeT>
+				type _type_of(const NodeT& node) const
+				{
+					const auto pos = _type_annotations.find(&node);
+					if (pos != _type_annotations.end()) {
+						return pos->second;
+					}
+					return _shared_types.at(node);
+				}
+
 				bool _in_main() const noexcept
 				{
 					return !_poisoned_symbol.empty();
@@ -805,7 +808,7 @@ namespace minijava
 
 				void _check_type(const type expected, const ast::expression& expr)
 				{
-					const auto expr_type = _type_annotations.at(expr);
+					const auto expr_type = _type_of(expr);
 					if (!_is_assignable(expected, expr_type)) {
 						throw_incompatible_type(expected, expr_type, expr);
 					}
@@ -813,6 +816,131 @@ namespace minijava
 
 			};
 
+
+			// Analysis results of a single method in parallel mode.
+			struct method_shard
+			{
+				type_attributes type_annotations{};
+				locals_attributes locals_annotations{};
+				vardecl_attributes vardecl_annotations{};
+				method_attributes method_annotations{};
+				boost::optional<semantic_error> error{};
+			};
+
+			// Remembers `error` in `first` if it is the first error by
+			// position so far.  Among errors at the same position, the one
+			// that was seen first is kept.
+			void keep_first_error(boost::optional<semantic_error>& first, const semantic_error& error)
+			{
+				if (!first || (error.position() < first->position())) {
+					first = error;
+				}
+			}
+
+			// Performs the name and type analysis of the method bodies on up
+			// to `threads` threads after everything else has been annotated.
+			// Each method is analyzed on its own and if several methods
+			// contain errors, the error with the smallest position is
+			// `throw`n, so the diagnostic does not depend on `threads`.
+			void analyze_methods(const ast::program&      ast,
+								 const class_definitions& classes,
+								 const globals_vector&    globals,
+								 type_attributes&         type_annotations,
+								 locals_attributes&       locals_annotations,
+								 vardecl_attributes&      vardecl_annotations,
+								 method_attributes&       method_annotations,
+								 const std::size_t        threads)
+			{
+				struct method_job
+				{
+					const ast::class_declaration* clazz;
+					const ast::method* method;
+					const symbol_table* scopes;
+				};
+				// The scopes with the globals and with the fields of each
+				// class are built once and shared by all methods.
+				auto global_scope = symbol_table{};
+				global_scope.enter_scope(true);
+				for (const auto& glob : globals) {
+					type_annotations.put(*glob, get_type(glob->var_type(), classes, false));
+					global_scope.add_def(glob.get());
+				}
+				auto class_scopes = std::vector<symbol_table>{};
+				class_scopes.reserve(ast.classes().size());
+				auto jobs = std::vector<method_job>{};
+				for (const auto& clazz : ast.classes()) {
+					class_scopes.emplace_back(&global_scope);
+					auto& class_scope = class_scopes.back();
+					class_scope.enter_scope(true);
+					for (const auto& field : clazz->fields()) {
+						class_scope.add_def(field.get());
+					}
+					for (const auto& main : clazz->main_methods()) {
+						jobs.push_back({clazz.get(), main.get(), &global_scope});
+					}
+					for (const auto& method : clazz->instance_methods()) {
+						jobs.push_back({clazz.get(), method.get(), &class_scope});
+					}
+				}
+				auto first_error = boost::optional<semantic_error>{};
+				if (threads < 2) {
+					// Sequentially, the annotations can go right into the
+					// results.  Those of a method with an error don't matter
+					// because the analysis fails anyway.
+					for (const auto& job : jobs) {
+						auto visitor = name_type_visitor{
+								classes, type_annotations, type_annotations,
+								locals_annotations, vardecl_annotations, method_annotations
+						};
+						try {
+							visitor.visit_method_of(*job.clazz, *job.method, *job.scopes);
+						} catch (const semantic_error& e) {
+							keep_first_error(first_error, e);
+						}
+					}
+					if (first_error) {
+						throw *first_error;
+					}
+					return;
+				}
+				auto shards = std::vector<method_shard>(jobs.size());
+				run_worker_threads(jobs.size(), threads, [&](const std::size_t i){
+					auto& shard = shards[i];
+					auto visitor = name_type_visitor{
+							classes, type_annotations,
+							shard.type_annotations, shard.locals_annotations,
+							shard.vardecl_annotations, shard.method_annotations
+					};
+					try {
+						visitor.visit_method_of(*jobs[i].clazz, *jobs[i].method, *jobs[i].scopes);
+					} catch (const semantic_error& e) {
+						shard.error = e;
+					}
+				});
+				for (const auto& shard : shards) {
+					if (shard.error) {
+						keep_first_error(first_error, *shard.error);
+					}
+				}
+				if (first_error) {
+					throw *first_error;
+				}
+				for (auto& shard : shards) {
+					for (auto& kv : shard.type_annotations) {
+						type_annotations.insert(kv);
+					}
+					for (auto& kv : shard.locals_annotations) {
+						locals_annotations.insert(std::move(kv));
+					}
+					for (auto& kv : shard.vardecl_annotations) {
+						vardecl_annotations.insert(kv);
+					}
+					for (auto& kv : shard.method_annotations) {
+						method_annotations.insert(kv);
+					}
+				}
+			}
+
 		}  // namespace /* anonymous */
 
 
@@ -823,14 +951,14 @@ namespace minijava
 		                                type_attributes&         type_annotations,
 		                                locals_attributes&       locals_annotations,
 		                                vardecl_attributes&      vardecl_annotations,
-		                                method_attributes&       method_annotations)
+		                                method_attributes&       method_annotations,
+		                                const std::size_t        threads)
 		{
 			perform_shallow_type_analysis(ast, classes, type_annotations, expect_main);
-			auto visitor = name_type_visitor{
-					classes, globals, type_annotations, locals_annotations,
-					vardecl_annotations, method_annotations
-			};
-			ast.accept(visitor);
+			analyze_methods(
+					ast, classes, globals, type_annotations, locals_annotations,
+					vardecl_annotations, method_annotations, threads
+			);
 		}
 
 		std::ostream& operator<<(std::ostream& os, const type typ)
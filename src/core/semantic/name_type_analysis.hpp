@@ -198,8 +198,16 @@ namespace minijava
          *   declaration, no type and won't be included in the set of locals.
          *   This is because MiniJava is a messy language.)
 		 *
-		 * If there are multiple errors in the program, it is unspecified which
-		 * error will be reported.
+		 * The bodies of the methods are analyzed independently of each other.
+		 * If more than one method contains an error, the error with the
+		 * smallest source position is reported.  Within a method, it is
+		 * unspecified which error will be reported.  It is, however, always
+		 * the same error for the same input, regardless of `threads`.
+		 *
+		 * If `threads > 1`, the bodies of the methods are analyzed on up to
+		 * `threads` threads, each one into its own set of annotations that are
+		 * merged into the given containers afterwards.  The annotations are
+		 * the same for any number of threads.
 		 *
 		 * If there are class definitions in the `ast` that have no entry in
 		 * `classes`, the behavior is undefined.  On the other hand, `classes`
@@ -241,6 +249,9 @@ namespace minijava
 		 * @param method_annotations
 		 *     data structure to populate with extracted declaration pointers
 		 *
+		 * @param threads
+		 *     maximum number of threads to use
+		 *
 		 * @throws semantic_error
 		 *     if the program fails any of the checks listed above
 		 *
@@ -252,7 +263,8 @@ namespace minijava
 		                                type_attributes&         type_annotations,
 		                                locals_attributes&       locals_annotations,
 		                                vardecl_attributes&      vardecl_annotations,
-		                                method_attributes&       method_annotations);
+		                                method_attributes&       method_annotations,
+		                                std::size_t              threads = 1);
 
 	}  // namespace sem
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <utility>
@@ -364,6 +365,10 @@ namespace minijava
 	 * @param factory
 	 *     factory that was used to create the original AST
 	 *
+	 * @param threads
+	 *     maximum number of threads to use for the analysis of method bodies
+	 *     (see `sem::perform_name_type_analysis`)
+	 *
 	 * @returns
 	 *     semantic information about valid programs
 	 *
@@ -374,7 +379,8 @@ namespace minijava
 	template <typename PoolT>
 	semantic_info check_program(const ast::program& ast,
 	                            PoolT& pool,
-	                            ast_factory& factory);
+	                            ast_factory& factory,
+	                            std::size_t threads = 1);
 
 
 	/**
@@ -186,7 +186,7 @@ namespace minijava
 	}  // namespace sem
 
 	template<typename PoolT>
-	semantic_info check_program(const ast::program& ast, PoolT& pool, ast_factory& factory)
+	semantic_info check_program(const ast::program& ast, PoolT& pool, ast_factory& factory, const std::size_t threads)
 	{
 		// (0) Create the built-in AST.
 		auto builtin_ast = sem::detail::make_builtin_ast(pool, factory);
@@ -205,7 +205,7 @@ namespace minijava
 			sem::perform_name_type_analysis(
 				tree, !builtin, classes, globals,
 				type_annotations, locals_annotations,
-				vardecl_annotations, method_annotations
+				vardecl_annotations, method_annotations, threads
 			);
 		};
 		// (3) Process the built-in AST.  We can (and should) do this before we
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <unordered_map>
+#include <vector>
 
 #include "parser/ast.hpp"
 #include "symbol/symbol.hpp"
@@ -35,6 +36,10 @@ namespace minijava
 		 * definitions.  A `symbol_table` must have at least one scope pushed
 		 * in order for the operations on definitions to be well-defined.
 		 *
+		 * A `symbol_table` may be nested inside another one, which then acts
+		 * as if its scopes were at the bottom of the stack.  This allows
+		 * sharing scopes that are the same for many methods between threads.
+		 *
 		 */
 		class symbol_table final
 		{
@@ -65,6 +70,22 @@ namespace minijava
 			 */
 			symbol_table() noexcept;
 
+			/**
+			 * @brief
+			 *     Creates an empty symbol table with no initial scope that is
+			 *     nested inside another one.
+			 *
+			 * The definitions in `outer` are visible in the new table, too.
+			 * `outer` is only ever read and must neither be modified nor
+			 * destroyed as long as the new table is in use.  At least one
+			 * scope has to be pushed before definitions can be added.
+			 *
+			 * @param outer
+			 *     symbol table with the outer scopes
+			 *
+			 */
+			explicit symbol_table(const symbol_table* outer) noexcept;
+
 			/**
 			 * @brief
 			 *     `return`s the currently visible definition of a symbol, if
@@ -74,7 +95,7 @@ namespace minijava
 			 * %get_conflicting_definitions reports no conflicts.
 			 *
 			 * The behavior is undefined unless at least one scope has been
-			 * pushed.
+			 * pushed or the table is nested inside another one.
 			 *
 			 * @param name
 			 *     symbol to look up
@@ -165,6 +186,23 @@ namespace minijava
 			/** @brief Stack of nested scopes (top is most nested). */
 			std::vector<scope> _nested_scopes{};
 
+			/** @brief Symbol table with the outer scopes or `nullptr`. */
+			const symbol_table* _outer{};
+
+			/**
+			 * @brief
+			 *     `return`s the innermost definition of `name` in any scope
+			 *     that must not be shadowed or `nullptr`.
+			 *
+			 * @param name
+			 *     symbol to look up
+			 *
+			 * @returns
+			 *     pointer to definition or `nullptr` if no definition exists
+			 *
+			 */
+			const ast::var_decl* _get_unshadowable_definition(symbol name) const;
+
 		};  // class symbol_table
 
 	}  // namespace sem
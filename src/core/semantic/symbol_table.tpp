@@ -26,10 +26,15 @@ namespace minijava
 		{
 		}
 
+		inline symbol_table::symbol_table(const symbol_table*const outer) noexcept
+			: _outer{outer}
+		{
+		}
+
 		inline const ast::var_decl*
 		symbol_table::lookup(const symbol name) const
 		{
-			assert(!_nested_scopes.empty());
+			assert(!_nested_scopes.empty() || (_outer != nullptr));
 			const auto first = std::rbegin(_nested_scopes);
 			const auto last = std::rend(_nested_scopes);
 			for (auto it = first; it != last; ++it) {
@@ -38,7 +43,7 @@ namespace minijava
 					return pos->second;
 				}
 			}
-			return nullptr;
+			return (_outer != nullptr) ? _outer->lookup(name) : nullptr;
 		}
 
 		inline const ast::var_decl*
@@ -55,7 +60,23 @@ namespace minijava
 					}
 				}
 			}
-			return nullptr;
+			return (_outer != nullptr) ? _outer->_get_unshadowable_definition(name) : nullptr;
+		}
+
+		inline const ast::var_decl*
+		symbol_table::_get_unshadowable_definition(const symbol name) const
+		{
+			const auto first = std::rbegin(_nested_scopes);
+			const auto last = std::rend(_nested_scopes);
+			for (auto it = first; it != last; ++it) {
+				if (!it->may_shadow) {
+					const auto pos = it->defs.find(name);
+					if (pos != it->defs.end()) {
+						return pos->second;
+					}
+				}
+			}
+			return (_outer != nullptr) ? _outer->_get_unshadowable_definition(name) : nullptr;
 		}
 
 		inline void symbol_table::add_def(const ast::var_decl* def)
@@ -0,0 +1,3 @@
+#include "symbol/concurrent_symbol_pool.hpp"
+
+// This file is empty.
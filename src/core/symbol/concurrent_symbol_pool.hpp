@@ -0,0 +1,291 @@
+/**
+ * @file concurrent_symbol_pool.hpp
+ *
+ * @brief
+ *     Pools for canonical string representations that can be shared between
+ *     threads.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include <boost/unordered_set.hpp>
+
+#include "symbol/symbol.hpp"
+#include "symbol/symbol_anchor.hpp"
+#include "symbol/symbol_entry.hpp"
+
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     A pool for canonical string representations via symbols that may be
+	 *     used from multiple threads at the same time.
+	 *
+	 * This pool behaves exactly like a `symbol_pool` and the `symbol`s it
+	 * hands out are the same type and are compared the same way (by the
+	 * canonical address).  In addition, the member functions `size`,
+	 * `empty`, `is_normalized` and `normalize` may be called concurrently.
+	 *
+	 * The symbols are distributed over a fixed number of shards by their hash
+	 * value.  Each shard has its own hash set and its own lock, so threads
+	 * only contend if they normalize symbols that fall into the same shard at
+	 * the same time.
+	 *
+	 * Moving a `concurrent_symbol_pool` does not invalidate canonical
+	 * pointers but must not happen concurrently with any other use of either
+	 * pool.
+	 *
+	 * The pool only uses the provided allocator to allocate memory for
+	 * `symbol_entry`s of the normalized symbols.  The allocator is used from
+	 * multiple threads if the pool is.  Additional internal data structures
+	 * are always allocated using the global operator `new`.
+	 *
+	 * @tparam AllocT
+	 *     allocator type used for allocating memory for normalized symbols
+	 *
+	 */
+	template<typename AllocT = std::allocator<symbol_entry>>
+	class concurrent_symbol_pool final : private AllocT
+	{
+	public:
+
+		/** @brief Type alias for `AllocT`. */
+		using allocator_type = AllocT;
+
+		/** @brief Number of independently locked shards. */
+		static constexpr std::size_t shard_count = 64;
+
+	private:
+
+		/** @brief Type alias for a smart pointer holding a `symbol_entry`. */
+		using entryptr_type = unique_symbol_entr_ptr<allocator_type>;
+
+		/** @brief Hash set type. */
+		using hash_set_type = boost::unordered_set<
+			entryptr_type,
+			symbol_entry_ptr_hash,
+			symbol_entry_ptr_equal
+		>;
+
+		/** @brief Symbols that fall into one shard and their lock. */
+		struct shard
+		{
+			/** @brief Lock for `entries`. */
+			mutable std::mutex mutex{};
+
+			/** @brief Symbols in this shard. */
+			hash_set_type entries{};
+		};
+
+	public:
+
+		/**
+		 * @brief
+		 *     Constructs an empty pool with default-constructed allocator.
+		 *
+		 */
+		concurrent_symbol_pool();
+
+		/**
+		 * @brief
+		 *     Constructs an empty pool with the provided allocator.
+		 *
+		 * @param alloc
+		 *     allocator used to allocate `symbol_entry`s
+		 *
+		 */
+		concurrent_symbol_pool(const allocator_type& alloc);
+
+		/**
+		 * @brief
+		 *     Move constructor.
+		 *
+		 * The moved-away-from `concurrent_symbol_pool` is left in an empty
+		 * state.
+		 *
+		 * @param other
+		 *     `concurrent_symbol_pool` to move away from
+		 *
+		 */
+		concurrent_symbol_pool(concurrent_symbol_pool&& other);
+
+		/**
+		 * @brief
+		 *     Move-assignment operator.
+		 *
+		 * The moved-away-from `concurrent_symbol_pool` is left in an empty
+		 * state.
+		 *
+		 * @param other
+		 *     `concurrent_symbol_pool` to move away from
+		 *
+		 * @returns
+		 *     a reference to `*this`
+		 *
+		 */
+		concurrent_symbol_pool& operator=(concurrent_symbol_pool&& other);
+
+		/**
+		 * @brief
+		 *     `delete`d copy constructor.
+		 *
+		 * `concurrent_symbol_pool`s are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 */
+		concurrent_symbol_pool(const concurrent_symbol_pool& other) = delete;
+
+		/**
+		 * @brief
+		 *     `delete`d copy-assignment operator.
+		 *
+		 * `concurrent_symbol_pool`s are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 * @returns
+		 *     *N/A*
+		 *
+		 */
+		concurrent_symbol_pool& operator=(const concurrent_symbol_pool& other) = delete;
+
+		/**
+		 * @brief
+		 *     `return`s the number of symbols in the pool.
+		 *
+		 * If other threads normalize symbols at the same time, the result
+		 * may be out of date as soon as it is `return`ed.
+		 *
+		 * @returns
+		 *     number of symbols in the pool
+		 *
+		 */
+		std::size_t size() const;
+
+		/**
+		 * @brief
+		 *     Tests whether the pool is empty.
+		 *
+		 * @returns
+		 *     whether the pool is empty
+		 *
+		 */
+		bool empty() const;
+
+		/**
+		 * @brief
+		 *     Tests whether a canonical representation of a string already
+		 *     exists.
+		 *
+		 * The empty string always has a canonical representation even if it
+		 * was never added to the pool.  If the pool does not contain the
+		 * symbol, it will *not* be added.  Use `normalize` if you want to add
+		 * a symbol.
+		 *
+		 * @param text
+		 *     text to check
+		 *
+		 * @returns
+		 *     `true` if `text.empty()` or the pool contains `text`
+		 *
+		 */
+		bool is_normalized(const std::string& text) const;
+
+		/**
+		 * @brief
+		 *     `return` a canonical representation of a string.
+		 *
+		 * If the pool does not already contain the symbol, it is inserted.
+		 * Then a canonical representation is `return`ed.  If several threads
+		 * normalize the same text at the same time, they all get the same
+		 * canonical representation.
+		 *
+		 * @param text
+		 *     text value of the symbol
+		 *
+		 * @returns
+		 *     the canonical symbol
+		 *
+		 */
+		symbol normalize(const std::string& text);
+
+		/**
+		 * @brief
+		 *     `return`s a `const` reference to the stored allocator.
+		 *
+		 * @returns
+		 *     allocator
+		 *
+		 */
+		const allocator_type& get_allocator() const noexcept;
+
+		/**
+		 * @brief
+		 *     `return`s a mutable reference to the stored allocator.
+		 *
+		 * @returns
+		 *     allocator
+		 *
+		 */
+		allocator_type& get_allocator() noexcept;
+
+		/**
+		 * @brief
+		 *     Exchanges the states of two `concurrent_symbol_pool`.
+		 *
+		 * @param lhs
+		 *     first `concurrent_symbol_pool`
+		 *
+		 * @param rhs
+		 *     second `concurrent_symbol_pool`
+		 *
+		 */
+		friend void swap(concurrent_symbol_pool& lhs, concurrent_symbol_pool& rhs) noexcept
+		{
+			using std::swap;
+			swap(static_cast<AllocT&>(lhs), static_cast<AllocT&>(rhs));
+			swap(lhs._shards, rhs._shards);
+			swap(lhs._anchor, rhs._anchor);
+		}
+
+	private:
+
+		/** @brief Shards of the pool. */
+		std::unique_ptr<shard[]> _shards{};
+
+		/** @brief Anchor for the symbols handed out by this pool. */
+		std::shared_ptr<symbol_anchor> _anchor{};
+
+		/**
+		 * @brief
+		 *     `return`s the shard for symbols with the given hash value.
+		 *
+		 * @param hash
+		 *     hash value of the symbol
+		 *
+		 * @returns
+		 *     reference to the shard
+		 *
+		 */
+		shard& _get_shard(std::size_t hash) const noexcept;
+
+	};  // concurrent_symbol_pool
+
+}  // namespace minijava
+
+
+#define MINIJAVA_INCLUDED_FROM_SYMBOL_CONCURRENT_SYMBOL_POOL_HPP
+#include "symbol/concurrent_symbol_pool.tpp"
+#undef MINIJAVA_INCLUDED_FROM_SYMBOL_CONCURRENT_SYMBOL_POOL_HPP
@@ -0,0 +1,128 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYMBOL_CONCURRENT_SYMBOL_POOL_HPP
+#error "Never `#include <symbol/concurrent_symbol_pool.tpp>` directly; `#include <symbol/concurrent_symbol_pool.hpp>` instead."
+#endif
+
+#include <functional>
+#include <tuple>
+
+#include "symbol/symbol_pool.hpp"
+
+
+namespace minijava
+{
+
+	template <typename AllocT>
+	constexpr std::size_t concurrent_symbol_pool<AllocT>::shard_count;
+
+	template <typename AllocT>
+	concurrent_symbol_pool<AllocT>::concurrent_symbol_pool()
+		: _shards{std::make_unique<shard[]>(shard_count)}
+		, _anchor{symbol_anchor::make_symbol_anchor()}
+	{
+	}
+
+	template <typename AllocT>
+	concurrent_symbol_pool<AllocT>::concurrent_symbol_pool(const allocator_type& alloc)
+		: AllocT{alloc}
+		, _shards{std::make_unique<shard[]>(shard_count)}
+		, _anchor{symbol_anchor::make_symbol_anchor()}
+	{
+	}
+
+	template <typename AllocT>
+	concurrent_symbol_pool<AllocT>::concurrent_symbol_pool(concurrent_symbol_pool&& other)
+		: concurrent_symbol_pool{other.get_allocator()}
+	{
+		swap(*this, other);
+	}
+
+	template<typename AllocT>
+	concurrent_symbol_pool<AllocT>&
+	concurrent_symbol_pool<AllocT>::operator=(concurrent_symbol_pool&& other)
+	{
+		concurrent_symbol_pool temp{get_allocator()};
+		swap(*this, temp);
+		swap(*this, other);
+		return *this;
+	}
+
+	template <typename AllocT>
+	symbol concurrent_symbol_pool<AllocT>::normalize(const std::string& text)
+	{
+		if (text.empty()) {
+			return symbol{};
+		}
+		const auto hash_fn = std::hash<std::string>{};
+		const auto comp_fn = detail::symbol_entry_string_cmp{};
+		const auto hash = hash_fn(text);
+		auto& bucket = _get_shard(hash);
+		const std::lock_guard<std::mutex> lock{bucket.mutex};
+		auto entry_it = bucket.entries.find(text, hash_fn, comp_fn);
+		if (entry_it == bucket.entries.end()) {
+			auto insert_entry = new_symbol_entry(get_allocator(), hash, text.size(), text.data());
+			std::tie(entry_it, std::ignore) = bucket.entries.insert(std::move(insert_entry));
+		}
+		// The entries are never moved or removed while the pool exists, so
+		// the pointer stays valid after the lock is released.
+		return symbol{entry_it->get(), _anchor};
+	}
+
+	template <typename AllocT>
+	bool concurrent_symbol_pool<AllocT>::is_normalized(const std::string& text) const
+	{
+		if (text.empty()) {
+			return true;
+		}
+		const auto hash_fn = std::hash<std::string>{};
+		const auto comp_fn = detail::symbol_entry_string_cmp{};
+		const auto hash = hash_fn(text);
+		const auto& bucket = _get_shard(hash);
+		const std::lock_guard<std::mutex> lock{bucket.mutex};
+		return (bucket.entries.find(text, hash_fn, comp_fn) != bucket.entries.cend());
+	}
+
+	template <typename AllocT>
+	std::size_t concurrent_symbol_pool<AllocT>::size() const
+	{
+		auto total = std::size_t{};
+		for (auto i = std::size_t{}; i < shard_count; ++i) {
+			const std::lock_guard<std::mutex> lock{_shards[i].mutex};
+			total += _shards[i].entries.size();
+		}
+		return total;
+	}
+
+	template <typename AllocT>
+	bool concurrent_symbol_pool<AllocT>::empty() const
+	{
+		for (auto i = std::size_t{}; i < shard_count; ++i) {
+			const std::lock_guard<std::mutex> lock{_shards[i].mutex};
+			if (!_shards[i].entries.empty()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	template <typename AllocT>
+	const AllocT& concurrent_symbol_pool<AllocT>::get_allocator() const noexcept
+	{
+		return *this;
+	}
+
+	template <typename AllocT>
+	AllocT& concurrent_symbol_pool<AllocT>::get_allocator() noexcept
+	{
+		return *this;
+	}
+
+	template <typename AllocT>
+	typename concurrent_symbol_pool<AllocT>::shard&
+	concurrent_symbol_pool<AllocT>::_get_shard(const std::size_t hash) const noexcept
+	{
+		// The low bits of `std::hash<std::string>` are also used by the hash
+		// sets to pick a bucket, so the shard is picked by the high bits.
+		return _shards[(hash >> 16) % shard_count];
+	}
+
+}  // namespace minijava
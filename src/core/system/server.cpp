@@ -0,0 +1,26 @@
+#include "system/server.hpp"
+
+#include <cerrno>
+#include <system_error>
+
+
+namespace /* anonymous */
+{
+
+	[[noreturn]]
+	void throw_errno(const char*const what)
+	{
+		const auto ec = std::error_code{errno, std::system_category()};
+		throw std::system_error{ec, what};
+	}
+
+}  // namespace /* anonymous */
+
+
+#define MINIJAVA_INCLUDED_FROM_SYSTEM_SERVER_CPP
+#  if defined (__unix__)
+#    include "system/server_posix.tpp"
+#  else
+#    include "system/server_generic.tpp"
+#  endif
+#undef MINIJAVA_INCLUDED_FROM_SYSTEM_SERVER_CPP
@@ -0,0 +1,113 @@
+/**
+ * @file server.hpp
+ *
+ * @brief
+ *     Running a command-line program as a server on a local socket.
+ *
+ * A server keeps running and executes requests sent by clients.  A request
+ * consists of a command line, the client's working directory and the
+ * client's standard input, output and error streams, which are passed to
+ * the server as file descriptors.  Therefore, running a command via the
+ * server looks exactly like running it directly, except that the server
+ * can keep state that is expensive to set up between requests.
+ *
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     Function that executes a request.
+	 *
+	 * It receives the command line of the client (including a dummy first
+	 * element) and its standard streams and must `return` the exit status
+	 * for the client.
+	 *
+	 */
+	using server_handler = std::function<int(const std::vector<const char*>& args,
+	                                         std::FILE* thestdin,
+	                                         std::FILE* thestdout,
+	                                         std::FILE* thestderr)>;
+
+	/**
+	 * @brief
+	 *     Listens on the Unix socket `socket_name` and executes requests until
+	 *     the process receives `SIGINT` or `SIGTERM`.
+	 *
+	 * Each request is executed by calling `handler` in a process `fork`ed
+	 * from the server after changing to the client's working directory.
+	 * Therefore, the handler sees all state that was set up before calling
+	 * this function, but nothing it does affects the server or other
+	 * requests.  Requests are executed concurrently and a request that
+	 * crashes doesn't bring down the server.
+	 *
+	 * If a stale socket from a previous server exists, it is replaced.  The
+	 * socket is removed again when the server stops.
+	 *
+	 * On platforms without Unix sockets, this function always `throw`s a
+	 * `std::system_error` with an error code of `ENOSYS`.
+	 *
+	 * @param socket_name
+	 *     file name of the socket
+	 *
+	 * @param handler
+	 *     function that executes a request
+	 *
+	 * @throws std::system_error
+	 *     if the socket cannot be set up
+	 *
+	 */
+	void run_server(const std::string& socket_name, const server_handler& handler);
+
+	/**
+	 * @brief
+	 *     Sends a request to the server listening on the Unix socket
+	 *     `socket_name` and waits for it to complete.
+	 *
+	 * The request will be executed in the current working directory of the
+	 * calling process and with the given streams as standard input, output
+	 * and error.
+	 *
+	 * On platforms without Unix sockets, this function always `throw`s a
+	 * `std::system_error` with an error code of `ENOSYS`.
+	 *
+	 * @param socket_name
+	 *     file name of the socket
+	 *
+	 * @param args
+	 *     command line (including a dummy first element)
+	 *
+	 * @param thestdin
+	 *     standard input for the request
+	 *
+	 * @param thestdout
+	 *     standard output for the request
+	 *
+	 * @param thestderr
+	 *     standard error for the request
+	 *
+	 * @returns
+	 *     exit status of the request
+	 *
+	 * @throws std::system_error
+	 *     if the server cannot be reached
+	 *
+	 * @throws std::runtime_error
+	 *     if the server terminated without reporting an exit status
+	 *
+	 */
+	int run_client(const std::string& socket_name,
+	               const std::vector<const char*>& args,
+	               std::FILE* thestdin,
+	               std::FILE* thestdout,
+	               std::FILE* thestderr);
+
+}  // namespace minijava
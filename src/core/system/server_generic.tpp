@@ -0,0 +1,25 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYSTEM_SERVER_CPP
+#error "Never `#include` the source file `<system/server_generic.tpp>`"
+#endif
+
+
+namespace minijava
+{
+
+	void run_server(const std::string& /* socket_name */, const server_handler& /* handler */)
+	{
+		errno = ENOSYS;
+		throw_errno("Cannot run a server on this platform");
+	}
+
+	int run_client(const std::string& /* socket_name */,
+	               const std::vector<const char*>& /* args */,
+	               std::FILE* /* thestdin */,
+	               std::FILE* /* thestdout */,
+	               std::FILE* /* thestderr */)
+	{
+		errno = ENOSYS;
+		throw_errno("Cannot connect to a server on this platform");
+	}
+
+}  // namespace minijava
@@ -0,0 +1,467 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYSTEM_SERVER_CPP
+#error "Never `#include` the source file `<system/server_posix.tpp>`"
+#endif
+
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef MSG_NOSIGNAL
+#  define MSG_NOSIGNAL 0
+#endif
+
+
+namespace /* anonymous */
+{
+
+	// Every request starts with this header.  It is followed by `size`
+	// bytes of payload which is a sequence of NUL-terminated strings: the
+	// working directory of the client followed by its command line.  The
+	// header is sent together with the client's standard input, output and
+	// error file descriptors.  When the request is done, the server sends
+	// back the exit status as a 32 bit integer.
+	struct request_header
+	{
+		std::uint32_t magic;
+		std::uint32_t size;
+	};
+
+	constexpr std::uint32_t request_magic = 0x4d4a5331;  // "MJS1"
+
+	constexpr std::uint32_t max_request_size = 1024 * 1024;
+
+	// Closes a file descriptor when going out of scope.
+	class fd_guard final
+	{
+	public:
+
+		explicit fd_guard(const int fd = -1) noexcept : _fd{fd}
+		{
+		}
+
+		~fd_guard()
+		{
+			if (_fd >= 0) {
+				close(_fd);
+			}
+		}
+
+		fd_guard(const fd_guard&) = delete;
+		fd_guard& operator=(const fd_guard&) = delete;
+
+		int get() const noexcept
+		{
+			return _fd;
+		}
+
+	private:
+
+		int _fd;
+
+	};
+
+	sockaddr_un make_address(const std::string& socket_name)
+	{
+		auto address = sockaddr_un{};
+		address.sun_family = AF_UNIX;
+		if (socket_name.empty() || (socket_name.size() >= sizeof(address.sun_path))) {
+			errno = ENAMETOOLONG;
+			throw_errno("Invalid socket name");
+		}
+		std::strcpy(address.sun_path, socket_name.c_str());
+		return address;
+	}
+
+	int make_socket()
+	{
+		const auto fd = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (fd < 0) {
+			throw_errno("Cannot create socket");
+		}
+		fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+		return fd;
+	}
+
+	bool send_fully(const int fd, const void*const buffer, const std::size_t size) noexcept
+	{
+		auto p = static_cast<const char*>(buffer);
+		auto rest = size;
+		while (rest > 0) {
+			const auto n = send(fd, p, rest, MSG_NOSIGNAL);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			p += n;
+			rest -= static_cast<std::size_t>(n);
+		}
+		return true;
+	}
+
+	bool recv_fully(const int fd, void*const buffer, const std::size_t size) noexcept
+	{
+		auto p = static_cast<char*>(buffer);
+		auto rest = size;
+		while (rest > 0) {
+			const auto n = recv(fd, p, rest, 0);
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			if (n == 0) {
+				return false;
+			}
+			p += n;
+			rest -= static_cast<std::size_t>(n);
+		}
+		return true;
+	}
+
+	// Sends `header` together with the file descriptors `fds` over `sock`.
+	bool send_header(const int sock, const request_header& header, const int (&fds)[3]) noexcept
+	{
+		auto iov = iovec{};
+		iov.iov_base = const_cast<request_header*>(&header);
+		iov.iov_len = sizeof(header);
+		union {
+			char buffer[CMSG_SPACE(sizeof(fds))];
+			cmsghdr align;
+		} control{};
+		auto msg = msghdr{};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control.buffer;
+		msg.msg_controllen = sizeof(control.buffer);
+		const auto cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+		std::memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+		auto n = ssize_t{};
+		while ((n = sendmsg(sock, &msg, MSG_NOSIGNAL)) < 0) {
+			if (errno != EINTR) {
+				return false;
+			}
+		}
+		return (static_cast<std::size_t>(n) == sizeof(header));
+	}
+
+	// Receives the header of a request together with the client's file
+	// descriptors from `sock`.
+	bool recv_header(const int sock, request_header& header, int (&fds)[3]) noexcept
+	{
+		auto iov = iovec{};
+		iov.iov_base = &header;
+		iov.iov_len = sizeof(header);
+		union {
+			char buffer[CMSG_SPACE(sizeof(fds))];
+			cmsghdr align;
+		} control{};
+		auto msg = msghdr{};
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control.buffer;
+		msg.msg_controllen = sizeof(control.buffer);
+		auto n = ssize_t{};
+		while ((n = recvmsg(sock, &msg, 0)) < 0) {
+			if (errno != EINTR) {
+				return false;
+			}
+		}
+		const auto cmsg = CMSG_FIRSTHDR(&msg);
+		if ((cmsg == nullptr) || (cmsg->cmsg_level != SOL_SOCKET) || (cmsg->cmsg_type != SCM_RIGHTS)
+		    || (cmsg->cmsg_len != CMSG_LEN(sizeof(fds)))) {
+			return false;
+		}
+		std::memcpy(fds, CMSG_DATA(cmsg), sizeof(fds));
+		return (static_cast<std::size_t>(n) == sizeof(header)) && (header.magic == request_magic);
+	}
+
+	std::string get_working_directory()
+	{
+		auto buffer = std::string(256, '\0');
+		while (getcwd(&buffer[0], buffer.size()) == nullptr) {
+			if (errno != ERANGE) {
+				throw_errno("Cannot determine working directory");
+			}
+			buffer.resize(2 * buffer.size());
+		}
+		buffer.resize(std::strlen(buffer.c_str()));
+		return buffer;
+	}
+
+	// Executes the request from the client connected to `sock` and sends
+	// back the exit status.  This function runs in the `fork`ed child and
+	// never `return`s.  If the request is malformed, the connection is
+	// simply closed.
+	[[noreturn]]
+	void serve_request(const int sock, const minijava::server_handler& handler) noexcept
+	{
+		auto header = request_header{};
+		int fds[3] = {-1, -1, -1};
+		if (!recv_header(sock, header, fds) || (header.size > max_request_size)) {
+			_exit(EXIT_FAILURE);
+		}
+		auto payload = std::vector<char>(header.size);
+		if (!recv_fully(sock, payload.data(), payload.size())
+		    || payload.empty() || (payload.back() != '\0')) {
+			_exit(EXIT_FAILURE);
+		}
+		auto strings = std::vector<const char*>{};
+		for (auto it = payload.begin(); it != payload.end(); it = std::find(it, payload.end(), '\0') + 1) {
+			strings.push_back(&*it);
+		}
+		const auto thestdin = fdopen(fds[0], "rb");
+		const auto thestdout = fdopen(fds[1], "wb");
+		const auto thestderr = fdopen(fds[2], "wb");
+		if ((thestdin == nullptr) || (thestdout == nullptr) || (thestderr == nullptr)) {
+			_exit(EXIT_FAILURE);
+		}
+		std::int32_t status = EXIT_FAILURE;
+		if (chdir(strings.front()) < 0) {
+			std::fprintf(thestderr, "Cannot change to directory %s: %s\n", strings.front(), std::strerror(errno));
+		} else {
+			const auto args = std::vector<const char*>(strings.begin() + 1, strings.end());
+			try {
+				status = handler(args, thestdin, thestdout, thestderr);
+			} catch (const std::exception& e) {
+				std::fprintf(thestderr, "%s\n", e.what());
+			}
+		}
+		std::fflush(nullptr);
+		send_fully(sock, &status, sizeof(status));
+		_exit(EXIT_SUCCESS);
+	}
+
+	// Write end of the pipe that the signal handlers use to wake up the
+	// server and whether the server should stop.
+	volatile std::sig_atomic_t wakeup_fd = -1;
+	volatile std::sig_atomic_t stop_requested = 0;
+
+	extern "C" void handle_stop_signal(int)
+	{
+		stop_requested = 1;
+		const auto saved = errno;
+		const char byte = 0;
+		if (write(wakeup_fd, &byte, 1) < 0) { /* nothing to do */ }
+		errno = saved;
+	}
+
+	extern "C" void handle_child_signal(int)
+	{
+		const auto saved = errno;
+		const char byte = 0;
+		if (write(wakeup_fd, &byte, 1) < 0) { /* nothing to do */ }
+		errno = saved;
+	}
+
+	// Installs the signal handlers for the server and restores the previous
+	// ones when going out of scope.
+	class signal_guard final
+	{
+	public:
+
+		signal_guard()
+		{
+			_install(SIGINT, &handle_stop_signal, _old_int);
+			_install(SIGTERM, &handle_stop_signal, _old_term);
+			_install(SIGCHLD, &handle_child_signal, _old_chld);
+		}
+
+		~signal_guard()
+		{
+			restore();
+		}
+
+		signal_guard(const signal_guard&) = delete;
+		signal_guard& operator=(const signal_guard&) = delete;
+
+		void restore() noexcept
+		{
+			sigaction(SIGINT, &_old_int, nullptr);
+			sigaction(SIGTERM, &_old_term, nullptr);
+			sigaction(SIGCHLD, &_old_chld, nullptr);
+		}
+
+	private:
+
+		static void _install(const int sig, void (*const handler)(int), struct sigaction& old)
+		{
+			struct sigaction action{};
+			action.sa_handler = handler;
+			sigemptyset(&action.sa_mask);
+			action.sa_flags = 0;
+			if (sigaction(sig, &action, &old) < 0) {
+				throw_errno("Cannot install signal handler");
+			}
+		}
+
+		struct sigaction _old_int{};
+		struct sigaction _old_term{};
+		struct sigaction _old_chld{};
+
+	};
+
+	// Binds `sock` to `socket_name`, replacing a stale socket left behind by
+	// a previous server that is no longer running.
+	void bind_socket(const int sock, const std::string& socket_name)
+	{
+		const auto address = make_address(socket_name);
+		const auto addrptr = reinterpret_cast<const sockaddr*>(&address);
+		if (bind(sock, addrptr, sizeof(address)) == 0) {
+			return;
+		}
+		if (errno != EADDRINUSE) {
+			throw_errno("Cannot bind socket");
+		}
+		const fd_guard probe{make_socket()};
+		if (connect(probe.get(), addrptr, sizeof(address)) == 0) {
+			errno = EADDRINUSE;
+			throw_errno("Another server is already listening on the socket");
+		}
+		if (errno != ECONNREFUSED) {
+			throw_errno("Cannot bind socket");
+		}
+		unlink(socket_name.c_str());
+		if (bind(sock, addrptr, sizeof(address)) < 0) {
+			throw_errno("Cannot bind socket");
+		}
+	}
+
+	void reap_children(const bool block) noexcept
+	{
+		while (true) {
+			const auto pid = waitpid(-1, nullptr, block ? 0 : WNOHANG);
+			if ((pid < 0) && (errno == EINTR)) {
+				continue;
+			}
+			if (pid <= 0) {
+				break;
+			}
+		}
+	}
+
+}  // namespace /* anonymous */
+
+
+namespace minijava
+{
+
+	void run_server(const std::string& socket_name, const server_handler& handler)
+	{
+		int wakeup[2];
+		if (pipe(wakeup) < 0) {
+			throw_errno("Cannot create pipe");
+		}
+		const fd_guard wakeup_read{wakeup[0]};
+		const fd_guard wakeup_write{wakeup[1]};
+		for (const auto fd : wakeup) {
+			fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+			fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+		}
+		const fd_guard sock{make_socket()};
+		bind_socket(sock.get(), socket_name);
+		struct unlink_guard {
+			const std::string& name;
+			~unlink_guard() { unlink(name.c_str()); }
+		} const socket_cleanup{socket_name};
+		if (listen(sock.get(), SOMAXCONN) < 0) {
+			throw_errno("Cannot listen on socket");
+		}
+		wakeup_fd = wakeup[1];
+		stop_requested = 0;
+		signal_guard signals{};
+		std::fflush(nullptr);  // Don't duplicate buffered output.
+		while (!stop_requested) {
+			pollfd pfds[2] = {{sock.get(), POLLIN, 0}, {wakeup[0], POLLIN, 0}};
+			if (poll(pfds, 2, -1) < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				throw_errno("Cannot wait for connections");
+			}
+			if (pfds[1].revents) {
+				char buffer[64];
+				while (read(wakeup[0], buffer, sizeof(buffer)) > 0) {}
+				reap_children(false);
+			}
+			if (!(pfds[0].revents & POLLIN)) {
+				continue;
+			}
+			const auto conn = accept(sock.get(), nullptr, nullptr);
+			if (conn < 0) {
+				if ((errno == EINTR) || (errno == ECONNABORTED) || (errno == EAGAIN)) {
+					continue;
+				}
+				throw_errno("Cannot accept connection");
+			}
+			const fd_guard connection{conn};
+			const auto pid = fork();
+			if (pid < 0) {
+				continue;  // The client will see the connection closed.
+			}
+			if (pid == 0) {
+				signals.restore();
+				close(sock.get());
+				close(wakeup[0]);
+				close(wakeup[1]);
+				serve_request(conn, handler);
+			}
+		}
+		// Let running requests finish before removing the socket.
+		reap_children(true);
+	}
+
+	int run_client(const std::string& socket_name,
+	               const std::vector<const char*>& args,
+	               std::FILE* thestdin,
+	               std::FILE* thestdout,
+	               std::FILE* thestderr)
+	{
+		auto payload = get_working_directory();
+		payload.push_back('\0');
+		for (const auto arg : args) {
+			payload.append(arg);
+			payload.push_back('\0');
+		}
+		if (payload.size() > max_request_size) {
+			errno = E2BIG;
+			throw_errno("Cannot send request to server");
+		}
+		const auto address = make_address(socket_name);
+		const fd_guard sock{make_socket()};
+		if (connect(sock.get(), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0) {
+			throw_errno("Cannot connect to server");
+		}
+		std::fflush(thestdout);
+		std::fflush(thestderr);
+		const int fds[3] = {fileno(thestdin), fileno(thestdout), fileno(thestderr)};
+		const auto header = request_header{request_magic, static_cast<std::uint32_t>(payload.size())};
+		if (!send_header(sock.get(), header, fds) || !send_fully(sock.get(), payload.data(), payload.size())) {
+			throw_errno("Cannot send request to server");
+		}
+		std::int32_t status;
+		if (!recv_fully(sock.get(), &status, sizeof(status))) {
+			throw std::runtime_error{"Server terminated without reporting an exit status"};
+		}
+		return status;
+	}
+
+}  // namespace minijava
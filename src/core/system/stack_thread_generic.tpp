@@ -0,0 +1,59 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYSTEM_SYSTEM_HPP
+#error "Never `#include` the source file `<system/stack_thread_generic.tpp>`"
+#endif
+
+#include <exception>
+#include <thread>
+#include <utility>
+
+
+namespace minijava
+{
+
+	namespace detail
+	{
+
+		struct stack_thread_state
+		{
+			std::thread thread{};
+		};
+
+	}  // namespace detail
+
+
+	stack_thread::stack_thread(const std::size_t /* size */, std::function<void()> func)
+		: _state{std::make_unique<detail::stack_thread_state>()}
+	{
+		_state->thread = std::thread{[func = std::move(func)](){
+			try {
+				func();
+			} catch (...) {
+				std::terminate();
+			}
+		}};
+	}
+
+	stack_thread::~stack_thread()
+	{
+		join();
+	}
+
+	void stack_thread::join() noexcept
+	{
+		if (_state->thread.joinable()) {
+			_state->thread.join();
+		}
+	}
+
+	std::size_t current_thread_stack_size() noexcept
+	{
+		return 0;
+	}
+
+	void call_with_stack_size(const std::size_t /* size */, const std::function<void()>& func)
+	{
+		func();
+	}
+
+
+}  // namespace minijava
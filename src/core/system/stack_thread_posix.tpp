@@ -0,0 +1,156 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYSTEM_SYSTEM_HPP
+#error "Never `#include` the source file `<system/stack_thread_posix.tpp>`"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <exception>
+#include <system_error>
+#include <utility>
+
+#include <limits.h>
+#include <pthread.h>
+
+
+namespace minijava
+{
+
+	namespace detail
+	{
+
+		struct stack_thread_state
+		{
+			std::size_t size{};
+			std::function<void()> func{};
+			pthread_t thread{};
+			bool joinable{};
+		};
+
+	}  // namespace detail
+
+
+	namespace /* anonymous */
+	{
+
+		// Stack size the current thread was started with by a
+		// `stack_thread` or zero for any other thread.
+		thread_local std::size_t this_thread_stack_size = 0;
+
+		void* stack_thread_main(void* p)
+		{
+			const auto state = static_cast<detail::stack_thread_state*>(p);
+			this_thread_stack_size = state->size;
+			try {
+				state->func();
+			} catch (...) {
+				std::terminate();
+			}
+			return nullptr;
+		}
+
+		// Owns a `pthread_attr_t` for the lifetime of the object.
+		class thread_attributes final
+		{
+		public:
+
+			thread_attributes() : _ok{pthread_attr_init(&_attr) == 0}
+			{
+			}
+
+			~thread_attributes()
+			{
+				if (_ok) {
+					pthread_attr_destroy(&_attr);
+				}
+			}
+
+			thread_attributes(const thread_attributes&) = delete;
+			thread_attributes& operator=(const thread_attributes&) = delete;
+
+			bool set_stack_size(const std::size_t size) noexcept
+			{
+				const auto actual = std::max(size, static_cast<std::size_t>(PTHREAD_STACK_MIN));
+				return _ok && (pthread_attr_setstacksize(&_attr, actual) == 0);
+			}
+
+			const pthread_attr_t* get() const noexcept
+			{
+				return &_attr;
+			}
+
+		private:
+
+			pthread_attr_t _attr{};
+
+			bool _ok{};
+
+		};
+
+	}  // namespace /* anonymous */
+
+
+	stack_thread::stack_thread(const std::size_t size, std::function<void()> func)
+		: _state{std::make_unique<detail::stack_thread_state>()}
+	{
+		_state->size = size;
+		_state->func = std::move(func);
+		thread_attributes attributes{};
+		if ((size > 0) && !attributes.set_stack_size(size)) {
+			const auto ec = std::error_code{EINVAL, std::system_category()};
+			throw std::system_error{ec, "Cannot set stack size of thread"};
+		}
+		const auto attr = (size > 0) ? attributes.get() : nullptr;
+		if (const auto error = pthread_create(&_state->thread, attr, stack_thread_main, _state.get())) {
+			const auto ec = std::error_code{error, std::system_category()};
+			throw std::system_error{ec, "Cannot create thread"};
+		}
+		_state->joinable = true;
+	}
+
+	stack_thread::~stack_thread()
+	{
+		join();
+	}
+
+	void stack_thread::join() noexcept
+	{
+		if (_state->joinable) {
+			pthread_join(_state->thread, nullptr);
+			_state->joinable = false;
+		}
+	}
+
+	std::size_t current_thread_stack_size() noexcept
+	{
+		return this_thread_stack_size;
+	}
+
+	void call_with_stack_size(const std::size_t size, const std::function<void()>& func)
+	{
+		if (size == 0) {
+			func();
+			return;
+		}
+		auto error = std::exception_ptr{};
+		const auto wrapper = [&func, &error](){
+			try {
+				func();
+			} catch (...) {
+				error = std::current_exception();
+			}
+		};
+		try {
+			stack_thread thread{size, wrapper};
+		} catch (const std::system_error&) {
+			// The thread could not be created so `func` has not run yet.
+			func();
+			return;
+		}
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+
+
+}  // namespace minijava
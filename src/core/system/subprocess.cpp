@@ -4,6 +4,7 @@
 #include <cerrno>
 #include <stdexcept>
 #include <system_error>
+#include <utility>
 
 
 namespace /* anonymous */
@@ -23,6 +24,22 @@ namespace /* anonymous */
 		throw std::runtime_error{"Subprocess '" + cmd + "' exited with non-zero status"};
 	}
 
+	// Makes an `argv` array for `exec` from `command`.  The `return`ed
+	// pointers refer into `command` which must therefore stay alive.
+	std::vector<char*> make_argv(std::vector<std::string>& command)
+	{
+		if (command.size() < 1) {
+			throw std::invalid_argument{"Cannot execute empty command"};
+		}
+		auto argv = std::vector<char*>{command.size() + 1};
+		std::transform(
+			command.begin(), command.end(), argv.begin(),
+			[](auto&& s) { return &s[0]; }
+		);
+		argv[command.size()] = nullptr;
+		return argv;
+	}
+
 	void do_run_subprocess(std::vector<char*> argv);
 
 }  //  namespace /* anonymous */
@@ -32,17 +49,8 @@ namespace minijava
 
 	void run_subprocess(const std::vector<std::string>& command)
 	{
-		if (command.size() < 1) {
-			throw std::invalid_argument{"Cannot execute empty command"};
-		}
 		auto copy = command;  // Avoid const correctness issues.
-		auto argv = std::vector<char*>{copy.size() + 1};
-		std::transform(
-			copy.begin(), copy.end(), argv.begin(),
-			[](auto&& s) { return &s[0]; }
-		);
-		argv[copy.size()] = nullptr;
-		return do_run_subprocess(std::move(argv));
+		return do_run_subprocess(make_argv(copy));
 	}
 
 }  // namespace minijava
@@ -57,3 +65,47 @@ namespace minijava
 #    include "system/subprocess_generic.tpp"
 #  endif
 #undef MINIJAVA_INCLUDED_FROM_SYSTEM_SUBPROCESS_CPP
+
+
+namespace minijava
+{
+
+	subprocess::subprocess(const std::vector<std::string>& command,
+	                       const bool pipe_input, const bool pipe_output)
+	{
+		auto copy = command;  // Avoid const correctness issues.
+		auto argv = make_argv(copy);
+		_name = command.front();
+		_state = do_start_subprocess(std::move(argv), pipe_input, pipe_output);
+	}
+
+	subprocess::~subprocess()
+	{
+		if (_state) {
+			try {
+				do_wait_subprocess(*_state, _name);
+			} catch (const std::exception&) {
+				// We cannot report errors from a destructor.
+			}
+		}
+	}
+
+	std::FILE* subprocess::input() noexcept
+	{
+		return _state ? _state->input : nullptr;
+	}
+
+	std::FILE* subprocess::output() noexcept
+	{
+		return _state ? _state->output : nullptr;
+	}
+
+	void subprocess::wait()
+	{
+		if (_state) {
+			const auto running = std::move(_state);
+			do_wait_subprocess(*running, _name);
+		}
+	}
+
+}  // namespace minijava
@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <cstdio>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -30,4 +32,151 @@ namespace minijava
 	 */
 	void run_subprocess(const std::vector<std::string>& command);
 
+	namespace detail
+	{
+
+		/** @brief Platform-specific state of a running subprocess. */
+		struct subprocess_state;
+
+	}  // namespace detail
+
+	/**
+	 * @brief
+	 *     A subprocess running concurrently with the calling process whose
+	 *     standard input and output may be connected to pipes.
+	 *
+	 * The subprocess is started by the constructor.  If requested, its
+	 * standard input reads from a pipe that the caller can write to via
+	 * `input` and its standard output writes to a pipe that the caller can
+	 * read from via `output`.  Otherwise, it inherits the respective stream
+	 * of the calling process.  The caller must take care not to deadlock if
+	 * both streams are connected to pipes.
+	 *
+	 * When done, the caller should call `wait` which closes the pipes, waits
+	 * for the subprocess to exit and reports failure just like
+	 * `run_subprocess`.  If the object is destroyed without calling `wait`,
+	 * the destructor does the same but ignores any errors.
+	 *
+	 * On POSIX systems, `SIGPIPE` is ignored while the standard input of a
+	 * subprocess is connected to a pipe so writing to a subprocess that has
+	 * already exited fails with an error instead of killing the process.
+	 *
+	 */
+	class subprocess final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Starts a subprocess with the given command line.
+		 *
+		 * @param command
+		 *     command line of the subprocess
+		 *
+		 * @param pipe_input
+		 *     whether to connect the standard input of the subprocess to a
+		 *     pipe
+		 *
+		 * @param pipe_output
+		 *     whether to connect the standard output of the subprocess to a
+		 *     pipe
+		 *
+		 * @throws std::system_error
+		 *     if an error occurs while trying to start the subprocess
+		 *
+		 */
+		subprocess(const std::vector<std::string>& command,
+		           bool pipe_input, bool pipe_output = false);
+
+		/**
+		 * @brief
+		 *     Closes the pipes and waits for the subprocess to exit unless
+		 *     this has already been done by calling `wait`.
+		 *
+		 */
+		~subprocess();
+
+		/**
+		 * @brief
+		 *     `delete`d copy constructor.
+		 *
+		 * `subprocess` objects are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 */
+		subprocess(const subprocess& other) = delete;
+
+		/**
+		 * @brief
+		 *     `delete`d copy-assignment operator.
+		 *
+		 * `subprocess` objects are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 * @returns
+		 *     *N/A*
+		 *
+		 */
+		subprocess& operator=(const subprocess& other) = delete;
+
+		/**
+		 * @brief
+		 *     `return`s the file handle connected to the standard input of
+		 *     the subprocess.
+		 *
+		 * The handle is owned by the `subprocess` object and must not be
+		 * closed by the caller.  If the standard input is not connected to a
+		 * pipe or `wait` was already called, the `nullptr` is `return`ed.
+		 *
+		 * @returns
+		 *     file handle opened for writing
+		 *
+		 */
+		std::FILE* input() noexcept;
+
+		/**
+		 * @brief
+		 *     `return`s the file handle connected to the standard output of
+		 *     the subprocess.
+		 *
+		 * The handle is owned by the `subprocess` object and must not be
+		 * closed by the caller.  If the standard output is not connected to a
+		 * pipe or `wait` was already called, the `nullptr` is `return`ed.
+		 *
+		 * @returns
+		 *     file handle opened for reading
+		 *
+		 */
+		std::FILE* output() noexcept;
+
+		/**
+		 * @brief
+		 *     Closes the pipes and waits for the subprocess to exit.
+		 *
+		 * Calling this function more than once has no effect.
+		 *
+		 * @throws std::runtime_error
+		 *     if the subprocess fails
+		 *
+		 * @throws std::system_error
+		 *     if an error occurs while trying to join the subprocess or if the
+		 *     data written to its standard input could not be flushed
+		 *
+		 */
+		void wait();
+
+	private:
+
+		/** @brief Name of the executable (for error messages). */
+		std::string _name{};
+
+		/** @brief State of the running subprocess (`nullptr` after `wait`). */
+		std::unique_ptr<detail::subprocess_state> _state{};
+
+	};
+
 }
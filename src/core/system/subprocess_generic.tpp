@@ -2,6 +2,9 @@
 #error "Never `#include` the source file `<system/subprocess_generic.tpp>`"
 #endif
 
+#include <cstdio>
+#include <memory>
+
 
 namespace /* anonymous */
 {
@@ -13,3 +16,31 @@ namespace /* anonymous */
 	}
 
 }
+
+
+namespace minijava
+{
+
+	struct detail::subprocess_state
+	{
+		std::FILE* input{};
+		std::FILE* output{};
+	};
+
+}  // namespace minijava
+
+
+namespace /* anonymous */
+{
+
+	std::unique_ptr<minijava::detail::subprocess_state>
+	do_start_subprocess(std::vector<char*> argv, bool /* pipe_input */, bool /* pipe_output */)
+	{
+		throw_invoke_subprocess_failed(ENOSYS, argv.front());
+	}
+
+	void do_wait_subprocess(minijava::detail::subprocess_state& /* running */, const std::string& /* name */)
+	{
+	}
+
+}  // namespace /* anonymous */
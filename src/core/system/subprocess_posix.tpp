@@ -2,6 +2,8 @@
 #error "Never `#include` the source file `<system/subprocess_posix.tpp>`"
 #endif
 
+#include <csignal>
+#include <cstdio>
 #include <cstdlib>
 #include <memory>
 
@@ -89,3 +91,200 @@ namespace /* anonymous */
 	}
 
 }  //  namespace /* anonymous */
+
+
+namespace minijava
+{
+
+	struct detail::subprocess_state
+	{
+		// Process ID of the subprocess.
+		pid_t pid{-1};
+
+		// Write end of the pipe to the standard input of the subprocess.
+		std::FILE* input{};
+
+		// Read end of the pipe from the standard output of the subprocess.
+		std::FILE* output{};
+
+		// Whether `SIGPIPE` is ignored for the subprocess and the previous
+		// action that must be restored.
+		bool sigpipe_ignored{};
+		struct sigaction old_sigpipe{};
+	};
+
+}  // namespace minijava
+
+
+namespace /* anonymous */
+{
+
+	[[noreturn]]
+	void throw_errno(const char*const what)
+	{
+		const auto ec = std::error_code{errno, std::system_category()};
+		throw std::system_error{ec, what};
+	}
+
+	// Both ends of a pipe which are closed in the destructor unless they
+	// were `release`d.  Both ends are closed on `exec`.
+	struct pipe_ends
+	{
+		int fds[2] = {-1, -1};
+
+		pipe_ends() = default;
+
+		pipe_ends(const pipe_ends&) = delete;
+		pipe_ends& operator=(const pipe_ends&) = delete;
+
+		~pipe_ends()
+		{
+			close_end(0);
+			close_end(1);
+		}
+
+		void open()
+		{
+			if (pipe(fds) == -1) {
+				throw_errno("Could not create pipe");
+			}
+			for (const auto fd : fds) {
+				if (fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC) == -1) {
+					throw_errno("Could not create pipe");
+				}
+			}
+		}
+
+		void close_end(const int i) noexcept
+		{
+			if (fds[i] != -1) {
+				close(fds[i]);
+				fds[i] = -1;
+			}
+		}
+
+		int release(const int i) noexcept
+		{
+			const auto fd = fds[i];
+			fds[i] = -1;
+			return fd;
+		}
+	};
+
+	void reap_subprocess(const pid_t pid, int& status)
+	{
+		while (waitpid(pid, &status, 0) == -1) {
+			if (errno != EINTR) {
+				throw_errno("Cannot not wait for subprocess");
+			}
+		}
+	}
+
+	void do_wait_subprocess(minijava::detail::subprocess_state& running, const std::string& name)
+	{
+		auto flush_error = 0;
+		if (running.input != nullptr) {
+			if (std::fclose(running.input) != 0) {
+				flush_error = errno;
+			}
+			running.input = nullptr;
+		}
+		if (running.output != nullptr) {
+			std::fclose(running.output);
+			running.output = nullptr;
+		}
+		if (running.sigpipe_ignored) {
+			sigaction(SIGPIPE, &running.old_sigpipe, nullptr);
+			running.sigpipe_ignored = false;
+		}
+		int status;
+		reap_subprocess(running.pid, status);
+		running.pid = -1;
+		if (status) {
+			if (WIFEXITED(status)) {
+				throw_subprocess_failed(name);
+			} else {
+				throw std::runtime_error{"Subprocess terminated abnormally"};
+			}
+		}
+		if (flush_error) {
+			const auto ec = std::error_code{flush_error, std::system_category()};
+			throw std::system_error{ec, "Cannot write to subprocess"};
+		}
+	}
+
+	std::unique_ptr<minijava::detail::subprocess_state>
+	do_start_subprocess(std::vector<char*> argv, const bool pipe_input, const bool pipe_output)
+	{
+		auto running = std::make_unique<minijava::detail::subprocess_state>();
+		pipe_ends inpipe{};
+		pipe_ends outpipe{};
+		pipe_ends errpipe{};  // communicates the error code of `execvp`
+		if (pipe_input) {
+			inpipe.open();
+		}
+		if (pipe_output) {
+			outpipe.open();
+		}
+		errpipe.open();
+		const auto pid = fork();
+		if (pid == -1) {
+			throw_errno("Cannot fork subprocess");
+		} else if (pid == 0) {
+			if ((pipe_input && (dup2(inpipe.fds[0], STDIN_FILENO) == -1))
+			    || (pipe_output && (dup2(outpipe.fds[1], STDOUT_FILENO) == -1))) {
+				// Report the error below.
+			} else {
+				execvp(argv[0], argv.data());
+			}
+			while (write(errpipe.fds[1], &errno, sizeof(errno)) == -1) {
+				if (errno != EAGAIN && errno != EINTR) {
+					break;
+				}
+			}
+			_exit(EXIT_FAILURE);
+		}
+		running->pid = pid;
+		inpipe.close_end(0);
+		outpipe.close_end(1);
+		errpipe.close_end(1);
+		ssize_t bytes_read;
+		int code;
+		while ((bytes_read = read(errpipe.fds[0], &code, sizeof(code))) == -1) {
+			if (errno != EAGAIN && errno != EINTR) {
+				break;
+			}
+		}
+		if (bytes_read != 0) {
+			int status;
+			reap_subprocess(pid, status);
+			throw_invoke_subprocess_failed((bytes_read > 0) ? code : errno, argv.front());
+		}
+		if (pipe_input) {
+			struct sigaction ignore{};
+			ignore.sa_handler = SIG_IGN;
+			sigemptyset(&ignore.sa_mask);
+			running->sigpipe_ignored = (sigaction(SIGPIPE, &ignore, &running->old_sigpipe) == 0);
+			if ((running->input = fdopen(inpipe.fds[1], "wb"))) {
+				inpipe.release(1);
+			}
+		}
+		if (pipe_output) {
+			if ((running->output = fdopen(outpipe.fds[0], "rb"))) {
+				outpipe.release(0);
+			}
+		}
+		if ((pipe_input && !running->input) || (pipe_output && !running->output)) {
+			const auto error = errno;
+			inpipe.close_end(1);
+			outpipe.close_end(0);
+			try {
+				do_wait_subprocess(*running, argv.front());
+			} catch (const std::exception&) { /* report the original error */ }
+			errno = error;
+			throw_errno("Could not open pipe");
+		}
+		return running;
+	}
+
+}  //  namespace /* anonymous */
@@ -2,6 +2,12 @@
 #error "Never `#include` the source file `<system/subprocess_windows.tpp>`"
 #endif
 
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+
+#include <fcntl.h>
+#include <io.h>
 #include <process.h>
 
 namespace /* anonymous */
@@ -18,3 +24,126 @@ namespace /* anonymous */
 	}
 
 }  // namespace /* anonymous */
+
+
+namespace minijava
+{
+
+	struct detail::subprocess_state
+	{
+		// Handle of the subprocess as `return`ed by `_spawnvp`.
+		std::intptr_t process{-1};
+
+		// Write end of the pipe to the standard input of the subprocess.
+		std::FILE* input{};
+
+		// Read end of the pipe from the standard output of the subprocess.
+		std::FILE* output{};
+	};
+
+}  // namespace minijava
+
+
+namespace /* anonymous */
+{
+
+	[[noreturn]]
+	void throw_errno(const char*const what)
+	{
+		const auto ec = std::error_code{errno, std::system_category()};
+		throw std::system_error{ec, what};
+	}
+
+	void do_wait_subprocess(minijava::detail::subprocess_state& running, const std::string& name)
+	{
+		auto flush_error = 0;
+		if (running.input != nullptr) {
+			if (std::fclose(running.input) != 0) {
+				flush_error = errno;
+			}
+			running.input = nullptr;
+		}
+		if (running.output != nullptr) {
+			std::fclose(running.output);
+			running.output = nullptr;
+		}
+		int status;
+		if (_cwait(&status, running.process, 0) == -1) {
+			throw_errno("Cannot not wait for subprocess");
+		}
+		running.process = -1;
+		if (status) {
+			throw_subprocess_failed(name);
+		}
+		if (flush_error) {
+			const auto ec = std::error_code{flush_error, std::system_category()};
+			throw std::system_error{ec, "Cannot write to subprocess"};
+		}
+	}
+
+	// The spawned process inherits the standard streams of the calling
+	// process.  Therefore, they are temporarily replaced by the ends of the
+	// pipes while spawning.  The other ends are not inheritable.
+	std::unique_ptr<minijava::detail::subprocess_state>
+	do_start_subprocess(std::vector<char*> argv, const bool pipe_input, const bool pipe_output)
+	{
+		auto running = std::make_unique<minijava::detail::subprocess_state>();
+		int inpipe[2] = {-1, -1};
+		int outpipe[2] = {-1, -1};
+		const auto close_all = [&inpipe, &outpipe](){
+			for (const auto fd : {inpipe[0], inpipe[1], outpipe[0], outpipe[1]}) {
+				if (fd != -1) {
+					_close(fd);
+				}
+			}
+		};
+		if ((pipe_input && (_pipe(inpipe, 65536, _O_BINARY | _O_NOINHERIT) == -1))
+		    || (pipe_output && (_pipe(outpipe, 65536, _O_BINARY | _O_NOINHERIT) == -1))) {
+			const auto error = errno;
+			close_all();
+			errno = error;
+			throw_errno("Could not create pipe");
+		}
+		const auto saved_stdin = pipe_input ? _dup(0) : -1;
+		const auto saved_stdout = pipe_output ? _dup(1) : -1;
+		if (pipe_input) {
+			_dup2(inpipe[0], 0);
+		}
+		if (pipe_output) {
+			_dup2(outpipe[1], 1);
+		}
+		running->process = _spawnvp(_P_NOWAIT, argv[0], argv.data());
+		const auto error = errno;
+		if (pipe_input) {
+			_dup2(saved_stdin, 0);
+			_close(saved_stdin);
+			_close(inpipe[0]);
+			inpipe[0] = -1;
+		}
+		if (pipe_output) {
+			_dup2(saved_stdout, 1);
+			_close(saved_stdout);
+			_close(outpipe[1]);
+			outpipe[1] = -1;
+		}
+		if (running->process == -1) {
+			close_all();
+			throw_invoke_subprocess_failed(error, argv.front());
+		}
+		if (pipe_input && (running->input = _fdopen(inpipe[1], "wb"))) {
+			inpipe[1] = -1;
+		}
+		if (pipe_output && (running->output = _fdopen(outpipe[0], "rb"))) {
+			outpipe[0] = -1;
+		}
+		if ((pipe_input && !running->input) || (pipe_output && !running->output)) {
+			close_all();
+			try {
+				do_wait_subprocess(*running, argv.front());
+			} catch (const std::exception&) { /* report the original error */ }
+			throw_invoke_subprocess_failed(EMFILE, argv.front());
+		}
+		return running;
+	}
+
+}  // namespace /* anonymous */
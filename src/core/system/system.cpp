@@ -10,3 +10,11 @@
 #    include "system/rlimit_stack_generic.tpp"
 #  endif
 #undef MINIJAVA_INCLUDED_FROM_SYSTEM_SYSTEM_HPP
+
+#define MINIJAVA_INCLUDED_FROM_SYSTEM_SYSTEM_HPP
+#  if defined (__unix__)
+#    include "system/stack_thread_posix.tpp"
+#  else
+#    include "system/stack_thread_generic.tpp"
+#  endif
+#undef MINIJAVA_INCLUDED_FROM_SYSTEM_SYSTEM_HPP
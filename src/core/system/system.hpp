@@ -10,6 +10,8 @@
 #pragma once
 
 #include <cstddef>
+#include <functional>
+#include <memory>
 
 
 namespace minijava
@@ -42,4 +44,133 @@ namespace minijava
 	 */
 	std::ptrdiff_t set_max_stack_size_limit(std::ptrdiff_t limit);
 
+	namespace detail
+	{
+
+		// Platform specific state of a `stack_thread`.
+		struct stack_thread_state;
+
+	}  // namespace detail
+
+	/**
+	 * @brief
+	 *     A thread with a stack of a given size.
+	 *
+	 * Unlike a `std::thread`, a `stack_thread` is always joined when it is
+	 * destroyed.
+	 *
+	 */
+	class stack_thread final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Starts a new thread that calls `func` on a stack of `size`
+		 *     bytes.
+		 *
+		 * If `size` is zero or the platform doesn't support setting the stack
+		 * size of a thread, the default stack size is used.  If `func`
+		 * `throw`s an exception, `std::terminate` is called.
+		 *
+		 * @param size
+		 *     desired stack size in bytes
+		 *
+		 * @param func
+		 *     function to call on the new thread
+		 *
+		 * @throws std::system_error
+		 *     if the thread could not be created with the requested stack
+		 *     size
+		 *
+		 */
+		stack_thread(std::size_t size, std::function<void()> func);
+
+		/**
+		 * @brief
+		 *     Waits for the thread to finish unless it was already joined.
+		 *
+		 */
+		~stack_thread();
+
+		/**
+		 * @brief
+		 *     `delete`d copy constructor.
+		 *
+		 * `stack_thread`s are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 */
+		stack_thread(const stack_thread& other) = delete;
+
+		/**
+		 * @brief
+		 *     `delete`d copy-assignment operator.
+		 *
+		 * `stack_thread`s are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 * @returns
+		 *     *N/A*
+		 *
+		 */
+		stack_thread& operator=(const stack_thread& other) = delete;
+
+		/**
+		 * @brief
+		 *     Waits for the thread to finish.
+		 *
+		 * Calling this function more than once has no further effect.
+		 *
+		 */
+		void join() noexcept;
+
+	private:
+
+		/** @brief Platform specific state of the thread. */
+		std::unique_ptr<detail::stack_thread_state> _state;
+
+	};
+
+	/**
+	 * @brief
+	 *     `return`s the stack size the current thread was started with.
+	 *
+	 * This is the size that was passed to the `stack_thread` (or to
+	 * `call_with_stack_size`) that runs the current thread.  For any other
+	 * thread, and on platforms where the stack size of a thread cannot be
+	 * set, zero is `return`ed.
+	 *
+	 * @returns
+	 *     stack size in bytes or zero
+	 *
+	 */
+	std::size_t current_thread_stack_size() noexcept;
+
+	/**
+	 * @brief
+	 *     Calls a function on a new thread with a stack of the given size and
+	 *     waits for it to finish.
+	 *
+	 * This allows deeply recursive code to run without raising the stack
+	 * limit of the process, which might not be permitted.  Exceptions
+	 * `throw`n by `func` are propagated to the caller.
+	 *
+	 * If `size` is zero, the thread cannot be created with the requested
+	 * stack size or the platform doesn't support setting the stack size of
+	 * a thread, `func` is called on the current thread instead.
+	 *
+	 * @param size
+	 *     desired stack size in bytes
+	 *
+	 * @param func
+	 *     function to call
+	 *
+	 */
+	void call_with_stack_size(std::size_t size, const std::function<void()>& func);
+
 }  // namespace minijava
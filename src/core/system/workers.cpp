@@ -0,0 +1,125 @@
+#include "system/workers.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <system_error>
+#include <vector>
+
+#include "system/system.hpp"
+
+
+namespace /* anonymous */
+{
+
+	// Runs the job with index `index` and `return`s whether it succeeded,
+	// treating exceptions as failures.
+	bool run_job(const std::function<bool(std::size_t)>& job, const std::size_t index) noexcept
+	{
+		try {
+			return job(index);
+		} catch (const std::exception&) {
+			return false;
+		}
+	}
+
+	std::size_t run_sequentially(const std::size_t count, const std::function<bool(std::size_t)>& job)
+	{
+		auto failures = std::size_t{};
+		for (auto i = std::size_t{}; i < count; ++i) {
+			if (!run_job(job, i)) {
+				++failures;
+			}
+		}
+		return failures;
+	}
+
+	std::size_t do_run_worker_processes(std::size_t count, std::size_t workers,
+	                                    const std::function<bool(std::size_t)>& job);
+
+	// Starts a helper thread that runs `work` with the same stack size as
+	// the calling thread or, if that is not possible, the default size.
+	std::unique_ptr<minijava::stack_thread> start_helper_thread(const std::function<void()>& work)
+	{
+		if (const auto size = minijava::current_thread_stack_size()) {
+			try {
+				return std::make_unique<minijava::stack_thread>(size, work);
+			} catch (const std::system_error&) { /* fall through */ }
+		}
+		return std::make_unique<minijava::stack_thread>(0, work);
+	}
+
+}  // namespace /* anonymous */
+
+namespace minijava
+{
+
+	std::size_t run_worker_processes(const std::size_t count, const std::size_t workers,
+	                                 const std::function<bool(std::size_t)>& job)
+	{
+		if ((workers < 2) || (count < 2)) {
+			return run_sequentially(count, job);
+		}
+		return do_run_worker_processes(count, std::min(count, workers), job);
+	}
+
+	void run_worker_threads(const std::size_t count, const std::size_t threads,
+	                        const std::function<void(std::size_t)>& job)
+	{
+		if ((threads < 2) || (count < 2)) {
+			for (auto i = std::size_t{}; i < count; ++i) {
+				job(i);
+			}
+			return;
+		}
+		std::atomic<std::size_t> next{0};
+		std::atomic<bool> failed{false};
+		auto errors = std::vector<std::exception_ptr>(count);
+		const auto work = [&](){
+			while (!failed) {
+				const auto index = next++;
+				if (index >= count) {
+					break;
+				}
+				try {
+					job(index);
+				} catch (...) {
+					errors[index] = std::current_exception();
+					failed = true;
+				}
+			}
+		};
+		auto helpers = std::vector<std::unique_ptr<stack_thread>>{};
+		try {
+			for (auto i = std::min(count, threads); i > 1; --i) {
+				helpers.push_back(start_helper_thread(work));
+			}
+		} catch (...) {
+			failed = true;
+			for (auto& thread : helpers) {
+				thread->join();
+			}
+			throw;
+		}
+		work();
+		for (auto& thread : helpers) {
+			thread->join();
+		}
+		for (const auto& error : errors) {
+			if (error) {
+				std::rethrow_exception(error);
+			}
+		}
+	}
+
+}  // namespace minijava
+
+
+#define MINIJAVA_INCLUDED_FROM_SYSTEM_WORKERS_CPP
+#  if defined (__unix__)
+#    include "system/workers_posix.tpp"
+#  else
+#    include "system/workers_generic.tpp"
+#  endif
+#undef MINIJAVA_INCLUDED_FROM_SYSTEM_WORKERS_CPP
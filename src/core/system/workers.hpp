@@ -0,0 +1,95 @@
+/**
+ * @file workers.hpp
+ *
+ * @brief
+ *     Helper functions for running independent jobs in worker processes.
+ *
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     Runs `count` independent jobs on up to `workers` worker processes.
+	 *
+	 * The function `job` is called exactly once for each index in the range
+	 * [0, `count`) and must `return` whether that job succeeded.  Exceptions
+	 * `throw`n by `job` are treated as failures and not propagated.  The
+	 * order in which the jobs are run is unspecified.
+	 *
+	 * On POSIX systems, the worker processes are `fork`ed from the current
+	 * process, so they inherit any state that was set up before calling this
+	 * function.  Jobs are handed out one at a time to whichever worker is
+	 * idle, so a few expensive jobs don't hold up the others.  A worker that
+	 * terminates abnormally while running a job is not replaced and the job
+	 * counts as failed.  Standard output and error of the workers are not
+	 * synchronized beyond what a single `write` guarantees.
+	 *
+	 * If `workers` is less than two, or the platform doesn't support worker
+	 * processes, all jobs are run sequentially in the current process.
+	 *
+	 * @param count
+	 *     number of jobs
+	 *
+	 * @param workers
+	 *     maximum number of worker processes to use
+	 *
+	 * @param job
+	 *     function that runs the job with the given index
+	 *
+	 * @returns
+	 *     number of jobs that failed
+	 *
+	 * @throws std::system_error
+	 *     if the worker processes could not be started
+	 *
+	 */
+	std::size_t run_worker_processes(std::size_t count, std::size_t workers,
+	                                 const std::function<bool(std::size_t)>& job);
+
+	/**
+	 * @brief
+	 *     Runs `count` independent jobs on up to `threads` threads.
+	 *
+	 * The function `job` is called once for each index in the range [0,
+	 * `count`).  Jobs are handed out in increasing order of their index one
+	 * at a time to whichever thread is idle, so they may run concurrently
+	 * and `job` must be safe to call from several threads at once.  The
+	 * calling thread works on the jobs, too.  The other threads get the same
+	 * stack size as the calling thread if it was started by a `stack_thread`
+	 * (see `current_thread_stack_size`), so deeply recursive jobs work no
+	 * matter which thread runs them.
+	 *
+	 * If a job `throw`s an exception, no further jobs are started.  After
+	 * the running ones have finished, the exception of the failed job with
+	 * the smallest index is re`throw`n.  Since all jobs with a smaller index
+	 * have been started at that point, the exception does not depend on how
+	 * the threads were scheduled as long as the jobs themselves are
+	 * deterministic.
+	 *
+	 * If `threads` is less than two, all jobs are run sequentially in the
+	 * current thread.
+	 *
+	 * @param count
+	 *     number of jobs
+	 *
+	 * @param threads
+	 *     maximum number of threads to use
+	 *
+	 * @param job
+	 *     function that runs the job with the given index
+	 *
+	 * @throws std::system_error
+	 *     if the threads could not be started
+	 *
+	 */
+	void run_worker_threads(std::size_t count, std::size_t threads,
+	                        const std::function<void(std::size_t)>& job);
+
+}  // namespace minijava
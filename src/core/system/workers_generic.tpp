@@ -0,0 +1,15 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYSTEM_WORKERS_CPP
+#error "Never `#include` the source file `<system/workers_generic.tpp>`"
+#endif
+
+
+namespace /* anonymous */
+{
+
+	std::size_t do_run_worker_processes(const std::size_t count, const std::size_t /* workers */,
+	                                    const std::function<bool(std::size_t)>& job)
+	{
+		return run_sequentially(count, job);
+	}
+
+}  // namespace /* anonymous */
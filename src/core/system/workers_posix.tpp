@@ -0,0 +1,204 @@
+#ifndef MINIJAVA_INCLUDED_FROM_SYSTEM_WORKERS_CPP
+#error "Never `#include` the source file `<system/workers_posix.tpp>`"
+#endif
+
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <system_error>
+#include <vector>
+
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+
+namespace /* anonymous */
+{
+
+	// Message sent from a worker to the parent whenever it becomes idle.
+	struct worker_message
+	{
+		// Index of the worker.
+		std::size_t worker;
+
+		// Outcome of the last job: 1 for success, 0 for failure and -1 if
+		// the worker has not run any job yet.
+		int status;
+	};
+
+	[[noreturn]]
+	void throw_errno(const char*const what)
+	{
+		const auto ec = std::error_code{errno, std::system_category()};
+		throw std::system_error{ec, what};
+	}
+
+	// Reads exactly `size` bytes from `fd` into `buffer`, retrying on
+	// interrupts, and `return`s `false` on end of file or error.  The
+	// messages exchanged here are smaller than `PIPE_BUF` so they are
+	// written atomically and never split.
+	bool read_fully(const int fd, void*const buffer, const std::size_t size) noexcept
+	{
+		auto n = ssize_t{};
+		while ((n = read(fd, buffer, size)) == -1) {
+			if (errno != EINTR) {
+				return false;
+			}
+		}
+		return (static_cast<std::size_t>(n) == size);
+	}
+
+	bool write_fully(const int fd, const void*const buffer, const std::size_t size) noexcept
+	{
+		auto n = ssize_t{};
+		while ((n = write(fd, buffer, size)) == -1) {
+			if (errno != EINTR) {
+				return false;
+			}
+		}
+		return (static_cast<std::size_t>(n) == size);
+	}
+
+	// Main loop of worker number `worker` that receives job indices from
+	// `jobfd` and reports back to `resultfd` until the parent closes the job
+	// pipe.  Never `return`s.
+	[[noreturn]]
+	void worker_main(const std::size_t worker, const int jobfd, const int resultfd,
+	                 const std::function<bool(std::size_t)>& job) noexcept
+	{
+		auto message = worker_message{worker, -1};
+		auto index = std::size_t{};
+		while (write_fully(resultfd, &message, sizeof(message))
+		       && read_fully(jobfd, &index, sizeof(index))) {
+			message.status = run_job(job, index) ? 1 : 0;
+		}
+		std::fflush(nullptr);
+		_exit(EXIT_SUCCESS);
+	}
+
+	// Ignores `SIGPIPE` for the lifetime of the object so writing to a
+	// worker that has crashed fails with `EPIPE` instead of killing us.
+	class sigpipe_guard final
+	{
+	public:
+
+		sigpipe_guard()
+		{
+			struct sigaction ignore{};
+			ignore.sa_handler = SIG_IGN;
+			sigemptyset(&ignore.sa_mask);
+			if (sigaction(SIGPIPE, &ignore, &_old) == -1) {
+				throw_errno("Cannot ignore SIGPIPE");
+			}
+		}
+
+		~sigpipe_guard()
+		{
+			sigaction(SIGPIPE, &_old, nullptr);
+		}
+
+		sigpipe_guard(const sigpipe_guard&) = delete;
+		sigpipe_guard& operator=(const sigpipe_guard&) = delete;
+
+	private:
+
+		struct sigaction _old{};
+
+	};
+
+	std::size_t do_run_worker_processes(const std::size_t count, const std::size_t workers,
+	                                    const std::function<bool(std::size_t)>& job)
+	{
+		const sigpipe_guard guard{};
+		// File descriptors owned by the parent; closed in each child right
+		// after `fork`ing and in the parent when it's done.
+		auto parentfds = std::vector<int>{};
+		auto closeall = [](std::vector<int>& fds){
+			for (const auto fd : fds) {
+				if (fd >= 0) {
+					close(fd);
+				}
+			}
+			fds.clear();
+		};
+		int resultfds[2];
+		if (pipe(resultfds) == -1) {
+			throw_errno("Cannot create pipe for worker processes");
+		}
+		const auto resultfd = resultfds[0];
+		parentfds.push_back(resultfd);
+		auto jobfds = std::vector<int>(workers, -1);
+		auto pids = std::vector<pid_t>{};
+		auto running = std::vector<bool>(workers, false);
+		std::fflush(nullptr);  // Don't duplicate buffered output.
+		try {
+			for (auto w = std::size_t{}; w < workers; ++w) {
+				int fds[2];
+				if (pipe(fds) == -1) {
+					throw_errno("Cannot create pipe for worker processes");
+				}
+				const auto pid = fork();
+				if (pid == -1) {
+					close(fds[0]);
+					close(fds[1]);
+					throw_errno("Cannot fork worker process");
+				}
+				if (pid == 0) {
+					closeall(parentfds);
+					close(fds[1]);
+					worker_main(w, fds[0], resultfds[1], job);
+				}
+				close(fds[0]);
+				jobfds[w] = fds[1];
+				parentfds.push_back(fds[1]);
+				pids.push_back(pid);
+			}
+		} catch (...) {
+			close(resultfds[1]);
+			closeall(parentfds);
+			for (const auto pid : pids) {
+				while ((waitpid(pid, nullptr, 0) == -1) && (errno == EINTR)) {}
+			}
+			throw;
+		}
+		close(resultfds[1]);
+		auto next = std::size_t{};
+		auto failures = std::size_t{};
+		auto message = worker_message{};
+		while (read_fully(resultfd, &message, sizeof(message))) {
+			const auto w = message.worker;
+			if ((w >= workers) || (jobfds[w] < 0)) {
+				continue;
+			}
+			if (message.status == 0) {
+				++failures;
+			}
+			running[w] = false;
+			if ((next < count) && write_fully(jobfds[w], &next, sizeof(next))) {
+				running[w] = true;
+				++next;
+			} else {
+				close(jobfds[w]);
+				jobfds[w] = -1;
+			}
+		}
+		// We only get here after all workers have closed their end of the
+		// result pipe.  Any jobs still marked as running belong to workers
+		// that died and any jobs not handed out yet are lost, too.
+		failures += static_cast<std::size_t>(std::count(running.begin(), running.end(), true));
+		failures += count - next;
+		for (auto& fd : jobfds) {
+			if (fd >= 0) {
+				close(fd);
+			}
+		}
+		close(resultfd);
+		for (const auto pid : pids) {
+			while ((waitpid(pid, nullptr, 0) == -1) && (errno == EINTR)) {}
+		}
+		return failures;
+	}
+
+}  // namespace /* anonymous */
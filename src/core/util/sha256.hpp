@@ -0,0 +1,101 @@
+/**
+ * @file sha256.hpp
+ *
+ * @brief
+ *     SHA-256 message digests.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+
+namespace minijava
+{
+
+	/**
+	 * @brief
+	 *     Incremental computation of a SHA-256 message digest.
+	 *
+	 * Data is fed into the object via any number of calls to `update` and
+	 * the digest is obtained from `hexdigest` which also resets the object
+	 * so it can be used to compute another digest.
+	 *
+	 * The implementation is straight-forward and not hardened against side
+	 * channels.  It is intended for content-addressing, not cryptography.
+	 *
+	 */
+	class sha256 final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Creates an object ready to compute the digest of a new message.
+		 *
+		 */
+		sha256() noexcept;
+
+		/**
+		 * @brief
+		 *     Appends `size` bytes at `data` to the message.
+		 *
+		 * @param data
+		 *     pointer to the first byte
+		 *
+		 * @param size
+		 *     number of bytes
+		 *
+		 */
+		void update(const void* data, std::size_t size) noexcept;
+
+		/**
+		 * @brief
+		 *     Appends the characters of `text` to the message.
+		 *
+		 * @param text
+		 *     data to append
+		 *
+		 */
+		void update(const std::string& text) noexcept
+		{
+			update(text.data(), text.size());
+		}
+
+		/**
+		 * @brief
+		 *     Finishes the computation and `return`s the digest as a string
+		 *     of 64 lower-case hexadecimal digits.
+		 *
+		 * Afterwards, the object is in the same state as a newly created one.
+		 *
+		 * @returns
+		 *     hexadecimal digest
+		 *
+		 */
+		std::string hexdigest();
+
+	private:
+
+		/** @brief Processes the 64 bytes in `_block`. */
+		void _compress() noexcept;
+
+		/** @brief Intermediate hash value. */
+		std::array<std::uint32_t, 8> _state;
+
+		/** @brief Partially filled block of input. */
+		std::array<std::uint8_t, 64> _block;
+
+		/** @brief Number of bytes in `_block`. */
+		std::size_t _filled;
+
+		/** @brief Total length of the message in bytes. */
+		std::uint64_t _length;
+
+	};
+
+}  // namespace minijava
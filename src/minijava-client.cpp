@@ -0,0 +1,28 @@
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <vector>
+
+#include "global.hpp"
+#include "system/server.hpp"
+
+
+int main(int argc, char * * argv)
+{
+	try {
+		const auto socket_name = std::getenv(MINIJAVA_ENVVAR_SERVER);
+		if ((socket_name == nullptr) || (*socket_name == '\0')) {
+			std::fprintf(
+				stderr, "minijava-client: error: %s\n",
+				"Set " MINIJAVA_ENVVAR_SERVER " to the socket of a running compiler server"
+			);
+			return EXIT_FAILURE;
+		}
+		const auto args = std::vector<const char*>{argv, argv + argc};
+		return minijava::run_client(socket_name, args, stdin, stdout, stderr);
+	} catch (const std::exception& e) {
+		// NB: Don't alter the string "error: " -- it is required output.
+		std::fprintf(stderr, "minijava-client: error: %s\n", e.what());
+		return EXIT_FAILURE;
+	}
+}
@@ -11,8 +11,7 @@ int main(int argc, char * * argv)
 {
 	try {
 		const auto args = std::vector<const char*>{argv, argv + argc};
-		minijava::real_main(args, stdin, stdout, stderr);
-		return EXIT_SUCCESS;
+		return minijava::real_main(args, stdin, stdout, stderr);
 	} catch (const std::exception& e) {
 		// NB: Don't alter the string "error: " -- it is required output.
 		std::fprintf(stderr, "%s: error: %s\n", MINIJAVA_PROJECT_NAME, e.what());
@@ -5,6 +5,12 @@
 #include <stdlib.h>
 #include <setjmp.h>
 #include <string.h>
+#include <time.h>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 
 __attribute__ ((sysv_abi))
@@ -14,28 +20,704 @@ extern void minijava_main(void);
 static const char* program_name;
 static jmp_buf exception_jump_buffer;
 
+/* Streams of the program.  An executable uses the standard streams. */
+static FILE* input_stream;
+static FILE* output_stream;
+static FILE* error_stream;
+
+#if defined(__unix__)
+/* File descriptors of `input_stream` and `output_stream`. */
+static int input_fd;
+static int output_fd;
+#endif
+
+
+#if defined(MJ_RUNTIME_EMBEDDED)
+
+/*
+  Embedded runtime
+
+  If `MJ_RUNTIME_EMBEDDED` is defined, this file does not define `main` but
+  `mj_runtime_run`, which runs a program that the host process has loaded into
+  its own memory and `return`s its exit status instead of exiting.  The host
+  provides the streams and the name used in diagnostics.
+
+  Compiled code addresses the exported variables with 32 bit absolute
+  addresses, so they have to live in the image of the program.  The host
+  reserves a `struct mj_runtime_variables` there and the names of the
+  variables refer to its members.  The static data of the program is scanned
+  for roots instead of the static data of the host process.
+*/
+
+struct mj_runtime_variables
+{
+	char* heap_next;
+	char* heap_limit;
+	char* output_next;
+	char* output_limit;
+	char* input_next;
+	char* input_limit;
+};
+
+struct mj_runtime_host
+{
+	const char* program_name;
+	FILE* input;
+	FILE* output;
+	FILE* error;
+	struct mj_runtime_variables* variables;
+	/* Bounds of the static data of the program. */
+	const char* data_start;
+	const char* data_end;
+};
+
+static struct mj_runtime_variables* variables;
+static const char* data_start;
+static const char* data_end;
+static int exit_status;
+
+#define mj_runtime_heap_next (variables->heap_next)
+#define mj_runtime_heap_limit (variables->heap_limit)
+#define mj_runtime_output_next (variables->output_next)
+#define mj_runtime_output_limit (variables->output_limit)
+#define mj_runtime_input_next (variables->input_next)
+#define mj_runtime_input_limit (variables->input_limit)
+
+#endif
+
+
+/*
+  Heap
+
+  Every block on the heap starts with a header word that holds the size of the
+  block in bytes (including the header) and two flag bits.  Objects are
+  allocated by bumping `mj_runtime_heap_next` towards `mj_runtime_heap_limit`
+  and writing the header.  Compiled programs do this themselves for small
+  allocations of constant size and only call `mj_runtime_new` if the current
+  span of free memory is exhausted.
+
+  Small blocks live in chunks that can be parsed from their start by following
+  the sizes in the headers.  Large objects get their own chunk.  When the heap
+  grows beyond a threshold, a conservative mark-sweep collection is run.  Any
+  properly aligned word on the stack, in the callee-saved registers, in the
+  static data of the program or in a reachable block that points into a block
+  keeps that block alive.  Unreachable blocks are coalesced into free blocks,
+  which later become spans to allocate from.
+*/
+
+/* Size of the memory chunks the allocator requests from the system. */
+#define CHUNK_SIZE (1L << 20)
+
+/* Blocks larger than this get their own chunk. */
+#define LARGE_OBJECT_SIZE (CHUNK_SIZE / 4)
+
+/* Heap size below which no collection is attempted. */
+#define INITIAL_THRESHOLD (16L << 20)
+
+#define HEADER_SIZE 8
+#define FLAG_MARK 0x1
+#define FLAG_FREE 0x2
+#define SIZE_MASK (~(uint64_t) 7)
+
+/* Name of the environment variable that enables statistics of the collector. */
+#define ENVVAR_GC_STATS "MINIJAVA_GC_STATS"
+
+
+#if !defined(MJ_RUNTIME_EMBEDDED)
+char* mj_runtime_heap_next;
+char* mj_runtime_heap_limit;
+#endif
+
+
+struct chunk
+{
+	char* start;
+	char* end;
+	/* Bit set of the offsets (in words) where blocks start or `NULL` for the
+	 * chunk of a large object. */
+	uint64_t* starts;
+};
+
+static struct chunk* chunks;       /* sorted by address */
+static size_t chunk_count;
+static size_t chunk_capacity;
+static size_t heap_size;           /* total size of all chunks */
+static size_t heap_threshold = INITIAL_THRESHOLD;
+static char* free_list;            /* free blocks of at least 16 bytes */
+
+static char** mark_stack;
+static size_t mark_stack_size;
+static size_t mark_stack_capacity;
+
+static char* stack_bottom;
+
+static int gc_stats;
+static unsigned long gc_count;
+static double gc_total_pause;      /* in seconds */
+static double gc_max_pause;        /* in seconds */
+static size_t gc_peak_heap;
+
+#if !defined(MJ_RUNTIME_EMBEDDED) && defined(__GNUC__) && defined(__ELF__)
+/* Bounds of the static data of the program as defined by the GNU linker. */
+extern char __data_start[] __attribute__ ((weak));
+extern char _end[] __attribute__ ((weak));
+#endif
+
 
 static inline int32_t maximum(const int32_t a, const int32_t b)
 {
 	return (a > b) ? a : b;
 }
 
+static inline uint64_t* header_of(char* block)
+{
+	return (uint64_t*) (void*) block;
+}
+
+static inline size_t size_of(char* block)
+{
+	return (size_t) (*header_of(block) & SIZE_MASK);
+}
+
+static double current_time(void)
+{
+#if defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double) ts.tv_sec + 1.0E-9 * (double) ts.tv_nsec;
+#else
+	return (double) clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/* Returns `size` bytes of fresh zero-initialized memory or `NULL`.  Where
+ * available, the pages are mapped directly so they need not be cleared. */
+static char* map_memory(const size_t size)
+{
+#if defined(__unix__) && defined(MAP_ANONYMOUS)
+	void* memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	return (memory != MAP_FAILED) ? memory : NULL;
+#else
+	return calloc(1, size);
+#endif
+}
+
+static void unmap_memory(char* memory, const size_t size)
+{
+#if defined(__unix__) && defined(MAP_ANONYMOUS)
+	munmap(memory, size);
+#else
+	(void) size;
+	free(memory);
+#endif
+}
+
+__attribute__ ((noreturn))
+static void fail_out_of_memory(const char* function)
+{
+	fprintf(error_stream, "%s: %s: %s\n", program_name, function, strerror(ENOMEM));
+	longjmp(exception_jump_buffer, 1);
+}
+
+/* Maps a new chunk of `size` bytes and `return`s it or `NULL`. */
+static struct chunk* add_chunk(const size_t size, const int large)
+{
+	if (chunk_count == chunk_capacity) {
+		const size_t capacity = (chunk_capacity > 0) ? 2 * chunk_capacity : 16;
+		struct chunk* resized = realloc(chunks, capacity * sizeof(struct chunk));
+		if (resized == NULL) {
+			return NULL;
+		}
+		chunks = resized;
+		chunk_capacity = capacity;
+	}
+	uint64_t* starts = NULL;
+	if (!large && ((starts = calloc(size / HEADER_SIZE / 64, sizeof(uint64_t))) == NULL)) {
+		return NULL;
+	}
+	char* memory = map_memory(size);
+	if (memory == NULL) {
+		free(starts);
+		return NULL;
+	}
+	size_t i = chunk_count;
+	while ((i > 0) && (chunks[i - 1].start > memory)) {
+		chunks[i] = chunks[i - 1];
+		--i;
+	}
+	chunks[i].start = memory;
+	chunks[i].end = memory + size;
+	chunks[i].starts = starts;
+	chunk_count += 1;
+	heap_size += size;
+	if (heap_size > gc_peak_heap) {
+		gc_peak_heap = heap_size;
+	}
+	return &chunks[i];
+}
+
+/* Returns the chunk that contains `p` or `NULL`. */
+static struct chunk* find_chunk(const char* p)
+{
+	size_t lo = 0;
+	size_t hi = chunk_count;
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (p < chunks[mid].start) {
+			hi = mid;
+		} else if (p >= chunks[mid].end) {
+			lo = mid + 1;
+		} else {
+			return &chunks[mid];
+		}
+	}
+	return NULL;
+}
+
+/* Returns the start of the block in the chunk `c` that contains `p`. */
+static char* find_block(const struct chunk* c, const char* p)
+{
+	if (c->starts == NULL) {
+		return c->start;
+	}
+	size_t index = (size_t) (p - c->start) / HEADER_SIZE;
+	uint64_t word = c->starts[index / 64] & (~(uint64_t) 0 >> (63 - index % 64));
+	index /= 64;
+	/* Every chunk starts with a block, so this terminates. */
+	while (word == 0) {
+		word = c->starts[--index];
+	}
+	const size_t bit = 63 - (size_t) __builtin_clzll(word);
+	return c->start + HEADER_SIZE * (64 * index + bit);
+}
+
+/* Turns the rest of the current span into a free block so the heap can be
+ * parsed again. */
+static void retire_span(void)
+{
+	if (mj_runtime_heap_next < mj_runtime_heap_limit) {
+		*header_of(mj_runtime_heap_next) = (uint64_t) (mj_runtime_heap_limit - mj_runtime_heap_next) | FLAG_FREE;
+	}
+	mj_runtime_heap_next = NULL;
+	mj_runtime_heap_limit = NULL;
+}
+
+static void add_free_block(char* block, const size_t size)
+{
+	*header_of(block) = (uint64_t) size | FLAG_FREE;
+	if (size >= 2 * HEADER_SIZE) {
+		memcpy(block + HEADER_SIZE, &free_list, sizeof(free_list));
+		free_list = block;
+	}
+}
+
+/* Removes the first free block of at least `size` bytes from the free list,
+ * clears it and makes it the current span.  `return`s 0 on success. */
+static int take_free_block(const size_t size)
+{
+	for (char** link = &free_list; *link != NULL; ) {
+		char* block = *link;
+		const size_t available = size_of(block);
+		if (available >= size) {
+			memcpy(link, block + HEADER_SIZE, sizeof(free_list));
+			memset(block, 0, available);
+			mj_runtime_heap_next = block;
+			mj_runtime_heap_limit = block + available;
+			return 0;
+		}
+		link = (char**) (void*) (block + HEADER_SIZE);
+	}
+	return -1;
+}
+
+static void push_mark_stack(char* block)
+{
+	if (mark_stack_size == mark_stack_capacity) {
+		const size_t capacity = (mark_stack_capacity > 0) ? 2 * mark_stack_capacity : 1024;
+		char** resized = realloc(mark_stack, capacity * sizeof(char*));
+		if (resized == NULL) {
+			fail_out_of_memory("gc");
+		}
+		mark_stack = resized;
+		mark_stack_capacity = capacity;
+	}
+	mark_stack[mark_stack_size++] = block;
+}
+
+static void mark_address(const char* p)
+{
+	const struct chunk* c = find_chunk(p);
+	if (c == NULL) {
+		return;
+	}
+	char* block = find_block(c, p);
+	uint64_t* header = header_of(block);
+	if ((*header & (FLAG_MARK | FLAG_FREE)) == 0) {
+		*header |= FLAG_MARK;
+		push_mark_stack(block);
+	}
+}
+
+static void mark_range(const char* first, const char* last)
+{
+	const uintptr_t begin = ((uintptr_t) first + sizeof(char*) - 1) & ~(uintptr_t) (sizeof(char*) - 1);
+	for (const char* const* p = (const char* const*) begin; (const char*) (p + 1) <= last; ++p) {
+		mark_address(*p);
+	}
+}
+
+/* Marks everything that is reachable from the roots.  This function must not
+ * be inlined so its frame is below the saved registers of its caller. */
+__attribute__ ((noinline))
+static void mark_from_roots(void)
+{
+	const char* stack_top = __builtin_frame_address(0);
+	mark_range(stack_top, stack_bottom);
+#if defined(MJ_RUNTIME_EMBEDDED)
+	mark_range(data_start, data_end);
+#elif defined(__GNUC__) && defined(__ELF__)
+	if ((__data_start != NULL) && (_end != NULL)) {
+		mark_range(__data_start, _end);
+	}
+#endif
+	while (mark_stack_size > 0) {
+		char* block = mark_stack[--mark_stack_size];
+		mark_range(block + HEADER_SIZE, block + size_of(block));
+	}
+}
+
+/* Records where blocks start in all chunks of small blocks. */
+static void find_block_starts(void)
+{
+	for (size_t i = 0; i < chunk_count; ++i) {
+		const struct chunk* c = &chunks[i];
+		if (c->starts == NULL) {
+			continue;
+		}
+		memset(c->starts, 0, (size_t) (c->end - c->start) / HEADER_SIZE / 8);
+		for (char* block = c->start; block < c->end; block += size_of(block)) {
+			const size_t index = (size_t) (block - c->start) / HEADER_SIZE;
+			c->starts[index / 64] |= (uint64_t) 1 << (index % 64);
+		}
+	}
+}
+
+/* Frees all unmarked blocks, clears the marks and `return`s the number of
+ * bytes still in use.  Chunks without live blocks are left as a single free
+ * block that is not yet on the free list. */
+static size_t sweep(void)
+{
+	size_t live = 0;
+	size_t kept = 0;
+	free_list = NULL;
+	for (size_t i = 0; i < chunk_count; ++i) {
+		struct chunk c = chunks[i];
+		const size_t size = (size_t) (c.end - c.start);
+		if (c.starts == NULL) {
+			if ((*header_of(c.start) & FLAG_MARK) == 0) {
+				unmap_memory(c.start, size);
+				heap_size -= size;
+				continue;
+			}
+			*header_of(c.start) &= ~(uint64_t) FLAG_MARK;
+			live += size;
+			chunks[kept++] = c;
+			continue;
+		}
+		char* run = NULL;
+		for (char* block = c.start; block < c.end; block += size_of(block)) {
+			uint64_t* header = header_of(block);
+			if (*header & FLAG_MARK) {
+				*header &= ~(uint64_t) FLAG_MARK;
+				live += size_of(block);
+				if (run != NULL) {
+					add_free_block(run, (size_t) (block - run));
+					run = NULL;
+				}
+			} else if (run == NULL) {
+				run = block;
+			}
+		}
+		if (run == c.start) {
+			*header_of(run) = (uint64_t) size | FLAG_FREE;
+		} else if (run != NULL) {
+			add_free_block(run, (size_t) (c.end - run));
+		}
+		chunks[kept++] = c;
+	}
+	chunk_count = kept;
+	return live;
+}
+
+/* Gives chunks without live blocks back to the system as long as the heap is
+ * larger than `limit` and puts the remaining ones on the free list. */
+static void release_empty_chunks(const size_t limit)
+{
+	size_t kept = 0;
+	for (size_t i = 0; i < chunk_count; ++i) {
+		struct chunk c = chunks[i];
+		const size_t size = (size_t) (c.end - c.start);
+		const int empty = (c.starts != NULL) && (*header_of(c.start) == ((uint64_t) size | FLAG_FREE));
+		if (empty && (heap_size > limit)) {
+			unmap_memory(c.start, size);
+			free(c.starts);
+			heap_size -= size;
+			continue;
+		}
+		if (empty) {
+			add_free_block(c.start, size);
+		}
+		chunks[kept++] = c;
+	}
+	chunk_count = kept;
+}
+
+static void collect(void)
+{
+	const double start = current_time();
+	const size_t heap_before = heap_size;
+	retire_span();
+	find_block_starts();
+	mark_from_roots();
+	const size_t live = sweep();
+	heap_threshold = (2 * live > INITIAL_THRESHOLD) ? 2 * live : INITIAL_THRESHOLD;
+	release_empty_chunks(heap_threshold);
+	const double pause = current_time() - start;
+	gc_count += 1;
+	gc_total_pause += pause;
+	if (pause > gc_max_pause) {
+		gc_max_pause = pause;
+	}
+	if (gc_stats) {
+		fprintf(
+			error_stream, "%s: gc: collection %lu took %.3f ms, heap %lu KiB -> %lu KiB, live %lu KiB\n",
+			program_name, gc_count, 1.0E3 * pause,
+			(unsigned long) (heap_before / 1024), (unsigned long) (heap_size / 1024), (unsigned long) (live / 1024)
+		);
+	}
+}
+
+/* Collects garbage if the heap would grow beyond the threshold by adding
+ * `size` bytes.  This function must not be inlined so the callee-saved
+ * registers are saved in its frame, which is scanned for roots. */
+__attribute__ ((noinline))
+static void collect_if_needed(const size_t size)
+{
+	__builtin_unwind_init();
+	if (heap_size + size > heap_threshold) {
+		collect();
+	}
+}
+
+static void print_gc_summary(void)
+{
+	fprintf(
+		error_stream, "%s: gc: %lu collections, total pause %.3f ms, max pause %.3f ms, peak heap %lu KiB\n",
+		program_name, gc_count, 1.0E3 * gc_total_pause, 1.0E3 * gc_max_pause, (unsigned long) (gc_peak_heap / 1024)
+	);
+}
+
+/* Makes a free block or a new chunk the current span so that at least `size`
+ * bytes can be allocated from it.  `return`s 0 on success. */
+static int refill_span(const size_t size)
+{
+	retire_span();
+	if (take_free_block(size) == 0) {
+		return 0;
+	}
+	collect_if_needed(CHUNK_SIZE);
+	if (take_free_block(size) == 0) {
+		return 0;
+	}
+	const struct chunk* c = add_chunk(CHUNK_SIZE, 0);
+	if (c == NULL) {
+		return -1;
+	}
+	mj_runtime_heap_next = c->start;
+	mj_runtime_heap_limit = c->end;
+	return 0;
+}
+
+static void* allocate(const size_t size)
+{
+	/* Round to 8 bytes just like inline allocations do. */
+	const size_t total = ((size + 7) & ~(size_t) 7) + HEADER_SIZE;
+	if (total > LARGE_OBJECT_SIZE) {
+		collect_if_needed(total);
+		const struct chunk* c = add_chunk(total, 1);
+		if (c == NULL) {
+			return NULL;
+		}
+		*header_of(c->start) = total;
+		return c->start + HEADER_SIZE;
+	}
+	if ((total > (size_t) (mj_runtime_heap_limit - mj_runtime_heap_next)) && (refill_span(total) != 0)) {
+		return NULL;
+	}
+	char* block = mj_runtime_heap_next;
+	mj_runtime_heap_next += total;
+	*header_of(block) = total;
+	return block + HEADER_SIZE;
+}
+
+/*
+  Input and output
+
+  The runtime keeps its own buffers for standard input and output so that
+  each byte or number costs neither a call into a locked stdio function nor
+  parsing a format string.  Output is flushed by `flush`, when the buffer is
+  full and when the program exits.  If standard output is a terminal, it is
+  also flushed after each newline character and before blocking for input.
+
+  The current positions in the buffers and their limits are exported so that
+  compiled programs can write and read single bytes inline.  They only call
+  `mj_runtime_write` if `mj_runtime_output_next` has reached
+  `mj_runtime_output_limit` and `mj_runtime_read` if `mj_runtime_input_next`
+  has reached `mj_runtime_input_limit`.  If standard output is a terminal, the
+  output limit is the start of the buffer so every byte is checked for a
+  newline character.
+*/
+
+/* Size of the input and output buffers. */
+#define BUFFER_SIZE (1L << 16)
+
+static char output_buffer[BUFFER_SIZE];
+static char input_buffer[BUFFER_SIZE];
+static int input_eof;
+
+#if !defined(MJ_RUNTIME_EMBEDDED)
+char* mj_runtime_output_next;
+char* mj_runtime_output_limit;
+char* mj_runtime_input_next;
+char* mj_runtime_input_limit;
+#endif
+
+static int stdout_is_terminal;
+
+
+__attribute__ ((noreturn))
+static void fail(const char* function, const int error)
+{
+	fprintf(error_stream, "%s: %s: %s\n", program_name, function, strerror(error));
+	longjmp(exception_jump_buffer, 1);
+}
+
+/* Writes all `n` bytes to standard output and `return`s 0 or an error
+ * number. */
+static int write_output(const char* data, size_t n)
+{
+#if defined(__unix__)
+	while (n > 0) {
+		const ssize_t count = write(output_fd, data, n);
+		if (count < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			return errno;
+		}
+		data += count;
+		n -= (size_t) count;
+	}
+	return 0;
+#else
+	if ((fwrite(data, 1, n, output_stream) != n) || (fflush(output_stream) != 0)) {
+		return errno;
+	}
+	return 0;
+#endif
+}
+
+/* Reads up to `n` bytes from standard input and `return`s their number, 0 at
+ * the end of the input or -1 on error (with `errno` set). */
+static long read_input(char* data, const size_t n)
+{
+#if defined(__unix__)
+	for (;;) {
+		const ssize_t count = read(input_fd, data, n);
+		if ((count >= 0) || (errno != EINTR)) {
+			return (long) count;
+		}
+	}
+#else
+	/* The stream is buffered already and must not block for more input than
+	 * is available. */
+	(void) n;
+	const int c = fgetc(input_stream);
+	if (c < 0) {
+		return ferror(input_stream) ? -1 : 0;
+	}
+	data[0] = (char) c;
+	return 1;
+#endif
+}
+
+/* Flushes the output buffer and `return`s 0 or an error number.  The buffer
+ * is emptied either way. */
+static int flush_output(void)
+{
+	const int error = write_output(output_buffer, (size_t) (mj_runtime_output_next - output_buffer));
+	mj_runtime_output_next = output_buffer;
+	return error;
+}
+
+#if !defined(MJ_RUNTIME_EMBEDDED)
+static void flush_output_at_exit(void)
+{
+	flush_output();
+}
+#endif
+
+static void put_bytes(const char* function, const char* data, const size_t n)
+{
+	if (n > (size_t) (output_buffer + BUFFER_SIZE - mj_runtime_output_next)) {
+		const int error = flush_output();
+		if (error != 0) {
+			fail(function, error);
+		}
+	}
+	memcpy(mj_runtime_output_next, data, n);
+	mj_runtime_output_next += n;
+	if (stdout_is_terminal && (n > 0) && (data[n - 1] == '\n')) {
+		const int error = flush_output();
+		if (error != 0) {
+			fail(function, error);
+		}
+	}
+}
+
+/* Formats `n` in decimal and `return`s a pointer to the first digit.  `end`
+ * must point to the end of a buffer of at least 11 characters. */
+static char* format_decimal(char* end, const int32_t n)
+{
+	/* Compute the magnitude in unsigned arithmetic so INT32_MIN works. */
+	uint32_t magnitude = (n < 0) ? -(uint32_t) n : (uint32_t) n;
+	char* p = end;
+	do {
+		*--p = (char) ('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (n < 0) {
+		*--p = '-';
+	}
+	return p;
+}
+
+
 __attribute__ ((sysv_abi))
 void* mj_runtime_new(const int32_t nmemb, const int32_t size)
 {
 	if (nmemb < 0) {
-		fprintf(stderr, "%s: new: Request for negative array size %ld\n", program_name, (long) nmemb);
+		fprintf(error_stream, "%s: new: Request for negative array size %ld\n", program_name, (long) nmemb);
 		longjmp(exception_jump_buffer, 1);
 	}
 	if (size <= 0) {
-		fprintf(stderr, "%s: new: Request for non-positive object size %ld\n", program_name, (long) size);
+		fprintf(error_stream, "%s: new: Request for non-positive object size %ld\n", program_name, (long) size);
 		longjmp(exception_jump_buffer, 1);
 	}
 	/* Always allocate at least one byte to make sure arrays have unique addresses. */
-	void* memory = calloc((size_t) maximum(1, nmemb), (size_t) size);
+	void* memory = allocate((size_t) maximum(1, nmemb) * (size_t) size);
 	if (memory == NULL) {
-		fprintf(stderr, "%s: new: %s\n", program_name, strerror(errno));
-		longjmp(exception_jump_buffer, 1);
+		fail_out_of_memory("new");
 	}
 	return memory;
 }
@@ -49,17 +731,21 @@ int32_t mj_runtime_id(const int32_t x)
 __attribute__ ((sysv_abi))
 void mj_runtime_exit(const int32_t status)
 {
+#if defined(MJ_RUNTIME_EMBEDDED)
+	exit_status = (int) status;
+	longjmp(exception_jump_buffer, 2);
+#else
 	exit((int) status);
+#endif
 }
 
 __attribute__ ((sysv_abi))
 void mj_runtime_println(const int32_t n)
 {
-	const long promoted = n;  /* long is guaranteed to be at least 32 bit */
-	if (printf("%ld\n", promoted) < 0) {
-		fprintf(stderr, "%s: println: %s\n", program_name, strerror(errno));
-		longjmp(exception_jump_buffer, 1);
-	}
+	char text[12];
+	text[sizeof(text) - 1] = '\n';
+	const char* first = format_decimal(text + sizeof(text) - 1, n);
+	put_bytes("println", first, (size_t) (text + sizeof(text) - first));
 }
 
 __attribute__ ((sysv_abi))
@@ -69,40 +755,152 @@ void mj_runtime_write(const int32_t b)
 	  Cast the argument back and forth because an int may only provide 16 bits
 	  of precision and signed overflow is undefined behavior in ISO C.
 	*/
-	const int octet = (int) (((unsigned) b) & 0xffU);
-	if (fputc(octet, stdout) < 0) {
-		fprintf(stderr, "%s: write: %s\n", program_name, strerror(errno));
-		longjmp(exception_jump_buffer, 1);
-	}
+	const char octet = (char) (unsigned char) (((unsigned) b) & 0xffU);
+	put_bytes("write", &octet, 1);
 }
 
 __attribute__ ((sysv_abi))
 void mj_runtime_flush(void)
 {
-	if (fflush(stdout) < 0) {
-		fprintf(stderr, "%s: flush: %s\n", program_name, strerror(errno));
-		longjmp(exception_jump_buffer, 1);
+	const int error = flush_output();
+	if (error != 0) {
+		fail("flush", error);
 	}
 }
 
 __attribute__ ((sysv_abi))
 int32_t mj_runtime_read(void)
 {
-	const int c = fgetc(stdin);
-	if ((c < 0) && ferror(stdin)) {
-		fprintf(stderr, "%s: read: %s\n", program_name, strerror(errno));
-		longjmp(exception_jump_buffer, 1);
+	if (mj_runtime_input_next == mj_runtime_input_limit) {
+		if (input_eof) {
+			return -1;
+		}
+		if (stdout_is_terminal) {
+			/* Make sure prompts are visible before blocking. */
+			flush_output();
+		}
+		const long count = read_input(input_buffer, BUFFER_SIZE);
+		if (count < 0) {
+			fail("read", errno);
+		}
+		if (count == 0) {
+			input_eof = 1;
+			return -1;
+		}
+		mj_runtime_input_next = input_buffer;
+		mj_runtime_input_limit = input_buffer + count;
+	}
+	return (int32_t) (unsigned char) *mj_runtime_input_next++;
+}
+
+/* Prepares the buffers and the collector for running the program on the
+ * streams that are already set. */
+static void initialize(void)
+{
+#if defined(__unix__)
+	stdout_is_terminal = isatty(output_fd);
+#endif
+	mj_runtime_output_next = output_buffer;
+	mj_runtime_output_limit = stdout_is_terminal ? output_buffer : (output_buffer + BUFFER_SIZE);
+	const char* stats = getenv(ENVVAR_GC_STATS);
+	gc_stats = (stats != NULL) && (*stats != '\0');
+}
+
+#if defined(MJ_RUNTIME_EMBEDDED)
+
+/* Gives all memory of the heap back and resets the runtime for the next
+ * program. */
+static void release_heap(void)
+{
+	for (size_t i = 0; i < chunk_count; ++i) {
+		unmap_memory(chunks[i].start, (size_t) (chunks[i].end - chunks[i].start));
+		free(chunks[i].starts);
 	}
-	return (int32_t) c;
+	free(chunks);
+	free(mark_stack);
+	chunks = NULL;
+	chunk_count = 0;
+	chunk_capacity = 0;
+	heap_size = 0;
+	heap_threshold = INITIAL_THRESHOLD;
+	free_list = NULL;
+	mark_stack = NULL;
+	mark_stack_size = 0;
+	mark_stack_capacity = 0;
+	gc_count = 0;
+	gc_total_pause = 0.0;
+	gc_max_pause = 0.0;
+	gc_peak_heap = 0;
+	input_eof = 0;
+	stdout_is_terminal = 0;
+	variables = NULL;
 }
 
+/* Runs the program `entry` with the environment provided by `host` and
+ * `return`s its exit status.  Only one program may run at a time. */
+int mj_runtime_run(void (*entry)(void), const struct mj_runtime_host* host)
+{
+	program_name = host->program_name;
+	input_stream = host->input;
+	output_stream = host->output;
+	error_stream = host->error;
+#if defined(__unix__)
+	input_fd = fileno(input_stream);
+	output_fd = fileno(output_stream);
+#endif
+	variables = host->variables;
+	data_start = host->data_start;
+	data_end = host->data_end;
+	stack_bottom = __builtin_frame_address(0);
+	initialize();
+	int status;
+	switch (setjmp(exception_jump_buffer)) {
+	case 0:
+		entry();
+		status = EXIT_SUCCESS;
+		break;
+	case 1:
+		status = EXIT_FAILURE;
+		break;
+	case 2:
+		status = exit_status;
+		break;
+	default:
+		fprintf(error_stream, "%s: main: %s\n", program_name, "Assertion failed");
+		status = EXIT_FAILURE;
+		break;
+	}
+	/* Do what `exit` does for an executable. */
+	flush_output();
+	if (gc_stats) {
+		print_gc_summary();
+	}
+	release_heap();
+	return status;
+}
+
+#else
+
 int main(int argc, char** argv)
 {
 	program_name = (argc > 0) ? argv[0] : "minijava";
+	input_stream = stdin;
+	output_stream = stdout;
+	error_stream = stderr;
+#if defined(__unix__)
+	input_fd = STDIN_FILENO;
+	output_fd = STDOUT_FILENO;
+#endif
 	if (argc > 1) {
-		fprintf(stderr, "%s: Too many arguments\n", program_name);
+		fprintf(error_stream, "%s: Too many arguments\n", program_name);
 		return EXIT_FAILURE;
 	}
+	stack_bottom = __builtin_frame_address(0);
+	initialize();
+	atexit(flush_output_at_exit);
+	if (gc_stats) {
+		atexit(print_gc_summary);
+	}
 	switch (setjmp(exception_jump_buffer)) {
 	case 0:
 		minijava_main();
@@ -110,7 +908,9 @@ int main(int argc, char** argv)
 	case 1:
 		return EXIT_FAILURE;
 	default:
-		fprintf(stderr, "%s: main: %s\n", program_name, "Assertion failed");
+		fprintf(error_stream, "%s: main: %s\n", program_name, "Assertion failed");
 		return EXIT_FAILURE;
 	}
 }
+
+#endif
@@ -0,0 +1,372 @@
+/*
+  MiniJava runtime support library for x86-64 Linux that does not need a C
+  standard library.
+
+  It provides the same functions with the same observable behavior as
+  `mj_runtime.c` but talks to the kernel directly.  It has to be compiled
+  with `-nostdlib -ffreestanding -fno-stack-protector` and provides the
+  `_start` entry point itself.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+#if !defined(__x86_64__) || !defined(__linux__)
+#error "This runtime only works on x86-64 Linux"
+#endif
+
+
+__attribute__ ((sysv_abi))
+extern void minijava_main(void);
+
+
+#define SYS_READ         0
+#define SYS_WRITE        1
+#define SYS_MMAP         9
+#define SYS_IOCTL       16
+#define SYS_EXIT_GROUP 231
+
+#define PROT_READ        0x1
+#define PROT_WRITE       0x2
+#define MAP_PRIVATE      0x02
+#define MAP_ANONYMOUS    0x20
+#define TCGETS      0x5401
+
+#define EINTR   4
+#define EIO     5
+#define EBADF   9
+#define ENOMEM 12
+#define EFAULT 14
+#define EINVAL 22
+#define EFBIG  27
+#define ENOSPC 28
+#define EPIPE  32
+
+#define EXIT_SUCCESS 0
+#define EXIT_FAILURE 1
+
+/* Size of the stdio buffers. */
+#define BUFFER_SIZE 4096
+
+/* Size of the memory chunks the allocator requests from the kernel. */
+#define CHUNK_SIZE (1L << 20)
+
+
+static long syscall1(long n, long a)
+{
+	long ret;
+	__asm__ volatile ("syscall" : "=a" (ret) : "a" (n), "D" (a) : "rcx", "r11", "memory");
+	return ret;
+}
+
+static long syscall3(long n, long a, long b, long c)
+{
+	long ret;
+	__asm__ volatile ("syscall" : "=a" (ret) : "a" (n), "D" (a), "S" (b), "d" (c) : "rcx", "r11", "memory");
+	return ret;
+}
+
+static long syscall6(long n, long a, long b, long c, long d, long e, long f)
+{
+	long ret;
+	register long r10 __asm__ ("r10") = d;
+	register long r8 __asm__ ("r8") = e;
+	register long r9 __asm__ ("r9") = f;
+	__asm__ volatile (
+		"syscall"
+		: "=a" (ret)
+		: "a" (n), "D" (a), "S" (b), "d" (c), "r" (r10), "r" (r8), "r" (r9)
+		: "rcx", "r11", "memory"
+	);
+	return ret;
+}
+
+
+static const char* program_name;
+
+static int stdout_is_terminal;
+
+/* Positions in the buffers and their limits, exported for inline reads and
+ * writes like in `mj_runtime.c`. */
+static char stdout_buffer[BUFFER_SIZE];
+char* mj_runtime_output_next;
+char* mj_runtime_output_limit;
+
+static char stdin_buffer[BUFFER_SIZE];
+char* mj_runtime_input_next;
+char* mj_runtime_input_limit;
+static int stdin_eof;
+
+/* Bump pointer into the current chunk and its end.  Blocks have the same
+ * header as in `mj_runtime.c` but memory is never collected. */
+char* mj_runtime_heap_next;
+char* mj_runtime_heap_limit;
+
+
+__attribute__ ((noreturn))
+static void exit_group(const int status)
+{
+	for (;;) {
+		syscall1(SYS_EXIT_GROUP, status);
+	}
+}
+
+static const char* error_string(const long error)
+{
+	switch (error) {
+	case EIO:    return "Input/output error";
+	case EBADF:  return "Bad file descriptor";
+	case ENOMEM: return "Cannot allocate memory";
+	case EFAULT: return "Bad address";
+	case EINVAL: return "Invalid argument";
+	case EFBIG:  return "File too large";
+	case ENOSPC: return "No space left on device";
+	case EPIPE:  return "Broken pipe";
+	default:     return "Unknown error";
+	}
+}
+
+/* Writes all `n` bytes to `fd` and `return`s 0 or a negative error code. */
+static long write_all(const int fd, const char* data, size_t n)
+{
+	while (n > 0) {
+		const long ret = syscall3(SYS_WRITE, fd, (long) data, (long) n);
+		if (ret == -EINTR) {
+			continue;
+		}
+		if (ret < 0) {
+			return ret;
+		}
+		data += ret;
+		n -= (size_t) ret;
+	}
+	return 0;
+}
+
+/* Writes the message `program_name: function: message detail` followed by a
+ * newline character to standard error output.  `function` and `detail` may be
+ * `NULL`. */
+static void print_error(const char* function, const char* message, const char* detail)
+{
+	char line[256];
+	size_t n = 0;
+	const char* parts[] = {program_name, ": ", function, (function != NULL) ? ": " : NULL, message, detail};
+	for (size_t i = 0; i < sizeof(parts) / sizeof(parts[0]); ++i) {
+		for (const char* p = parts[i]; (p != NULL) && (*p != '\0') && (n < sizeof(line) - 1); ++p) {
+			line[n++] = *p;
+		}
+	}
+	line[n++] = '\n';
+	write_all(2, line, n);
+}
+
+/* Formats `n` in decimal and `return`s a pointer to the first digit.  `end`
+ * must point to the end of a buffer of at least 11 characters. */
+static char* format_decimal(char* end, const int32_t n)
+{
+	uint32_t magnitude = (n < 0) ? -(uint32_t) n : (uint32_t) n;
+	char* p = end;
+	do {
+		*--p = (char) ('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (n < 0) {
+		*--p = '-';
+	}
+	return p;
+}
+
+/* Flushes the standard output buffer and `return`s 0 or a negative error
+ * code.  The buffer is emptied either way. */
+static long flush_stdout(void)
+{
+	const long ret = write_all(1, stdout_buffer, (size_t) (mj_runtime_output_next - stdout_buffer));
+	mj_runtime_output_next = stdout_buffer;
+	return ret;
+}
+
+/* Terminates the program after a runtime error.  Like returning from `main`
+ * in `mj_runtime.c`, this still flushes standard output. */
+__attribute__ ((noreturn))
+static void fail(const char* function, const char* message)
+{
+	print_error(function, message, NULL);
+	flush_stdout();
+	exit_group(EXIT_FAILURE);
+}
+
+static void put_bytes(const char* function, const char* data, const size_t n)
+{
+	for (size_t i = 0; i < n; ++i) {
+		if (mj_runtime_output_next == stdout_buffer + BUFFER_SIZE) {
+			const long ret = flush_stdout();
+			if (ret < 0) {
+				fail(function, error_string(-ret));
+			}
+		}
+		*mj_runtime_output_next++ = data[i];
+	}
+	if (stdout_is_terminal && (n > 0) && (data[n - 1] == '\n')) {
+		const long ret = flush_stdout();
+		if (ret < 0) {
+			fail(function, error_string(-ret));
+		}
+	}
+}
+
+static void* allocate(const size_t size)
+{
+	/* Round to 8 bytes and add a header word just like inline allocations
+	 * do. */
+	const size_t rounded = ((size + 7) & ~(size_t) 7) + 8;
+	if (rounded > (size_t) (mj_runtime_heap_limit - mj_runtime_heap_next)) {
+		const size_t chunk = (rounded > CHUNK_SIZE / 4) ? rounded : CHUNK_SIZE;
+		const long ret = syscall6(
+			SYS_MMAP, 0, (long) chunk, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+		);
+		if ((ret < 0) && (ret > -4096)) {
+			return NULL;
+		}
+		if (chunk != CHUNK_SIZE) {
+			/* Large objects get their own mapping so the current chunk is not
+			 * wasted. */
+			*(uint64_t*) ret = rounded;
+			return (char*) ret + 8;
+		}
+		mj_runtime_heap_next = (char*) ret;
+		mj_runtime_heap_limit = mj_runtime_heap_next + chunk;
+	}
+	char* block = mj_runtime_heap_next;
+	mj_runtime_heap_next += rounded;
+	*(uint64_t*) (void*) block = rounded;
+	return block + 8;
+}
+
+
+__attribute__ ((sysv_abi))
+void* mj_runtime_new(const int32_t nmemb, const int32_t size)
+{
+	if (nmemb < 0) {
+		char digits[12];
+		digits[sizeof(digits) - 1] = '\0';
+		print_error("new", "Request for negative array size ", format_decimal(digits + sizeof(digits) - 1, nmemb));
+		flush_stdout();
+		exit_group(EXIT_FAILURE);
+	}
+	if (size <= 0) {
+		char digits[12];
+		digits[sizeof(digits) - 1] = '\0';
+		print_error("new", "Request for non-positive object size ", format_decimal(digits + sizeof(digits) - 1, size));
+		flush_stdout();
+		exit_group(EXIT_FAILURE);
+	}
+	/* Always allocate at least one byte to make sure arrays have unique
+	 * addresses.  Fresh memory from the kernel is zeroed and never reused. */
+	const size_t count = (nmemb > 1) ? (size_t) nmemb : 1;
+	void* memory = allocate(count * (size_t) size);
+	if (memory == NULL) {
+		fail("new", error_string(ENOMEM));
+	}
+	return memory;
+}
+
+__attribute__ ((sysv_abi))
+int32_t mj_runtime_id(const int32_t x)
+{
+	return x;
+}
+
+__attribute__ ((sysv_abi))
+void mj_runtime_exit(const int32_t status)
+{
+	flush_stdout();
+	exit_group((int) status);
+}
+
+__attribute__ ((sysv_abi))
+void mj_runtime_println(const int32_t n)
+{
+	char text[12];
+	text[sizeof(text) - 1] = '\n';
+	const char* first = format_decimal(text + sizeof(text) - 1, n);
+	put_bytes("println", first, (size_t) (text + sizeof(text) - first));
+}
+
+__attribute__ ((sysv_abi))
+void mj_runtime_write(const int32_t b)
+{
+	const char octet = (char) (((uint32_t) b) & 0xffU);
+	put_bytes("write", &octet, 1);
+}
+
+__attribute__ ((sysv_abi))
+void mj_runtime_flush(void)
+{
+	const long ret = flush_stdout();
+	if (ret < 0) {
+		fail("flush", error_string(-ret));
+	}
+}
+
+__attribute__ ((sysv_abi))
+int32_t mj_runtime_read(void)
+{
+	if (mj_runtime_input_next == mj_runtime_input_limit) {
+		if (stdin_eof) {
+			return -1;
+		}
+		if (stdout_is_terminal) {
+			/* Make sure prompts are visible before blocking. */
+			flush_stdout();
+		}
+		long ret;
+		do {
+			ret = syscall3(SYS_READ, 0, (long) stdin_buffer, BUFFER_SIZE);
+		} while (ret == -EINTR);
+		if (ret < 0) {
+			fail("read", error_string(-ret));
+		}
+		if (ret == 0) {
+			stdin_eof = 1;
+			return -1;
+		}
+		mj_runtime_input_next = stdin_buffer;
+		mj_runtime_input_limit = stdin_buffer + ret;
+	}
+	return (int32_t) (unsigned char) *mj_runtime_input_next++;
+}
+
+
+/* Called from `_start` with a pointer to the initial stack, which holds
+ * `argc` followed by the `argv` array. */
+__attribute__ ((noreturn, used))
+void mj_runtime_start(long* stack)
+{
+	const long argc = stack[0];
+	char** argv = (char**) (stack + 1);
+	program_name = (argc > 0) ? argv[0] : "minijava";
+	if (argc > 1) {
+		print_error(NULL, "Too many arguments", NULL);
+		exit_group(EXIT_FAILURE);
+	}
+	char termios[64];
+	stdout_is_terminal = (syscall3(SYS_IOCTL, 1, TCGETS, (long) termios) == 0);
+	mj_runtime_output_next = stdout_buffer;
+	mj_runtime_output_limit = stdout_is_terminal ? stdout_buffer : (stdout_buffer + BUFFER_SIZE);
+	minijava_main();
+	flush_stdout();
+	exit_group(EXIT_SUCCESS);
+}
+
+__asm__ (
+	"\t.text\n"
+	"\t.globl _start\n"
+	"\t.type _start, @function\n"
+	"_start:\n"
+	"\txorl %ebp, %ebp\n"
+	"\tmovq %rsp, %rdi\n"
+	"\tandq $-16, %rsp\n"
+	"\tcall mj_runtime_start\n"
+	"\thlt\n"
+);
@@ -104,6 +104,7 @@ namespace testaux
 		c.quantile = get_quantile("BENCHMARK_QUANTILE");
 		c.significance = get_significance("BENCHMARK_SIGNIFICANCE");
 		c.verbose = get_bool("BENCHMARK_VERBOSE");
+		c.counters = get_bool("BENCHMARK_COUNTERS");
 		return c;
 	}
 
@@ -114,6 +115,16 @@ namespace testaux
 		return engine;
 	}
 
+	result normalize(const result& res, const std::size_t units)
+	{
+		const auto factor = static_cast<double>(units);
+		auto normalized = result{res.mean / factor, res.stdev / factor, res.n};
+		for (const auto& kv : res.counters) {
+			normalized.counters[kv.first] = kv.second / factor;
+		}
+		return normalized;
+	}
+
 	void print_result(const result& res)
 	{
 		const auto m = res.mean.count();
@@ -122,7 +133,20 @@ namespace testaux
 		if (!std::isfinite(m) || (m < 0.0) || !std::isfinite(s) || (s < 0.0) || (n == 0)) {
 			throw std::invalid_argument{"Obtained garbage results"};
 		}
-		if ((std::printf("%18.8E  %18.8E  %18zu\n", m, s, n) < 0) || (std::fflush(stdout) < 0)) {
+		if (std::printf("%18.8E  %18.8E  %18zu\n", m, s, n) < 0) {
+			const auto ec = std::error_code{errno, std::system_category()};
+			throw std::system_error{ec, "Cannot write data to file"};
+		}
+		for (const auto& kv : res.counters) {
+			if (!std::isfinite(kv.second) || (kv.second < 0.0)) {
+				throw std::invalid_argument{"Obtained garbage results for counter " + kv.first};
+			}
+			if (std::printf("%s  %18.8E\n", kv.first.c_str(), kv.second) < 0) {
+				const auto ec = std::error_code{errno, std::system_category()};
+				throw std::system_error{ec, "Cannot write data to file"};
+			}
+		}
+		if (std::fflush(stdout) < 0) {
 			const auto ec = std::error_code{errno, std::system_category()};
 			throw std::system_error{ec, "Cannot write data to file"};
 		}
@@ -152,6 +176,14 @@ namespace testaux
 			std::fprintf(stderr, "quantile:      %16.6f\n", c.quantile);
 			std::fprintf(stderr, "significance:  %16.6f\n", c.significance);
 			std::fprintf(stderr, "verbose:       %16s\n", c.verbose ? "yes" : "no");
+			std::fprintf(stderr, "counters:      %16s\n", c.counters ? "yes" : "no");
+		}
+
+		void print_unavailable_counters(const perf_counters& pc)
+		{
+			for (const auto& name : pc.unavailable()) {
+				std::fprintf(stderr, "counter %s is not available\n", name.c_str());
+			}
 		}
 
 	}  // namespace detail
@@ -170,6 +202,7 @@ namespace testaux
 				"warmup",
 				"quantile",
 				"significance",
+				"counters",
 			};
 			return (std::find(std::begin(special), std::end(special), name) != std::end(special));
 		}
@@ -214,6 +247,9 @@ namespace testaux
 				}
 				constr.significance = value;
 			}
+			if (varmap.count("counters")) {
+				constr.counters = true;
+			}
 		}
 
 
@@ -262,6 +298,7 @@ namespace testaux
 			("warmup", po::value<std::ptrdiff_t>(), "number of initial samples to throw away")
 			("quantile", po::value<double>(), "fraction of (best) samples to use")
 			("significance", po::value<double>(), "desired relative standard deviation")
+			("counters", "collect hardware and software performance counters")
 			("verbose", "print status messages to standard error output");
 		auto specific = po::options_description{"Specific Options for this Benchmark"};
 		for (const auto& kv : _cmd_args) {
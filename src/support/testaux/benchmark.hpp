@@ -17,6 +17,8 @@
 #include <stdexcept>
 #include <string>
 
+#include "perf_counters.hpp"
+
 
 namespace testaux
 {
@@ -86,6 +88,16 @@ namespace testaux
 		/** @brief Number of samples used to compute the statistics (at least 3). */
 		std::size_t n{};
 
+		/**
+		 * @brief
+		 *     Median value of each performance counter per sample.
+		 *
+		 * This is empty unless counters were requested via the `constraints`
+		 * and only has entries for the counters that were available.
+		 *
+		 */
+		std::map<std::string, double> counters{};
+
 	};
 
 
@@ -139,6 +151,9 @@ namespace testaux
 		/** @brief Whether to produce verbose output. */
 		bool verbose{};
 
+		/** @brief Whether to collect performance counters. */
+		bool counters{};
+
 	};
 
 
@@ -154,6 +169,7 @@ namespace testaux
 	 *  - `BENCHMARK_QUANTILE` (default: 1)
 	 *  - `BENCHMARK_SIGNIFICANCE` (default: 20 %)
 	 *  - `BENCHMARK_VERBOSE` (default: no)
+	 *  - `BENCHMARK_COUNTERS` (default: no)
 	 *
 	 * @returns
 	 *     `constraints` initialized from environment and defaults
@@ -173,6 +189,13 @@ namespace testaux
 	 * If a constraint limit is exceeded before at least three data points
 	 * could be sampled, an exception is `throw`n.
 	 *
+	 * If the constraints ask for performance counters, they are enabled
+	 * around each call to `bench` and the median of the counted values over
+	 * all samples after the warmup is reported in the result.  The counters
+	 * are started before and stopped after the time is taken so they don't
+	 * add to the measured time.  Counters that are not available are left
+	 * out of the result.
+	 *
 	 * @tparam CallT
 	 *     callable type that can be invoked with arguments `args`
 	 *
@@ -198,6 +221,63 @@ namespace testaux
 	template <typename CallT, typename... ArgTs>
 	result run_benchmark(const constraints& c, CallT&& bench, ArgTs&&... args);
 
+	/**
+	 * @brief
+	 *     Like `run_benchmark` but prepares fresh input for every run of the
+	 *     benchmark without timing that.
+	 *
+	 * This is useful for benchmarking code that consumes or modifies its
+	 * input.  Before each run, `prepare` is called without arguments and the
+	 * object it `return`s is passed to `bench` by reference.  Only the call to
+	 * `bench` is timed.  The time spent in `prepare` still counts towards the
+	 * timeout, though.
+	 *
+	 * @tparam PrepareT
+	 *     callable type that can be invoked without arguments
+	 *
+	 * @tparam CallT
+	 *     callable type that can be invoked with the result of `prepare`
+	 *
+	 * @param c
+	 *     constraints subject to which the benchmark should be run
+	 *
+	 * @param prepare
+	 *     callable object that creates the input for a single run
+	 *
+	 * @param bench
+	 *     callable object to benchmark
+	 *
+	 * @returns
+	 *     the statistical result of running the benchmark
+	 *
+	 * @throws failure
+	 *     if a constraint limit is hit before a result could be obtained
+	 *
+	 */
+	template <typename PrepareT, typename CallT>
+	result run_benchmark_with_setup(const constraints& c, PrepareT&& prepare, CallT&& bench);
+
+	/**
+	 * @brief
+	 *     Scales a result to a single unit of work.
+	 *
+	 * Divides the mean, standard deviation and all counters in `res` by
+	 * `units` and leaves the number of samples alone.  This is useful for
+	 * benchmarks that perform `units` operations per sample and want to
+	 * report the cost of a single one.
+	 *
+	 * @param res
+	 *     result for all units of work
+	 *
+	 * @param units
+	 *     number of units of work per sample
+	 *
+	 * @returns
+	 *     result for a single unit of work
+	 *
+	 */
+	result normalize(const result& res, std::size_t units);
+
 	/**
 	 * @brief
 	 *     Prints a result to standard output.
@@ -206,8 +286,12 @@ namespace testaux
 	 *
 	 *     MEAN STDEV N
 	 *
-	 * where times are in seconds.  This is meant to be an easily parseable
-	 * format.
+	 * where times are in seconds, followed by one line
+	 *
+	 *     NAME VALUE
+	 *
+	 * for each performance counter in the result.  This is meant to be an
+	 * easily parseable format.
 	 *
 	 * @param res
 	 *     result to print
@@ -266,6 +350,7 @@ namespace testaux
 	 *  - `--warmup=ARG` -- overrides the environment variable `BENCHMARK_WARMUP`
 	 *  - `--quantile=ARG` -- overrides the environment variable `BENCHMARK_QUANTILE`
 	 *  - `--significance=ARG` -- overrides the environment variable `BENCHMARK_SIGNIFICANCE`
+	 *  - `--counters` -- overrides the environment variable `BENCHMARK_COUNTERS`
 	 *
 	 */
 	class benchmark_setup final
@@ -6,7 +6,9 @@
 #include <cassert>
 #include <cmath>
 #include <iterator>
+#include <map>
 #include <numeric>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -52,22 +54,96 @@ namespace testaux
 
 		void print_constraints(const constraints& c);
 
+		void print_unavailable_counters(const perf_counters& pc);
+
+		// Computes the median of each counter over all samples after the
+		// first `warmup` ones.  Counters missing from any sample are left
+		// out.
+		inline std::map<std::string, double>
+		median_counters(const std::vector<std::map<std::string, double>>& samples,
+						const std::size_t warmup)
+		{
+			auto medians = std::map<std::string, double>{};
+			const auto first = std::begin(samples) + static_cast<std::ptrdiff_t>(warmup);
+			const auto last = std::end(samples);
+			if (first == last) {
+				return medians;
+			}
+			for (const auto& kv : *first) {
+				auto values = std::vector<double>{};
+				for (auto it = first; it != last; ++it) {
+					const auto pos = it->find(kv.first);
+					if (pos != it->end()) {
+						values.push_back(pos->second);
+					}
+				}
+				if (values.size() == static_cast<std::size_t>(std::distance(first, last))) {
+					const auto middle = std::begin(values) + static_cast<std::ptrdiff_t>(values.size() / 2);
+					std::nth_element(std::begin(values), middle, std::end(values));
+					medians[kv.first] = *middle;
+				}
+			}
+			return medians;
+		}
+
+		// Calls `sample` repetitively until the constraints are satisfied.
+		// Each call must run the benchmark once with the `perf_counters` it
+		// is passed started and `return` the time it took.
+		template <typename SampleT>
+		result run_samples(const constraints& c, SampleT&& sample)
+		{
+			const auto minruns = c.warmup + static_cast<std::size_t>(std::ceil(3.0 / c.quantile));
+			auto timings = std::vector<duration_type>{};
+			auto counts = std::vector<std::map<std::string, double>>{};
+			perf_counters counters{c.counters};
+			const auto t0 = clock_type::now();
+			if (c.verbose) {
+				print_constraints(c);
+				print_unavailable_counters(counters);
+			}
+			if (c.timeout.count() < 0) {
+				throw failure{"Timeout expired before I could do anything useful"};
+			}
+			while (true) {
+				const auto t = sample(counters);
+				const auto t2 = clock_type::now();
+				timings.push_back(t);
+				if (c.counters) {
+					counts.push_back(counters.read());
+				}
+				if (c.verbose) {
+					print_verbose_progress(timings.size(), t);
+				}
+				const auto elapsed = std::chrono::duration_cast<duration_type>(t2 - t0);
+				const auto too_long = (c.timeout.count() > 0) && (elapsed >= c.timeout);
+				const auto too_often = (c.repetitions > 0) && (timings.size() >= c.repetitions);
+				if (timings.size() >= minruns) {
+					auto res = do_statistics(
+						std::begin(timings),  std::end(timings), c.warmup, c.quantile
+					);
+					const auto done = (res.stdev.count() == 0.0)
+						|| (res.stdev.count() / res.mean.count() < c.significance)
+						|| too_long || too_often;
+					if (done) {
+						res.counters = median_counters(counts, c.warmup);
+						return res;
+					}
+				} else if (too_long) {
+					throw failure{"Timeout expired"};
+				} else if (too_often) {
+					throw failure{"Maximum number of repetitions exceeded"};
+				}
+			}
+		}
+
 	}  // namespace detail
 
 
 	template <typename CallT, typename... ArgTs>
 	result run_benchmark(const constraints& c, CallT&& bench, ArgTs&&... args)
 	{
-		const auto minruns = c.warmup + static_cast<std::size_t>(std::ceil(3.0 / c.quantile));
-		auto timings = std::vector<duration_type>{};
-		const auto t0 = clock_type::now();
-		if (c.verbose) {
-			detail::print_constraints(c);
-		}
-		if (c.timeout.count() < 0) {
-			throw failure{"Timeout expired before I could do anything useful"};
-		}
-		while (true) {
+		const auto sample = [&](perf_counters& counters){
+			counters.start();
 			compiler_barrier();
 			const auto t1 = clock_type::now();
 			compiler_barrier();
@@ -78,32 +154,29 @@ namespace testaux
 			compiler_barrier();
 			const auto t2 = clock_type::now();
 			compiler_barrier();
-			const auto t = std::chrono::duration_cast<duration_type>(t2 - t1);
-			timings.push_back(t);
-			if (c.verbose) {
-				detail::print_verbose_progress(timings.size(), t);
-			}
-			const auto elapsed = std::chrono::duration_cast<duration_type>(t2 - t0);
-			const auto too_long = (c.timeout.count() > 0) && (elapsed >= c.timeout);
-			const auto too_often = (c.repetitions > 0) && (timings.size() >= c.repetitions);
-			if (timings.size() >= minruns) {
-				const auto res = detail::do_statistics(
-					std::begin(timings),  std::end(timings), c.warmup, c.quantile
-				);
-				if (res.stdev.count() == 0.0) {
-					return res;
-				} else if (res.stdev.count() / res.mean.count() < c.significance) {
-					return res;
-				} else if (too_long || too_often) {
-					return res;
-				}
-			} else if (too_long) {
-				throw failure{"Timeout expired"};
-			} else if (too_often) {
-				throw failure{"Maximum number of repetitions exceeded"};
-			}
-		}
+			counters.stop();
+			return std::chrono::duration_cast<duration_type>(t2 - t1);
+		};
+		return detail::run_samples(c, sample);
+	}
 
+	template <typename PrepareT, typename CallT>
+	result run_benchmark_with_setup(const constraints& c, PrepareT&& prepare, CallT&& bench)
+	{
+		const auto sample = [&](perf_counters& counters){
+			auto input = prepare();
+			counters.start();
+			compiler_barrier();
+			const auto t1 = clock_type::now();
+			compiler_barrier();
+			bench(input);
+			compiler_barrier();
+			const auto t2 = clock_type::now();
+			compiler_barrier();
+			counters.stop();
+			return std::chrono::duration_cast<duration_type>(t2 - t1);
+		};
+		return detail::run_samples(c, sample);
 	}
 
 }  // namespace testaux
@@ -0,0 +1,137 @@
+#include "perf_counters.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace testaux
+{
+
+	namespace /* anonymous */
+	{
+
+#if defined(__linux__)
+
+		struct counter_info
+		{
+			const char* name;
+			std::uint32_t type;
+			std::uint64_t config;
+		};
+
+		const counter_info all_counters[] = {
+			{"cycles",        PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+			{"instructions",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+			{"branch-misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+			{"cache-misses",  PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+			{"page-faults",   PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+		};
+
+		int open_counter(const counter_info& info)
+		{
+			auto attr = perf_event_attr{};
+			std::memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = info.type;
+			attr.config = info.config;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+			const auto fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+			return static_cast<int>(fd);
+		}
+
+#endif  // defined(__linux__)
+
+	}  // namespace /* anonymous */
+
+
+	perf_counters::perf_counters(const bool enable)
+	{
+		if (!enable) {
+			return;
+		}
+#if defined(__linux__)
+		for (const auto& info : all_counters) {
+			const auto fd = open_counter(info);
+			if (fd >= 0) {
+				_counters.emplace_back(fd, info.name);
+			} else {
+				_unavailable.push_back(info.name);
+			}
+		}
+#else
+		_unavailable = {"cycles", "instructions", "branch-misses", "cache-misses", "page-faults"};
+#endif
+	}
+
+	perf_counters::~perf_counters()
+	{
+#if defined(__linux__)
+		for (const auto& counter : _counters) {
+			close(counter.first);
+		}
+#endif
+	}
+
+	void perf_counters::start() noexcept
+	{
+#if defined(__linux__)
+		for (const auto& counter : _counters) {
+			ioctl(counter.first, PERF_EVENT_IOC_RESET, 0);
+		}
+		for (const auto& counter : _counters) {
+			ioctl(counter.first, PERF_EVENT_IOC_ENABLE, 0);
+		}
+#endif
+	}
+
+	void perf_counters::stop() noexcept
+	{
+#if defined(__linux__)
+		for (const auto& counter : _counters) {
+			ioctl(counter.first, PERF_EVENT_IOC_DISABLE, 0);
+		}
+#endif
+	}
+
+	std::map<std::string, double> perf_counters::read() const
+	{
+		auto values = std::map<std::string, double>{};
+#if defined(__linux__)
+		for (const auto& counter : _counters) {
+			// value, time enabled, time running
+			std::uint64_t buffer[3] = {};
+			const auto n = ::read(counter.first, buffer, sizeof(buffer));
+			if ((n != sizeof(buffer)) || (buffer[2] == 0)) {
+				continue;
+			}
+			auto value = static_cast<double>(buffer[0]);
+			if (buffer[2] < buffer[1]) {
+				value *= static_cast<double>(buffer[1]) / static_cast<double>(buffer[2]);
+			}
+			values[counter.second] = value;
+		}
+#endif
+		return values;
+	}
+
+	std::vector<std::string> perf_counters::names() const
+	{
+		auto result = std::vector<std::string>{};
+		for (const auto& counter : _counters) {
+			result.push_back(counter.second);
+		}
+		return result;
+	}
+
+}  // namespace testaux
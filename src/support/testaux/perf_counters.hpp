@@ -0,0 +1,147 @@
+/**
+ * @file perf_counters.hpp
+ *
+ * @brief
+ *     Hardware and software performance counters for micro-benchmarks.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+namespace testaux
+{
+
+	/**
+	 * @brief
+	 *     Set of performance counters that count the events caused by the
+	 *     current thread between calls to `start` and `stop`.
+	 *
+	 * The following counters are supported.
+	 *
+	 *  - `cycles` -- CPU cycles spent in user-space
+	 *  - `instructions` -- instructions retired in user-space
+	 *  - `branch-misses` -- mispredicted branches in user-space
+	 *  - `cache-misses` -- last-level cache misses in user-space
+	 *  - `page-faults` -- page faults (minor and major)
+	 *
+	 * The counters are obtained via the Linux `perf_event_open` system call.
+	 * Any counter that cannot be opened -- because the hardware doesn't
+	 * support it, the system doesn't allow it or the platform is not Linux
+	 * at all -- is silently left out.  Therefore, it is always safe to create
+	 * a `perf_counters` object but it might end up counting nothing at all.
+	 *
+	 * Only user-space events are counted so the results can be obtained with
+	 * the default `perf_event_paranoid` setting of most distributions.
+	 *
+	 */
+	class perf_counters final
+	{
+	public:
+
+		/**
+		 * @brief
+		 *     Opens all available counters if `enable` is `true` or none at
+		 *     all otherwise.
+		 *
+		 * @param enable
+		 *     whether to open any counters
+		 *
+		 */
+		explicit perf_counters(bool enable = true);
+
+		/** @brief Closes all counters. */
+		~perf_counters();
+
+		/**
+		 * @brief
+		 *     `perf_counters` are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 */
+		perf_counters(const perf_counters& other) = delete;
+
+		/**
+		 * @brief
+		 *     `perf_counters` are not copyable.
+		 *
+		 * @param other
+		 *     *N/A*
+		 *
+		 * @returns
+		 *     *N/A*
+		 *
+		 */
+		perf_counters& operator=(const perf_counters& other) = delete;
+
+		/**
+		 * @brief
+		 *     Resets all counters to zero and starts counting.
+		 *
+		 */
+		void start() noexcept;
+
+		/**
+		 * @brief
+		 *     Stops counting.
+		 *
+		 */
+		void stop() noexcept;
+
+		/**
+		 * @brief
+		 *     `return`s the number of events counted between the last calls
+		 *     to `start` and `stop`.
+		 *
+		 * Counters that could not be opened or read are not included in the
+		 * result.  If the kernel had to multiplex the counters, the values are
+		 * extrapolated to the whole time the counters were enabled.
+		 *
+		 * @returns
+		 *     mapping from counter names to values
+		 *
+		 */
+		std::map<std::string, double> read() const;
+
+		/**
+		 * @brief
+		 *     `return`s the names of all counters that could be opened.
+		 *
+		 * @returns
+		 *     list of counter names
+		 *
+		 */
+		std::vector<std::string> names() const;
+
+		/**
+		 * @brief
+		 *     `return`s the names of all counters that were requested but
+		 *     could not be opened.
+		 *
+		 * @returns
+		 *     list of counter names
+		 *
+		 */
+		const std::vector<std::string>& unavailable() const noexcept
+		{
+			return _unavailable;
+		}
+
+	private:
+
+		/** @brief File descriptors and names of the opened counters. */
+		std::vector<std::pair<int, std::string>> _counters{};
+
+		/** @brief Names of counters that could not be opened. */
+		std::vector<std::string> _unavailable{};
+
+	};  // class perf_counters
+
+}  // namespace testaux
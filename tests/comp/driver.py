@@ -57,6 +57,10 @@ def main(args):
         '--execute', metavar='FILE', type=str, const='a.out', nargs='?',
         help="execute FILE (default: '%(const)s') after successful compilation"
     )
+    ap.add_argument(
+        '--run', action='store_true',
+        help="the compiler runs the program itself; pass the program as a file argument and check its results"
+    )
     ap.add_argument(
         '--debug', action='store_true',
         help="dump internal state for debugging the test driver"
@@ -155,6 +159,9 @@ def run_single(program, ns, pragmas):
     with tempfile.TemporaryDirectory() as tempdir:
         if ns.debug:
             print("DEBUG: Using temporary directory '{:s}'".format(tempdir))
+        if ns.run:
+            run_in_compiler(program, ns, pragmas, tempdir)
+            return
         run_compiler(program, ns, pragmas, tempdir)
         if ns.execute:
             run_executable(ns, pragmas, tempdir)
@@ -192,6 +199,39 @@ def run_compiler(program, ns, pragmas, directory=None):
             raise Failure("Compiler didn't produce the expected error message")
 
 
+def run_in_compiler(program, ns, pragmas, directory):
+    if 'status' in pragmas:
+        # The program is not expected to compile so there is nothing to run.
+        run_compiler(program, ns, pragmas, directory)
+        return
+    filename = os.path.join(directory, 'program.mj')
+    with open(filename, 'w') as ostr:
+        ostr.write(program)
+    cmd = abscmd(ns.command) + [filename]
+    if ns.debug:
+        print("DEBUG: Running compiler as {:s} ...".format(repr(cmd)))
+    proc = subprocess.Popen(
+        cmd,
+        stdin=subprocess.PIPE,
+        stdout=subprocess.PIPE,
+        stderr=subprocess.PIPE,
+        cwd=directory
+    )
+    with open(pragmas.get('stdin', os.devnull), 'rb') as istr:
+        try:
+            (out, err) = proc.communicate(input=istr.read(), timeout=COMPILER_TIMEOUT + EXECUTABLE_TIMEOUT)
+        except subprocess.TimeoutExpired:
+            proc.kill()
+            proc.communicate()
+            raise Failure("Program did not complete within {:.2f} seconds".format(COMPILER_TIMEOUT + EXECUTABLE_TIMEOUT))
+    if ns.debug:
+        log_popen_result(proc, out, err)
+    check_exec_status(pragmas, proc.returncode)
+    check_exec_stdios(pragmas, out, 'stdout')
+    check_exec_stdios(pragmas, out, 'stderr')
+    check_exec_output(pragmas, out)
+
+
 def run_executable(ns, pragmas, directory=None):
     assert ns.execute
     executable = ns.execute if directory is None else os.path.join(directory, ns.execute)
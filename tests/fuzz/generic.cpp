@@ -58,7 +58,7 @@ namespace /* anonymous */
 		const testaux::temporary_directory tempdir{};
 		minijava::dump_firm_ir(ir, tempdir.filename());
 		if (action == actions::firm_dump) { return; }
-		minijava::optimize(ir);
+		minijava::optimize(ir, false);
 		const auto asmfilename = tempdir.filename("test.s");
 		auto asmfile = minijava::file_output{asmfilename};
 		minijava::emit_x64_assembly_firm(ir, asmfile);
@@ -1,14 +1,186 @@
 #include "asm/allocator.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <vector>
+
 #define BOOST_TEST_MODULE  asm_allocator
 #include <boost/test/unit_test.hpp>
 
 #include "exceptions.hpp"
 
+namespace be = minijava::backend;
+
+
+namespace /* anonymous */
+{
+
+	be::virtual_register general(const int n)
+	{
+		return static_cast<be::virtual_register>(
+			static_cast<int>(be::virtual_register::general) + n - 1
+		);
+	}
+
+	be::virtual_assembly make_function(const std::vector<be::virtual_instruction>& code)
+	{
+		auto virtasm = be::virtual_assembly{"foo"};
+		auto block = be::virtual_basic_block{".L0"};
+		block.code = code;
+		block.code.emplace_back(be::opcode::op_ret);
+		virtasm.blocks.push_back(std::move(block));
+		return virtasm;
+	}
+
+	std::size_t count_instructions(const be::real_assembly& realasm, const be::opcode code)
+	{
+		auto count = std::size_t{};
+		for (const auto& block : realasm.blocks) {
+			count += static_cast<std::size_t>(std::count_if(
+				block.code.begin(), block.code.end(),
+				[code](const auto& instr){ return instr.code == code; }
+			));
+		}
+		return count;
+	}
+
+	bool uses_frame_pointer(const be::real_assembly& realasm)
+	{
+		for (const auto& block : realasm.blocks) {
+			for (const auto& instr : block.code) {
+				for (const auto* op : {&instr.op1, &instr.op2}) {
+					const auto reg = be::get_register(*op);
+					const auto addr = be::get_address(*op);
+					if ((reg && (*reg == be::real_register::bp))
+							|| (addr && addr->base && (*addr->base == be::real_register::bp))) {
+						return true;
+					}
+				}
+			}
+		}
+		return false;
+	}
+
+}
+
 
 BOOST_AUTO_TEST_CASE(allocate_registers_for_empty_function)
 {
-	const auto virtasm = minijava::backend::virtual_assembly{"foo"};
-	const auto realasm = minijava::backend::allocate_registers(virtasm);
-	BOOST_REQUIRE(!realasm.blocks.front().code.empty());
+	const auto virtasm = be::virtual_assembly{"foo"};
+	const auto realasm = be::allocate_registers(virtasm);
+	BOOST_REQUIRE_EQUAL(1, realasm.blocks.size());
+	BOOST_REQUIRE(realasm.blocks.front().code.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(leaf_function_needs_no_frame)
+{
+	const auto virtasm = make_function({
+		{be::opcode::op_mov, be::bit_width::xxxii, be::virtual_register::argument, general(1)},
+		{be::opcode::op_add, be::bit_width::xxxii, std::int64_t{1}, general(1)},
+		{be::opcode::op_mov, be::bit_width::xxxii, general(1), be::virtual_register::result},
+	});
+	const auto realasm = be::allocate_registers(virtasm);
+	BOOST_REQUIRE(!uses_frame_pointer(realasm));
+	BOOST_REQUIRE_EQUAL(0, count_instructions(realasm, be::opcode::op_push));
+	BOOST_REQUIRE_EQUAL(0, count_instructions(realasm, be::opcode::op_pop));
+	BOOST_REQUIRE_EQUAL(1, count_instructions(realasm, be::opcode::op_ret));
+}
+
+
+BOOST_AUTO_TEST_CASE(non_leaf_function_saves_callee_saved_registers)
+{
+	auto labels = be::label_table{};
+	const auto virtasm = make_function({
+		{be::opcode::op_mov, be::bit_width::xxxii, std::int64_t{42}, general(1)},
+		{be::opcode::op_call, be::bit_width{}, labels.intern("bar"), {}},
+		{be::opcode::op_mov, be::bit_width::xxxii, general(1), be::virtual_register::result},
+	});
+	const auto realasm = be::allocate_registers(virtasm);
+	BOOST_REQUIRE(!uses_frame_pointer(realasm));
+	const auto& prologue = realasm.blocks.front().code;
+	BOOST_REQUIRE_EQUAL(1, prologue.size());
+	BOOST_REQUIRE(be::opcode::op_push == prologue.front().code);
+	const auto saved = be::get_register(prologue.front().op1);
+	BOOST_REQUIRE(saved);
+	BOOST_REQUIRE(be::real_register::b == *saved);
+	const auto& body = realasm.blocks.back().code;
+	BOOST_REQUIRE(body.size() >= 2);
+	const auto& pop = body[body.size() - 2];
+	BOOST_REQUIRE(be::opcode::op_pop == pop.code);
+	BOOST_REQUIRE(be::real_register::b == *be::get_register(pop.op1));
+}
+
+
+BOOST_AUTO_TEST_CASE(excess_registers_are_spilled_to_frame)
+{
+	auto code = std::vector<be::virtual_instruction>{};
+	for (int i = 1; i <= 20; ++i) {
+		code.emplace_back(be::opcode::op_mov, be::bit_width::lxiv, std::int64_t{i}, general(i));
+	}
+	for (int i = 2; i <= 20; ++i) {
+		code.emplace_back(be::opcode::op_add, be::bit_width::lxiv, general(i), general(1));
+	}
+	const auto realasm = be::allocate_registers(make_function(code));
+	BOOST_REQUIRE(uses_frame_pointer(realasm));
+	const auto& prologue = realasm.blocks.front().code;
+	BOOST_REQUIRE(be::opcode::op_push == prologue.at(0).code);
+	BOOST_REQUIRE(be::opcode::op_mov == prologue.at(1).code);
+	BOOST_REQUIRE(be::opcode::op_sub == prologue.at(2).code);
+	// 5 free argument registers and 5 callee-saved registers
+	BOOST_REQUIRE_EQUAL(std::int64_t{8} * (10 + 5), *be::get_immediate(prologue.at(2).op1));
+}
+
+
+BOOST_AUTO_TEST_CASE(inline_allocation_bumps_heap_pointer)
+{
+	const auto virtasm = make_function({
+		{be::opcode::mac_new, be::bit_width::lxiv, std::int64_t{24}, general(1)},
+		{be::opcode::op_mov, be::bit_width::lxiv, general(1), be::virtual_register::result},
+	});
+	const auto realasm = be::allocate_registers(virtasm);
+	BOOST_REQUIRE_EQUAL(0, count_instructions(realasm, be::opcode::mac_new));
+	BOOST_REQUIRE_EQUAL(1, count_instructions(realasm, be::opcode::op_ja));
+	BOOST_REQUIRE_EQUAL(1, count_instructions(realasm, be::opcode::op_call));
+	// The slow path is placed after the function's last block.
+	const auto& slow = realasm.blocks.back();
+	BOOST_REQUIRE(be::opcode::op_jmp == slow.code.back().code);
+	const auto resume = be::get_label(slow.code.back().op1);
+	BOOST_REQUIRE(resume);
+	const auto pos = std::find_if(
+		realasm.blocks.begin(), realasm.blocks.end(),
+		[&](const auto& block){ return block.label == realasm.labels.name(*resume); }
+	);
+	BOOST_REQUIRE(pos != realasm.blocks.end());
+	BOOST_REQUIRE(be::opcode::op_ret != pos->code.front().code);
+	const auto lea = std::find_if(
+		std::prev(pos)->code.begin(), std::prev(pos)->code.end(),
+		[](const auto& instr){ return instr.code == be::opcode::op_lea; }
+	);
+	BOOST_REQUIRE(lea != std::prev(pos)->code.end());
+	BOOST_REQUIRE_EQUAL(24 + 8, *be::get_address(lea->op1)->constant);
+}
+
+
+BOOST_AUTO_TEST_CASE(inline_io_calls_runtime_out_of_line)
+{
+	const auto virtasm = make_function({
+		{be::opcode::mac_read, be::bit_width::xxxii, general(1), {}},
+		{be::opcode::mac_write, be::bit_width::xxxii, general(1), {}},
+	});
+	const auto realasm = be::allocate_registers(virtasm);
+	BOOST_REQUIRE_EQUAL(0, count_instructions(realasm, be::opcode::mac_read));
+	BOOST_REQUIRE_EQUAL(0, count_instructions(realasm, be::opcode::mac_write));
+	BOOST_REQUIRE_EQUAL(2, count_instructions(realasm, be::opcode::op_jae));
+	BOOST_REQUIRE_EQUAL(2, count_instructions(realasm, be::opcode::op_call));
+	auto targets = std::vector<std::string>{};
+	for (const auto& block : realasm.blocks) {
+		for (const auto& instr : block.code) {
+			if (instr.code == be::opcode::op_call) {
+				targets.push_back(realasm.labels.name(*be::get_label(instr.op1)));
+			}
+		}
+	}
+	BOOST_REQUIRE(targets == (std::vector<std::string>{"mj_runtime_read", "mj_runtime_write"}));
 }
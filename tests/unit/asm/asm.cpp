@@ -1,27 +1,98 @@
 #include "asm/asm.hpp"
 
+#include <cstddef>
+#include <random>
+#include <string>
+
 #define BOOST_TEST_MODULE  asm_asm
 #include <boost/test/unit_test.hpp>
 
 #include "exceptions.hpp"
+#include "firm.hpp"
+#include "io/file_data.hpp"
 #include "io/file_output.hpp"
 #include "irg/irg.hpp"
 #include "opt/opt.hpp"
+#include "parser/ast_factory.hpp"
 #include "semantic/semantic.hpp"
+#include "symbol/symbol_pool.hpp"
 
 #include "testaux/ast_test_factory.hpp"
+#include "testaux/astgen.hpp"
 #include "testaux/temporary_file.hpp"
 
 
+namespace /* anonymous */
+{
+
+	// libfirm can only be initialized once per process so all tests have to
+	// share the global state.
+	minijava::global_firm_state& get_firm()
+	{
+		static const auto firm = minijava::initialize_firm();
+		return *firm;
+	}
+
+	// Compiles the checked program `ast` and `return`s the assembly generated
+	// with `threads` threads.
+	std::string assemble_program(const minijava::ast::program& ast,
+	                             const minijava::semantic_info& seminfo,
+	                             const std::size_t threads)
+	{
+		auto irg = minijava::create_firm_ir(get_firm(), ast, seminfo, "test");
+		minijava::optimize(irg);
+		testaux::temporary_file tempfile{};
+		auto asmfile = minijava::file_output{tempfile.filename()};
+		minijava::assemble(irg, asmfile, threads);
+		asmfile.close();
+		const auto data = minijava::file_data{tempfile.filename()};
+		return std::string{data.begin(), data.end()};
+	}
+
+}  // namespace /* anonymous */
+
+
 BOOST_AUTO_TEST_CASE(demo)
 {
 	auto tf = testaux::ast_test_factory{};
 	const auto ast = tf.make_hello_world();
 	const auto seminfo = minijava::check_program(*ast, tf.pool, tf.factory);
-	auto firm = minijava::initialize_firm();
-	auto irg = minijava::create_firm_ir(*firm, *ast, seminfo, "test");
+	auto irg = minijava::create_firm_ir(get_firm(), *ast, seminfo, "test");
 	minijava::optimize(irg);
 	testaux::temporary_file tempfile{};
 	auto asmfile = minijava::file_output{tempfile.filename()};
 	minijava::assemble(irg, asmfile);
 }
+
+
+BOOST_AUTO_TEST_CASE(assemble_frees_graphs)
+{
+	auto tf = testaux::ast_test_factory{};
+	const auto ast = tf.make_hello_world();
+	const auto seminfo = minijava::check_program(*ast, tf.pool, tf.factory);
+	auto irg = minijava::create_firm_ir(get_firm(), *ast, seminfo, "test");
+	testaux::temporary_file tempfile{};
+	auto asmfile = minijava::file_output{tempfile.filename()};
+	minijava::assemble(irg, asmfile);
+	const auto guard = minijava::make_irp_guard(*irg->second, irg->first);
+	BOOST_REQUIRE_EQUAL(0u, firm::get_irp_n_irgs());
+}
+
+
+BOOST_AUTO_TEST_CASE(assembly_does_not_depend_on_thread_count)
+{
+	// The generated program depends on the addresses of the symbols so it
+	// must only be generated once for all thread counts.
+	for (auto seed = 1u; seed <= 3u; ++seed) {
+		auto engine = std::default_random_engine{seed};
+		auto pool = minijava::symbol_pool<>{};
+		auto factory = minijava::ast_factory{};
+		const auto ast = testaux::generate_semantic_ast(engine, pool, factory, 25);
+		const auto seminfo = minijava::check_program(*ast, pool, factory);
+		const auto expected = assemble_program(*ast, seminfo, 1);
+		BOOST_REQUIRE(!expected.empty());
+		for (const auto threads : {2, 3, 8}) {
+			BOOST_REQUIRE_EQUAL(expected, assemble_program(*ast, seminfo, threads));
+		}
+	}
+}
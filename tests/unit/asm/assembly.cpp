@@ -18,3 +18,17 @@ BOOST_AUTO_TEST_CASE_TEMPLATE(assembly_ctor, RegT, both_register_types)
 	BOOST_REQUIRE_EQUAL("foo", as.ldname);
 	BOOST_REQUIRE(as.blocks.empty());
 }
+
+
+BOOST_AUTO_TEST_CASE(label_table_interns_names)
+{
+	auto labels = minijava::backend::label_table{};
+	BOOST_REQUIRE_EQUAL(0, labels.size());
+	const auto foo = labels.intern("foo");
+	const auto bar = labels.intern("bar");
+	BOOST_REQUIRE(foo != bar);
+	BOOST_REQUIRE(foo == labels.intern("foo"));
+	BOOST_REQUIRE_EQUAL(2, labels.size());
+	BOOST_REQUIRE_EQUAL("foo", labels.name(foo));
+	BOOST_REQUIRE_EQUAL("bar", labels.name(bar));
+}
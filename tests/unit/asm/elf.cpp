@@ -0,0 +1,127 @@
+#include "asm/elf.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#define BOOST_TEST_MODULE  asm_elf
+#include <boost/test/unit_test.hpp>
+
+#include "testaux/temporary_file.hpp"
+
+namespace be = minijava::backend;
+
+
+namespace /* anonymous */
+{
+
+	std::vector<std::uint8_t> write(const be::object_file& obj)
+	{
+		testaux::temporary_file tempfile{};
+		auto out = minijava::file_output{tempfile.filename()};
+		be::write_elf_object(obj, out);
+		out.close();
+		auto in = std::ifstream{tempfile.filename(), std::ios::binary};
+		return std::vector<std::uint8_t>(std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{});
+	}
+
+	std::uint64_t read(const std::vector<std::uint8_t>& image, const std::size_t offset, const std::size_t size)
+	{
+		auto value = std::uint64_t{};
+		for (std::size_t i = 0; i < size; ++i) {
+			value |= std::uint64_t{image.at(offset + i)} << (8 * i);
+		}
+		return value;
+	}
+
+	// Returns the offset of the section header with the given index.
+	std::size_t section_header(const std::vector<std::uint8_t>& image, const std::size_t index)
+	{
+		return read(image, 0x28, 8) + 64 * index;
+	}
+
+}  // namespace /* anonymous */
+
+
+BOOST_AUTO_TEST_CASE(align_section_pads_with_zeros)
+{
+	auto bytes = std::vector<std::uint8_t>{1, 2, 3};
+	be::align_section(bytes, 8);
+	BOOST_REQUIRE((std::vector<std::uint8_t>{1, 2, 3, 0, 0, 0, 0, 0} == bytes));
+	be::align_section(bytes, 4);
+	BOOST_REQUIRE_EQUAL(8, bytes.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(elf_header_of_empty_object)
+{
+	const auto image = write(be::object_file{});
+	BOOST_REQUIRE(image.size() >= 64);
+	BOOST_REQUIRE_EQUAL(0x7f, image[0]);
+	BOOST_REQUIRE_EQUAL('E', image[1]);
+	BOOST_REQUIRE_EQUAL('L', image[2]);
+	BOOST_REQUIRE_EQUAL('F', image[3]);
+	BOOST_REQUIRE_EQUAL(2, image[4]);              // 64 bit
+	BOOST_REQUIRE_EQUAL(1, image[5]);              // little endian
+	BOOST_REQUIRE_EQUAL(1, read(image, 16, 2));    // relocatable
+	BOOST_REQUIRE_EQUAL(62, read(image, 18, 2));   // x86-64
+	const auto shnum = read(image, 60, 2);
+	const auto shoff = read(image, 40, 8);
+	BOOST_REQUIRE_EQUAL(image.size(), shoff + 64 * shnum);
+}
+
+
+BOOST_AUTO_TEST_CASE(text_section_holds_code)
+{
+	auto obj = be::object_file{};
+	obj.text = {0x90, 0xc3};
+	const auto image = write(obj);
+	const auto shdr = section_header(image, 1);
+	BOOST_REQUIRE_EQUAL(1, read(image, shdr + 4, 4));         // SHT_PROGBITS
+	BOOST_REQUIRE_EQUAL(0x6, read(image, shdr + 8, 8));       // SHF_ALLOC | SHF_EXECINSTR
+	const auto offset = read(image, shdr + 24, 8);
+	BOOST_REQUIRE_EQUAL(2, read(image, shdr + 32, 8));
+	BOOST_REQUIRE_EQUAL(0x90, image.at(offset));
+	BOOST_REQUIRE_EQUAL(0xc3, image.at(offset + 1));
+}
+
+
+BOOST_AUTO_TEST_CASE(undefined_symbols_are_added_for_relocations)
+{
+	auto obj = be::object_file{};
+	obj.text = {0xe8, 0, 0, 0, 0};
+	auto sym = be::object_symbol{};
+	sym.name = "f";
+	sym.section = be::object_section::text;
+	sym.kind = be::symbol_kind::function;
+	sym.size = 5;
+	obj.symbols.push_back(sym);
+	auto rel = be::relocation{};
+	rel.section = be::object_section::text;
+	rel.offset = 1;
+	rel.symbol = "g";
+	rel.kind = be::relocation_kind::plt32;
+	rel.addend = -4;
+	obj.relocations.push_back(rel);
+	const auto image = write(obj);
+	// .rela.text
+	const auto rela = section_header(image, 4);
+	BOOST_REQUIRE_EQUAL(4, read(image, rela + 4, 4));         // SHT_RELA
+	BOOST_REQUIRE_EQUAL(24, read(image, rela + 32, 8));
+	const auto entry = read(image, rela + 24, 8);
+	BOOST_REQUIRE_EQUAL(1, read(image, entry, 8));
+	BOOST_REQUIRE_EQUAL((std::uint64_t{2} << 32) | 4, read(image, entry + 8, 8));
+	BOOST_REQUIRE_EQUAL(static_cast<std::uint64_t>(-4), read(image, entry + 16, 8));
+	// .symtab: null symbol, local f, global undefined g
+	const auto symtab = section_header(image, 6);
+	BOOST_REQUIRE_EQUAL(2, read(image, symtab + 4, 4));       // SHT_SYMTAB
+	BOOST_REQUIRE_EQUAL(3 * 24, read(image, symtab + 32, 8));
+	BOOST_REQUIRE_EQUAL(2, read(image, symtab + 44, 4));      // first global
+	const auto symbols = read(image, symtab + 24, 8);
+	BOOST_REQUIRE_EQUAL(0x02, read(image, symbols + 24 + 4, 1));  // LOCAL FUNC
+	BOOST_REQUIRE_EQUAL(1, read(image, symbols + 24 + 6, 2));     // .text
+	BOOST_REQUIRE_EQUAL(0x10, read(image, symbols + 48 + 4, 1));  // GLOBAL NOTYPE
+	BOOST_REQUIRE_EQUAL(0, read(image, symbols + 48 + 6, 2));     // undefined
+}
@@ -0,0 +1,164 @@
+#include "asm/encoder.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#define BOOST_TEST_MODULE  asm_encoder
+#include <boost/test/unit_test.hpp>
+
+#include "exceptions.hpp"
+
+namespace be = minijava::backend;
+
+using bytes = std::vector<std::uint8_t>;
+
+
+namespace /* anonymous */
+{
+
+	be::object_file encode(const std::vector<be::real_instruction>& code)
+	{
+		auto assembly = be::real_assembly{"f"};
+		assembly.blocks.emplace_back("");
+		assembly.blocks.back().code = code;
+		auto obj = be::object_file{};
+		be::encode_text(assembly, true, obj);
+		return obj;
+	}
+
+	bytes encode_one(const be::real_instruction& instr)
+	{
+		return encode({instr}).text;
+	}
+
+}  // namespace /* anonymous */
+
+
+BOOST_AUTO_TEST_CASE(function_symbol_is_defined)
+{
+	auto obj = be::object_file{};
+	obj.text = {0x90};
+	auto assembly = be::real_assembly{"foo"};
+	assembly.blocks.emplace_back("");
+	assembly.blocks.back().code.emplace_back(be::opcode::op_ret);
+	be::encode_text(assembly, false, obj);
+	BOOST_REQUIRE_EQUAL(1, obj.symbols.size());
+	const auto& sym = obj.symbols.front();
+	BOOST_REQUIRE_EQUAL("foo", sym.name);
+	BOOST_REQUIRE(be::object_section::text == sym.section);
+	BOOST_REQUIRE(be::symbol_kind::function == sym.kind);
+	BOOST_REQUIRE(!sym.global);
+	BOOST_REQUIRE_EQUAL(1, sym.offset);
+	BOOST_REQUIRE_EQUAL(1, sym.size);
+	BOOST_REQUIRE((bytes{0x90, 0xc3} == obj.text));
+}
+
+
+BOOST_AUTO_TEST_CASE(encode_register_moves)
+{
+	using rr = be::real_register;
+	using bw = be::bit_width;
+	const auto mov = be::opcode::op_mov;
+	BOOST_REQUIRE((bytes{0x48, 0x89, 0xf8} == encode_one({mov, bw::lxiv, rr::di, rr::a})));
+	BOOST_REQUIRE((bytes{0x89, 0xf8} == encode_one({mov, bw::xxxii, rr::di, rr::a})));
+	BOOST_REQUIRE((bytes{0x4d, 0x89, 0xe3} == encode_one({mov, bw::lxiv, rr::r12, rr::r11})));
+	BOOST_REQUIRE((bytes{0x40, 0x88, 0xf7} == encode_one({mov, bw::viii, rr::si, rr::di})));
+	BOOST_REQUIRE((bytes{0x66, 0x89, 0xc3} == encode_one({mov, bw::xvi, rr::a, rr::b})));
+}
+
+
+BOOST_AUTO_TEST_CASE(encode_immediates)
+{
+	using rr = be::real_register;
+	using bw = be::bit_width;
+	BOOST_REQUIRE((bytes{0xb8, 0x2a, 0x00, 0x00, 0x00} == encode_one({be::opcode::op_mov, bw::xxxii, 42, rr::a})));
+	BOOST_REQUIRE((bytes{0x48, 0xc7, 0xc1, 0xff, 0xff, 0xff, 0xff} == encode_one({be::opcode::op_mov, bw::lxiv, -1, rr::c})));
+	BOOST_REQUIRE((bytes{0x48, 0x83, 0xe4, 0xf0} == encode_one({be::opcode::op_and, bw::lxiv, -16, rr::sp})));
+	BOOST_REQUIRE((bytes{0x05, 0xe8, 0x03, 0x00, 0x00} == encode_one({be::opcode::op_add, bw::xxxii, 1000, rr::a})));
+	BOOST_REQUIRE((bytes{0x6b, 0xdb, 0x03} == encode_one({be::opcode::op_imul, bw::xxxii, 3, rr::b})));
+	BOOST_REQUIRE((bytes{0x6a, 0x07} == encode_one({be::opcode::op_push, bw::lxiv, 7})));
+}
+
+
+BOOST_AUTO_TEST_CASE(encode_addresses)
+{
+	using rr = be::real_register;
+	using bw = be::bit_width;
+	using addr = be::real_address;
+	const auto mov = be::opcode::op_mov;
+	BOOST_REQUIRE((bytes{0x48, 0x8b, 0x45, 0xf8} == encode_one({mov, bw::lxiv, addr{-8, rr::bp}, rr::a})));
+	BOOST_REQUIRE((bytes{0x48, 0x8b, 0x04, 0x24} == encode_one({mov, bw::lxiv, addr{boost::none, rr::sp}, rr::a})));
+	BOOST_REQUIRE((bytes{0x41, 0x89, 0x45, 0x00} == encode_one({mov, bw::xxxii, rr::a, addr{boost::none, rr::r13}})));
+	BOOST_REQUIRE((bytes{0x8b, 0x04, 0x25, 0xd2, 0x04, 0x00, 0x00} == encode_one({mov, bw::xxxii, addr{1234}, rr::a})));
+	BOOST_REQUIRE((bytes{0x4b, 0x8d, 0x44, 0xec, 0x04} == encode_one({be::opcode::op_lea, bw{}, addr{4, rr::r12, rr::r13, 8}, rr::a})));
+	BOOST_REQUIRE((bytes{0xff, 0x34, 0x24} == encode_one({be::opcode::op_push, bw::lxiv, addr{boost::none, rr::sp}})));
+}
+
+
+BOOST_AUTO_TEST_CASE(encode_conditional_instructions)
+{
+	using rr = be::real_register;
+	using bw = be::bit_width;
+	BOOST_REQUIRE((bytes{0x0f, 0x4c, 0xc1} == encode_one({be::opcode::op_cmovl, bw::xxxii, rr::c, rr::a})));
+	BOOST_REQUIRE((bytes{0x48, 0x0f, 0x4f, 0xc1} == encode_one({be::opcode::op_cmovg, bw::lxiv, rr::c, rr::a})));
+	BOOST_REQUIRE((bytes{0x40, 0x0f, 0x94, 0xc6} == encode_one({be::opcode::op_sete, bw{}, rr::si})));
+	BOOST_REQUIRE((bytes{0x41, 0x0f, 0x9e, 0xc0} == encode_one({be::opcode::op_setle, bw{}, rr::r8})));
+}
+
+
+BOOST_AUTO_TEST_CASE(local_jumps_are_resolved)
+{
+	using oc = be::opcode;
+	auto assembly = be::real_assembly{"f"};
+	const auto top = assembly.labels.intern(".Ltop");
+	const auto bottom = assembly.labels.intern(".Lbottom");
+	assembly.blocks.emplace_back(".Ltop");
+	assembly.blocks.back().code.emplace_back(oc::op_jne, be::bit_width{}, bottom);
+	assembly.blocks.emplace_back(".Lbottom");
+	assembly.blocks.back().code.emplace_back(oc::op_jmp, be::bit_width{}, top);
+	auto obj = be::object_file{};
+	be::encode_text(assembly, true, obj);
+	const auto expected = bytes{
+		0x0f, 0x85, 0x00, 0x00, 0x00, 0x00,  // jne .Lbottom
+		0xe9, 0xf5, 0xff, 0xff, 0xff,        // jmp .Ltop
+	};
+	BOOST_REQUIRE((expected == obj.text));
+	BOOST_REQUIRE(obj.relocations.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(references_to_names_are_relocated)
+{
+	using oc = be::opcode;
+	using rr = be::real_register;
+	auto assembly = be::real_assembly{"f"};
+	assembly.blocks.emplace_back("");
+	assembly.blocks.back().code.emplace_back(oc::op_call, be::bit_width{}, assembly.labels.intern("g"));
+	assembly.blocks.back().code.emplace_back(oc::op_lea, be::bit_width{}, assembly.labels.intern("v"), rr::a);
+	auto obj = be::object_file{};
+	be::encode_text(assembly, true, obj);
+	const auto expected = bytes{
+		0xe8, 0x00, 0x00, 0x00, 0x00,                    // call g
+		0x48, 0x8d, 0x04, 0x25, 0x00, 0x00, 0x00, 0x00,  // lea v, %rax
+	};
+	BOOST_REQUIRE((expected == obj.text));
+	BOOST_REQUIRE_EQUAL(2, obj.relocations.size());
+	BOOST_REQUIRE_EQUAL("g", obj.relocations[0].symbol);
+	BOOST_REQUIRE(be::relocation_kind::plt32 == obj.relocations[0].kind);
+	BOOST_REQUIRE_EQUAL(1, obj.relocations[0].offset);
+	BOOST_REQUIRE_EQUAL(-4, obj.relocations[0].addend);
+	BOOST_REQUIRE_EQUAL("v", obj.relocations[1].symbol);
+	BOOST_REQUIRE(be::relocation_kind::abs32s == obj.relocations[1].kind);
+	BOOST_REQUIRE_EQUAL(9, obj.relocations[1].offset);
+	BOOST_REQUIRE_EQUAL(0, obj.relocations[1].addend);
+}
+
+
+BOOST_AUTO_TEST_CASE(macros_cannot_be_encoded)
+{
+	using rr = be::real_register;
+	BOOST_REQUIRE_THROW(
+		encode_one({be::opcode::mac_div, be::bit_width::lxiv, rr::a, rr::b}),
+		minijava::internal_compiler_error
+	);
+}
@@ -1,5 +1,7 @@
 #include "asm/generator.hpp"
 
+#include <vector>
+
 #define BOOST_TEST_MODULE  asm_generator
 #include <boost/test/unit_test.hpp>
 
@@ -25,3 +27,53 @@ BOOST_AUTO_TEST_CASE(assemble_empty_function)
 	const auto virtasm = minijava::backend::assemble_function(irg);
 	// TODO: Check something meaningful.
 }
+
+
+BOOST_AUTO_TEST_CASE(assemble_negated_materialized_comparison)
+{
+	using namespace minijava::backend;
+	auto firm = minijava::initialize_firm();
+	const auto int_type = firm::new_type_primitive(firm::mode_Is);
+	const auto bool_type = firm::new_type_primitive(firm::mode_Bs);
+	const auto name = firm::new_id_from_str("not_less");
+	const auto method_type = firm::new_type_method(
+		2, 1, 0, 0, firm::mtp_no_property
+	);
+	firm::set_method_param_type(method_type, 0, int_type);
+	firm::set_method_param_type(method_type, 1, int_type);
+	firm::set_method_res_type(method_type, 0, bool_type);
+	const auto method_entity = firm::new_entity(
+		firm::get_glob_type(), name, method_type
+	);
+	firm::set_entity_ld_ident(method_entity, name);
+	const auto irg = firm::new_ir_graph(method_entity, 0);
+	firm::set_current_ir_graph(irg);
+	const auto args = firm::get_irg_args(irg);
+	const auto cmp = firm::new_Cmp(
+		firm::new_Proj(args, firm::mode_Is, 0),
+		firm::new_Proj(args, firm::mode_Is, 1),
+		firm::ir_relation_less
+	);
+	// This is what `!(a < b)` becomes once the comparison is materialized.
+	auto mux = firm::new_Mux(
+		cmp,
+		firm::new_Const_long(firm::mode_Bs, 1),
+		firm::new_Const_long(firm::mode_Bs, 0)
+	);
+	const auto ret = firm::new_Return(firm::get_store(), 1, &mux);
+	firm::add_immBlock_pred(firm::get_irg_end_block(irg), ret);
+	firm::mature_immBlock(firm::get_r_cur_block(irg));
+	firm::mature_immBlock(firm::get_irg_end_block(irg));
+	firm::irg_finalize_cons(irg);
+	const auto virtasm = assemble_function(irg);
+	auto setcc = std::vector<opcode>{};
+	for (const auto& block : virtasm.blocks) {
+		for (const auto& instr : block.code) {
+			if ((instr.code == opcode::op_setge) || (instr.code == opcode::op_setl)) {
+				setcc.push_back(instr.code);
+			}
+		}
+	}
+	BOOST_REQUIRE_EQUAL(1, setcc.size());
+	BOOST_REQUIRE(opcode::op_setge == setcc.front());
+}
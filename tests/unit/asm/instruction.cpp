@@ -40,7 +40,7 @@ BOOST_AUTO_TEST_CASE(operand_none)
 	BOOST_REQUIRE(nullptr == get_immediate(operand));
 	BOOST_REQUIRE(nullptr == get_register(operand));
 	BOOST_REQUIRE(nullptr == get_address(operand));
-	BOOST_REQUIRE(nullptr == get_name(operand));
+	BOOST_REQUIRE(nullptr == get_label(operand));
 }
 
 BOOST_AUTO_TEST_CASE(operand_immediate)
@@ -52,7 +52,7 @@ BOOST_AUTO_TEST_CASE(operand_immediate)
 	BOOST_REQUIRE_EQUAL(42, *get_immediate(operand));
 	BOOST_REQUIRE(nullptr == get_register(operand));
 	BOOST_REQUIRE(nullptr == get_address(operand));
-	BOOST_REQUIRE(nullptr == get_name(operand));
+	BOOST_REQUIRE(nullptr == get_label(operand));
 }
 
 BOOST_AUTO_TEST_CASE(operand_register)
@@ -64,7 +64,7 @@ BOOST_AUTO_TEST_CASE(operand_register)
 	BOOST_REQUIRE(nullptr != get_register(operand));
 	BOOST_REQUIRE(mock_register::b == *get_register(operand));
 	BOOST_REQUIRE(nullptr == get_address(operand));
-	BOOST_REQUIRE(nullptr == get_name(operand));
+	BOOST_REQUIRE(nullptr == get_label(operand));
 }
 
 BOOST_AUTO_TEST_CASE(operand_address)
@@ -76,18 +76,44 @@ BOOST_AUTO_TEST_CASE(operand_address)
 	BOOST_REQUIRE(nullptr == get_immediate(operand));
 	BOOST_REQUIRE(nullptr == get_register(operand));
 	BOOST_REQUIRE(nullptr != get_address(operand));
-	BOOST_REQUIRE(nullptr == get_name(operand));
+	BOOST_REQUIRE(nullptr == get_label(operand));
 }
 
 BOOST_AUTO_TEST_CASE(operand_name)
 {
 	using operand_type = minijava::backend::operand<mock_register>;
-	const auto label = "foo";
+	const auto label = static_cast<minijava::backend::label_id>(7);
 	const auto operand = operand_type{label};
 	BOOST_REQUIRE(!empty(operand));
 	BOOST_REQUIRE(nullptr == get_immediate(operand));
 	BOOST_REQUIRE(nullptr == get_register(operand));
 	BOOST_REQUIRE(nullptr == get_address(operand));
-	BOOST_REQUIRE(nullptr != get_name(operand));
-	BOOST_REQUIRE_EQUAL(label, *get_name(operand));
+	BOOST_REQUIRE(nullptr != get_label(operand));
+	BOOST_REQUIRE(label == *get_label(operand));
+}
+
+BOOST_AUTO_TEST_CASE(operand_address_fields)
+{
+	using operand_type = minijava::backend::operand<mock_register>;
+	using address_type = minijava::backend::address<mock_register>;
+	const auto operand = operand_type{address_type{-8, mock_register::c, boost::none, 4}};
+	const auto addr = get_address(operand);
+	BOOST_REQUIRE(nullptr != addr);
+	BOOST_REQUIRE(addr->constant);
+	BOOST_REQUIRE_EQUAL(-8, *addr->constant);
+	BOOST_REQUIRE(addr->base);
+	BOOST_REQUIRE(mock_register::c == *addr->base);
+	BOOST_REQUIRE(!addr->index);
+	BOOST_REQUIRE(addr->scale);
+	BOOST_REQUIRE_EQUAL(4, *addr->scale);
+}
+
+BOOST_AUTO_TEST_CASE(instruction_type_traits)
+{
+	using minijava::backend::virtual_instruction;
+	using minijava::backend::real_instruction;
+	static_assert(std::is_trivially_copyable<virtual_instruction>{}, "");
+	static_assert(std::is_trivially_copyable<real_instruction>{}, "");
+	static_assert(std::is_trivially_destructible<virtual_instruction>{}, "");
+	static_assert(std::is_trivially_destructible<real_instruction>{}, "");
 }
@@ -108,9 +108,9 @@ BOOST_AUTO_TEST_CASE(write_text_for_arbitrary_crap)
 	using rr = minijava::backend::real_register;
 	auto assembly = minijava::backend::real_assembly{"name"};
 	assembly.blocks.emplace_back("");
-	assembly.blocks.back().code.emplace_back(opc::op_push, bw::xxxii, "button");
-	assembly.blocks.back().code.emplace_back(opc::op_call, bw{}, "me");
-	assembly.blocks.back().code.emplace_back(opc::op_jmp, bw{}, "high");
+	assembly.blocks.back().code.emplace_back(opc::op_push, bw::xxxii, assembly.labels.intern("button"));
+	assembly.blocks.back().code.emplace_back(opc::op_call, bw{}, assembly.labels.intern("me"));
+	assembly.blocks.back().code.emplace_back(opc::op_jmp, bw{}, assembly.labels.intern("high"));
 	assembly.blocks.back().code.emplace_back(opc::op_push, bw::xxxii, 42);
 	const minijava::backend::address<rr> addresses[] = {
 		{1234},
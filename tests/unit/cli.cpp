@@ -7,6 +7,8 @@
 #include <vector>
 
 #include "exceptions.hpp"
+#include "io/compilation_cache.hpp"
+#include "io/file_data.hpp"
 
 #include "testaux/random.hpp"
 #include "testaux/temporary_file.hpp"
@@ -138,6 +140,20 @@ static const testaux::you_can_print_me<std::vector<const char *>> garbage_data[]
 	{{"", "--echo", "bar", "--lextest", "baz"}},
 	{{"", "foo", "--echo", "bar", "--lextest", "baz"}},
 	{{"", "--no-such-option", "--echo", "somefile"}},
+	{{"", "--run", "--echo", "somefile"}},
+	{{"", "--check", "--run", "somefile"}},
+	{{"", "--workers", "2", "somefile"}},
+	{{"", "--batch", "--lextest", "somefile"}},
+	{{"", "--batch", "--run", "somefile"}},
+	{{"", "--batch", "--workers", "0", "somefile"}},
+	{{"", "--serve", "socket", "somefile"}},
+	{{"", "--serve", "socket", "--check"}},
+	{{"", "--serve", "socket", "--batch"}},
+	{{"", "--serve", ""}},
+	{{"", "--cache-stats", "somefile"}},
+	{{"", "--cache-size", "10", "somefile"}},
+	{{"", "--jobs", "0", "somefile"}},
+	{{"", "-j", "none", "somefile"}},
 };
 
 BOOST_DATA_TEST_CASE(garbage_throws, garbage_data)
@@ -652,3 +668,205 @@ BOOST_AUTO_TEST_CASE(print_ast_passes_example_test)
 	BOOST_REQUIRE(testaux::file_has_content(out.filename(), official_pretty_printer_test_result));
 	BOOST_REQUIRE(testaux::file_has_content(err.filename(), ""s));
 }
+
+
+static const int batch_worker_counts[] = {1, 2, 3};
+
+BOOST_DATA_TEST_CASE(batch_check_accepts_valid_programs, batch_worker_counts)
+{
+	using namespace std::string_literals;
+	testaux::temporary_file first{valid_program_data};
+	testaux::temporary_file second{valid_program_data};
+	testaux::temporary_file list{second.filename() + "\n"};
+	testaux::temporary_file in{};
+	testaux::temporary_file out{};
+	testaux::temporary_file err{};
+	auto fh_in = testaux::open_file(in.filename(), "rb");
+	auto fh_out = testaux::open_file(out.filename(), "wb");
+	auto fh_err = testaux::open_file(err.filename(), "wb");
+	const auto workers = std::to_string(sample);
+	minijava::real_main(
+		{"", "--batch", "--check", "--workers", workers.c_str(), first.filename().c_str(),
+		 "--batch-file", list.filename().c_str()},
+		fh_in.get(), fh_out.get(), fh_err.get()
+	);
+	BOOST_REQUIRE(testaux::file_has_content(out.filename(), ""s));
+	BOOST_REQUIRE(testaux::file_has_content(err.filename(), ""s));
+}
+
+
+BOOST_DATA_TEST_CASE(batch_check_reports_all_invalid_programs, batch_worker_counts)
+{
+	using namespace std::string_literals;
+	testaux::temporary_file good{valid_program_data};
+	testaux::temporary_file bad1{"class Foo { public static main(String[] args) {} }"};
+	testaux::temporary_file bad2{"class Main { public static void main(String[] args) { int x = true; } }"};
+	testaux::temporary_file in{};
+	testaux::temporary_file out{};
+	testaux::temporary_file err{};
+	auto fh_in = testaux::open_file(in.filename(), "rb");
+	auto fh_out = testaux::open_file(out.filename(), "wb");
+	auto fh_err = testaux::open_file(err.filename(), "wb");
+	const auto workers = std::to_string(sample);
+	BOOST_REQUIRE_EXCEPTION(
+		minijava::real_main(
+			{"", "--batch", "--check", "--workers", workers.c_str(),
+			 bad1.filename().c_str(), good.filename().c_str(), bad2.filename().c_str()},
+			fh_in.get(), fh_out.get(), fh_err.get()
+		),
+		std::exception,
+		[](auto&& e){ return std::string{e.what()}.find("2 of 3") != std::string::npos; }
+	);
+	fh_err.reset();
+	const auto errtext = minijava::file_data{err.filename()};
+	const auto errstr = std::string{errtext.begin(), errtext.end()};
+	BOOST_REQUIRE(errstr.find(bad1.filename()) != std::string::npos);
+	BOOST_REQUIRE(errstr.find(bad2.filename()) != std::string::npos);
+	BOOST_REQUIRE(errstr.find(good.filename()) == std::string::npos);
+	BOOST_REQUIRE(testaux::file_has_content(out.filename(), ""s));
+}
+
+
+BOOST_AUTO_TEST_CASE(batch_compiles_each_program_into_own_executable)
+{
+	namespace fs = boost::filesystem;
+	using namespace std::string_literals;
+	testaux::temporary_directory outdir{};
+	testaux::temporary_file first{valid_program_data, ".mj"};
+	testaux::temporary_file second{valid_program_data, ".java"};
+	testaux::temporary_file in{};
+	testaux::temporary_file out{};
+	testaux::temporary_file err{};
+	auto fh_in = testaux::open_file(in.filename(), "rb");
+	auto fh_out = testaux::open_file(out.filename(), "wb");
+	auto fh_err = testaux::open_file(err.filename(), "wb");
+	minijava::real_main(
+		{"", "--batch", "--workers", "2", "--output", outdir.filename().c_str(),
+		 first.filename().c_str(), second.filename().c_str()},
+		fh_in.get(), fh_out.get(), fh_err.get()
+	);
+	for (const auto& src : {first.filename(), second.filename()}) {
+		const auto exe = fs::path{outdir.filename()} / fs::path{src}.stem();
+		BOOST_REQUIRE(fs::exists(exe));
+		BOOST_REQUIRE(fs::file_size(exe) > 0);
+	}
+	BOOST_REQUIRE(testaux::file_has_content(out.filename(), ""s));
+	BOOST_REQUIRE(testaux::file_has_content(err.filename(), ""s));
+}
+
+
+BOOST_AUTO_TEST_CASE(deeply_nested_program_is_checked_on_any_number_of_threads)
+{
+	using namespace std::string_literals;
+	// Far deeper than a default stack of a few MiB allows.  With several
+	// classes, the parser and the semantic analysis use all threads.
+	const auto depth = 20000;
+	auto program = std::string{};
+	for (const auto name : {"A", "B", "C", "D"}) {
+		program += "class "s + name + " { public void f(int x) { ";
+		for (auto i = 0; i < depth; ++i) {
+			program += "if (x < 1) { ";
+		}
+		program += "x = (((x + 1)));";
+		for (auto i = 0; i < depth; ++i) {
+			program += " }";
+		}
+		program += " } }\n";
+	}
+	program += "class Main { public static void main(String[] args) { } }\n";
+	testaux::temporary_file source{program};
+	for (const auto jobs : {"1", "4"}) {
+		testaux::temporary_file in{};
+		testaux::temporary_file out{};
+		testaux::temporary_file err{};
+		auto fh_in = testaux::open_file(in.filename(), "rb");
+		auto fh_out = testaux::open_file(out.filename(), "wb");
+		auto fh_err = testaux::open_file(err.filename(), "wb");
+		minijava::real_main(
+			{"", "--check", "-j", jobs, source.filename().c_str()},
+			fh_in.get(), fh_out.get(), fh_err.get()
+		);
+		BOOST_REQUIRE(testaux::file_has_content(out.filename(), ""s));
+		BOOST_REQUIRE(testaux::file_has_content(err.filename(), ""s));
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(check_verdict_is_cached)
+{
+	using namespace std::string_literals;
+	testaux::temporary_directory cachedir{};
+	testaux::temporary_file source{valid_program_data};
+	for (auto i = 0; i < 2; ++i) {
+		testaux::temporary_file in{};
+		testaux::temporary_file out{};
+		testaux::temporary_file err{};
+		auto fh_in = testaux::open_file(in.filename(), "rb");
+		auto fh_out = testaux::open_file(out.filename(), "wb");
+		auto fh_err = testaux::open_file(err.filename(), "wb");
+		minijava::real_main(
+			{"", "--check", "--cache", cachedir.filename().c_str(), source.filename().c_str()},
+			fh_in.get(), fh_out.get(), fh_err.get()
+		);
+		BOOST_REQUIRE(testaux::file_has_content(out.filename(), ""s));
+		BOOST_REQUIRE(testaux::file_has_content(err.filename(), ""s));
+	}
+	const auto stats = minijava::compilation_cache{cachedir.filename(), 1000}.statistics();
+	BOOST_REQUIRE_EQUAL(1, stats.entries);
+	BOOST_REQUIRE_EQUAL(1, stats.hits);
+	BOOST_REQUIRE_EQUAL(1, stats.misses);
+}
+
+
+BOOST_AUTO_TEST_CASE(invalid_programs_are_not_cached)
+{
+	testaux::temporary_directory cachedir{};
+	testaux::temporary_file source{"class Foo { public static main(String[] args) {} }"};
+	for (auto i = 0; i < 2; ++i) {
+		testaux::temporary_file in{};
+		testaux::temporary_file out{};
+		testaux::temporary_file err{};
+		auto fh_in = testaux::open_file(in.filename(), "rb");
+		auto fh_out = testaux::open_file(out.filename(), "wb");
+		auto fh_err = testaux::open_file(err.filename(), "wb");
+		BOOST_REQUIRE_THROW(
+			minijava::real_main(
+				{"", "--check", "--cache", cachedir.filename().c_str(), source.filename().c_str()},
+				fh_in.get(), fh_out.get(), fh_err.get()
+			),
+			std::exception
+		);
+	}
+	const auto stats = minijava::compilation_cache{cachedir.filename(), 1000}.statistics();
+	BOOST_REQUIRE_EQUAL(0, stats.entries);
+	BOOST_REQUIRE_EQUAL(2, stats.misses);
+}
+
+
+BOOST_AUTO_TEST_CASE(cached_executable_is_reused)
+{
+	namespace fs = boost::filesystem;
+	testaux::temporary_directory cachedir{};
+	testaux::temporary_directory outdir{};
+	testaux::temporary_file source{valid_program_data};
+	for (const auto name : {"first", "second"}) {
+		testaux::temporary_file in{};
+		testaux::temporary_file out{};
+		testaux::temporary_file err{};
+		auto fh_in = testaux::open_file(in.filename(), "rb");
+		auto fh_out = testaux::open_file(out.filename(), "wb");
+		auto fh_err = testaux::open_file(err.filename(), "wb");
+		const auto exe = outdir.filename(name);
+		minijava::real_main(
+			{"", "--cache", cachedir.filename().c_str(), "--output", exe.c_str(), source.filename().c_str()},
+			fh_in.get(), fh_out.get(), fh_err.get()
+		);
+	}
+	const auto first = minijava::file_data{outdir.filename("first")};
+	const auto second = minijava::file_data{outdir.filename("second")};
+	BOOST_REQUIRE(first.size() > 0);
+	BOOST_REQUIRE(std::equal(first.begin(), first.end(), second.begin(), second.end()));
+	BOOST_REQUIRE(fs::status(outdir.filename("second")).permissions() & fs::owner_exe);
+	const auto stats = minijava::compilation_cache{cachedir.filename(), 1000}.statistics();
+	BOOST_REQUIRE_EQUAL(1, stats.hits);
+}
@@ -0,0 +1,125 @@
+#include "io/compilation_cache.hpp"
+
+#include <string>
+
+#define BOOST_TEST_MODULE  io_compilation_cache
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+
+#include "testaux/temporary_file.hpp"
+
+
+namespace fs = boost::filesystem;
+
+
+BOOST_AUTO_TEST_CASE(directory_is_created)
+{
+	const testaux::temporary_directory tempdir{};
+	const auto dirname = tempdir.filename("a/b/cache");
+	const auto cache = minijava::compilation_cache{dirname, 1000};
+	BOOST_REQUIRE(fs::is_directory(dirname));
+	BOOST_REQUIRE_EQUAL(dirname, cache.directory());
+	BOOST_REQUIRE_EQUAL(1000, cache.size_limit());
+}
+
+
+BOOST_AUTO_TEST_CASE(verdict_is_found_after_storing_it)
+{
+	const testaux::temporary_directory tempdir{};
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 1000};
+	BOOST_REQUIRE(!cache.lookup("key"));
+	cache.store("key");
+	BOOST_REQUIRE(cache.lookup("key"));
+	BOOST_REQUIRE(!cache.lookup("other"));
+}
+
+
+BOOST_AUTO_TEST_CASE(file_is_copied_back_with_permissions)
+{
+	using namespace std::string_literals;
+	const testaux::temporary_directory tempdir{};
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 1000};
+	const testaux::temporary_file original{"some data"};
+	fs::permissions(original.filename(), fs::owner_all);
+	cache.store("key", original.filename());
+	const testaux::temporary_file copy{"garbage that is longer than the data"};
+	BOOST_REQUIRE(cache.lookup("key", copy.filename()));
+	BOOST_REQUIRE(testaux::file_has_content(copy.filename(), "some data"s));
+	BOOST_REQUIRE(fs::status(copy.filename()).permissions() == fs::owner_all);
+}
+
+
+BOOST_AUTO_TEST_CASE(missing_file_is_not_copied)
+{
+	using namespace std::string_literals;
+	const testaux::temporary_directory tempdir{};
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 1000};
+	const testaux::temporary_file file{"data"};
+	BOOST_REQUIRE(!cache.lookup("key", file.filename()));
+	BOOST_REQUIRE(testaux::file_has_content(file.filename(), "data"s));
+}
+
+
+BOOST_AUTO_TEST_CASE(statistics_are_shared_between_instances)
+{
+	const testaux::temporary_directory tempdir{};
+	const testaux::temporary_file data{"12345"};
+	const testaux::temporary_file dest{};
+	{
+		auto cache = minijava::compilation_cache{tempdir.filename("cache"), 1000};
+		cache.lookup("a");
+		cache.store("a");
+		cache.lookup("a");
+		cache.lookup("b", dest.filename());
+		cache.store("b", data.filename());
+	}
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 1000};
+	cache.lookup("b", dest.filename());
+	const auto stats = cache.statistics();
+	BOOST_REQUIRE_EQUAL(2, stats.entries);
+	BOOST_REQUIRE_EQUAL(5, stats.size);
+	BOOST_REQUIRE_EQUAL(2, stats.hits);
+	BOOST_REQUIRE_EQUAL(2, stats.misses);
+}
+
+
+BOOST_AUTO_TEST_CASE(least_recently_used_entries_are_evicted)
+{
+	const testaux::temporary_directory tempdir{};
+	const testaux::temporary_file data{std::string(100, 'x')};
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 250};
+	cache.store("a", data.filename());
+	cache.store("b", data.filename());
+	fs::last_write_time(tempdir.filename("cache/a"), 1000);
+	fs::last_write_time(tempdir.filename("cache/b"), 2000);
+	BOOST_REQUIRE(cache.lookup("a"));
+	cache.store("c", data.filename());
+	BOOST_REQUIRE(fs::exists(tempdir.filename("cache/a")));
+	BOOST_REQUIRE(!fs::exists(tempdir.filename("cache/b")));
+	BOOST_REQUIRE(fs::exists(tempdir.filename("cache/c")));
+	BOOST_REQUIRE_EQUAL(200, cache.statistics().size);
+}
+
+
+BOOST_AUTO_TEST_CASE(file_larger_than_limit_is_not_stored)
+{
+	const testaux::temporary_directory tempdir{};
+	const testaux::temporary_file data{std::string(100, 'x')};
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 99};
+	cache.store("a", data.filename());
+	BOOST_REQUIRE_EQUAL(0, cache.statistics().entries);
+}
+
+
+BOOST_AUTO_TEST_CASE(vanished_directory_is_not_an_error)
+{
+	const testaux::temporary_directory tempdir{};
+	const testaux::temporary_file data{"data"};
+	auto cache = minijava::compilation_cache{tempdir.filename("cache"), 1000};
+	fs::remove_all(tempdir.filename("cache"));
+	cache.store("a");
+	cache.store("b", data.filename());
+	BOOST_REQUIRE(!cache.lookup("a"));
+	BOOST_REQUIRE(!cache.lookup("b", data.filename()));
+	BOOST_REQUIRE_EQUAL(0, cache.statistics().entries);
+}
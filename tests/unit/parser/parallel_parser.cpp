@@ -0,0 +1,214 @@
+#include "parser/parallel_parser.hpp"
+
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#define BOOST_TEST_MODULE  parser_parallel_parser
+#include <boost/test/unit_test.hpp>
+
+#include "lexer/lexer.hpp"
+#include "parser/ast.hpp"
+#include "parser/ast_misc.hpp"
+#include "parser/for_each_node.hpp"
+#include "parser/parser.hpp"
+#include "position.hpp"
+#include "symbol/concurrent_symbol_pool.hpp"
+#include "symbol/symbol_pool.hpp"
+
+#include "testaux/astgen.hpp"
+
+namespace ast = minijava::ast;
+
+
+namespace /* anonymous */
+{
+
+	struct node_collector : minijava::for_each_node
+	{
+
+		void visit_node(const ast::node& node) override
+		{
+			nodes.emplace_back(node.id(), node.position().line(), node.position().column());
+		}
+
+		std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> nodes{};
+
+	};
+
+	std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> collect_nodes(const ast::node& ast)
+	{
+		auto collector = node_collector{};
+		ast.accept(collector);
+		return collector.nodes;
+	}
+
+	// The chunks point into `text` so it must outlive them.
+	std::vector<minijava::source_chunk> split(const std::string& text)
+	{
+		return minijava::split_class_declarations(text.data(), text.data() + text.size());
+	}
+
+	std::string chunk_text(const minijava::source_chunk& chunk)
+	{
+		return std::string{chunk.first, chunk.last};
+	}
+
+	// Parses `text` with `threads` threads and checks that the result is
+	// identical to the result of parsing it sequentially.
+	template <typename PoolT = minijava::symbol_pool<>>
+	void check_same_as_sequential(const std::string& text, const std::size_t threads)
+	{
+		const auto first = text.data();
+		const auto last = text.data() + text.size();
+		auto pool = PoolT{};
+		auto expected_factory = minijava::ast_factory{7};
+		auto actual_factory = minijava::ast_factory{7};
+		const auto expected = minijava::parse_source(first, last, pool, expected_factory, 1);
+		const auto actual = minijava::parse_source(first, last, pool, actual_factory, threads);
+		BOOST_REQUIRE_EQUAL(expected_factory.id(), actual_factory.id());
+		BOOST_REQUIRE_EQUAL(to_text(*expected), to_text(*actual));
+		const auto expected_nodes = collect_nodes(*expected);
+		const auto actual_nodes = collect_nodes(*actual);
+		BOOST_REQUIRE(expected_nodes == actual_nodes);
+	}
+
+	// Checks that parsing `text` with `threads` threads `throw`s the same
+	// exception with the same position as parsing it sequentially.
+	template <typename ExceptionT>
+	void check_same_error_as_sequential(const std::string& text, const std::size_t threads)
+	{
+		const auto parse = [&text](const std::size_t threads){
+			auto pool = minijava::symbol_pool<>{};
+			auto factory = minijava::ast_factory{};
+			try {
+				minijava::parse_source(text.data(), text.data() + text.size(), pool, factory, threads);
+			} catch (const ExceptionT& e) {
+				return e.position();
+			}
+			BOOST_FAIL("Expected exception was not thrown");
+			return minijava::position{};
+		};
+		BOOST_REQUIRE_EQUAL(parse(1), parse(threads));
+	}
+
+}  // namespace /* anonymous */
+
+
+BOOST_AUTO_TEST_CASE(split_empty_input)
+{
+	BOOST_REQUIRE(split("").empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(split_single_class)
+{
+	const auto text = std::string{"class A { public int[] a; public void f() { {} } }\n"};
+	const auto chunks = split(text);
+	BOOST_REQUIRE_EQUAL(1, chunks.size());
+	BOOST_REQUIRE_EQUAL("class A { public int[] a; public void f() { {} } }\n", chunk_text(chunks[0]));
+	BOOST_REQUIRE_EQUAL(minijava::position(1, 1), chunks[0].start);
+}
+
+
+BOOST_AUTO_TEST_CASE(split_multiple_classes)
+{
+	const auto text = std::string{"class A {}\nclass B {\n{}\n} class C {}  \n"};
+	const auto chunks = split(text);
+	BOOST_REQUIRE_EQUAL(3, chunks.size());
+	BOOST_REQUIRE_EQUAL("class A {}", chunk_text(chunks[0]));
+	BOOST_REQUIRE_EQUAL("\nclass B {\n{}\n}", chunk_text(chunks[1]));
+	BOOST_REQUIRE_EQUAL(" class C {}  \n", chunk_text(chunks[2]));
+	BOOST_REQUIRE_EQUAL(minijava::position(1, 1), chunks[0].start);
+	BOOST_REQUIRE_EQUAL(minijava::position(2, 0), chunks[1].start);
+	BOOST_REQUIRE_EQUAL(minijava::position(4, 2), chunks[2].start);
+}
+
+
+BOOST_AUTO_TEST_CASE(split_ignores_braces_in_comments)
+{
+	const auto text = std::string{"/* } */ class A { /* { */ } /**/ class B { /*/ } */ }"};
+	const auto chunks = split(text);
+	BOOST_REQUIRE_EQUAL(2, chunks.size());
+	BOOST_REQUIRE_EQUAL("/* } */ class A { /* { */ }", chunk_text(chunks[0]));
+	BOOST_REQUIRE_EQUAL(" /**/ class B { /*/ } */ }", chunk_text(chunks[1]));
+}
+
+
+BOOST_AUTO_TEST_CASE(split_rejects_broken_structure)
+{
+	BOOST_REQUIRE(split("class A {").empty());
+	BOOST_REQUIRE(split("class A { } }").empty());
+	BOOST_REQUIRE(split("class A { } /* class B { }").empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_source_with_multiple_classes)
+{
+	const auto text = std::string{
+		"class A {\n"
+		"    public int x;\n"
+		"    public static void main(String[] args) { new A().f(1); }\n"
+		"    public int f(int y) { return x + y; }\n"
+		"}\n"
+		"/* class Z { */ class B { public boolean b; }\n"
+		"class C { public void g() { if (true) { } else { while (false) { } } } }\n"
+	};
+	for (const auto threads : {2, 3, 8}) {
+		check_same_as_sequential(text, threads);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_source_with_random_programs)
+{
+	for (auto seed = 1u; seed <= 5u; ++seed) {
+		auto engine = std::default_random_engine{seed};
+		auto pool = minijava::symbol_pool<>{};
+		auto factory = minijava::ast_factory{};
+		const auto ast = testaux::generate_semantic_ast(engine, pool, factory, 25);
+		const auto text = to_text(*ast);
+		for (const auto threads : {2, 5}) {
+			check_same_as_sequential(text, threads);
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_source_with_concurrent_symbol_pool)
+{
+	const auto text = std::string{
+		"class A { public A a; public int f(int x) { return x; } }\n"
+		"class B { public A a; public int g(int x) { return 42 + x; } }\n"
+		"class C { public B b; public static void main(String[] args) { } }\n"
+	};
+	for (const auto threads : {2, 3}) {
+		check_same_as_sequential<minijava::concurrent_symbol_pool<>>(text, threads);
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_source_reports_first_syntax_error)
+{
+	const auto text = std::string{
+		"class A { }\n"
+		"class B { public int x }\n"
+		"class C { public void f() { return return; } }\n"
+	};
+	check_same_error_as_sequential<minijava::syntax_error>(text, 3);
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_source_reports_lexical_error)
+{
+	const auto text = std::string{"class A { }\nclass B { public int x; }\nclass C { # }\n"};
+	check_same_error_as_sequential<minijava::lexical_error>(text, 3);
+}
+
+
+BOOST_AUTO_TEST_CASE(parse_source_reports_unbalanced_braces)
+{
+	const auto text = std::string{"class A { }\nclass B { public void f() { }\n"};
+	check_same_error_as_sequential<minijava::syntax_error>(text, 3);
+}
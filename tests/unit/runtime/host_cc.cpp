@@ -1,9 +1,12 @@
 #include "runtime/host_cc.hpp"
 
 #include <cstring>
+#include <stdexcept>
+#include <string>
 
 #define BOOST_TEST_MODULE  runtime_host_cc
 #include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
 
 #include "io/file_data.hpp"
 #include "io/file_output.hpp"
@@ -23,6 +26,12 @@
 #   define WINDOWS 0
 #endif
 
+#if defined (__linux__) && defined (__x86_64__)
+#   define LINUX_X64 1
+#else
+#   define LINUX_X64 0
+#endif
+
 
 BOOST_AUTO_TEST_CASE(default_c_compiler_is_not_empty)
 {
@@ -68,3 +77,129 @@ BOOST_AUTO_TEST_CASE(link_runtime_can_assemble)
 	}
 	BOOST_REQUIRE_NO_THROW(minijava::run_subprocess({outfile.filename()}));
 }
+
+
+BOOST_AUTO_TEST_CASE(link_runtime_without_libc)
+{
+	if (!LINUX_X64) {
+		return;
+	}
+	testaux::temporary_file outfile{};
+	testaux::temporary_file asmfile{simple_asm, ".S"};
+	minijava::link_runtime(
+		minijava::get_default_c_compiler(),
+		outfile.filename(),
+		asmfile.filename(),
+		minijava::runtime_library::nolibc
+	);
+	minijava::file_data executable{outfile.filename()};
+	BOOST_REQUIRE(executable.size() > 4);
+	const char magic[] = {0x7f, 'E', 'L', 'F'};
+	BOOST_CHECK(std::memcmp(magic, executable.data(), 4) == 0);
+	BOOST_REQUIRE_NO_THROW(minijava::run_subprocess({outfile.filename()}));
+}
+
+
+BOOST_AUTO_TEST_CASE(runtime_object_can_be_linked_repeatedly)
+{
+	namespace fs = boost::filesystem;
+	auto objname = std::string{};
+	{
+		const minijava::runtime_object runtime{
+			minijava::get_default_c_compiler(),
+			minijava::runtime_library::libc
+		};
+		objname = runtime.filename();
+		BOOST_REQUIRE(fs::exists(objname));
+		for (auto i = 0; i < 2; ++i) {
+			testaux::temporary_file outfile{};
+			testaux::temporary_file asmfile{simple_asm, ".S"};
+			minijava::link_runtime(
+				minijava::get_default_c_compiler(),
+				outfile.filename(),
+				asmfile.filename(),
+				runtime
+			);
+			if (!WINDOWS) {
+				BOOST_REQUIRE_NO_THROW(minijava::run_subprocess({outfile.filename()}));
+			}
+		}
+	}
+	BOOST_REQUIRE(!fs::exists(objname));
+}
+
+
+BOOST_AUTO_TEST_CASE(runtime_object_without_libc)
+{
+	if (!LINUX_X64) {
+		return;
+	}
+	const minijava::runtime_object runtime{
+		minijava::get_default_c_compiler(),
+		minijava::runtime_library::nolibc
+	};
+	BOOST_REQUIRE(runtime.library() == minijava::runtime_library::nolibc);
+	testaux::temporary_file outfile{};
+	testaux::temporary_file asmfile{simple_asm, ".S"};
+	minijava::link_runtime(
+		minijava::get_default_c_compiler(),
+		outfile.filename(),
+		asmfile.filename(),
+		runtime
+	);
+	BOOST_REQUIRE_NO_THROW(minijava::run_subprocess({outfile.filename()}));
+}
+
+
+BOOST_AUTO_TEST_CASE(assembly_pipe_can_assemble)
+{
+	testaux::temporary_file outfile{};
+	{
+		minijava::assembly_pipe pipe{minijava::get_default_c_compiler(), outfile.filename()};
+		pipe.assembly().write(simple_asm);
+		pipe.finish();
+	}
+	if (!WINDOWS) {
+		BOOST_REQUIRE_NO_THROW(minijava::run_subprocess({outfile.filename()}));
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(assembly_pipe_with_runtime_object)
+{
+	const minijava::runtime_object runtime{
+		minijava::get_default_c_compiler(),
+		minijava::runtime_library::libc
+	};
+	for (auto i = 0; i < 2; ++i) {
+		testaux::temporary_file outfile{};
+		minijava::assembly_pipe pipe{minijava::get_default_c_compiler(), outfile.filename(), runtime};
+		pipe.assembly().write(simple_asm);
+		pipe.finish();
+		if (!WINDOWS) {
+			BOOST_REQUIRE_NO_THROW(minijava::run_subprocess({outfile.filename()}));
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(assembly_pipe_reports_bad_assembly)
+{
+	testaux::temporary_file outfile{};
+	minijava::assembly_pipe pipe{minijava::get_default_c_compiler(), outfile.filename()};
+	pipe.assembly().write("this is not assembly\n");
+	BOOST_REQUIRE_THROW(pipe.finish(), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_CASE(unfinished_assembly_pipe_produces_no_executable)
+{
+	namespace fs = boost::filesystem;
+	testaux::temporary_file outfile{};
+	fs::remove(outfile.filename());
+	{
+		minijava::assembly_pipe pipe{minijava::get_default_c_compiler(), outfile.filename()};
+		pipe.assembly().write(simple_asm);
+	}
+	BOOST_REQUIRE(!fs::exists(outfile.filename()));
+}
@@ -0,0 +1,287 @@
+#include "runtime/jit.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#define BOOST_TEST_MODULE  runtime_jit
+#include <boost/test/unit_test.hpp>
+
+#include "testaux/temporary_file.hpp"
+
+#if defined (__linux__) && defined (__x86_64__)
+#  define JIT_AVAILABLE 1
+#else
+#  define JIT_AVAILABLE 0
+#endif
+
+namespace be = minijava::backend;
+
+
+namespace /* anonymous */
+{
+
+	// Machine code fragments for building tiny test programs by hand.
+	const std::vector<std::uint8_t> sub_8_rsp = {0x48, 0x83, 0xec, 0x08};
+	const std::vector<std::uint8_t> add_8_rsp = {0x48, 0x83, 0xc4, 0x08};
+	const std::vector<std::uint8_t> ret = {0xc3};
+
+	struct program
+	{
+		be::object_file obj{};
+
+		program()
+		{
+			auto sym = be::object_symbol{};
+			sym.name = "minijava_main";
+			sym.section = be::object_section::text;
+			sym.kind = be::symbol_kind::function;
+			sym.global = true;
+			obj.symbols.push_back(sym);
+		}
+
+		program& code(const std::vector<std::uint8_t>& bytes)
+		{
+			obj.text.insert(obj.text.end(), bytes.begin(), bytes.end());
+			return *this;
+		}
+
+		program& mov_edi(const std::int32_t value)
+		{
+			obj.text.push_back(0xbf);
+			return imm32(static_cast<std::uint32_t>(value));
+		}
+
+		program& mov_esi(const std::int32_t value)
+		{
+			obj.text.push_back(0xbe);
+			return imm32(static_cast<std::uint32_t>(value));
+		}
+
+		program& call(const std::string& name)
+		{
+			obj.text.push_back(0xe8);
+			reference(name, be::relocation_kind::plt32, -4);
+			return imm32(0);
+		}
+
+		program& imm32(const std::uint32_t value)
+		{
+			for (auto i = 0; i < 4; ++i) {
+				obj.text.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+			}
+			return *this;
+		}
+
+		program& reference(const std::string& name, const be::relocation_kind kind, const std::int64_t addend = 0)
+		{
+			auto rel = be::relocation{};
+			rel.section = be::object_section::text;
+			rel.offset = obj.text.size();
+			rel.symbol = name;
+			rel.kind = kind;
+			rel.addend = addend;
+			obj.relocations.push_back(rel);
+			return *this;
+		}
+
+		int run(const std::string& input, std::string& output, std::string& errors)
+		{
+			testaux::temporary_file infile{input};
+			testaux::temporary_file outfile{};
+			testaux::temporary_file errfile{};
+			auto status = -1;
+			{
+				auto in = testaux::open_file(infile.filename(), "rb");
+				auto out = testaux::open_file(outfile.filename(), "wb");
+				auto err = testaux::open_file(errfile.filename(), "wb");
+				status = minijava::run_object(obj, "test", in.get(), out.get(), err.get());
+			}
+			output = read(outfile.filename());
+			errors = read(errfile.filename());
+			return status;
+		}
+
+		static std::string read(const std::string& filename)
+		{
+			auto fh = testaux::open_file(filename, "rb");
+			auto text = std::string{};
+			for (auto c = std::fgetc(fh.get()); c >= 0; c = std::fgetc(fh.get())) {
+				text.push_back(static_cast<char>(c));
+			}
+			return text;
+		}
+	};
+
+}  // namespace /* anonymous */
+
+
+BOOST_AUTO_TEST_CASE(empty_program_exits_successfully)
+{
+	auto prog = program{};
+	prog.code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	if (!JIT_AVAILABLE) {
+		BOOST_REQUIRE_THROW(prog.run("", output, errors), std::system_error);
+		return;
+	}
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, prog.run("", output, errors));
+	BOOST_REQUIRE_EQUAL("", output);
+	BOOST_REQUIRE_EQUAL("", errors);
+}
+
+
+BOOST_AUTO_TEST_CASE(println_writes_to_output)
+{
+	if (!JIT_AVAILABLE) {
+		return;
+	}
+	auto prog = program{};
+	prog.code(sub_8_rsp).mov_edi(-42).call("mj_runtime_println").mov_edi(7).call("mj_runtime_println");
+	prog.code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, prog.run("", output, errors));
+	BOOST_REQUIRE_EQUAL("-42\n7\n", output);
+}
+
+
+BOOST_AUTO_TEST_CASE(read_and_write_bytes)
+{
+	if (!JIT_AVAILABLE) {
+		return;
+	}
+	auto prog = program{};
+	prog.code(sub_8_rsp);
+	for (auto i = 0; i < 3; ++i) {
+		prog.call("mj_runtime_read").code({0x89, 0xc7}).call("mj_runtime_write");  // mov %eax, %edi
+	}
+	prog.call("mj_runtime_flush").code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, prog.run("ab", output, errors));
+	BOOST_REQUIRE_EQUAL("ab\xff", output);
+}
+
+
+BOOST_AUTO_TEST_CASE(exit_status_is_returned)
+{
+	if (!JIT_AVAILABLE) {
+		return;
+	}
+	auto prog = program{};
+	prog.code(sub_8_rsp).mov_edi(1).call("mj_runtime_println").mov_edi(3).call("mj_runtime_exit");
+	prog.mov_edi(2).call("mj_runtime_println").code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_EQUAL(3, prog.run("", output, errors));
+	BOOST_REQUIRE_EQUAL("1\n", output);
+}
+
+
+BOOST_AUTO_TEST_CASE(runtime_errors_fail_the_program)
+{
+	if (!JIT_AVAILABLE) {
+		return;
+	}
+	auto prog = program{};
+	prog.code(sub_8_rsp).mov_edi(-1).mov_esi(4).call("mj_runtime_new").code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_EQUAL(EXIT_FAILURE, prog.run("", output, errors));
+	BOOST_REQUIRE_EQUAL(0, errors.find("test: new: "));
+	BOOST_REQUIRE(errors.find("negative array size") != std::string::npos);
+}
+
+
+#if JIT_AVAILABLE
+
+BOOST_AUTO_TEST_CASE(garbage_is_collected)
+{
+	// Allocate far more unreachable memory than the collector lets the heap
+	// grow to before it collects.
+	auto prog = program{};
+	prog.code(sub_8_rsp);
+	for (auto i = 0; i < 48; ++i) {
+		prog.mov_edi(1 << 20).mov_esi(1).call("mj_runtime_new");
+	}
+	prog.code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	setenv("MINIJAVA_GC_STATS", "1", 1);
+	const auto status = prog.run("", output, errors);
+	unsetenv("MINIJAVA_GC_STATS");
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, status);
+	BOOST_REQUIRE_EQUAL(0, errors.find("test: gc: collection 1 took "));
+	BOOST_REQUIRE(errors.find(" collections, total pause ") != std::string::npos);
+}
+
+#endif
+
+
+BOOST_AUTO_TEST_CASE(global_data_is_addressable)
+{
+	if (!JIT_AVAILABLE) {
+		return;
+	}
+	auto prog = program{};
+	auto sym = be::object_symbol{};
+	sym.name = "counter";
+	sym.section = be::object_section::bss;
+	sym.kind = be::symbol_kind::object;
+	sym.offset = 4;
+	sym.size = 4;
+	prog.obj.symbols.push_back(sym);
+	prog.obj.bss_size = 8;
+	prog.obj.bss_alignment = 8;
+	prog.code(sub_8_rsp);
+	prog.code({0xc7, 0x04, 0x25}).reference("counter", be::relocation_kind::abs32s).imm32(0).imm32(5);  // movl $5, counter
+	prog.code({0x8b, 0x3c, 0x25}).reference("counter", be::relocation_kind::abs32s).imm32(0);           // movl counter, %edi
+	prog.call("mj_runtime_println").code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, prog.run("", output, errors));
+	BOOST_REQUIRE_EQUAL("5\n", output);
+}
+
+
+BOOST_AUTO_TEST_CASE(heap_pointer_is_addressable)
+{
+	if (!JIT_AVAILABLE) {
+		return;
+	}
+	auto prog = program{};
+	prog.code(sub_8_rsp).mov_edi(1).mov_esi(12).call("mj_runtime_new");
+	prog.code({0x48, 0x8b, 0x3c, 0x25}).reference("mj_runtime_heap_next", be::relocation_kind::abs32s).imm32(0);  // movq mj_runtime_heap_next, %rdi
+	prog.code({0x48, 0x29, 0xc7});  // subq %rax, %rdi
+	prog.call("mj_runtime_println").code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, prog.run("", output, errors));
+	BOOST_REQUIRE_EQUAL("16\n", output);
+}
+
+
+BOOST_AUTO_TEST_CASE(unknown_symbols_are_rejected)
+{
+	auto prog = program{};
+	prog.code(sub_8_rsp).call("printf").code(add_8_rsp).code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_THROW(prog.run("", output, errors), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_CASE(missing_entry_point_is_rejected)
+{
+	auto prog = program{};
+	prog.obj.symbols.clear();
+	prog.code(ret);
+	auto output = std::string{};
+	auto errors = std::string{};
+	BOOST_REQUIRE_THROW(prog.run("", output, errors), std::runtime_error);
+}
@@ -11,3 +11,14 @@ BOOST_AUTO_TEST_CASE(runtime_source_can_be_called)
 	using namespace std::string_literals;
 	BOOST_REQUIRE_NE(""s, minijava::runtime_source());
 }
+
+
+BOOST_AUTO_TEST_CASE(nolibc_runtime_source_is_different)
+{
+	using namespace std::string_literals;
+	const auto libc = minijava::runtime_source(minijava::runtime_library::libc);
+	const auto nolibc = minijava::runtime_source(minijava::runtime_library::nolibc);
+	BOOST_REQUIRE_NE(""s, nolibc);
+	BOOST_REQUIRE_NE(libc, nolibc);
+	BOOST_REQUIRE_NE(std::string::npos, nolibc.find("_start"));
+}
@@ -1,18 +1,78 @@
 #include "semantic/semantic.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <sstream>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #define BOOST_TEST_MODULE  semantic_semantic
 #include <boost/test/unit_test.hpp>
 
+#include "lexer/lexer.hpp"
+#include "lexer/token_iterator.hpp"
+#include "parser/parser.hpp"
+#include "semantic/semantic_error.hpp"
+
 #include "testaux/ast_test_factory.hpp"
+#include "testaux/astgen.hpp"
 #include "testaux/unique_ptr_vector.hpp"
 
 namespace ast = minijava::ast;
 using namespace std::string_literals;
 
 
+namespace /* anonymous */
+{
+
+	// Parses the program `text` with the pool and factory of `tf`.
+	std::unique_ptr<ast::program> parse(testaux::ast_test_factory& tf, const std::string& text)
+	{
+		auto lex = minijava::make_lexer(std::begin(text), std::end(text), tf.pool, tf.pool);
+		return minijava::parse_program(minijava::token_begin(lex), minijava::token_end(lex), tf.factory);
+	}
+
+	// Describes the annotations in `info` of the nodes with IDs up to
+	// `lastid` in terms of node IDs.  Since `check_program` creates new nodes
+	// for the built-in classes each time it is called, those only appear as
+	// "builtin" so the descriptions can be compared between calls.
+	std::vector<std::string> describe_annotations(const minijava::semantic_info& info,
+	                                              const std::size_t lastid)
+	{
+		auto lines = std::vector<std::string>{};
+		const auto name = [lastid](const ast::node& node){
+			return (node.id() <= lastid) ? std::to_string(node.id()) : "builtin"s;
+		};
+		const auto describe = [&lines, lastid](const ast::node& node, const auto& value){
+			if (node.id() <= lastid) {
+				auto oss = std::ostringstream{};
+				oss << node.id() << " " << value;
+				lines.push_back(oss.str());
+			}
+		};
+		for (const auto& kv : info.type_annotations()) {
+			describe(*kv.first, kv.second);
+		}
+		for (const auto& kv : info.locals_annotations()) {
+			for (const auto decl : kv.second) {
+				describe(*kv.first, name(*decl));
+			}
+		}
+		for (const auto& kv : info.vardecl_annotations()) {
+			describe(*kv.first, name(*kv.second));
+		}
+		for (const auto& kv : info.method_annotations()) {
+			describe(*kv.first, name(*kv.second));
+		}
+		std::sort(std::begin(lines), std::end(lines));
+		return lines;
+	}
+
+}  // namespace /* anonymous */
+
+
 BOOST_AUTO_TEST_CASE(semantic_info_type_sanity_checks)
 {
 	// Default-construct the parameters using AAA syntax.
@@ -129,3 +189,87 @@ BOOST_AUTO_TEST_CASE(check_invalid_program)
 		minijava::semantic_error
 	);
 }
+
+
+BOOST_AUTO_TEST_CASE(check_program_does_not_depend_on_thread_count)
+{
+	// The generated program depends on the addresses of the symbols so it
+	// must only be generated once for all thread counts.
+	for (auto seed = 1u; seed <= 3u; ++seed) {
+		auto engine = std::default_random_engine{seed};
+		auto pool = minijava::symbol_pool<>{};
+		auto factory = minijava::ast_factory{};
+		const auto ast = testaux::generate_semantic_ast(engine, pool, factory, 25);
+		const auto lastid = factory.id();
+		const auto expected = describe_annotations(
+			minijava::check_program(*ast, pool, factory, 1), lastid
+		);
+		BOOST_REQUIRE(!expected.empty());
+		for (const auto threads : {2, 3, 8}) {
+			const auto actual = describe_annotations(
+				minijava::check_program(*ast, pool, factory, threads), lastid
+			);
+			BOOST_REQUIRE_EQUAL_COLLECTIONS(
+				std::begin(expected), std::end(expected),
+				std::begin(actual), std::end(actual)
+			);
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(check_program_in_parallel_reports_first_error)
+{
+	const auto text = std::string{
+		"class A {\n"
+		"    public int f() { return true; }\n"
+		"    public static void main(String[] args) { int a = b; }\n"
+		"}\n"
+		"class B {\n"
+		"    public int g() { return c; }\n"
+		"}\n"
+	};
+	for (const auto threads : {2, 3, 8}) {
+		auto tf = testaux::ast_test_factory{};
+		const auto ast = parse(tf, text);
+		try {
+			minijava::check_program(*ast, tf.pool, tf.factory, threads);
+			BOOST_FAIL("Program was not rejected");
+		} catch (const minijava::semantic_error& e) {
+			BOOST_REQUIRE_EQUAL(2, e.position().line());
+		}
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(check_program_reports_same_error_for_any_thread_count)
+{
+	// Sequentially, the `main` method used to be analyzed before the
+	// instance methods, so the error on line 3 was reported instead of the
+	// one on line 2.
+	const auto text = std::string{
+		"class A {\n"
+		"    public int f() { return true; }\n"
+		"    public static void main(String[] args) { int a = b; }\n"
+		"    public void g() { this.h(); }\n"
+		"}\n"
+	};
+	const auto diagnose = [&text](const std::size_t threads){
+		auto tf = testaux::ast_test_factory{};
+		const auto ast = parse(tf, text);
+		try {
+			minijava::check_program(*ast, tf.pool, tf.factory, threads);
+		} catch (const minijava::semantic_error& e) {
+			auto oss = std::ostringstream{};
+			oss << e.position() << ": " << e.what();
+			return oss.str();
+		}
+		BOOST_FAIL("Program was not rejected");
+		return std::string{};
+	};
+	const auto expected = diagnose(1);
+	BOOST_REQUIRE_EQUAL(0, expected.find("line: 2 "));
+	for (const auto threads : {2, 4}) {
+		BOOST_REQUIRE_EQUAL(expected, diagnose(threads));
+	}
+}
@@ -168,3 +168,34 @@ BOOST_AUTO_TEST_CASE(shadowing_disallowed)
 	);
 	BOOST_REQUIRE_EQUAL(a1.get(), st.get_conflicting_definitions(a1->name()));
 }
+
+
+BOOST_AUTO_TEST_CASE(nested_table_sees_outer_definitions)
+{
+	auto pool = minijava::symbol_pool<>{};
+	auto outer = minijava::sem::symbol_table{};
+	const auto a1 = make_decl(pool, "alpha");
+	const auto a2 = make_decl(pool, "alpha");
+	const auto b = make_decl(pool, "beta");
+	const auto c = make_decl(pool, "gamma");
+	outer.enter_scope(true);
+	outer.add_def(a1.get());
+	outer.enter_scope();
+	outer.add_def(b.get());
+	auto inner = minijava::sem::symbol_table{&outer};
+	BOOST_REQUIRE_EQUAL(0, inner.depth());
+	BOOST_REQUIRE_EQUAL(a1.get(), inner.lookup(a1->name()));
+	BOOST_REQUIRE_EQUAL(b.get(), inner.lookup(b->name()));
+	BOOST_REQUIRE(!inner.lookup(c->name()));
+	inner.enter_scope();
+	BOOST_REQUIRE(!inner.get_conflicting_definitions(a1->name()));
+	BOOST_REQUIRE_EQUAL(b.get(), inner.get_conflicting_definitions(b->name()));
+	inner.add_def(a2.get());
+	inner.add_def(c.get());
+	BOOST_REQUIRE_EQUAL(a2.get(), inner.lookup(a1->name()));
+	BOOST_REQUIRE_EQUAL(c.get(), inner.lookup(c->name()));
+	BOOST_REQUIRE_EQUAL(a1.get(), outer.lookup(a1->name()));
+	BOOST_REQUIRE(!outer.lookup(c->name()));
+	inner.leave_scope();
+	BOOST_REQUIRE_EQUAL(a1.get(), inner.lookup(a1->name()));
+}
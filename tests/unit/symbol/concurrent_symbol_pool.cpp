@@ -0,0 +1,122 @@
+#include "symbol/concurrent_symbol_pool.hpp"
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BOOST_TEST_MODULE  symbol_concurrent_symbol_pool
+#include <boost/test/unit_test.hpp>
+
+
+BOOST_AUTO_TEST_CASE(empty_when_default_constructed)
+{
+	const auto pool = minijava::concurrent_symbol_pool<>{};
+	BOOST_REQUIRE_EQUAL(std::size_t{0}, pool.size());
+	BOOST_REQUIRE(pool.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(empty_pool_is_normalized_only_empty_string)
+{
+	const auto pool = minijava::concurrent_symbol_pool<>{};
+	BOOST_REQUIRE(pool.is_normalized(""));
+	BOOST_REQUIRE(not pool.is_normalized("elephant"));
+}
+
+
+BOOST_AUTO_TEST_CASE(pool_returns_empty_symbol_singlton)
+{
+	auto pool = minijava::concurrent_symbol_pool<>{};
+	auto empty_symbol = pool.normalize("");
+	auto full_symbol = pool.normalize("testtest");
+	BOOST_REQUIRE(empty_symbol.empty());
+	BOOST_REQUIRE_EQUAL(empty_symbol, minijava::symbol{});
+	BOOST_REQUIRE_NE(empty_symbol, full_symbol);
+}
+
+
+BOOST_AUTO_TEST_CASE(returns_canonical_pointer_after_normalization)
+{
+	using namespace std::string_literals;
+	auto pool = minijava::concurrent_symbol_pool<>{};
+	const auto text = "matchstick"s;
+	const auto canonical = pool.normalize(text);
+	BOOST_REQUIRE(pool.is_normalized(text));
+	BOOST_REQUIRE(canonical.c_str() != text.c_str());
+	BOOST_REQUIRE_EQUAL(canonical, pool.normalize(text));
+}
+
+
+BOOST_AUTO_TEST_CASE(correct_size_after_normalization)
+{
+	auto pool = minijava::concurrent_symbol_pool<>{};
+	pool.normalize("alpha");
+	pool.normalize("beta");
+	pool.normalize("gamma");
+	BOOST_REQUIRE_EQUAL(std::size_t{3}, pool.size());
+	BOOST_REQUIRE(not pool.empty());
+	pool.normalize("beta");  // should already be present
+	BOOST_REQUIRE_EQUAL(std::size_t{3}, pool.size());
+}
+
+
+BOOST_AUTO_TEST_CASE(move_constructed_pool_behaves_like_old_pool)
+{
+	using namespace std::string_literals;
+	auto pool = minijava::concurrent_symbol_pool<>{};
+	const auto text = "matchstick"s;
+	const auto canonical = pool.normalize(text);
+	auto moved_pool = std::move(pool);
+	BOOST_REQUIRE_EQUAL(canonical, moved_pool.normalize(text));
+	BOOST_REQUIRE_EQUAL(std::size_t{1}, moved_pool.size());
+	// old pool is empty
+	BOOST_REQUIRE(pool.empty());
+	BOOST_REQUIRE(not pool.is_normalized(text));
+}
+
+
+BOOST_AUTO_TEST_CASE(move_assigned_pool_behaves_like_old_pool)
+{
+	using namespace std::string_literals;
+	auto pool = minijava::concurrent_symbol_pool<>{};
+	const auto text = "matchstick"s;
+	const auto canonical = pool.normalize(text);
+	auto second_pool = minijava::concurrent_symbol_pool<>{};
+	second_pool.normalize("other");
+	second_pool = std::move(pool);
+	BOOST_REQUIRE_EQUAL(canonical, second_pool.normalize(text));
+	BOOST_REQUIRE_EQUAL(std::size_t{1}, second_pool.size());
+	BOOST_REQUIRE(pool.empty());
+}
+
+
+BOOST_AUTO_TEST_CASE(symbols_interned_from_multiple_threads_are_identical)
+{
+	constexpr auto threads = std::size_t{8};
+	constexpr auto words = std::size_t{500};
+	auto pool = minijava::concurrent_symbol_pool<>{};
+	// Each thread interns all words, starting at a different offset, so all
+	// threads compete for the same words.
+	auto results = std::vector<std::vector<minijava::symbol>>(threads);
+	auto workers = std::vector<std::thread>{};
+	for (auto t = std::size_t{}; t < threads; ++t) {
+		workers.emplace_back([&pool, &results, t](){
+			results[t].resize(words);
+			for (auto i = std::size_t{}; i < words; ++i) {
+				const auto w = (i + t * words / threads) % words;
+				results[t][w] = pool.normalize("word" + std::to_string(w));
+			}
+		});
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+	BOOST_REQUIRE_EQUAL(words, pool.size());
+	for (auto w = std::size_t{}; w < words; ++w) {
+		BOOST_REQUIRE_EQUAL("word" + std::to_string(w), results[0][w].c_str());
+		for (auto t = std::size_t{1}; t < threads; ++t) {
+			BOOST_REQUIRE_EQUAL(results[0][w], results[t][w]);
+		}
+	}
+}
@@ -0,0 +1,256 @@
+#include "system/server.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef __unix__
+#  include <csignal>
+#  include <sys/socket.h>
+#  include <sys/stat.h>
+#  include <sys/un.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#define BOOST_TEST_MODULE  system_server
+#include <boost/test/unit_test.hpp>
+
+#include "testaux/temporary_file.hpp"
+
+
+#ifdef __unix__
+
+namespace /* anonymous */
+{
+
+	// Echoes its arguments and standard input to standard output and
+	// `return`s the number of arguments.  A first argument of "throw" or
+	// "crash" makes it fail instead.
+	int echo_handler(const std::vector<const char*>& args,
+	                 std::FILE* thestdin, std::FILE* thestdout, std::FILE* thestderr)
+	{
+		using namespace std::string_literals;
+		if ((args.size() > 1) && (args[1] == "throw"s)) {
+			throw std::runtime_error{"oops"};
+		}
+		if ((args.size() > 1) && (args[1] == "crash"s)) {
+			_exit(42);
+		}
+		for (const auto arg : args) {
+			std::fprintf(thestdout, "[%s]", arg);
+		}
+		auto c = 0;
+		while ((c = std::fgetc(thestdin)) != EOF) {
+			std::fputc(c, thestdout);
+		}
+		std::fputs("done", thestderr);
+		return static_cast<int>(args.size());
+	}
+
+	bool file_exists(const std::string& filename)
+	{
+		struct stat info;
+		return (stat(filename.c_str(), &info) == 0);
+	}
+
+	// Runs a server with the `echo_handler` in a child process and stops it
+	// again in the destructor.
+	class server_process final
+	{
+	public:
+
+		explicit server_process(const std::string& socket_name)
+			: _socket_name{socket_name}
+		{
+			std::fflush(nullptr);
+			_pid = fork();
+			if (_pid < 0) {
+				throw std::runtime_error{"Cannot fork"};
+			}
+			if (_pid == 0) {
+				try {
+					minijava::run_server(socket_name, &echo_handler);
+				} catch (const std::exception&) {
+					_exit(EXIT_FAILURE);
+				}
+				_exit(EXIT_SUCCESS);
+			}
+			for (auto i = 0; i < 500; ++i) {
+				if (file_exists(socket_name) && _can_connect()) {
+					return;
+				}
+				usleep(10000);
+			}
+			stop();
+			throw std::runtime_error{"Server did not start"};
+		}
+
+		~server_process()
+		{
+			stop();
+		}
+
+		server_process(const server_process&) = delete;
+		server_process& operator=(const server_process&) = delete;
+
+		int stop()
+		{
+			auto status = -1;
+			if (_pid > 0) {
+				kill(_pid, SIGTERM);
+				waitpid(_pid, &status, 0);
+				_pid = -1;
+			}
+			return status;
+		}
+
+	private:
+
+		bool _can_connect() const
+		{
+			const auto sock = socket(AF_UNIX, SOCK_STREAM, 0);
+			auto address = sockaddr_un{};
+			address.sun_family = AF_UNIX;
+			_socket_name.copy(address.sun_path, sizeof(address.sun_path) - 1);
+			const auto ok = connect(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+			close(sock);
+			return ok;
+		}
+
+		std::string _socket_name{};
+		pid_t _pid{-1};
+
+	};
+
+	struct client_streams
+	{
+		explicit client_streams(const std::string& input = "") : in{input}
+		{
+		}
+
+		int run(const std::string& socket_name, const std::vector<const char*>& args)
+		{
+			auto fh_in = testaux::open_file(in.filename(), "rb");
+			auto fh_out = testaux::open_file(out.filename(), "wb");
+			auto fh_err = testaux::open_file(err.filename(), "wb");
+			return minijava::run_client(socket_name, args, fh_in.get(), fh_out.get(), fh_err.get());
+		}
+
+		testaux::temporary_file in;
+		testaux::temporary_file out{};
+		testaux::temporary_file err{};
+	};
+
+}  // namespace /* anonymous */
+
+
+BOOST_AUTO_TEST_CASE(request_sees_arguments_and_streams_of_client)
+{
+	using namespace std::string_literals;
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	server_process server{socket_name};
+	client_streams client{"input"};
+	const auto status = client.run(socket_name, {"cmd", "alpha", "beta"});
+	BOOST_REQUIRE_EQUAL(3, status);
+	BOOST_REQUIRE(testaux::file_has_content(client.out.filename(), "[cmd][alpha][beta]input"s));
+	BOOST_REQUIRE(testaux::file_has_content(client.err.filename(), "done"s));
+}
+
+
+BOOST_AUTO_TEST_CASE(server_handles_many_requests)
+{
+	using namespace std::string_literals;
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	server_process server{socket_name};
+	for (auto i = 0; i < 20; ++i) {
+		const auto arg = std::to_string(i);
+		client_streams client{};
+		const auto status = client.run(socket_name, {"cmd", arg.c_str()});
+		BOOST_REQUIRE_EQUAL(2, status);
+		BOOST_REQUIRE(testaux::file_has_content(client.out.filename(), "[cmd][" + arg + "]"));
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(exception_in_request_is_reported_as_failure)
+{
+	using namespace std::string_literals;
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	server_process server{socket_name};
+	client_streams client{};
+	const auto status = client.run(socket_name, {"cmd", "throw"});
+	BOOST_REQUIRE_EQUAL(EXIT_FAILURE, status);
+	BOOST_REQUIRE(testaux::file_has_content(client.err.filename(), "oops\n"s));
+}
+
+
+BOOST_AUTO_TEST_CASE(crashed_request_does_not_stop_server)
+{
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	server_process server{socket_name};
+	client_streams crashing{};
+	BOOST_REQUIRE_THROW(crashing.run(socket_name, {"cmd", "crash"}), std::runtime_error);
+	client_streams client{};
+	BOOST_REQUIRE_EQUAL(1, client.run(socket_name, {"cmd"}));
+}
+
+
+BOOST_AUTO_TEST_CASE(socket_is_removed_when_server_stops)
+{
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	server_process server{socket_name};
+	BOOST_REQUIRE(file_exists(socket_name));
+	const auto status = server.stop();
+	BOOST_REQUIRE(WIFEXITED(status));
+	BOOST_REQUIRE_EQUAL(EXIT_SUCCESS, WEXITSTATUS(status));
+	BOOST_REQUIRE(!file_exists(socket_name));
+}
+
+
+BOOST_AUTO_TEST_CASE(stale_socket_is_replaced)
+{
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	{
+		const auto sock = socket(AF_UNIX, SOCK_STREAM, 0);
+		auto address = sockaddr_un{};
+		address.sun_family = AF_UNIX;
+		socket_name.copy(address.sun_path, sizeof(address.sun_path) - 1);
+		BOOST_REQUIRE_EQUAL(0, bind(sock, reinterpret_cast<const sockaddr*>(&address), sizeof(address)));
+		close(sock);
+	}
+	BOOST_REQUIRE(file_exists(socket_name));
+	server_process server{socket_name};
+	client_streams client{};
+	BOOST_REQUIRE_EQUAL(1, client.run(socket_name, {"cmd"}));
+}
+
+
+BOOST_AUTO_TEST_CASE(unreachable_server_throws)
+{
+	const testaux::temporary_directory tempdir{};
+	const auto socket_name = tempdir.filename("socket");
+	client_streams client{};
+	BOOST_REQUIRE_THROW(client.run(socket_name, {"cmd"}), std::system_error);
+}
+
+#else  // __unix__
+
+BOOST_AUTO_TEST_CASE(server_is_not_supported)
+{
+	BOOST_REQUIRE_THROW(
+		minijava::run_server("socket", [](auto&&...){ return 0; }),
+		std::system_error
+	);
+}
+
+#endif  // __unix__
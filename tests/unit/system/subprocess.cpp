@@ -1,6 +1,9 @@
 #include "system/subprocess.hpp"
 
+#include <cstdio>
+#include <stdexcept>
 #include <string>
+#include <system_error>
 #include <vector>
 
 #include <boost/algorithm/string/join.hpp>
@@ -89,3 +92,63 @@ BOOST_AUTO_TEST_CASE(subprocess_invalid)
 		std::invalid_argument
 	);
 }
+
+
+#ifdef __unix__
+
+BOOST_AUTO_TEST_CASE(subprocess_reads_piped_input)
+{
+	using namespace std::string_literals;
+	const testaux::temporary_file temp{};
+	minijava::subprocess proc{{"sh", "-c", "cat > \"$0\"", temp.filename()}, true};
+	BOOST_REQUIRE(proc.input() != nullptr);
+	BOOST_REQUIRE(proc.output() == nullptr);
+	std::fputs("first line\n", proc.input());
+	std::fputs("second line\n", proc.input());
+	proc.wait();
+	BOOST_REQUIRE(proc.input() == nullptr);
+	BOOST_REQUIRE(testaux::file_has_content(temp.filename(), "first line\nsecond line\n"s));
+}
+
+
+BOOST_AUTO_TEST_CASE(subprocess_writes_piped_output)
+{
+	minijava::subprocess proc{{"echo", "hello"}, false, true};
+	BOOST_REQUIRE(proc.input() == nullptr);
+	char buffer[16] = {};
+	BOOST_REQUIRE(std::fgets(buffer, sizeof(buffer), proc.output()) != nullptr);
+	BOOST_REQUIRE_EQUAL("hello\n", std::string{buffer});
+	proc.wait();
+}
+
+
+BOOST_AUTO_TEST_CASE(subprocess_failure_is_reported_by_wait)
+{
+	minijava::subprocess proc{{"sh", "-c", "cat > /dev/null; exit 3"}, true};
+	std::fputs("ignored", proc.input());
+	BOOST_CHECK_THROW(proc.wait(), std::runtime_error);
+}
+
+
+BOOST_AUTO_TEST_CASE(subprocess_start_error)
+{
+	const auto cmd = [](){
+		const testaux::temporary_file temp{};
+		return temp.filename();
+	}();
+	BOOST_CHECK_THROW((minijava::subprocess{{cmd}, true}), std::system_error);
+}
+
+
+BOOST_AUTO_TEST_CASE(writing_to_exited_subprocess_does_not_kill_caller)
+{
+	minijava::subprocess proc{{"true"}, true};
+	const auto junk = std::string(1024 * 1024, 'x');
+	for (auto i = 0; i < 4; ++i) {
+		std::fwrite(junk.data(), 1, junk.size(), proc.input());
+	}
+	BOOST_REQUIRE(std::ferror(proc.input()));
+	proc.wait();
+}
+
+#endif  // __unix__
@@ -1,11 +1,28 @@
 #include "system/system.hpp"
 
 #include <cstddef>
+#include <stdexcept>
+#include <thread>
 
 #define BOOST_TEST_MODULE  system_system
 #include <boost/test/unit_test.hpp>
 
 
+namespace /* anonymous */
+{
+
+	// Recurses `depth` times with a frame of at least 1 KiB each and
+	// `return`s `depth`.
+	std::size_t recurse(const std::size_t depth)
+	{
+		volatile char frame[1024];
+		frame[depth % sizeof(frame)] = 0;
+		return (depth == 0) ? 0 : 1 + recurse(depth - 1) + static_cast<std::size_t>(frame[depth % sizeof(frame)]);
+	}
+
+}  // namespace /* anonymous */
+
+
 BOOST_AUTO_TEST_CASE(set_max_stack_size_limit_query)
 {
 	try {
@@ -44,3 +61,66 @@ BOOST_AUTO_TEST_CASE(set_max_stack_size_limit_unlimited)
 		// failure is okay
 	}
 }
+
+
+BOOST_AUTO_TEST_CASE(stack_thread_runs_function_before_join_returns)
+{
+	auto calls = 0;
+	minijava::stack_thread thread{std::size_t{1} << 20, [&calls](){ ++calls; }};
+	thread.join();
+	BOOST_REQUIRE_EQUAL(1, calls);
+	thread.join();
+}
+
+
+BOOST_AUTO_TEST_CASE(current_thread_stack_size_reports_requested_size)
+{
+	BOOST_REQUIRE_EQUAL(0, minijava::current_thread_stack_size());
+	auto actual = std::size_t{};
+	{
+		const auto size = std::size_t{1} << 22;
+		minijava::stack_thread thread{size, [&actual](){ actual = minijava::current_thread_stack_size(); }};
+		thread.join();
+#ifdef __unix__
+		BOOST_REQUIRE_EQUAL(size, actual);
+#endif
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(call_with_stack_size_calls_function_once)
+{
+	auto calls = 0;
+	minijava::call_with_stack_size(std::size_t{1} << 20, [&calls](){ ++calls; });
+	BOOST_REQUIRE_EQUAL(1, calls);
+}
+
+
+BOOST_AUTO_TEST_CASE(call_with_stack_size_zero_uses_current_thread)
+{
+	auto id = std::thread::id{};
+	minijava::call_with_stack_size(0, [&id](){ id = std::this_thread::get_id(); });
+	BOOST_REQUIRE(std::this_thread::get_id() == id);
+}
+
+
+BOOST_AUTO_TEST_CASE(call_with_stack_size_propagates_exceptions)
+{
+	const auto func = [](){ throw std::runtime_error{"boom"}; };
+	BOOST_REQUIRE_THROW(minijava::call_with_stack_size(std::size_t{1} << 20, func), std::runtime_error);
+	BOOST_REQUIRE_THROW(minijava::call_with_stack_size(0, func), std::runtime_error);
+}
+
+
+#ifdef __unix__
+
+BOOST_AUTO_TEST_CASE(call_with_stack_size_allows_deep_recursion)
+{
+	// About 100 MiB of stack, which is way more than the usual default.
+	const auto depth = std::size_t{100000};
+	auto result = std::size_t{};
+	minijava::call_with_stack_size(std::size_t{1} << 28, [&result, depth](){ result = recurse(depth); });
+	BOOST_REQUIRE_EQUAL(depth, result);
+}
+
+#endif  // __unix__
@@ -0,0 +1,135 @@
+#include "system/workers.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "system/system.hpp"
+
+#ifdef __unix__
+#  include <unistd.h>
+#endif
+
+#define BOOST_TEST_MODULE  system_workers
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/data/monomorphic.hpp>
+
+
+static const std::size_t worker_counts[] = {0, 1, 2, 3, 8};
+
+
+BOOST_DATA_TEST_CASE(no_jobs_no_failures, worker_counts)
+{
+	const auto failures = minijava::run_worker_processes(
+		0, sample, [](std::size_t){ return false; }
+	);
+	BOOST_REQUIRE_EQUAL(0, failures);
+}
+
+
+BOOST_AUTO_TEST_CASE(sequential_jobs_run_exactly_once_in_order)
+{
+	auto seen = std::vector<std::size_t>{};
+	const auto failures = minijava::run_worker_processes(
+		100, 1, [&seen](std::size_t i){ seen.push_back(i); return true; }
+	);
+	BOOST_REQUIRE_EQUAL(0, failures);
+	BOOST_REQUIRE_EQUAL(100, seen.size());
+	for (auto i = std::size_t{}; i < seen.size(); ++i) {
+		BOOST_REQUIRE_EQUAL(i, seen[i]);
+	}
+}
+
+
+BOOST_DATA_TEST_CASE(failed_jobs_are_counted, worker_counts)
+{
+	const auto failures = minijava::run_worker_processes(
+		100, sample, [](std::size_t i){ return (i % 3) != 0; }
+	);
+	BOOST_REQUIRE_EQUAL(34, failures);
+}
+
+
+BOOST_DATA_TEST_CASE(exceptions_count_as_failures, worker_counts)
+{
+	const auto failures = minijava::run_worker_processes(
+		20, sample, [](std::size_t i){
+			if (i % 5 == 0) {
+				throw std::runtime_error{"oops"};
+			}
+			return true;
+		}
+	);
+	BOOST_REQUIRE_EQUAL(4, failures);
+}
+
+
+#ifdef __unix__
+
+BOOST_AUTO_TEST_CASE(crashed_worker_loses_only_its_current_job)
+{
+	const auto failures = minijava::run_worker_processes(
+		50, 4, [](std::size_t i){
+			if (i == 10) {
+				_exit(42);
+			}
+			return true;
+		}
+	);
+	BOOST_REQUIRE_EQUAL(1, failures);
+}
+
+#endif
+
+
+BOOST_DATA_TEST_CASE(thread_jobs_run_exactly_once, worker_counts)
+{
+	auto counts = std::vector<std::atomic<int>>(1000);
+	minijava::run_worker_threads(
+		counts.size(), sample, [&counts](std::size_t i){ ++counts[i]; }
+	);
+	for (const auto& count : counts) {
+		BOOST_REQUIRE_EQUAL(1, count.load());
+	}
+}
+
+
+BOOST_DATA_TEST_CASE(thread_job_exception_with_smallest_index_wins, worker_counts)
+{
+	try {
+		minijava::run_worker_threads(
+			100, sample, [](std::size_t i){
+				if ((i == 17) || (i == 42)) {
+					throw std::runtime_error{std::to_string(i)};
+				}
+			}
+		);
+		BOOST_FAIL("No exception was thrown");
+	} catch (const std::runtime_error& e) {
+		BOOST_REQUIRE_EQUAL("17", e.what());
+	}
+}
+
+
+#ifdef __unix__
+
+BOOST_AUTO_TEST_CASE(thread_jobs_get_stack_size_of_calling_thread)
+{
+	const auto size = std::size_t{1} << 26;
+	auto sizes = std::vector<std::size_t>(16);
+	minijava::call_with_stack_size(size, [&sizes](){
+		minijava::run_worker_threads(
+			sizes.size(), 4, [&sizes](std::size_t i){
+				sizes[i] = minijava::current_thread_stack_size();
+			}
+		);
+	});
+	for (const auto actual : sizes) {
+		BOOST_REQUIRE_EQUAL(size, actual);
+	}
+}
+
+#endif
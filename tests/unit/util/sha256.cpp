@@ -0,0 +1,72 @@
+#include "util/sha256.hpp"
+
+#include <string>
+
+#define BOOST_TEST_MODULE  util_sha256
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/data/monomorphic.hpp>
+
+
+namespace /* anonymous */
+{
+
+	struct test_vector
+	{
+		std::string message{};
+		std::string digest{};
+	};
+
+	std::ostream& operator<<(std::ostream& os, const test_vector& tv)
+	{
+		return os << "sha256(\"" << tv.message.substr(0, 20) << "...\")";
+	}
+
+}  // namespace /* anonymous */
+
+
+static const test_vector test_vectors[] = {
+	{"", "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"},
+	{"abc", "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"},
+	{
+		"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq",
+		"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"
+	},
+	{
+		std::string(1000000, 'a'),
+		"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"
+	},
+};
+
+
+BOOST_DATA_TEST_CASE(digest_of_complete_message_is_correct, test_vectors)
+{
+	auto hasher = minijava::sha256{};
+	hasher.update(sample.message);
+	BOOST_REQUIRE_EQUAL(sample.digest, hasher.hexdigest());
+}
+
+
+BOOST_DATA_TEST_CASE(digest_does_not_depend_on_chunking, test_vectors)
+{
+	for (const auto chunk : {1u, 3u, 63u, 64u, 65u, 1000u}) {
+		auto hasher = minijava::sha256{};
+		for (auto i = std::size_t{}; i < sample.message.size(); i += chunk) {
+			hasher.update(sample.message.substr(i, chunk));
+		}
+		BOOST_REQUIRE_EQUAL(sample.digest, hasher.hexdigest());
+	}
+}
+
+
+BOOST_AUTO_TEST_CASE(hexdigest_resets_the_state)
+{
+	auto hasher = minijava::sha256{};
+	hasher.update("garbage");
+	hasher.hexdigest();
+	hasher.update("abc");
+	BOOST_REQUIRE_EQUAL(
+		"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad",
+		hasher.hexdigest()
+	);
+}